@@ -30,10 +30,16 @@
 #ifndef CPUNIT_HPP
 #define CPUNIT_HPP
 
+#include "cpunit_AllocationTracker.hpp"
 #include "cpunit_Assert.hpp"
+#include "cpunit_BenchRegistrar.hpp"
+#include "cpunit_BenchState.hpp"
+#include "cpunit_Expect.hpp"
+#include "cpunit_ExpectationScope.hpp"
 #include "cpunit_FuncTestRegistrar.hpp"
 #include "cpunit_ExceptionTestRegistrar.hpp"
 #include "cpunit_FixtureRegistrar.hpp"
+#include "cpunit_Golden.hpp"
 
 /**
  * Forward stringify macro for full expansion macros when stringifying.
@@ -93,6 +99,53 @@
   namespace { static ::cpunit::ExceptionTestRegistrar<E> a##f##Registrar (CPUNIT_STRINGIFY(n), CPUNIT_STRINGIFY(f), __FILE__, __LINE__, &n::f);  } \
   void f()
 
+/** 
+ * Benchmark registrator for global benchmark functions.
+ * @param x The name of the benchmark to register.
+ */
+#define CPUNIT_GBENCH(x) CPUNIT_BENCH(,x)
+
+/** 
+ * Benchmark registrator for benchmark functions in a suite/namespace.
+ * The benchmark body is given a cpunit::BenchState named <tt>state</tt>,
+ * and must loop while <tt>state.keep_running()</tt> returns true.
+ * Benchmarks are only run with the --bench option.
+ * @param n The namespace name where the benchmark resides.
+ * @param f The name of the benchmark to register.
+ */
+#define CPUNIT_BENCH(n,f)						\
+  void f(::cpunit::BenchState &state);					\
+  namespace { static ::cpunit::BenchRegistrar a##f##Registrar (CPUNIT_STRINGIFY(n), CPUNIT_STRINGIFY(f), __FILE__, __LINE__, &n::f);  } \
+  void f(::cpunit::BenchState &state)
+
+/** 
+ * Registrator for benchmarks over a range of input sizes. The benchmark is run 
+ * with <tt>state.get_range()</tt> set to lo, 2*lo, 4*lo, ... up to hi, and the
+ * times are fitted to O(1), O(log n), O(n), O(n log n) and O(n^2).
+ * @param n  The namespace name where the benchmark resides.
+ * @param f  The name of the benchmark to register.
+ * @param lo The smallest input size, at least 1.
+ * @param hi The largest input size.
+ */
+#define CPUNIT_BENCH_RANGE(n,f,lo,hi)					\
+  void f(::cpunit::BenchState &state);					\
+  namespace { static ::cpunit::BenchRegistrar a##f##Registrar (CPUNIT_STRINGIFY(n), CPUNIT_STRINGIFY(f), __FILE__, __LINE__, &n::f, lo, hi);  } \
+  void f(::cpunit::BenchState &state)
+
+/** 
+ * Like CPUNIT_BENCH_RANGE, but fails the benchmark if the fitted complexity
+ * is worse than the given bound, e.g. <tt>cpunit::O_N_LOG_N</tt>.
+ * @param n  The namespace name where the benchmark resides.
+ * @param f  The name of the benchmark to register.
+ * @param lo The smallest input size, at least 1.
+ * @param hi The largest input size.
+ * @param c  The worst acceptable cpunit::Complexity.
+ */
+#define CPUNIT_BENCH_COMPLEXITY(n,f,lo,hi,c)				\
+  void f(::cpunit::BenchState &state);					\
+  namespace { static ::cpunit::BenchRegistrar a##f##Registrar (CPUNIT_STRINGIFY(n), CPUNIT_STRINGIFY(f), __FILE__, __LINE__, &n::f, lo, hi, c);  } \
+  void f(::cpunit::BenchState &state)
+
 /**
  * Set-up method registrator. There can only be one set-up method for each suite/namespace.
  * @param n The namespace to register the set-up method for.
@@ -111,6 +164,7 @@
   namespace { static ::cpunit::FixtureRegistrar tearDownRegistrar (CPUNIT_STRINGIFY(n), "tear_down", __FILE__, __LINE__, &n::tear_down, cpunit::FixtureRegistrar::TEAR_DOWN);  } \
   void tear_down()
 
+#include "cpunit_impl_Expression.hpp"
 #include "cpunit_impl_StrCat.hpp"
 
 /**
@@ -142,35 +196,95 @@
  * Convenience macro for calling assert_true. 
  * Will use the statement as message,
  * and will add the line number to the message as well.
+ * The message is only formatted if the assert fails, so a passing assert costs a branch.
  * @param x The statement to verify
  */
-#define CPUNIT_ASSERT(x)    cpunit::assert_true (CPUNIT_STR("At line " << __LINE__  << " of " << __FILE__ << " Stmt: '" << #x << '\''), x)
+#define CPUNIT_ASSERT(x)    ((x) ? (void)0 : cpunit::assert_true (CPUNIT_STR("At line " << __LINE__  << " of " << __FILE__ << " Stmt: '" << #x << '\''), false))
 
 /**
  * Convenience macro for calling assert_true. 
  * Will use the statement as part of the message,
  * and will add the line number to the message as well.
  * @param m A stream-formatted statement which will become part of the message.
+ *          It is only evaluated if the assert fails.
  * @param x The statement to verify
  */
-#define CPUNIT_ASSERT1(m,x) cpunit::assert_true (CPUNIT_STR("At line " << __LINE__  << " of " << __FILE__ << ": " << m << " Stmt: '" << #x << '\''), x)
+#define CPUNIT_ASSERT1(m,x) ((x) ? (void)0 : cpunit::assert_true (CPUNIT_STR("At line " << __LINE__  << " of " << __FILE__ << ": " << m << " Stmt: '" << #x << '\''), false))
 
 /**
  * Convenience macro for calling assert_false. 
  * Will use the statement as message,
  * and will add the line number to the message as well.
+ * The message is only formatted if the assert fails.
  * @param x The statement to falsify
  */
-#define CPUNIT_DISPROVE(x)    cpunit::assert_false(CPUNIT_STR("At line " << __LINE__  << " of " << __FILE__ << " Stmt: '" << #x << '\''), x)
+#define CPUNIT_DISPROVE(x)    ((x) ? cpunit::assert_false(CPUNIT_STR("At line " << __LINE__  << " of " << __FILE__ << " Stmt: '" << #x << '\''), true) : (void)0)
 
 /**
  * Convenience macro for calling assert_false. 
  * Will use the statement as message,
  * and will add the line number to the message as well.
  * @param m A stream-formatted statement which will become part of the message.
+ *          It is only evaluated if the assert fails.
  * @param x The statement to falsify
  */
-#define CPUNIT_DISPROVE1(m,x) cpunit::assert_false(CPUNIT_STR("At line " << __LINE__  << " of " << __FILE__ << ": " << m << " Stmt: '" << #x << '\''), x)
+#define CPUNIT_DISPROVE1(m,x) ((x) ? cpunit::assert_false(CPUNIT_STR("At line " << __LINE__  << " of " << __FILE__ << ": " << m << " Stmt: '" << #x << '\''), true) : (void)0)
+
+// The capture in CPUNIT_CHECK reads 'ExpressionDecomposer() <= a == b', which is meant.
+#ifdef __GNUC__
+#define CPUNIT_IMPL_IGNORE_PARENTHESES_WARNING _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wparentheses\"")
+#define CPUNIT_IMPL_RESTORE_WARNINGS _Pragma("GCC diagnostic pop")
+#else
+#define CPUNIT_IMPL_IGNORE_PARENTHESES_WARNING
+#define CPUNIT_IMPL_RESTORE_WARNINGS
+#endif
+
+/**
+ * Checks a statement, and shows the values of its operands if it fails.
+ * A single comparison is taken apart, so that
+ * <pre>
+ *   CPUNIT_CHECK(v.size() == 3);
+ * </pre>
+ * fails with the message "CHECK FAILED - At line ... Stmt: 'v.size() == 3' With: &lt;2&gt; == &lt;3&gt;".
+ * The operands are captured by reference, and only written to the message if the check 
+ * fails. Operands that cannot be written to a std::ostream are shown as {?}.
+ * Statements combining comparisons with && or || must be put in parentheses.
+ * @param x The statement to verify.
+ */
+#define CPUNIT_CHECK(x)							\
+  do {									\
+    CPUNIT_IMPL_IGNORE_PARENTHESES_WARNING				\
+    cpunit::impl::check(cpunit::impl::ExpressionDecomposer() <= x, __FILE__, __LINE__, #x); \
+    CPUNIT_IMPL_RESTORE_WARNINGS					\
+  } while (false)
+
+/**
+ * Like CPUNIT_CHECK, but lets the test go on if the statement is false.
+ * The failure is recorded, and the test fails when it returns, with the
+ * messages of all its failed expectations:
+ * <pre>
+ *   for (std::size_t i=0; i<records.size(); ++i) {
+ *     CPUNIT_EXPECT(records[i].checksum() == records[i].stored_checksum);
+ *   }
+ * </pre>
+ * Only the first 100 messages are kept, see --max-expect-messages.
+ * @param x The statement to verify.
+ * @see ExpectationScope
+ */
+#define CPUNIT_EXPECT(x)						\
+  do {									\
+    CPUNIT_IMPL_IGNORE_PARENTHESES_WARNING				\
+    cpunit::impl::expect(cpunit::impl::ExpressionDecomposer() <= x, __FILE__, __LINE__, #x); \
+    CPUNIT_IMPL_RESTORE_WARNINGS					\
+  } while (false)
+
+/**
+ * Fails the test if it has made more than n heap allocations through operator new
+ * since the test function started. The allocations are counted before the message 
+ * is formatted, and allocations made by other threads are not counted.
+ * @param n The highest number of allocations allowed.
+ */
+#define CPUNIT_ASSERT_MAX_ALLOCS(n) cpunit::assert_max_allocations(cpunit::AllocationTracker::since_mark().get_allocations(), n, __FILE__, __LINE__)
 
 #endif // CPUNIT_HPP
 
@@ -0,0 +1,264 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#include "cpunit_AssertionException.hpp"
+#include "cpunit_impl_AllocationCounters.hpp"
+
+#include <cstdlib>
+#include <execinfo.h>
+#include <new>
+#include <sstream>
+
+/*
+  The replacement operator new and delete that feed AllocationTracker.
+  Compiled into lib/libCPUnitAllocationHooks.a rather than libCPUnit.a, 
+  so that only test programs linked with -lCPUnitAllocationHooks have 
+  their operators replaced.
+ */
+
+#if __cplusplus >= 201103L
+# define CPUNIT_THROW_BAD_ALLOC
+# define CPUNIT_NO_THROW noexcept
+#else
+# define CPUNIT_THROW_BAD_ALLOC throw(std::bad_alloc)
+# define CPUNIT_NO_THROW throw()
+#endif
+
+namespace {
+
+  using cpunit::impl::AllocationCounters;
+  using cpunit::impl::allocation_counters;
+  using cpunit::impl::live_blocks;
+
+  // Room for the frames of the allocation functions, which are left out of the call stacks.
+  const int EXTRA_FRAMES = 5;
+
+  // A return address at most this far after the start of an allocation function lies within it.
+  const std::size_t MAX_FUNCTION_SIZE = 512;
+
+  const int NUM_ENTRY_POINTS = 8;
+
+  // The start addresses of the allocation functions, set when leak detection is enabled.
+  std::size_t entry_points[NUM_ENTRY_POINTS];
+
+  /**
+     The size of a block, and the leak check it was recorded for, or 0.
+   */
+  struct BlockInfo {
+    std::size_t size;
+    unsigned long serial;
+  };
+
+  /**
+     Precedes every block. Sized to keep the block aligned as malloc would.
+   */
+  union Header {
+    BlockInfo info;
+    long double ld;
+    void *p;
+  };
+
+  bool is_allocation_function(const void *frame) {
+    const std::size_t address = reinterpret_cast<std::size_t>(frame);
+    for (int i=0; i<NUM_ENTRY_POINTS; ++i) {
+      if (address > entry_points[i] && address - entry_points[i] < MAX_FUNCTION_SIZE) {
+	return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+     Records a block allocated within a leak check, with its call stack
+     starting at the caller of operator new.
+   */
+  void record(Header *h, AllocationCounters &c) {
+    void *frames[cpunit::LeakReport::MAX_FRAMES + EXTRA_FRAMES];
+    const int depth = backtrace(frames, cpunit::LeakReport::MAX_FRAMES + EXTRA_FRAMES);
+    int first = 0;
+    while (first < depth && is_allocation_function(frames[first])) {
+      ++first;
+    }
+    cpunit::LeakReport::Block b;
+    b.size = h->info.size;
+    b.depth = 0;
+    for (int i=first; i<depth && b.depth < cpunit::LeakReport::MAX_FRAMES; ++i) {
+      b.frames[b.depth++] = frames[i];
+    }
+    if (live_blocks->insert(h + 1, c.leak_serial, b)) {
+      h->info.serial = c.leak_serial;
+      ++c.recorded;
+    }
+  }
+
+  void fail_allocation(const std::size_t n) {
+    // Allow the allocations of the exception itself.
+    allocation_counters.forbidden = false;
+    std::ostringstream oss;
+    oss<<"ALLOCATION FAILURE - Allocated "<<n<<" bytes in a NoAllocationScope";
+    throw cpunit::AssertionException(oss.str());
+  }
+
+  void* allocate(const std::size_t n) {
+    AllocationCounters &c = allocation_counters;
+    if (c.forbidden) {
+      fail_allocation(n);
+    }
+    Header *h = static_cast<Header*>(std::malloc(sizeof(Header) + n));
+    if (h == NULL) {
+      return NULL;
+    }
+    h->info.size = n;
+    h->info.serial = 0;
+    if (c.recording) {
+      record(h, c);
+    }
+    ++c.allocations;
+    c.bytes += n;
+    c.live += static_cast<long>(n);
+    if (c.live > c.peak) {
+      c.peak = c.live;
+    }
+    return h + 1;
+  }
+
+  void deallocate(void *p) {
+    if (p == NULL) {
+      return;
+    }
+    Header *h = static_cast<Header*>(p) - 1;
+    AllocationCounters &c = allocation_counters;
+    ++c.deallocations;
+    c.live -= static_cast<long>(h->info.size);
+    if (h->info.serial != 0) {
+      live_blocks->erase(p);
+      if (h->info.serial == c.leak_serial) {
+	--c.recorded;
+      }
+    }
+    std::free(h);
+  }
+
+  void* allocate_or_throw(const std::size_t n) {
+    for (;;) {
+      void *p = allocate(n);
+      if (p != NULL) {
+	return p;
+      }
+      const std::new_handler handler = std::set_new_handler(0);
+      std::set_new_handler(handler);
+      if (handler == 0) {
+	throw std::bad_alloc();
+      }
+      handler();
+    }
+  }
+
+  /**
+     Refuses the allocation while allocations are forbidden, since an 
+     exception must not leave the nothrow operators. The test runner 
+     fails the test after it returns.
+   */
+  void* allocate_or_null(const std::size_t n) {
+    AllocationCounters &c = allocation_counters;
+    if (c.forbidden) {
+      ++c.refused;
+      return NULL;
+    }
+    try {
+      return allocate_or_throw(n);
+    } catch (std::bad_alloc &) {
+      return NULL;
+    }
+  }
+}
+
+void* operator new(std::size_t n) CPUNIT_THROW_BAD_ALLOC {
+  return allocate_or_throw(n);
+}
+
+void* operator new[](std::size_t n) CPUNIT_THROW_BAD_ALLOC {
+  return allocate_or_throw(n);
+}
+
+void* operator new(std::size_t n, const std::nothrow_t&) CPUNIT_NO_THROW {
+  return allocate_or_null(n);
+}
+
+void* operator new[](std::size_t n, const std::nothrow_t&) CPUNIT_NO_THROW {
+  return allocate_or_null(n);
+}
+
+void operator delete(void *p) CPUNIT_NO_THROW {
+  deallocate(p);
+}
+
+void operator delete[](void *p) CPUNIT_NO_THROW {
+  deallocate(p);
+}
+
+void operator delete(void *p, const std::nothrow_t&) CPUNIT_NO_THROW {
+  deallocate(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t&) CPUNIT_NO_THROW {
+  deallocate(p);
+}
+
+#if __cplusplus >= 201402L
+void operator delete(void *p, std::size_t) noexcept {
+  deallocate(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+  deallocate(p);
+}
+#endif
+
+/**
+   Notes the start addresses of the allocation functions, and loads libgcc
+   by a first call to backtrace, which is better done up front.
+ */
+void
+cpunit::impl::prepare_leak_recording() {
+  void *dummy[1];
+  backtrace(dummy, 1);
+  typedef void* (*New)(std::size_t);
+  typedef void* (*NoThrowNew)(std::size_t, const std::nothrow_t&);
+  entry_points[0] = reinterpret_cast<std::size_t>(&record);
+  entry_points[1] = reinterpret_cast<std::size_t>(&allocate);
+  entry_points[2] = reinterpret_cast<std::size_t>(&allocate_or_throw);
+  entry_points[3] = reinterpret_cast<std::size_t>(&allocate_or_null);
+  entry_points[4] = reinterpret_cast<std::size_t>(static_cast<New>(&::operator new));
+  entry_points[5] = reinterpret_cast<std::size_t>(static_cast<New>(&::operator new[]));
+  entry_points[6] = reinterpret_cast<std::size_t>(static_cast<NoThrowNew>(&::operator new));
+  entry_points[7] = reinterpret_cast<std::size_t>(static_cast<NoThrowNew>(&::operator new[]));
+}
@@ -0,0 +1,50 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_AllocationRunner.hpp"
+#include "cpunit_AllocationTracker.hpp"
+#include "cpunit_trace.hpp"
+
+cpunit::AllocationRunner::AllocationRunner() :
+  TestRunnerDecorator() {
+    CPUNIT_ITRACE("AllocationRunner - instantiated.");
+}
+
+cpunit::AllocationRunner::~AllocationRunner() {
+  CPUNIT_ITRACE("AllocationRunner - destroyed.");
+}
+
+cpunit::ExecutionReport
+cpunit::AllocationRunner::run(Callable& tu) const  {
+  AllocationTracker::mark();
+  ExecutionReport result = inner_run(tu);
+  result.set_allocation_stats(AllocationTracker::since_mark());
+  return result;
+}
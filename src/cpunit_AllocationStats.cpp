@@ -0,0 +1,113 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_AllocationStats.hpp"
+
+#include <algorithm>
+
+cpunit::AllocationStats::AllocationStats() :
+  allocations(0),
+  deallocations(0),
+  bytes(0),
+  peak_bytes(0)
+{}
+
+cpunit::AllocationStats::AllocationStats(const std::size_t a, const std::size_t d, const std::size_t b, const std::size_t p) :
+  allocations(a),
+  deallocations(d),
+  bytes(b),
+  peak_bytes(p)
+{}
+
+cpunit::AllocationStats::AllocationStats(const AllocationStats &o) :
+  allocations(o.allocations),
+  deallocations(o.deallocations),
+  bytes(o.bytes),
+  peak_bytes(o.peak_bytes)
+{}
+
+cpunit::AllocationStats::~AllocationStats()
+{}
+
+cpunit::AllocationStats&
+cpunit::AllocationStats::operator = (const AllocationStats &o) {
+  if (&o != this) {
+    allocations = o.allocations;
+    deallocations = o.deallocations;
+    bytes = o.bytes;
+    peak_bytes = o.peak_bytes;
+  }
+  return *this;
+}
+
+/**
+   @return The number of calls to operator new.
+ */
+std::size_t
+cpunit::AllocationStats::get_allocations() const {
+  return allocations;
+}
+
+/**
+   @return The number of calls to operator delete, not counting null pointers.
+ */
+std::size_t
+cpunit::AllocationStats::get_deallocations() const {
+  return deallocations;
+}
+
+/**
+   @return The total number of bytes requested from operator new.
+ */
+std::size_t
+cpunit::AllocationStats::get_bytes() const {
+  return bytes;
+}
+
+/**
+   @return The highest number of bytes allocated and not yet deallocated,
+           counting from the start of the measurement.
+ */
+std::size_t
+cpunit::AllocationStats::get_peak_bytes() const {
+  return peak_bytes;
+}
+
+/**
+   Adds the counts of o. The peak of the sum is the highest of the two peaks.
+ */
+cpunit::AllocationStats&
+cpunit::AllocationStats::operator += (const AllocationStats &o) {
+  allocations += o.allocations;
+  deallocations += o.deallocations;
+  bytes += o.bytes;
+  peak_bytes = std::max(peak_bytes, o.peak_bytes);
+  return *this;
+}
@@ -0,0 +1,227 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_AllocationTracker.hpp"
+#include "cpunit_AssertionException.hpp"
+#include "cpunit_impl_AllocationCounters.hpp"
+
+#include <sstream>
+
+namespace cpunit {
+  namespace impl {
+    // Weak, so that the address is NULL unless the hooks library is linked.
+    void prepare_leak_recording() __attribute__((weak));
+
+    __thread AllocationCounters allocation_counters;
+
+    LiveBlockTable *live_blocks = NULL;
+  }
+}
+
+namespace {
+
+  using cpunit::impl::AllocationCounters;
+  using cpunit::impl::allocation_counters;
+  using cpunit::impl::live_blocks;
+
+  bool leak_detection = false;
+}
+
+/**
+   @return true if the test program is linked with the CPUnitAllocationHooks
+           library, which replaces operator new and delete. Otherwise, all
+           counts are zero and allocations are never forbidden.
+ */
+bool
+cpunit::AllocationTracker::is_enabled() {
+  return &impl::prepare_leak_recording != NULL;
+}
+
+/**
+   Starts a new measurement on the calling thread.
+ */
+void
+cpunit::AllocationTracker::mark() {
+  AllocationCounters &c = allocation_counters;
+  c.mark_allocations = c.allocations;
+  c.mark_deallocations = c.deallocations;
+  c.mark_bytes = c.bytes;
+  c.mark_live = c.live;
+  c.peak = c.live;
+}
+
+/**
+   @return The allocations of the calling thread since the last call to mark().
+ */
+cpunit::AllocationStats
+cpunit::AllocationTracker::since_mark() {
+  const AllocationCounters &c = allocation_counters;
+  return AllocationStats(c.allocations - c.mark_allocations,
+			 c.deallocations - c.mark_deallocations,
+			 c.bytes - c.mark_bytes,
+			 static_cast<std::size_t>(c.peak - c.mark_live));
+}
+
+/**
+   Makes allocations on the calling thread fail, or not.
+   @param forbid true to throw an AssertionException from operator new,
+                 or return NULL from the nothrow operator new.
+   @return Whether allocations were forbidden before the call.
+ */
+bool
+cpunit::AllocationTracker::forbid_allocations(const bool forbid) {
+  const bool previous = allocation_counters.forbidden;
+  allocation_counters.forbidden = forbid;
+  return previous;
+}
+
+/**
+   Counts the allocations the nothrow operator new refused, and returned 
+   NULL for, since allocations were forbidden, and starts a new count.
+   @return The allocations refused on the calling thread since the last call.
+ */
+std::size_t
+cpunit::AllocationTracker::take_refused_allocations() {
+  const std::size_t refused = allocation_counters.refused;
+  allocation_counters.refused = 0;
+  return refused;
+}
+
+/**
+   Turns leak detection, which records the blocks allocated within leak 
+   checks, on or off. Call before any tests are run.
+   @param enabled true to detect leaks.
+   @return false if leak detection was requested, but the test program is
+           not linked with the CPUnitAllocationHooks library.
+ */
+bool
+cpunit::AllocationTracker::set_leak_detection(const bool enabled) {
+  if (enabled && !is_enabled()) {
+    return false;
+  }
+  if (enabled && live_blocks == NULL) {
+    impl::prepare_leak_recording();
+    live_blocks = new impl::LiveBlockTable;
+  }
+  leak_detection = enabled;
+  return true;
+}
+
+bool
+cpunit::AllocationTracker::is_leak_detection_enabled() {
+  return leak_detection;
+}
+
+/**
+   Starts a leak check on the calling thread, if leak detection is enabled.
+   Blocks are recorded while recording is turned on by record_leaks(true).
+ */
+void
+cpunit::AllocationTracker::start_leak_check() {
+  if (leak_detection) {
+    AllocationCounters &c = allocation_counters;
+    c.leak_serial = live_blocks->next_serial();
+    c.recording = false;
+    c.recorded = 0;
+  }
+}
+
+/**
+   Ends the leak check of the calling thread.
+   @return The blocks recorded by the check and not yet deallocated.
+ */
+cpunit::LeakReport
+cpunit::AllocationTracker::end_leak_check() {
+  LeakReport result;
+  AllocationCounters &c = allocation_counters;
+  const unsigned long serial = c.leak_serial;
+  const bool scan = c.recorded > 0;
+  c.leak_serial = 0;
+  c.recording = false;
+  c.recorded = 0;
+  // Blocks deallocated on this thread are already counted out. Only those 
+  // deallocated by other threads make the scan come back empty.
+  if (serial != 0 && scan) {
+    result = live_blocks->remove_all(serial);
+  }
+  return result;
+}
+
+/**
+   Turns the recording of the leak check of the calling thread on or off.
+   Recording is never on outside a leak check.
+   @return Whether recording was on before the call.
+ */
+bool
+cpunit::AllocationTracker::record_leaks(const bool record) {
+  AllocationCounters &c = allocation_counters;
+  const bool previous = c.recording;
+  c.recording = record && c.leak_serial != 0;
+  return previous;
+}
+
+/**
+   @param record false to keep blocks from being recorded, e.g. the entries
+                 of a cache that lives on after the test.
+ */
+cpunit::LeakRecordingScope::LeakRecordingScope(const bool record) :
+  previous(AllocationTracker::record_leaks(record))
+{}
+
+cpunit::LeakRecordingScope::~LeakRecordingScope() {
+  AllocationTracker::record_leaks(previous);
+}
+
+cpunit::NoAllocationScope::NoAllocationScope() :
+  previous(AllocationTracker::forbid_allocations(true))
+{}
+
+cpunit::NoAllocationScope::~NoAllocationScope() {
+  AllocationTracker::forbid_allocations(previous);
+}
+
+/**
+   Fails unless the number of allocations is within a budget.
+   Called from CPUNIT_ASSERT_MAX_ALLOCS, which counts the allocations
+   before the message is formatted.
+   @param allocations The allocations made.
+   @param max         The highest number of allocations allowed.
+   @param file        The file of the assertion.
+   @param line        The line of the assertion.
+ */
+void
+cpunit::assert_max_allocations(const std::size_t allocations, const std::size_t max, const char *file, const int line) {
+  if (allocations > max) {
+    std::ostringstream oss;
+    oss<<"ALLOCATION BUDGET EXCEEDED - At line "<<line<<" of "<<file<<": ";
+    oss<<allocations<<" allocations since the start of the test, exceeding the budget of "<<max;
+    throw AssertionException(oss.str());
+  }
+}
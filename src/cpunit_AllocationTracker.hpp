@@ -0,0 +1,125 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_ALLOCATIONTRACKER_HPP
+#define CPUNIT_ALLOCATIONTRACKER_HPP
+
+#include "cpunit_AllocationStats.hpp"
+#include "cpunit_LeakReport.hpp"
+
+#include <cstddef>
+
+namespace cpunit {
+
+  /**
+     Counts the heap allocations of each thread. Linking the test program 
+     with -lCPUnitAllocationHooks, ahead of -lCPUnit, replaces the global
+     operator new and operator delete, and every call updates thread local
+     counters, which costs a few instructions. Memory allocated directly with
+     malloc is not counted.
+
+     The test runner chain calls mark() before each test, so that since_mark()
+     gives the allocations of the test so far. Allocations made by other 
+     threads than the one running the test are not included.
+
+     With leak detection enabled, the test runner chain starts a leak check 
+     before the set-up of each test, records the blocks allocated by the
+     set-up, test and tear-down, with their call stacks, and ends the check
+     after the tear-down. Blocks allocated by threads the test starts are
+     not recorded.
+
+     Without the CPUnitAllocationHooks library, e.g. for code under test or
+     a memory checker that replaces operator new and delete itself, all 
+     counts are zero and leak detection is not available.
+   */
+  class AllocationTracker {
+  public:
+    static bool is_enabled();
+    static void mark();
+    static AllocationStats since_mark();
+    static bool forbid_allocations(const bool forbid);
+    static std::size_t take_refused_allocations();
+
+    static bool set_leak_detection(const bool enabled);
+    static bool is_leak_detection_enabled();
+    static void start_leak_check();
+    static LeakReport end_leak_check();
+    static bool record_leaks(const bool record);
+
+  private:
+    AllocationTracker();
+  };
+
+  /**
+     Fails the test with an AssertionException at the first allocation made 
+     by operator new on the calling thread while the scope object is alive.
+     The nothrow operator new returns NULL instead, and the test fails when
+     it returns.
+     Declare one at the start of a block that must not allocate:
+     <pre>
+       {
+         cpunit::NoAllocationScope no_allocations;
+         queue.push(item);
+       }
+     </pre>
+   */
+  class NoAllocationScope {
+    const bool previous;
+
+    // No copy.
+    NoAllocationScope(const NoAllocationScope&);
+    NoAllocationScope& operator = (const NoAllocationScope&);
+  public:
+    NoAllocationScope();
+    ~NoAllocationScope();
+  };
+
+  /**
+     Records the blocks allocated while the scope object is alive, if a
+     leak check is running on the calling thread, or keeps them from being
+     recorded. Recording is on around the set-up, test and tear-down only,
+     so that the reports and exceptions of CPUnit itself are not taken for
+     leaks.
+   */
+  class LeakRecordingScope {
+    const bool previous;
+
+    // No copy.
+    LeakRecordingScope(const LeakRecordingScope&);
+    LeakRecordingScope& operator = (const LeakRecordingScope&);
+  public:
+    explicit LeakRecordingScope(const bool record);
+    ~LeakRecordingScope();
+  };
+
+  void assert_max_allocations(const std::size_t allocations, const std::size_t max, const char *file, const int line);
+}
+
+#endif // CPUNIT_ALLOCATIONTRACKER_HPP
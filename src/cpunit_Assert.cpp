@@ -30,8 +30,100 @@
 
 
 #include "cpunit_Assert.hpp"
+#include "cpunit_impl_ArrayCompare.hpp"
+#include "cpunit_impl_FloatCompare.hpp"
+#include <cmath>
+#include <cstring>
+#include <limits>
 #include <sstream>
 
+namespace {
+
+  /**
+     Compares two arrays with the widest instruction set available, and
+     only describes the differences if there are any.
+   */
+  template<class T>
+  void check_arrays(const char *kind, const std::string &msg, const T *expected, const T *actual, const std::size_t n, const T abs_tol, const T rel_tol) {
+    const cpunit::impl::ArrayMismatches m = cpunit::impl::find_mismatches(expected, actual, n, abs_tol, rel_tol, cpunit::impl::best_simd_level());
+    if (m.count > 0) {
+      std::ostringstream oss;
+      oss<<"ASSERT "<<kind<<" FAILED - "<<msg<<' ';
+      if (abs_tol != 0 || rel_tol != 0) {
+	oss<<"With abs tolerance "<<abs_tol<<" and rel tolerance "<<rel_tol<<", ";
+      }
+      oss<<cpunit::impl::describe_mismatches(expected, actual, n, abs_tol, rel_tol, m);
+      throw cpunit::AssertionException(oss.str());
+    }
+  }
+
+  /**
+     Compares two arrays ulp by ulp with the widest instruction set available.
+   */
+  template<class T>
+  void check_ulp_arrays(const std::string &msg, const T *expected, const T *actual, const std::size_t n, const unsigned int max_ulps) {
+    const cpunit::impl::ArrayMismatches m = cpunit::impl::find_ulp_mismatches(expected, actual, n, max_ulps, cpunit::impl::best_simd_level());
+    if (m.count > 0) {
+      std::ostringstream oss;
+      oss<<"ASSERT ALL WITHIN ULPS FAILED - "<<msg<<" With at most "<<max_ulps<<" ulps allowed, ";
+      oss<<cpunit::impl::describe_ulp_mismatches(expected, actual, n, max_ulps, m);
+      throw cpunit::AssertionException(oss.str());
+    }
+  }
+
+  // The digits needed to tell apart any two values of T.
+  template<class T>
+  int max_digits10() {
+    return 2 + std::numeric_limits<T>::digits * 3010 / 10000;
+  }
+
+  /**
+     @throw AssertionException explaining why expected and actual are not within max_ulps.
+   */
+  template<class T>
+  void fail_ulps(const std::string &msg, const T expected, const T actual, const unsigned int max_ulps) {
+    std::ostringstream oss;
+    oss.precision(max_digits10<T>());
+    oss<<"ASSERT EQUALS ULPS FAILED - "<<msg<<" Expected <"<<expected<<">, was <"<<actual<<">, ";
+    if (expected != expected || actual != actual) {
+      oss<<"and NaN is not equal to anything.";
+    } else if (std::fabs(expected) == std::numeric_limits<T>::infinity() || std::fabs(actual) == std::numeric_limits<T>::infinity()) {
+      oss<<"and infinity is only equal to itself.";
+    } else {
+      oss<<cpunit::impl::ulp_distance(expected, actual)<<" ulps apart, with at most "<<max_ulps<<" allowed.";
+    }
+    throw cpunit::AssertionException(oss.str());
+  }
+
+  /**
+     @throw AssertionException giving the errors of expected and actual, which are not close.
+   */
+  template<class T>
+  void fail_close(const std::string &msg, const T expected, const T actual, const T abs_tol, const T rel_tol) {
+    const T abs_err = std::fabs(actual - expected);
+    std::ostringstream oss;
+    oss<<"ASSERT CLOSE FAILED - "<<msg<<" With abs tolerance "<<abs_tol<<" and rel tolerance "<<rel_tol;
+    oss<<", abs error "<<abs_err<<", rel error "<<abs_err / std::fabs(expected)<<'.';
+    oss.precision(max_digits10<T>());
+    oss<<" Expected <"<<expected<<">, was <"<<actual<<">.";
+    throw cpunit::AssertionException(oss.str());
+  }
+}
+
+/**
+   Throws an AssertionException for arrays of different lengths.
+   @param kind     The kind of assert, e.g. "ALL CLOSE".
+   @param msg      The text message of the assert.
+   @param expected The length of the expected array.
+   @param actual   The length of the actual array.
+   @throws AssertionException allways.
+*/
+void cpunit::priv::fail_sizes(const char *kind, const std::string &msg, const std::size_t expected, const std::size_t actual) {
+  std::ostringstream oss;
+  oss<<"ASSERT "<<kind<<" FAILED - "<<msg<<" Expected "<<expected<<" elements, was "<<actual<<'.';
+  throw AssertionException(oss.str());
+}
+
 /**
    Causes an AssertionException to be thrown.
    @param msg The error message to display.
@@ -65,6 +157,19 @@ void cpunit::assert_true(const std::string &msg, const bool statement) {
   }
 }
 
+/**
+   Checks that a statement is <tt>true</tt>. The message is only
+   copied into a std::string if the assert fails.
+   @param msg       A text to be displayed together with the error message if the assertion fails.
+   @param statement The statement to check for truthfulness.
+   @throw AssertionException if the assert fails.
+*/
+void cpunit::assert_true(const char *msg, const bool statement) {
+  if (!statement) {
+    assert_true(std::string(msg), false);
+  }
+}
+
 /**
    Checks that a statement is <tt>true</tt>.
    @param statement The statement to check for truthfulness.
@@ -88,6 +193,19 @@ void cpunit::assert_false(const std::string &msg, const bool statement) {
   }
 }
 
+/**
+   Checks that a statement is <tt>false</tt>. The message is only
+   copied into a std::string if the assert fails.
+   @param msg       A text to be displayed together with the error message if the assertion fails.
+   @param statement The statement to check for falseness.
+   @throw AssertionException if the assert fails.
+*/
+void cpunit::assert_false(const char *msg, const bool statement) {
+  if (statement) {
+    assert_false(std::string(msg), true);
+  }
+}
+
 /**
    Checks that a statement is <tt>false</tt>.
    @param statement The statement to check for falseness.
@@ -121,7 +239,9 @@ void cpunit::assert_equals(const std::string &msg, const float expected, const f
    @throw AssertionException if the assert fails.
 */
 void cpunit::assert_equals(const float expected, const float actual, const float error) {
-  assert_equals("", expected, actual, error);
+  if (priv::abs(expected - actual) > error) {
+    priv::fail_equals("", expected, actual);
+  }
 }
 
 /**
@@ -150,28 +270,35 @@ void cpunit::assert_equals(const std::string &msg, const double expected, const
    @throw AssertionException if the assert fails.
 */
 void cpunit::assert_equals(const double expected, const double actual, const double error) {
-  assert_equals("", expected, actual, error);
+  if (priv::abs(expected - actual) > error) {
+    priv::fail_equals("", expected, actual);
+  }
 }
 
 /**
-   Check that two C-strings are equal, using the == operator of std::string.
+   Check that two C-strings are equal, comparing their characters.
+   The strings are only copied into std::strings if the comparison fails.
    @param msg      A text to be displayed together with the error message if the comparison fails.
    @param expected The expected value.
    @param actual   The actual value to test against the facit 'expected'.
    @throw AssertionException if the assert fails.
 */
 void cpunit::assert_equals(const std::string &msg, const char *expected, const  char *actual) {
-  assert_equals(msg, std::string(expected), std::string(actual));
+  if (std::strcmp(expected, actual) != 0) {
+    priv::fail_equals(msg, std::string(expected), std::string(actual));
+  }
 }
 
 /**
-   Check that two C-strings are equal, using the == operator of std::string.
+   Check that two C-strings are equal, comparing their characters.
    @param expected The expected value.
    @param actual   The actual value to test against the facit 'expected'.
    @throw AssertionException if the assert fails.
 */
 void cpunit::assert_equals(const char *expected, const char *actual) {
-  assert_equals("", expected, actual);
+  if (std::strcmp(expected, actual) != 0) {
+    priv::fail_equals("", std::string(expected), std::string(actual));
+  }
 }
   
 /**
@@ -213,6 +340,19 @@ void cpunit::assert_not_null(const std::string &msg, const void *data) {
   }
 }
 
+/**
+   Checks that a pointer is not <tt>NULL</tt>. The message is only
+   copied into a std::string if the assert fails.
+   @param msg  A text to be displayed together with the error message if the test fails.
+   @param data The pointer to test.
+   @throw AssertionException if the assert fails.
+*/
+void cpunit::assert_not_null(const char *msg, const void *data) {
+  if (data == NULL) {
+    assert_not_null(std::string(msg), data);
+  }
+}
+
 /**
    Checks that a pointer is not <tt>NULL</tt>.
    @param data The pointer to test.
@@ -236,6 +376,19 @@ void cpunit::assert_null(const std::string &msg, const void *data) {
   }
 }
 
+/**
+   Checks that a pointer is <tt>NULL</tt>. The message is only
+   copied into a std::string if the assert fails.
+   @param msg  A text to be displayed together with the error message if the test fails.
+   @param data The pointer to test.
+   @throw AssertionException if the assert fails.
+*/
+void cpunit::assert_null(const char *msg, const void *data) {
+  if (data != NULL) {
+    assert_null(std::string(msg), data);
+  }
+}
+
 /**
    Checks that a pointer is <tt>NULL</tt>.
    @param data The pointer to test.
@@ -244,3 +397,337 @@ void cpunit::assert_null(const std::string &msg, const void *data) {
 void cpunit::assert_null(const void *data) {
   assert_null("", data);
 }
+
+/**
+   Check that two arrays of floating point numbers are equal, element by element.
+   Equal infinities are equal, and NaN is not equal to anything. The arrays are 
+   compared with SSE2 or AVX2 instructions if the processor has them.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param n        The number of elements of each array.
+   @throw AssertionException if any elements differ. The message gives the number of differing
+                             elements, the largest absolute and relative difference, and lists 
+                             the first differing elements.
+*/
+void cpunit::assert_array_equals(const std::string &msg, const float *expected, const float *actual, const std::size_t n) {
+  check_arrays("ARRAY EQUALS", msg, expected, actual, n, 0.0f, 0.0f);
+}
+
+/**
+   Check that two arrays of floating point numbers are equal, element by element.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param n        The number of elements of each array.
+   @throw AssertionException if any elements differ.
+*/
+void cpunit::assert_array_equals(const float *expected, const float *actual, const std::size_t n) {
+  check_arrays("ARRAY EQUALS", "", expected, actual, n, 0.0f, 0.0f);
+}
+
+/**
+   Check that two arrays of double precision floating point numbers are equal, element by element.
+   Equal infinities are equal, and NaN is not equal to anything. The arrays are 
+   compared with SSE2 or AVX2 instructions if the processor has them.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param n        The number of elements of each array.
+   @throw AssertionException if any elements differ.
+*/
+void cpunit::assert_array_equals(const std::string &msg, const double *expected, const double *actual, const std::size_t n) {
+  check_arrays("ARRAY EQUALS", msg, expected, actual, n, 0.0, 0.0);
+}
+
+/**
+   Check that two arrays of double precision floating point numbers are equal, element by element.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param n        The number of elements of each array.
+   @throw AssertionException if any elements differ.
+*/
+void cpunit::assert_array_equals(const double *expected, const double *actual, const std::size_t n) {
+  check_arrays("ARRAY EQUALS", "", expected, actual, n, 0.0, 0.0);
+}
+
+/**
+   Check that two arrays of floating point numbers are close, element by element.
+   The elements e and a are considered close if they are equal, or if e is finite
+   and abs(a - e) <= abs_tol + rel_tol * abs(e). NaN is not close to anything.
+   The arrays are compared with SSE2 or AVX2 instructions if the processor has them,
+   so this is a lot faster than calling assert_equals for each element.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param n        The number of elements of each array.
+   @param abs_tol  The absolute tolerance.
+   @param rel_tol  The tolerance relative to the expected value.
+   @throw AssertionException if any elements are not close. The message gives the number
+                             of such elements, the largest absolute and relative difference, 
+                             and lists the first of them.
+*/
+void cpunit::assert_all_close(const std::string &msg, const float *expected, const float *actual, const std::size_t n, const float abs_tol, const float rel_tol) {
+  check_arrays("ALL CLOSE", msg, expected, actual, n, abs_tol, rel_tol);
+}
+
+/**
+   Check that two arrays of floating point numbers are close, element by element.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param n        The number of elements of each array.
+   @param abs_tol  The absolute tolerance.
+   @param rel_tol  The tolerance relative to the expected value.
+   @throw AssertionException if any elements are not close.
+*/
+void cpunit::assert_all_close(const float *expected, const float *actual, const std::size_t n, const float abs_tol, const float rel_tol) {
+  check_arrays("ALL CLOSE", "", expected, actual, n, abs_tol, rel_tol);
+}
+
+/**
+   Check that two arrays of double precision floating point numbers are close, element by element.
+   The elements e and a are considered close if they are equal, or if e is finite
+   and abs(a - e) <= abs_tol + rel_tol * abs(e). NaN is not close to anything.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param n        The number of elements of each array.
+   @param abs_tol  The absolute tolerance.
+   @param rel_tol  The tolerance relative to the expected value.
+   @throw AssertionException if any elements are not close.
+*/
+void cpunit::assert_all_close(const std::string &msg, const double *expected, const double *actual, const std::size_t n, const double abs_tol, const double rel_tol) {
+  check_arrays("ALL CLOSE", msg, expected, actual, n, abs_tol, rel_tol);
+}
+
+/**
+   Check that two arrays of double precision floating point numbers are close, element by element.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param n        The number of elements of each array.
+   @param abs_tol  The absolute tolerance.
+   @param rel_tol  The tolerance relative to the expected value.
+   @throw AssertionException if any elements are not close.
+*/
+void cpunit::assert_all_close(const double *expected, const double *actual, const std::size_t n, const double abs_tol, const double rel_tol) {
+  check_arrays("ALL CLOSE", "", expected, actual, n, abs_tol, rel_tol);
+}
+
+/**
+   Check that two floating point numbers are at most max_ulps representable values 
+   apart. Unlike assert_equals with an absolute error, this suits values of any 
+   magnitude. +0 and -0 are equal, infinity is only equal to itself, and NaN is
+   not equal to anything.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected value.
+   @param actual   The actual value to test against the facit 'expected'.
+   @param max_ulps The largest distance accepted, in units in the last place. 
+                   0 accepts only equal values.
+   @throw AssertionException if the assert fails.
+*/
+void cpunit::assert_equals_ulps(const std::string &msg, const float expected, const float actual, const unsigned int max_ulps) {
+  if (!impl::within_ulps(expected, actual, max_ulps)) {
+    fail_ulps(msg, expected, actual, max_ulps);
+  }
+}
+
+/**
+   Check that two floating point numbers are at most max_ulps representable values apart.
+   @param expected The expected value.
+   @param actual   The actual value to test against the facit 'expected'.
+   @param max_ulps The largest distance accepted, in units in the last place.
+   @throw AssertionException if the assert fails.
+*/
+void cpunit::assert_equals_ulps(const float expected, const float actual, const unsigned int max_ulps) {
+  if (!impl::within_ulps(expected, actual, max_ulps)) {
+    fail_ulps(std::string(), expected, actual, max_ulps);
+  }
+}
+
+/**
+   Check that two double precision floating point numbers are at most max_ulps 
+   representable values apart. +0 and -0 are equal, infinity is only equal to 
+   itself, and NaN is not equal to anything.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected value.
+   @param actual   The actual value to test against the facit 'expected'.
+   @param max_ulps The largest distance accepted, in units in the last place.
+   @throw AssertionException if the assert fails.
+*/
+void cpunit::assert_equals_ulps(const std::string &msg, const double expected, const double actual, const unsigned int max_ulps) {
+  if (!impl::within_ulps(expected, actual, max_ulps)) {
+    fail_ulps(msg, expected, actual, max_ulps);
+  }
+}
+
+/**
+   Check that two double precision floating point numbers are at most max_ulps 
+   representable values apart.
+   @param expected The expected value.
+   @param actual   The actual value to test against the facit 'expected'.
+   @param max_ulps The largest distance accepted, in units in the last place.
+   @throw AssertionException if the assert fails.
+*/
+void cpunit::assert_equals_ulps(const double expected, const double actual, const unsigned int max_ulps) {
+  if (!impl::within_ulps(expected, actual, max_ulps)) {
+    fail_ulps(std::string(), expected, actual, max_ulps);
+  }
+}
+
+/**
+   Check that two floating point numbers are close, combining an absolute and a
+   relative tolerance. They are close if they are equal, or if expected is finite
+   and abs(actual - expected) <= abs_tol + rel_tol * abs(expected). The absolute 
+   tolerance covers values near zero, and the relative one large values.
+   NaN is not close to anything.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected value.
+   @param actual   The actual value to test against the facit 'expected'.
+   @param abs_tol  The absolute tolerance.
+   @param rel_tol  The tolerance relative to the expected value.
+   @throw AssertionException if the assert fails.
+*/
+void cpunit::assert_close(const std::string &msg, const float expected, const float actual, const float abs_tol, const float rel_tol) {
+  if (!impl::is_close(expected, actual, abs_tol, rel_tol)) {
+    fail_close(msg, expected, actual, abs_tol, rel_tol);
+  }
+}
+
+/**
+   Check that two floating point numbers are close, combining an absolute and a
+   relative tolerance.
+   @param expected The expected value.
+   @param actual   The actual value to test against the facit 'expected'.
+   @param abs_tol  The absolute tolerance.
+   @param rel_tol  The tolerance relative to the expected value.
+   @throw AssertionException if the assert fails.
+*/
+void cpunit::assert_close(const float expected, const float actual, const float abs_tol, const float rel_tol) {
+  if (!impl::is_close(expected, actual, abs_tol, rel_tol)) {
+    fail_close(std::string(), expected, actual, abs_tol, rel_tol);
+  }
+}
+
+/**
+   Check that two double precision floating point numbers are close, combining 
+   an absolute and a relative tolerance. They are close if they are equal, or if 
+   expected is finite and abs(actual - expected) <= abs_tol + rel_tol * abs(expected).
+   NaN is not close to anything.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected value.
+   @param actual   The actual value to test against the facit 'expected'.
+   @param abs_tol  The absolute tolerance.
+   @param rel_tol  The tolerance relative to the expected value.
+   @throw AssertionException if the assert fails.
+*/
+void cpunit::assert_close(const std::string &msg, const double expected, const double actual, const double abs_tol, const double rel_tol) {
+  if (!impl::is_close(expected, actual, abs_tol, rel_tol)) {
+    fail_close(msg, expected, actual, abs_tol, rel_tol);
+  }
+}
+
+/**
+   Check that two double precision floating point numbers are close, combining 
+   an absolute and a relative tolerance.
+   @param expected The expected value.
+   @param actual   The actual value to test against the facit 'expected'.
+   @param abs_tol  The absolute tolerance.
+   @param rel_tol  The tolerance relative to the expected value.
+   @throw AssertionException if the assert fails.
+*/
+void cpunit::assert_close(const double expected, const double actual, const double abs_tol, const double rel_tol) {
+  if (!impl::is_close(expected, actual, abs_tol, rel_tol)) {
+    fail_close(std::string(), expected, actual, abs_tol, rel_tol);
+  }
+}
+
+/**
+   Check that two arrays of floating point numbers are within max_ulps of each
+   other, element by element, as assert_equals_ulps. The arrays are compared
+   with SSE2 or AVX2 instructions if the processor has them.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param n        The number of elements of each array.
+   @param max_ulps The largest distance accepted, in units in the last place.
+   @throw AssertionException if any elements are too far apart. The message gives the
+                             number of such elements, the largest absolute and relative 
+                             difference, and lists the first of them.
+*/
+void cpunit::assert_all_within_ulps(const std::string &msg, const float *expected, const float *actual, const std::size_t n, const unsigned int max_ulps) {
+  check_ulp_arrays(msg, expected, actual, n, max_ulps);
+}
+
+/**
+   Check that two arrays of floating point numbers are within max_ulps of each
+   other, element by element.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param n        The number of elements of each array.
+   @param max_ulps The largest distance accepted, in units in the last place.
+   @throw AssertionException if any elements are too far apart.
+*/
+void cpunit::assert_all_within_ulps(const float *expected, const float *actual, const std::size_t n, const unsigned int max_ulps) {
+  check_ulp_arrays(std::string(), expected, actual, n, max_ulps);
+}
+
+/**
+   Check that two arrays of double precision floating point numbers are within 
+   max_ulps of each other, element by element, as assert_equals_ulps. The arrays 
+   are compared with AVX2 instructions if the processor has them.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param n        The number of elements of each array.
+   @param max_ulps The largest distance accepted, in units in the last place.
+   @throw AssertionException if any elements are too far apart.
+*/
+void cpunit::assert_all_within_ulps(const std::string &msg, const double *expected, const double *actual, const std::size_t n, const unsigned int max_ulps) {
+  check_ulp_arrays(msg, expected, actual, n, max_ulps);
+}
+
+/**
+   Check that two arrays of double precision floating point numbers are within 
+   max_ulps of each other, element by element.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param n        The number of elements of each array.
+   @param max_ulps The largest distance accepted, in units in the last place.
+   @throw AssertionException if any elements are too far apart.
+*/
+void cpunit::assert_all_within_ulps(const double *expected, const double *actual, const std::size_t n, const unsigned int max_ulps) {
+  check_ulp_arrays(std::string(), expected, actual, n, max_ulps);
+}
+
+/**
+   Check that two buffers hold the same bytes. The buffers are compared in place
+   with memcmp, and differing parts are scanned with SSE2 or AVX2 instructions
+   if the processor has them, so this also suits buffers of several gigabytes.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected bytes.
+   @param actual   The actual bytes to test against the facit 'expected'.
+   @param n        The number of bytes of each buffer.
+   @throw AssertionException if any bytes differ. The message gives the number of 
+                             differing bytes, the offset of the first, and a hex 
+                             and ASCII dump of both buffers around it.
+*/
+void cpunit::assert_bytes_equal(const std::string &msg, const void *expected, const void *actual, const std::size_t n) {
+  const unsigned char *e = static_cast<const unsigned char*>(expected);
+  const unsigned char *a = static_cast<const unsigned char*>(actual);
+  const impl::ArrayMismatches m = impl::find_byte_mismatches(e, a, n, impl::best_simd_level());
+  if (m.count > 0) {
+    std::ostringstream oss;
+    oss<<"ASSERT BYTES EQUAL FAILED - "<<msg<<' '<<impl::describe_byte_mismatches(e, a, n, m);
+    throw AssertionException(oss.str());
+  }
+}
+
+/**
+   Check that two buffers hold the same bytes.
+   @param expected The expected bytes.
+   @param actual   The actual bytes to test against the facit 'expected'.
+   @param n        The number of bytes of each buffer.
+   @throw AssertionException if any bytes differ.
+*/
+void cpunit::assert_bytes_equal(const void *expected, const void *actual, const std::size_t n) {
+  assert_bytes_equal(std::string(), expected, actual, n);
+}
@@ -32,7 +32,19 @@
 #ifndef CPUNIT_ASSERT_HPP
 #define CPUNIT_ASSERT_HPP
 
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <map>
+#include <ostream>
+#include <set>
 #include <string>
+#include <vector>
+
+#if __cplusplus >= 201103L
+#include <unordered_map>
+#include <unordered_set>
+#endif
 
 namespace cpunit {
 
@@ -60,16 +72,75 @@ namespace cpunit {
   void assert_equals(const std::string &msg, const std::string &expected, const std::string &actual);
   void assert_equals(const std::string &expected, const std::string &actual);
   
+  template<class T>
+  void assert_array_equals(const std::string &msg, const T *expected, const T *actual, const std::size_t n);
+  template<class T>
+  void assert_array_equals(const T *expected, const T *actual, const std::size_t n);
+
+  void assert_array_equals(const std::string &msg, const float *expected, const float *actual, const std::size_t n);
+  void assert_array_equals(const float *expected, const float *actual, const std::size_t n);
+
+  void assert_array_equals(const std::string &msg, const double *expected, const double *actual, const std::size_t n);
+  void assert_array_equals(const double *expected, const double *actual, const std::size_t n);
+
+  void assert_all_close(const std::string &msg, const float *expected, const float *actual, const std::size_t n, const float abs_tol, const float rel_tol);
+  void assert_all_close(const float *expected, const float *actual, const std::size_t n, const float abs_tol, const float rel_tol);
+
+  void assert_all_close(const std::string &msg, const double *expected, const double *actual, const std::size_t n, const double abs_tol, const double rel_tol);
+  void assert_all_close(const double *expected, const double *actual, const std::size_t n, const double abs_tol, const double rel_tol);
+
+  void assert_equals_ulps(const std::string &msg, const float expected, const float actual, const unsigned int max_ulps);
+  void assert_equals_ulps(const float expected, const float actual, const unsigned int max_ulps);
+
+  void assert_equals_ulps(const std::string &msg, const double expected, const double actual, const unsigned int max_ulps);
+  void assert_equals_ulps(const double expected, const double actual, const unsigned int max_ulps);
+
+  void assert_close(const std::string &msg, const float expected, const float actual, const float abs_tol, const float rel_tol);
+  void assert_close(const float expected, const float actual, const float abs_tol, const float rel_tol);
+
+  void assert_close(const std::string &msg, const double expected, const double actual, const double abs_tol, const double rel_tol);
+  void assert_close(const double expected, const double actual, const double abs_tol, const double rel_tol);
+
+  void assert_all_within_ulps(const std::string &msg, const float *expected, const float *actual, const std::size_t n, const unsigned int max_ulps);
+  void assert_all_within_ulps(const float *expected, const float *actual, const std::size_t n, const unsigned int max_ulps);
+
+  void assert_all_within_ulps(const std::string &msg, const double *expected, const double *actual, const std::size_t n, const unsigned int max_ulps);
+  void assert_all_within_ulps(const double *expected, const double *actual, const std::size_t n, const unsigned int max_ulps);
+
+  void assert_bytes_equal(const std::string &msg, const void *expected, const void *actual, const std::size_t n);
+  void assert_bytes_equal(const void *expected, const void *actual, const std::size_t n);
+
+  template<class T>
+  void assert_array_equals(const std::string &msg, const std::vector<T> &expected, const std::vector<T> &actual);
+  template<class T>
+  void assert_array_equals(const std::vector<T> &expected, const std::vector<T> &actual);
+
+  template<class T>
+  void assert_all_close(const std::string &msg, const std::vector<T> &expected, const std::vector<T> &actual, 
+			const typename std::vector<T>::value_type abs_tol, const typename std::vector<T>::value_type rel_tol);
+  template<class T>
+  void assert_all_close(const std::vector<T> &expected, const std::vector<T> &actual, 
+			const typename std::vector<T>::value_type abs_tol, const typename std::vector<T>::value_type rel_tol);
+
+  template<class T>
+  void assert_all_within_ulps(const std::string &msg, const std::vector<T> &expected, const std::vector<T> &actual, const unsigned int max_ulps);
+  template<class T>
+  void assert_all_within_ulps(const std::vector<T> &expected, const std::vector<T> &actual, const unsigned int max_ulps);
+
   void assert_true(const std::string &msg, const bool statement);
+  void assert_true(const char *msg, const bool statement);
   void assert_true(const bool statement);
 
   void assert_false(const std::string &msg, const bool statement);
+  void assert_false(const char *msg, const bool statement);
   void assert_false(const bool statement);
 
   void assert_not_null(const std::string &msg, const void *data);
+  void assert_not_null(const char *msg, const void *data);
   void assert_not_null(const void *data);
 
   void assert_null(const std::string &msg, const void *data);
+  void assert_null(const char *msg, const void *data);
   void assert_null(const void *data);
 
   void fail(const std::string &msg);
@@ -84,6 +155,55 @@ namespace cpunit {
     
     template<class T>
     void fail_equals(const std::string& msg, const T &expected, const T &actual);
+
+    template<class T>
+    void fail_equals_diff(const std::string& msg, const T &expected, const T &actual);
+
+    template<class T>
+    void describe_difference(std::ostream &out, const T &expected, const T &actual);
+
+    template<class T, class A>
+    void describe_difference(std::ostream &out, const std::vector<T, A> &expected, const std::vector<T, A> &actual);
+
+    template<class T, class A>
+    void describe_difference(std::ostream &out, const std::list<T, A> &expected, const std::list<T, A> &actual);
+
+    template<class T, class A>
+    void describe_difference(std::ostream &out, const std::deque<T, A> &expected, const std::deque<T, A> &actual);
+
+    template<class T, class C, class A>
+    void describe_difference(std::ostream &out, const std::set<T, C, A> &expected, const std::set<T, C, A> &actual);
+
+    template<class T, class C, class A>
+    void describe_difference(std::ostream &out, const std::multiset<T, C, A> &expected, const std::multiset<T, C, A> &actual);
+
+    template<class K, class T, class C, class A>
+    void describe_difference(std::ostream &out, const std::map<K, T, C, A> &expected, const std::map<K, T, C, A> &actual);
+
+    template<class K, class T, class C, class A>
+    void describe_difference(std::ostream &out, const std::multimap<K, T, C, A> &expected, const std::multimap<K, T, C, A> &actual);
+
+#if __cplusplus >= 201103L
+    template<class T, class H, class P, class A>
+    void describe_difference(std::ostream &out, const std::unordered_set<T, H, P, A> &expected, const std::unordered_set<T, H, P, A> &actual);
+
+    template<class T, class H, class P, class A>
+    void describe_difference(std::ostream &out, const std::unordered_multiset<T, H, P, A> &expected, const std::unordered_multiset<T, H, P, A> &actual);
+
+    template<class K, class T, class H, class P, class A>
+    void describe_difference(std::ostream &out, const std::unordered_map<K, T, H, P, A> &expected, const std::unordered_map<K, T, H, P, A> &actual);
+
+    template<class K, class T, class H, class P, class A>
+    void describe_difference(std::ostream &out, const std::unordered_multimap<K, T, H, P, A> &expected, const std::unordered_multimap<K, T, H, P, A> &actual);
+#endif
+
+    template<class T>
+    const T* data_of(const std::vector<T> &v);
+
+    void fail_sizes(const char *kind, const std::string &msg, const std::size_t expected, const std::size_t actual);
+
+    template<class T>
+    void fail_array_equals(const std::string& msg, const T *expected, const T *actual, const std::size_t n, const std::size_t first);
   }
 }
 
@@ -32,6 +32,8 @@
 
 #include "cpunit_AssertionException.hpp"
 #include "cpunit_Ostreams.hpp"
+#include "cpunit_impl_ArrayCompare.hpp"
+#include "cpunit_impl_Diff.hpp"
 
 /**
    Check that two objects are equal, using ==.
@@ -49,7 +51,7 @@
 template<class T>
 void cpunit::assert_equals(const std::string &msg, const T &expected, const T &actual) {
   if (!(expected == actual)) {
-    priv::fail_equals(msg, expected, actual);
+    priv::fail_equals_diff(msg, expected, actual);
   }
 }
 
@@ -66,7 +68,9 @@ void cpunit::assert_equals(const std::string &msg, const T &expected, const T &a
 */
 template<class T>
 void cpunit::assert_equals(const T &expected, const T &actual) {
-  assert_equals("", expected, actual);
+  if (!(expected == actual)) {
+    priv::fail_equals_diff("", expected, actual);
+  }
 }
 
 /**
@@ -103,7 +107,143 @@ void cpunit::assert_equals(const std::string &msg, const T &expected, const T &a
 */
 template<class T, class Eq>
 void cpunit::assert_equals(const T &expected, const T &actual, const Eq &eq) {
-  assert_equals("", expected, actual, eq);
+  if (!eq(expected, actual)) {
+    priv::fail_equals("", expected, actual);
+  }
+}
+
+/**
+   Check that two arrays are equal, comparing the elements with ==.
+   Arrays of float and double are compared by vectorized overloads.
+   @tparam T       The type of the elements.
+                   The type must support the operator '==' as well as the stream operator 
+                   std::ostream& operator << (std::ostream&, const T&)
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param n        The number of elements of each array.
+   @throw AssertionException if any elements differ. The message gives the number
+                             of differing elements, and lists the first of them.
+*/
+template<class T>
+void cpunit::assert_array_equals(const std::string &msg, const T *expected, const T *actual, const std::size_t n) {
+  for (std::size_t i=0; i<n; ++i) {
+    if (!(expected[i] == actual[i])) {
+      priv::fail_array_equals(msg, expected, actual, n, i);
+    }
+  }
+}
+
+/**
+   Check that two arrays are equal, comparing the elements with ==.
+   @tparam T       The type of the elements.
+                   The type must support the operator '==' as well as the stream operator 
+                   std::ostream& operator << (std::ostream&, const T&)
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param n        The number of elements of each array.
+   @throw AssertionException if any elements differ.
+*/
+template<class T>
+void cpunit::assert_array_equals(const T *expected, const T *actual, const std::size_t n) {
+  assert_array_equals(std::string(), expected, actual, n);
+}
+
+/**
+   Check that two vectors are equal, comparing the elements as the array version does.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @throw AssertionException if the sizes or any elements differ.
+*/
+template<class T>
+void cpunit::assert_array_equals(const std::string &msg, const std::vector<T> &expected, const std::vector<T> &actual) {
+  if (expected.size() != actual.size()) {
+    priv::fail_sizes("ARRAY EQUALS", msg, expected.size(), actual.size());
+  }
+  assert_array_equals(msg, priv::data_of(expected), priv::data_of(actual), expected.size());
+}
+
+/**
+   Check that two vectors are equal, comparing the elements as the array version does.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @throw AssertionException if the sizes or any elements differ.
+*/
+template<class T>
+void cpunit::assert_array_equals(const std::vector<T> &expected, const std::vector<T> &actual) {
+  assert_array_equals(std::string(), expected, actual);
+}
+
+/**
+   Check that two vectors of float or double are close, element by element, as 
+   assert_all_close for arrays does. The tolerances have the type of the elements.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param abs_tol  The absolute tolerance.
+   @param rel_tol  The tolerance relative to the expected value.
+   @throw AssertionException if the sizes differ, or any elements are not close.
+*/
+template<class T>
+void cpunit::assert_all_close(const std::string &msg, const std::vector<T> &expected, const std::vector<T> &actual, 
+			      const typename std::vector<T>::value_type abs_tol, const typename std::vector<T>::value_type rel_tol) {
+  if (expected.size() != actual.size()) {
+    priv::fail_sizes("ALL CLOSE", msg, expected.size(), actual.size());
+  }
+  assert_all_close(msg, priv::data_of(expected), priv::data_of(actual), expected.size(), abs_tol, rel_tol);
+}
+
+/**
+   Check that two vectors of float or double are close, element by element.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param abs_tol  The absolute tolerance.
+   @param rel_tol  The tolerance relative to the expected value.
+   @throw AssertionException if the sizes differ, or any elements are not close.
+*/
+template<class T>
+void cpunit::assert_all_close(const std::vector<T> &expected, const std::vector<T> &actual, 
+			      const typename std::vector<T>::value_type abs_tol, const typename std::vector<T>::value_type rel_tol) {
+  assert_all_close(std::string(), expected, actual, abs_tol, rel_tol);
+}
+
+/**
+   Check that two vectors of float or double are within max_ulps of each other, 
+   element by element, as assert_all_within_ulps for arrays does.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param max_ulps The largest distance accepted, in units in the last place.
+   @throw AssertionException if the sizes differ, or any elements are too far apart.
+*/
+template<class T>
+void cpunit::assert_all_within_ulps(const std::string &msg, const std::vector<T> &expected, const std::vector<T> &actual, const unsigned int max_ulps) {
+  if (expected.size() != actual.size()) {
+    priv::fail_sizes("ALL WITHIN ULPS", msg, expected.size(), actual.size());
+  }
+  assert_all_within_ulps(msg, priv::data_of(expected), priv::data_of(actual), expected.size(), max_ulps);
+}
+
+/**
+   Check that two vectors of float or double are within max_ulps of each other, 
+   element by element.
+   @param expected The expected values.
+   @param actual   The actual values to test against the facit 'expected'.
+   @param max_ulps The largest distance accepted, in units in the last place.
+   @throw AssertionException if the sizes differ, or any elements are too far apart.
+*/
+template<class T>
+void cpunit::assert_all_within_ulps(const std::vector<T> &expected, const std::vector<T> &actual, const unsigned int max_ulps) {
+  assert_all_within_ulps(std::string(), expected, actual, max_ulps);
+}
+
+/**
+   @return The first element of a vector, or NULL if it is empty.
+*/
+template<class T>
+const T* cpunit::priv::data_of(const std::vector<T> &v) {
+  return v.empty() ? NULL : &v[0];
 }
 
 /**
@@ -148,3 +288,117 @@ void cpunit::priv::fail_equals(const std::string& msg, const T &expected, const
   message<<"ASSERT EQUALS FAILED - "<<msg<<" Expected <"<<expected<<">, was <"<<actual<<">.";
   throw AssertionException(message.str());
 }
+
+/**
+   As fail_equals, but for objects compared with ==, also describes where 
+   standard containers differ, since their contents are abbreviated in the message.
+   @see describe_difference
+*/
+template<class T>
+void cpunit::priv::fail_equals_diff(const std::string& msg, const T &expected, const T &actual) {
+  std::ostringstream message;
+  message<<"ASSERT EQUALS FAILED - "<<msg<<" Expected <"<<expected<<">, was <"<<actual<<">.";
+  describe_difference(message, expected, actual);
+  throw AssertionException(message.str());
+}
+
+/**
+   Describes where two unequal objects differ. Only done for standard 
+   containers, where it is up to impl::Diff::get_default_max_lines() lines long.
+*/
+template<class T>
+void cpunit::priv::describe_difference(std::ostream &, const T &, const T &) 
+{}
+
+template<class T, class A>
+void cpunit::priv::describe_difference(std::ostream &out, const std::vector<T, A> &expected, const std::vector<T, A> &actual) {
+  impl::write_sequence_diff(out, expected.begin(), expected.end(), actual.begin(), actual.end());
+}
+
+template<class T, class A>
+void cpunit::priv::describe_difference(std::ostream &out, const std::list<T, A> &expected, const std::list<T, A> &actual) {
+  impl::write_sequence_diff(out, expected.begin(), expected.end(), actual.begin(), actual.end());
+}
+
+template<class T, class A>
+void cpunit::priv::describe_difference(std::ostream &out, const std::deque<T, A> &expected, const std::deque<T, A> &actual) {
+  impl::write_sequence_diff(out, expected.begin(), expected.end(), actual.begin(), actual.end());
+}
+
+template<class T, class C, class A>
+void cpunit::priv::describe_difference(std::ostream &out, const std::set<T, C, A> &expected, const std::set<T, C, A> &actual) {
+  impl::write_set_diff(out, expected.begin(), expected.end(), actual.begin(), actual.end(), expected.key_comp());
+}
+
+template<class T, class C, class A>
+void cpunit::priv::describe_difference(std::ostream &out, const std::multiset<T, C, A> &expected, const std::multiset<T, C, A> &actual) {
+  impl::write_set_diff(out, expected.begin(), expected.end(), actual.begin(), actual.end(), expected.key_comp());
+}
+
+template<class K, class T, class C, class A>
+void cpunit::priv::describe_difference(std::ostream &out, const std::map<K, T, C, A> &expected, const std::map<K, T, C, A> &actual) {
+  impl::write_map_diff(out, expected.begin(), expected.end(), actual.begin(), actual.end(), expected.key_comp());
+}
+
+/**
+   The values of equal keys in a multimap are not sorted, so these are diffed
+   as sequences.
+*/
+template<class K, class T, class C, class A>
+void cpunit::priv::describe_difference(std::ostream &out, const std::multimap<K, T, C, A> &expected, const std::multimap<K, T, C, A> &actual) {
+  impl::write_sequence_diff(out, expected.begin(), expected.end(), actual.begin(), actual.end());
+}
+
+#if __cplusplus >= 201103L
+template<class T, class H, class P, class A>
+void cpunit::priv::describe_difference(std::ostream &out, const std::unordered_set<T, H, P, A> &expected, const std::unordered_set<T, H, P, A> &actual) {
+  impl::write_unordered_diff(out, expected, actual, impl::ElementKey(), false);
+}
+
+template<class T, class H, class P, class A>
+void cpunit::priv::describe_difference(std::ostream &out, const std::unordered_multiset<T, H, P, A> &expected, const std::unordered_multiset<T, H, P, A> &actual) {
+  impl::write_unordered_diff(out, expected, actual, impl::ElementKey(), false);
+}
+
+template<class K, class T, class H, class P, class A>
+void cpunit::priv::describe_difference(std::ostream &out, const std::unordered_map<K, T, H, P, A> &expected, const std::unordered_map<K, T, H, P, A> &actual) {
+  impl::write_unordered_diff(out, expected, actual, impl::PairKey(), true);
+}
+
+template<class K, class T, class H, class P, class A>
+void cpunit::priv::describe_difference(std::ostream &out, const std::unordered_multimap<K, T, H, P, A> &expected, const std::unordered_multimap<K, T, H, P, A> &actual) {
+  impl::write_unordered_diff(out, expected, actual, impl::PairKey(), true);
+}
+#endif
+
+/**
+   Throws an AssertionException with a message consistent with being the cause of a
+   failed assert_array_equals call.
+   @tparam T The type of the elements. The type must support the
+             std::ostream& operator << (std::ostream&, const T&).
+   @param msg      The text message to show together with the text "ASSERT ARRAY EQUALS FAILED - ".
+   @param expected The expected values.
+   @param actual   The actual values.
+   @param n        The number of elements of each array.
+   @param first    The index of the first differing element.
+   @throws AssertionException allways.
+*/
+template<class T>
+void cpunit::priv::fail_array_equals(const std::string& msg, const T *expected, const T *actual, const std::size_t n, const std::size_t first) {
+  std::ostringstream shown;
+  std::size_t count = 0;
+  for (std::size_t i=first; i<n; ++i) {
+    if (!(expected[i] == actual[i])) {
+      if (count < impl::MAX_MISMATCHES_SHOWN) {
+	shown<<std::endl<<"  ["<<i<<"] expected <"<<expected[i]<<">, was <"<<actual[i]<<'>';
+      }
+      ++count;
+    }
+  }
+  std::ostringstream message;
+  message<<"ASSERT ARRAY EQUALS FAILED - "<<msg<<' '<<count<<" of "<<n<<" elements differ:"<<shown.str();
+  if (count > impl::MAX_MISMATCHES_SHOWN) {
+    message<<std::endl<<"  ("<<count - impl::MAX_MISMATCHES_SHOWN<<" more)";
+  }
+  throw AssertionException(message.str());
+}
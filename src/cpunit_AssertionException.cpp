@@ -75,6 +75,13 @@ void cpunit::AssertionException::set_test(const RegInfo &t) throw() {
   generate_what_msg();
 }
 
+/**
+ * @return The RegInfo of the failed test, or NULL if it has not been set.
+ */
+const cpunit::RegInfo* cpunit::AssertionException::get_test() const throw() {
+  return test;
+}
+
 void cpunit::AssertionException::generate_what_msg() {
   std::ostringstream out;
   if (test != NULL) {
@@ -55,6 +55,7 @@ namespace cpunit {
     virtual const char* get_message() const throw();
 
     virtual void set_test(const RegInfo &t) throw();
+    virtual const RegInfo* get_test() const throw();
   };
 
 }
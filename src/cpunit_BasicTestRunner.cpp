@@ -29,11 +29,14 @@
 
 
 
+#include "cpunit_AllocationTracker.hpp"
 #include "cpunit_AssertionException.hpp"
 #include "cpunit_BasicTestRunner.hpp"
+#include "cpunit_ExpectationScope.hpp"
 #include "cpunit_trace.hpp"
 #include <string>
 #include <iostream>
+#include <sstream>
 
 cpunit::BasicTestRunner::BasicTestRunner()
 {}
@@ -41,16 +44,46 @@ cpunit::BasicTestRunner::BasicTestRunner()
 cpunit::BasicTestRunner::~BasicTestRunner()
 {}
 
+/**
+   Runs the callable, collecting its failed expectations.
+   @param tu The callable to run.
+   @return An OK report.
+   @throw AssertionException if an assert failed, or if expectations failed.
+                             The message lists the failed expectations, followed
+                             by the failed assert, if any.
+ */
 cpunit::ExecutionReport
 cpunit::BasicTestRunner::run(Callable& tu) const  {
+  ExpectationScope expectations;
   try {
     CPUNIT_DTRACE("BasicTestRunner::run with '"<<tu.get_reg_info().to_string()<<'\'');
-    tu.run();
+    AllocationTracker::take_refused_allocations();
+    {
+      LeakRecordingScope recording(true);
+      tu.run();
+    }
+    const std::size_t refused = AllocationTracker::take_refused_allocations();
+    if (refused > 0) {
+      std::ostringstream oss;
+      oss<<"ALLOCATION FAILURE - Refused "<<refused<<" nothrow allocations in a NoAllocationScope";
+      throw AssertionException(oss.str());
+    }
     CPUNIT_DTRACE("BasicTestRunner::run done.");
   } catch (AssertionException &e) {
     CPUNIT_DTRACE("BasicTestRunner::run failed.");
+    if (expectations.has_failures()) {
+      AssertionException all(expectations.to_string() + "\n  " + e.get_message());
+      all.set_test(tu.get_reg_info());
+      throw all;
+    }
     e.set_test(tu.get_reg_info());
     throw;
   }
+  if (expectations.has_failures()) {
+    CPUNIT_DTRACE("BasicTestRunner::run - "<<expectations.get_failures()<<" expectations failed.");
+    AssertionException all(expectations.to_string());
+    all.set_test(tu.get_reg_info());
+    throw all;
+  }
   return ExecutionReport(ExecutionReport::OK, "", tu.get_reg_info());
 }
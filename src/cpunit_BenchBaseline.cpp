@@ -0,0 +1,161 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_BenchBaseline.hpp"
+#include "cpunit_CPUnitException.hpp"
+#include "cpunit_trace.hpp"
+#include "cpunit_impl_AtomicFile.hpp"
+
+#include <fstream>
+#include <sstream>
+
+namespace {
+  const char SEPARATOR = '\t';
+}
+
+/**
+   Creates an empty baseline. Call load() to read the file.
+   @param file_name The name of the baseline file.
+ */
+cpunit::BenchBaseline::BenchBaseline(const std::string &fn) :
+  file_name(fn),
+  entries()
+{}
+
+cpunit::BenchBaseline::BenchBaseline(const BenchBaseline &o) :
+  file_name(o.file_name),
+  entries(o.entries)
+{}
+
+cpunit::BenchBaseline::~BenchBaseline()
+{}
+
+cpunit::BenchBaseline&
+cpunit::BenchBaseline::operator = (const BenchBaseline &o) {
+  if (&o != this) {
+    file_name = o.file_name;
+    entries = o.entries;
+  }
+  return *this;
+}
+
+const std::string&
+cpunit::BenchBaseline::get_file_name() const {
+  return file_name;
+}
+
+/**
+   @return The number of benchmarks in the baseline.
+ */
+std::size_t
+cpunit::BenchBaseline::size() const {
+  return entries.size();
+}
+
+/**
+   Reads the file, adding its benchmarks. Malformed lines are skipped.
+   @throws CPUnitException if the file cannot be read.
+ */
+void
+cpunit::BenchBaseline::load() {
+  std::ifstream in(file_name.c_str());
+  if (!in) {
+    throw CPUnitException("Unable to read the benchmark baseline " + file_name);
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string path, name;
+    Entry e;
+    if (std::getline(fields, path, SEPARATOR) &&
+	std::getline(fields, name, SEPARATOR) &&
+	fields>>e.samples>>e.mean>>e.stddev>>e.median>>e.mad) {
+      entries[path + "::" + name] = e;
+    } else {
+      CPUNIT_DTRACE("BenchBaseline - Skipping malformed line '"<<line<<"' in "<<file_name);
+    }
+  }
+  CPUNIT_ITRACE("BenchBaseline - Loaded "<<entries.size()<<" benchmarks from "<<file_name);
+}
+
+/**
+   @param bench  The benchmark to look up.
+   @param result Set to the statistics of the benchmark, if it is found.
+   @return true if the benchmark is in the baseline.
+ */
+bool
+cpunit::BenchBaseline::lookup(const RegInfo &bench, Entry &result) const {
+  const std::map<std::string, Entry>::const_iterator it = entries.find(key_of(bench));
+  if (it == entries.end()) {
+    return false;
+  }
+  result = it->second;
+  return true;
+}
+
+/**
+   Adds the statistics of a benchmark, replacing any previous ones.
+ */
+void
+cpunit::BenchBaseline::record(const RegInfo &bench, const BenchStatistics &stats) {
+  Entry e;
+  e.samples = stats.size();
+  e.mean = stats.get_mean();
+  e.stddev = stats.get_stddev();
+  e.median = stats.get_median();
+  e.mad = stats.get_mad();
+  entries[key_of(bench)] = e;
+}
+
+/**
+   Writes the baseline to its file, replacing the old file atomically.
+   @throws CPUnitException if the file cannot be written.
+ */
+void
+cpunit::BenchBaseline::save() const {
+  std::ostringstream out;
+  out<<"# CPUnit benchmark baseline: path, name, samples, and the mean, stddev, median and MAD of seconds per iteration."<<std::endl;
+  out.precision(10);
+  for (std::map<std::string, Entry>::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+    const std::size_t sep = it->first.rfind("::");
+    const Entry &e = it->second;
+    out<<it->first.substr(0, sep)<<SEPARATOR<<it->first.substr(sep + 2)<<SEPARATOR<<e.samples;
+    out<<SEPARATOR<<e.mean<<SEPARATOR<<e.stddev<<SEPARATOR<<e.median<<SEPARATOR<<e.mad<<std::endl;
+  }
+  impl::write_file_atomically(file_name, out.str());
+}
+
+std::string
+cpunit::BenchBaseline::key_of(const RegInfo &bench) {
+  return bench.get_path() + "::" + bench.get_name();
+}
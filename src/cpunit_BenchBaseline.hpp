@@ -0,0 +1,81 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_BENCHBASELINE_HPP
+#define CPUNIT_BENCHBASELINE_HPP
+
+#include "cpunit_BenchStatistics.hpp"
+#include "cpunit_RegInfo.hpp"
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+namespace cpunit {
+
+  /**
+     Benchmark statistics saved in a text file, for later runs to be 
+     compared against. Each line holds the path and name of a benchmark,
+     followed by the number of samples and the mean, standard deviation, 
+     median and MAD of the time per iteration, separated by tabs.
+   */
+  class BenchBaseline {
+  public:
+    struct Entry {
+      std::size_t samples;
+      double mean;
+      double stddev;
+      double median;
+      double mad;
+    };
+
+  private:
+    std::string file_name;
+    std::map<std::string, Entry> entries;
+
+    static std::string key_of(const RegInfo &bench);
+  public:
+    explicit BenchBaseline(const std::string &file_name);
+    BenchBaseline(const BenchBaseline &o);
+    virtual ~BenchBaseline();
+    BenchBaseline& operator = (const BenchBaseline &o);
+
+    const std::string& get_file_name() const;
+    std::size_t size() const;
+
+    void load();
+    bool lookup(const RegInfo &bench, Entry &result) const;
+    void record(const RegInfo &bench, const BenchStatistics &stats);
+    void save() const;
+  };
+
+}
+
+#endif // CPUNIT_BENCHBASELINE_HPP
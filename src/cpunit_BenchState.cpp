@@ -0,0 +1,126 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_BenchState.hpp"
+#include "cpunit_Clock.hpp"
+
+/**
+   @param n The number of iterations keep_running() should allow.
+   @param r The input size to run the benchmark with.
+ */
+cpunit::BenchState::BenchState(const std::size_t n, const long r) :
+  left(0),
+  iterations(n),
+  range(r),
+  started(0),
+  elapsed(0),
+  running(false),
+  paused(false),
+  finished(false)
+{}
+
+cpunit::BenchState::~BenchState()
+{}
+
+/**
+   Starts the clock on the first call, and stops it when the 
+   iterations are used up.
+   @return true if the loop should continue.
+ */
+bool
+cpunit::BenchState::next() {
+  if (!running && !finished && iterations > 0) {
+    running = true;
+    left = iterations - 1;
+    started = Clock::now();
+    return true;
+  }
+  if (running) {
+    if (!paused) {
+      elapsed += Clock::elapsed(started, Clock::now());
+    }
+    running = false;
+    paused = false;
+  }
+  finished = true;
+  return false;
+}
+
+/**
+   Stops the clock, e.g. to prepare the input of the next iteration.
+ */
+void
+cpunit::BenchState::pause_timing() {
+  if (running && !paused) {
+    elapsed += Clock::elapsed(started, Clock::now());
+    paused = true;
+  }
+}
+
+/**
+   Restarts the clock after pause_timing().
+ */
+void
+cpunit::BenchState::resume_timing() {
+  if (running && paused) {
+    paused = false;
+    started = Clock::now();
+  }
+}
+
+std::size_t
+cpunit::BenchState::get_iterations() const {
+  return iterations;
+}
+
+/**
+   @return The input size to run the benchmark with, or 0 if the 
+           benchmark was not registered with a range.
+ */
+long
+cpunit::BenchState::get_range() const {
+  return range;
+}
+
+/**
+   @return The measured time in seconds.
+ */
+double
+cpunit::BenchState::get_elapsed() const {
+  return elapsed / 1e9;
+}
+
+/**
+   @return true if the benchmark ran all of its iterations.
+ */
+bool
+cpunit::BenchState::is_finished() const {
+  return finished && left == 0;
+}
@@ -0,0 +1,127 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_BENCHSTATE_HPP
+#define CPUNIT_BENCHSTATE_HPP
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace cpunit {
+
+  /**
+     Drives the measurement loop of a benchmark. The framework decides
+     how many iterations to run, and the benchmark loops until told to stop:
+     <pre>
+       CPUNIT_BENCH(MySuite, bench_sort) {
+         std::vector<int> v;
+         while (state.keep_running()) {
+           state.pause_timing();
+           v = make_input();
+           state.resume_timing();
+           std::sort(v.begin(), v.end());
+           cpunit::do_not_optimize(v);
+         }
+       }
+     </pre>
+     Only the time spent inside the loop, and not between pause_timing() 
+     and resume_timing(), is measured.
+     Benchmarks registered with a range of input sizes get the size
+     to run with from get_range().
+   */
+  class BenchState {
+    std::size_t left;
+    const std::size_t iterations;
+    const long range;
+    uint64_t started;
+    uint64_t elapsed;
+    bool running;
+    bool paused;
+    bool finished;
+
+    bool next();
+
+    // No copy.
+    BenchState(const BenchState&);
+    BenchState& operator = (const BenchState&);
+  public:
+    explicit BenchState(const std::size_t iterations, const long range = 0);
+    virtual ~BenchState();
+
+    bool keep_running();
+    void pause_timing();
+    void resume_timing();
+
+    std::size_t get_iterations() const;
+    long get_range() const;
+    double get_elapsed() const;
+    bool is_finished() const;
+  };
+
+  /**
+     Called once per iteration, so it is kept inline, and the 
+     bookkeeping at the start and the end of the loop is left to next().
+     @return true as long as there are iterations left to run.
+   */
+  inline bool 
+  BenchState::keep_running() {
+    if (left != 0) {
+      --left;
+      return true;
+    }
+    return next();
+  }
+
+  /**
+     Prevents the compiler from optimizing away the computation of value.
+     @param value A result of the code under measurement.
+   */
+  template<class T>
+  inline void do_not_optimize(const T &value) {
+#if defined(__GNUC__)
+    __asm__ __volatile__ ("" : : "r,m" (value) : "memory");
+#else
+    static const void * volatile sink;
+    sink = &value;
+#endif
+  }
+
+  /**
+     Forces the compiler to assume that all memory may have been read and
+     written, so that stores done by the code under measurement are kept.
+   */
+  inline void clobber_memory() {
+#if defined(__GNUC__)
+    __asm__ __volatile__ ("" : : : "memory");
+#endif
+  }
+}
+
+#endif // CPUNIT_BENCHSTATE_HPP
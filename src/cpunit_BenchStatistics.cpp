@@ -0,0 +1,168 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_BenchStatistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+cpunit::BenchStatistics::BenchStatistics() :
+  samples(),
+  mean(0),
+  median(0),
+  stddev(0),
+  mad(0)
+{}
+
+/**
+   @param s The time per iteration of each sample.
+ */
+cpunit::BenchStatistics::BenchStatistics(const std::vector<double> &s) :
+  samples(s),
+  mean(0),
+  median(0),
+  stddev(0),
+  mad(0)
+{
+  if (samples.empty()) {
+    return;
+  }
+  double sum = 0;
+  for (std::size_t i=0; i<samples.size(); ++i) {
+    sum += samples[i];
+  }
+  mean = sum / samples.size();
+
+  if (samples.size() > 1) {
+    double squares = 0;
+    for (std::size_t i=0; i<samples.size(); ++i) {
+      squares += (samples[i] - mean) * (samples[i] - mean);
+    }
+    stddev = std::sqrt(squares / (samples.size() - 1));
+  }
+
+  median = median_of(samples);
+  std::vector<double> deviations(samples.size());
+  for (std::size_t i=0; i<samples.size(); ++i) {
+    deviations[i] = std::fabs(samples[i] - median);
+  }
+  mad = median_of(deviations);
+}
+
+cpunit::BenchStatistics::BenchStatistics(const BenchStatistics &o) :
+  samples(o.samples),
+  mean(o.mean),
+  median(o.median),
+  stddev(o.stddev),
+  mad(o.mad)
+{}
+
+cpunit::BenchStatistics::~BenchStatistics()
+{}
+
+cpunit::BenchStatistics&
+cpunit::BenchStatistics::operator = (const BenchStatistics &o) {
+  if (&o != this) {
+    samples = o.samples;
+    mean = o.mean;
+    median = o.median;
+    stddev = o.stddev;
+    mad = o.mad;
+  }
+  return *this;
+}
+
+double
+cpunit::BenchStatistics::median_of(std::vector<double> v) {
+  const std::size_t mid = v.size() / 2;
+  std::nth_element(v.begin(), v.begin() + mid, v.end());
+  if (v.size() % 2 == 1) {
+    return v[mid];
+  }
+  const double upper = v[mid];
+  const double lower = *std::max_element(v.begin(), v.begin() + mid);
+  return (lower + upper) / 2;
+}
+
+const std::vector<double>&
+cpunit::BenchStatistics::get_samples() const {
+  return samples;
+}
+
+std::size_t
+cpunit::BenchStatistics::size() const {
+  return samples.size();
+}
+
+double
+cpunit::BenchStatistics::get_mean() const {
+  return mean;
+}
+
+double
+cpunit::BenchStatistics::get_median() const {
+  return median;
+}
+
+/**
+   @return The sample standard deviation.
+ */
+double
+cpunit::BenchStatistics::get_stddev() const {
+  return stddev;
+}
+
+/**
+   @return The median absolute deviation from the median.
+ */
+double
+cpunit::BenchStatistics::get_mad() const {
+  return mad;
+}
+
+/**
+   Formats a time in the unit that suits its magnitude, e.g. "12.3us".
+   @param seconds The time to format.
+ */
+std::string
+cpunit::BenchStatistics::format(const double seconds) {
+  static const char *units[] = { "s", "ms", "us", "ns" };
+  double value = seconds;
+  std::size_t unit = 0;
+  while (unit < 3 && std::fabs(value) < 1 && value != 0) {
+    value *= 1000;
+    ++unit;
+  }
+  std::ostringstream oss;
+  oss<<std::fixed<<std::setprecision(value >= 100 ? 1 : 3)<<value<<units[unit];
+  return oss.str();
+}
@@ -0,0 +1,73 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_BENCHSTATISTICS_HPP
+#define CPUNIT_BENCHSTATISTICS_HPP
+
+#include <string>
+#include <vector>
+
+namespace cpunit {
+
+  /**
+     Summary statistics of the time per iteration of a benchmark,
+     over a number of samples. All times are in seconds.
+     The median and the median absolute deviation (MAD) are less 
+     affected by a few disturbed samples than the mean and the
+     standard deviation.
+   */
+  class BenchStatistics {
+    std::vector<double> samples;
+    double mean;
+    double median;
+    double stddev;
+    double mad;
+
+    static double median_of(std::vector<double> v);
+  public:
+    BenchStatistics();
+    explicit BenchStatistics(const std::vector<double> &samples);
+    BenchStatistics(const BenchStatistics &o);
+    virtual ~BenchStatistics();
+    BenchStatistics& operator = (const BenchStatistics &o);
+
+    const std::vector<double>& get_samples() const;
+    std::size_t size() const;
+    double get_mean() const;
+    double get_median() const;
+    double get_stddev() const;
+    double get_mad() const;
+
+    static std::string format(const double seconds);
+  };
+
+}
+
+#endif // CPUNIT_BENCHSTATISTICS_HPP
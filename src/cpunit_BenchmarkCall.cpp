@@ -0,0 +1,346 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_AssertionException.hpp"
+#include "cpunit_BenchBaseline.hpp"
+#include "cpunit_BenchmarkCall.hpp"
+#include "cpunit_WrongSetupException.hpp"
+#include "cpunit_trace.hpp"
+#include "cpunit_impl_Statistics.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+  const std::size_t MAX_ITERATIONS = 1000000000;
+  const double MAX_GROWTH = 10;
+  const double SIGNIFICANCE = 0.05;
+
+  /**
+     @return lo, 2*lo, 4*lo, ... and finally hi.
+   */
+  std::vector<long> doubling(const long lo, const long hi) {
+    std::vector<long> result;
+    for (long r=lo; r<hi; r*=2) {
+      result.push_back(r);
+      if (r > hi / 2) {
+	break;
+      }
+    }
+    result.push_back(hi);
+    return result;
+  }
+
+  /**
+     @param ri The registration info of the benchmark.
+     @param lo The smallest input size.
+     @param hi The largest input size.
+     @return The input sizes from lo to hi.
+     @throws WrongSetupException if lo is below 1 or hi is below lo.
+   */
+  std::vector<long> checked_range(const cpunit::RegInfo &ri, const long lo, const long hi) {
+    if (lo < 1 || hi < lo) {
+      throw cpunit::WrongSetupException("The benchmark '" + ri.to_string() + "' has an illegal range.");
+    }
+    return doubling(lo, hi);
+  }
+
+  /**
+     @param ri The registration info of the benchmark.
+     @param lo The smallest input size.
+     @param hi The largest input size.
+     @return The input sizes from lo to hi.
+     @throws WrongSetupException if lo is below 1 or the range has less than two sizes.
+   */
+  std::vector<long> checked_complexity_range(const cpunit::RegInfo &ri, const long lo, const long hi) {
+    if (lo < 1 || hi <= lo) {
+      throw cpunit::WrongSetupException("The benchmark '" + ri.to_string() + "' needs at least two input sizes to check its complexity.");
+    }
+    return doubling(lo, hi);
+  }
+}
+
+/**
+   The defaults of --bench-time and --bench-samples, without a baseline.
+ */
+cpunit::BenchmarkCall::Settings::Settings() :
+  min_time(0.5),
+  samples(10),
+  baseline(NULL),
+  max_regression(0)
+{}
+
+/**
+   @param min_time_       The time in seconds to sample for, at each input size.
+   @param samples_        The number of samples, of which at least 1 is taken.
+   @param baseline_       The baseline to compare with, or NULL. Must outlive the runs.
+   @param max_regression_ The slowdown allowed, as a fraction of the baseline.
+ */
+cpunit::BenchmarkCall::Settings::Settings(const double min_time_, const std::size_t samples_, const BenchBaseline *baseline_, const double max_regression_) :
+  min_time(min_time_),
+  samples(std::max(static_cast<std::size_t>(1), samples_)),
+  baseline(baseline_),
+  max_regression(max_regression_)
+{}
+
+/**
+   @param ri The registration info of the benchmark.
+   @param b  The benchmark function.
+   @param s  How long to measure, and what to compare with.
+ */
+cpunit::BenchmarkCall::BenchmarkCall(const RegInfo &ri, BenchMethod b, const Settings &s) :
+  Callable(ri),
+  bench(b),
+  settings(s),
+  ranges(1, 0),
+  bounded(false),
+  bound(O_1),
+  measurements(),
+  fit()
+{}
+
+/**
+   @param ri The registration info of the benchmark.
+   @param b  The benchmark function.
+   @param lo The smallest input size, at least 1.
+   @param hi The largest input size.
+   @param s  How long to measure, and what to compare with.
+   @throws WrongSetupException if the range is empty.
+ */
+cpunit::BenchmarkCall::BenchmarkCall(const RegInfo &ri, BenchMethod b, const long lo, const long hi, const Settings &s) :
+  Callable(ri),
+  bench(b),
+  settings(s),
+  ranges(checked_range(ri, lo, hi)),
+  bounded(false),
+  bound(O_1),
+  measurements(),
+  fit()
+{}
+
+/**
+   @param ri    The registration info of the benchmark.
+   @param b     The benchmark function.
+   @param lo    The smallest input size, at least 1.
+   @param hi    The largest input size.
+   @param bound The worst complexity the fit may have.
+   @param s     How long to measure, and what to compare with.
+   @throws WrongSetupException if the range is empty.
+ */
+cpunit::BenchmarkCall::BenchmarkCall(const RegInfo &ri, BenchMethod b, const long lo, const long hi, const Complexity c, const Settings &s) :
+  Callable(ri),
+  bench(b),
+  settings(s),
+  ranges(checked_complexity_range(ri, lo, hi)),
+  bounded(true),
+  bound(c),
+  measurements(),
+  fit()
+{}
+
+cpunit::BenchmarkCall::~BenchmarkCall()
+{}
+
+/**
+   Calls the benchmark function with n iterations.
+   @return The measured time in seconds.
+   @throws WrongSetupException if the benchmark does not loop on BenchState::keep_running().
+ */
+double
+cpunit::BenchmarkCall::run_once(const std::size_t n, const long range) {
+  BenchState state(n, range);
+  (*bench)(state);
+  if (!state.is_finished()) {
+    throw WrongSetupException("The benchmark '" + get_reg_info().to_string() + "' must loop until BenchState::keep_running() returns false.");
+  }
+  return state.get_elapsed();
+}
+
+/**
+   Calibrates, warms up and samples the benchmark at one input size.
+ */
+cpunit::BenchmarkCall::Measurement
+cpunit::BenchmarkCall::measure(const long range) {
+  const std::size_t samples = settings.samples;
+  const double sample_time = settings.min_time / samples;
+
+  std::size_t n = 1;
+  double secs = run_once(n, range);
+  while (secs < sample_time && n < MAX_ITERATIONS) {
+    // Aim a little beyond the target, so that noise does not cause an extra round.
+    const double growth = secs > 0 ? std::min(MAX_GROWTH, 1.4 * sample_time / secs) : MAX_GROWTH;
+    n = std::min(MAX_ITERATIONS, std::max(n + 1, static_cast<std::size_t>(n * growth)));
+    secs = run_once(n, range);
+  }
+  CPUNIT_DTRACE("BenchmarkCall::measure - Calibrated to "<<n<<" iterations at range "<<range);
+  run_once(n, range);
+
+  std::vector<double> per_iteration(samples);
+  for (std::size_t i=0; i<samples; ++i) {
+    per_iteration[i] = run_once(n, range) / n;
+  }
+  Measurement m;
+  m.range = range;
+  m.iterations = n;
+  m.statistics = BenchStatistics(per_iteration);
+  return m;
+}
+
+void
+cpunit::BenchmarkCall::run() {
+  CPUNIT_DTRACE("BenchmarkCall::run called");
+  measurements.clear();
+  for (std::size_t i=0; i<ranges.size(); ++i) {
+    measurements.push_back(measure(ranges[i]));
+  }
+  if (has_fit()) {
+    std::vector<double> sizes, times;
+    for (std::size_t i=0; i<measurements.size(); ++i) {
+      sizes.push_back(static_cast<double>(measurements[i].range));
+      times.push_back(measurements[i].statistics.get_mean());
+    }
+    fit = ComplexityFit::fit(sizes, times);
+  }
+  for (std::size_t i=0; i<measurements.size(); ++i) {
+    check_regression(i);
+  }
+  check_complexity();
+  CPUNIT_DTRACE("BenchmarkCall::run succeeded");
+}
+
+/**
+   Compares the mean time per iteration with the baseline, scaled up by the
+   allowed regression. The benchmark fails if Welch's t-test finds it slower
+   with 95% confidence, so that noise in either run does not fail it.
+   @param i The measurement to check.
+   @throws AssertionException if the benchmark has regressed.
+ */
+void
+cpunit::BenchmarkCall::check_regression(const std::size_t i) const {
+  const BenchBaseline *reference = settings.baseline;
+  const double regression = settings.max_regression;
+  BenchBaseline::Entry base;
+  if (reference == NULL || !reference->lookup(get_measurement_info(i), base)) {
+    return;
+  }
+  const BenchStatistics &statistics = measurements[i].statistics;
+  const double scale = 1 + regression;
+  const double p = impl::welch_p_value(statistics.get_mean(), statistics.get_stddev() * statistics.get_stddev(), statistics.size(),
+				       base.mean * scale, base.stddev * base.stddev * scale * scale, base.samples);
+  CPUNIT_DTRACE("BenchmarkCall - "<<get_measurement_info(i).to_string()<<" vs baseline: p="<<p);
+  if (p < SIGNIFICANCE) {
+    std::ostringstream oss;
+    oss<<"BENCHMARK REGRESSION - ";
+    if (has_fit()) {
+      oss<<"At range "<<measurements[i].range<<": ";
+    }
+    oss<<"Mean "<<BenchStatistics::format(statistics.get_mean());
+    oss<<" vs baseline "<<BenchStatistics::format(base.mean);
+    oss<<" ("<<std::showpos<<std::fixed<<std::setprecision(1)<<(100 * (statistics.get_mean() / base.mean - 1))<<"%)";
+    oss<<std::noshowpos<<", exceeding max-regression="<<(100 * regression)<<"% (p="<<std::setprecision(4)<<p<<')';
+    throw AssertionException(oss.str());
+  }
+}
+
+/**
+   @throws AssertionException if the fitted complexity is worse than the bound.
+ */
+void
+cpunit::BenchmarkCall::check_complexity() const {
+  if (bounded && fit.get_complexity() > bound) {
+    std::ostringstream oss;
+    oss<<"COMPLEXITY FAILURE - Fitted "<<ComplexityFit::to_string(fit.get_complexity());
+    oss<<" (RMS "<<std::fixed<<std::setprecision(1)<<(100 * fit.get_rms())<<"%)";
+    oss<<", which is worse than the declared "<<ComplexityFit::to_string(bound);
+    throw AssertionException(oss.str());
+  }
+}
+
+/**
+   @return true if the benchmark has been run to completion.
+ */
+bool
+cpunit::BenchmarkCall::has_result() const {
+  return measurements.size() == ranges.size();
+}
+
+/**
+   @return The measurements of the last run, one per input size.
+ */
+const std::vector<cpunit::BenchmarkCall::Measurement>&
+cpunit::BenchmarkCall::get_measurements() const {
+  return measurements;
+}
+
+/**
+   @return The registration info of the benchmark, with the input size 
+           of measurement i appended to the name of a range benchmark, 
+           e.g. "bench_sort/1024".
+ */
+cpunit::RegInfo
+cpunit::BenchmarkCall::get_measurement_info(const std::size_t i) const {
+  const RegInfo &ri = get_reg_info();
+  if (!has_fit()) {
+    return ri;
+  }
+  std::ostringstream name;
+  name<<ri.get_name()<<'/'<<ranges[i];
+  return RegInfo(ri.get_path(), name.str(), ri.get_file(), ri.get_line());
+}
+
+/**
+   @return true if the benchmark runs over a range of input sizes,
+           and its times are fitted to a complexity model.
+ */
+bool
+cpunit::BenchmarkCall::has_fit() const {
+  return ranges.size() > 1;
+}
+
+const cpunit::ComplexityFit&
+cpunit::BenchmarkCall::get_fit() const {
+  return fit;
+}
+
+const cpunit::BenchmarkCall::Settings&
+cpunit::BenchmarkCall::get_settings() const {
+  return settings;
+}
+
+/**
+   Replaces the settings of a registered benchmark with those of the 
+   command line. Should be called before the benchmark is run.
+   @param s How long to measure, and what to compare with.
+ */
+void
+cpunit::BenchmarkCall::set_settings(const Settings &s) {
+  settings = s;
+}
@@ -0,0 +1,130 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_BENCHMARKCALL_HPP
+#define CPUNIT_BENCHMARKCALL_HPP
+
+#include "cpunit_BenchState.hpp"
+#include "cpunit_BenchStatistics.hpp"
+#include "cpunit_Callable.hpp"
+#include "cpunit_Complexity.hpp"
+#include "cpunit_RegInfo.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace cpunit {
+
+  class BenchBaseline;
+
+  /**
+     A benchmark registered with CPUNIT_BENCH.
+     Running it first grows the number of iterations until a sample takes 
+     long enough to measure, which also serves as warm-up, runs one more 
+     warm-up sample, and then takes the samples the statistics are made of.
+     The statistics of the last run are kept in the object.
+
+     A benchmark registered with a range of input sizes is measured once for 
+     each size, from the lower bound and doubling up to the upper bound, 
+     and the times are fitted to a complexity model. If a bound on the 
+     complexity is given, a worse fit fails the benchmark.
+
+     If the settings have a baseline to compare with, a benchmark that is 
+     significantly slower than its baseline fails with an AssertionException.
+     The benchmarks registered with CPUNIT_BENCH get their settings from the
+     command line before they are run.
+   */
+  class BenchmarkCall : public Callable {
+  public:
+    typedef void (*BenchMethod)(BenchState&);
+
+    /**
+       The result of measuring the benchmark at one input size.
+     */
+    struct Measurement {
+      long range;
+      std::size_t iterations;
+      BenchStatistics statistics;
+    };
+
+    /**
+       How long to measure at each input size, and what to compare with.
+     */
+    struct Settings {
+      // The time in seconds of all samples together.
+      double min_time;
+      std::size_t samples;
+      // The baseline to compare with, or NULL. Not owned.
+      const BenchBaseline *baseline;
+      // The slowdown allowed, as a fraction of the baseline.
+      double max_regression;
+
+      Settings();
+      Settings(const double min_time_, const std::size_t samples_, const BenchBaseline *baseline_, const double max_regression_);
+    };
+
+  private:
+    BenchMethod bench;
+    Settings settings;
+    std::vector<long> ranges;
+    bool bounded;
+    Complexity bound;
+    std::vector<Measurement> measurements;
+    ComplexityFit fit;
+
+    double run_once(const std::size_t n, const long range);
+    Measurement measure(const long range);
+    void check_regression(const std::size_t i) const;
+    void check_complexity() const;
+
+    // No copy.
+    BenchmarkCall(const BenchmarkCall&);
+    BenchmarkCall& operator = (const BenchmarkCall&);
+  public:
+    BenchmarkCall(const RegInfo &ri, BenchMethod b, const Settings &s = Settings());
+    BenchmarkCall(const RegInfo &ri, BenchMethod b, const long lo, const long hi, const Settings &s = Settings());
+    BenchmarkCall(const RegInfo &ri, BenchMethod b, const long lo, const long hi, const Complexity bound, const Settings &s = Settings());
+    virtual ~BenchmarkCall();
+
+    virtual void run();
+
+    bool has_result() const;
+    const std::vector<Measurement>& get_measurements() const;
+    RegInfo get_measurement_info(const std::size_t i) const;
+    bool has_fit() const;
+    const ComplexityFit& get_fit() const;
+
+    const Settings& get_settings() const;
+    void set_settings(const Settings &s);
+  };
+
+}
+
+#endif // CPUNIT_BENCHMARKCALL_HPP
@@ -0,0 +1,194 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_Clock.hpp"
+#include "cpunit_trace.hpp"
+
+#include <ctime>
+#include <pthread.h>
+#include <sys/time.h>
+
+#if defined(__i386__) || defined(__x86_64__)
+# include <cpuid.h>
+# define CPUNIT_HAS_TSC
+#endif
+
+namespace {
+
+  const int OVERHEAD_SAMPLES = 1000;
+  const uint64_t TSC_CALIBRATION_NS = 10000000;
+
+  cpunit::Clock::Source source = cpunit::Clock::MONOTONIC;
+  uint64_t overhead = 0;
+  pthread_once_t overhead_once = PTHREAD_ONCE_INIT;
+  // The source the overhead was measured for.
+  cpunit::Clock::Source overhead_source = cpunit::Clock::MONOTONIC;
+
+  // Translation of counter ticks to CLOCK_MONOTONIC nanoseconds.
+  uint64_t tsc_base = 0;
+  uint64_t tsc_base_ns = 0;
+  double ns_per_tick = 0;
+
+  uint64_t monotonic_ns() {
+#ifdef CLOCK_MONOTONIC
+    timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+      return static_cast<uint64_t>(ts.tv_sec) * 1000000000UL + ts.tv_nsec;
+    }
+#endif
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    return static_cast<uint64_t>(tv.tv_sec) * 1000000000UL + tv.tv_usec * 1000UL;
+  }
+
+#ifdef CPUNIT_HAS_TSC
+  uint64_t read_tsc() {
+    unsigned int lo, hi;
+    __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+  }
+
+  void calibrate_tsc() {
+    const uint64_t ns0 = monotonic_ns();
+    const uint64_t tsc0 = read_tsc();
+    uint64_t ns1 = ns0;
+    while (ns1 - ns0 < TSC_CALIBRATION_NS) {
+      ns1 = monotonic_ns();
+    }
+    const uint64_t tsc1 = read_tsc();
+    ns_per_tick = static_cast<double>(ns1 - ns0) / static_cast<double>(tsc1 - tsc0);
+    tsc_base = tsc0;
+    tsc_base_ns = ns0;
+    CPUNIT_ITRACE("Clock - Calibrated TSC to "<<(1.0 / ns_per_tick)<<" ticks per ns.");
+  }
+#endif
+
+  /**
+     Takes the smallest difference between back to back reads, which is
+     the cost of a read without any interference from the scheduler.
+   */
+  void measure_overhead() {
+    uint64_t best = 0;
+    for (int i=0; i<OVERHEAD_SAMPLES; ++i) {
+      const uint64_t a = cpunit::Clock::now();
+      const uint64_t b = cpunit::Clock::now();
+      if (i == 0 || b - a < best) {
+	best = b - a;
+      }
+    }
+    overhead = best;
+    overhead_source = source;
+    CPUNIT_ITRACE("Clock - Read overhead is "<<overhead<<"ns.");
+  }
+}
+
+/**
+   @return The current time in nanoseconds.
+ */
+uint64_t
+cpunit::Clock::now() {
+#ifdef CPUNIT_HAS_TSC
+  if (source == TSC) {
+    return tsc_base_ns + static_cast<uint64_t>((read_tsc() - tsc_base) * ns_per_tick);
+  }
+#endif
+  return monotonic_ns();
+}
+
+/**
+   @param start A reading taken at the start of an interval.
+   @param end   A reading taken at the end of the interval.
+   @return The nanoseconds between the readings, less the cost of reading the clock.
+ */
+uint64_t
+cpunit::Clock::elapsed(const uint64_t start, const uint64_t end) {
+  const uint64_t o = get_overhead();
+  return end > start + o ? end - start - o : 0;
+}
+
+/**
+   Selects the time source, and measures the cost of reading it.
+   @param s The source to use.
+   @return false if the source is not supported, in which case CLOCK_MONOTONIC is used.
+ */
+bool
+cpunit::Clock::use(const Source s) {
+  bool supported = true;
+  source = MONOTONIC;
+  if (s == TSC) {
+#ifdef CPUNIT_HAS_TSC
+    if (has_invariant_tsc()) {
+      calibrate_tsc();
+      source = TSC;
+    } else {
+      supported = false;
+    }
+#else
+    supported = false;
+#endif
+  }
+  // Measures the selected source, unless it was measured already.
+  pthread_once(&overhead_once, measure_overhead);
+  if (overhead_source != source) {
+    measure_overhead();
+  }
+  return supported;
+}
+
+cpunit::Clock::Source
+cpunit::Clock::get_source() {
+  return source;
+}
+
+/**
+   @return The cost of reading the clock in nanoseconds.
+ */
+uint64_t
+cpunit::Clock::get_overhead() {
+  pthread_once(&overhead_once, measure_overhead);
+  return overhead;
+}
+
+/**
+   @return true if the time stamp counter ticks at a constant rate on all cores,
+           regardless of frequency scaling and sleep states.
+ */
+bool
+cpunit::Clock::has_invariant_tsc() {
+#ifdef CPUNIT_HAS_TSC
+  unsigned int a, b, c, d;
+  if (__get_cpuid(0x80000007, &a, &b, &c, &d) == 0) {
+    return false;
+  }
+  return (d & (1U << 8)) != 0;
+#else
+  return false;
+#endif
+}
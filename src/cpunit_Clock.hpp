@@ -0,0 +1,72 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_CLOCK_HPP
+#define CPUNIT_CLOCK_HPP
+
+#include <stdint.h>
+
+namespace cpunit {
+
+  /**
+     The time source used to time tests. Readings are nanoseconds since an 
+     arbitrary, fixed point in time, and never decrease, so they cannot be 
+     used as wall clock time, but are not affected by adjustments of it either.
+
+     The default source is CLOCK_MONOTONIC. On x86 processors with an invariant
+     time stamp counter, the counter may be used instead. It is then calibrated
+     against CLOCK_MONOTONIC, and reads are a lot cheaper.
+
+     The cost of reading the clock is measured when the source is selected, 
+     and subtracted from the intervals measured by elapsed().
+     The source should be selected before any tests are started.
+   */
+  class Clock {
+  public:
+    enum Source {
+      MONOTONIC,
+      TSC
+    };
+
+    static uint64_t now();
+    static uint64_t elapsed(const uint64_t start, const uint64_t end);
+
+    static bool use(const Source s);
+    static Source get_source();
+    static uint64_t get_overhead();
+    static bool has_invariant_tsc();
+
+  private:
+    Clock();
+  };
+
+}
+
+#endif // CPUNIT_CLOCK_HPP
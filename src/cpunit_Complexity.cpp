@@ -0,0 +1,163 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_Complexity.hpp"
+#include "cpunit_IllegalArgumentException.hpp"
+
+#include <cmath>
+
+namespace {
+  const cpunit::Complexity MODELS[] = { 
+    cpunit::O_1, 
+    cpunit::O_LOG_N, 
+    cpunit::O_N, 
+    cpunit::O_N_LOG_N, 
+    cpunit::O_N_SQUARED 
+  };
+
+  double model(const cpunit::Complexity c, const double n) {
+    switch (c) {
+    case cpunit::O_1:         return 1;
+    case cpunit::O_LOG_N:     return std::log(n);
+    case cpunit::O_N:         return n;
+    case cpunit::O_N_LOG_N:   return n * std::log(n);
+    case cpunit::O_N_SQUARED: return n * n;
+    }
+    return 1;
+  }
+}
+
+cpunit::ComplexityFit::ComplexityFit() :
+  complexity(O_1),
+  coefficient(0),
+  rms(0)
+{}
+
+cpunit::ComplexityFit::ComplexityFit(const Complexity c, const double coeff, const double r) :
+  complexity(c),
+  coefficient(coeff),
+  rms(r)
+{}
+
+cpunit::ComplexityFit::ComplexityFit(const ComplexityFit &o) :
+  complexity(o.complexity),
+  coefficient(o.coefficient),
+  rms(o.rms)
+{}
+
+cpunit::ComplexityFit::~ComplexityFit()
+{}
+
+cpunit::ComplexityFit&
+cpunit::ComplexityFit::operator = (const ComplexityFit &o) {
+  if (&o != this) {
+    complexity = o.complexity;
+    coefficient = o.coefficient;
+    rms = o.rms;
+  }
+  return *this;
+}
+
+cpunit::Complexity
+cpunit::ComplexityFit::get_complexity() const {
+  return complexity;
+}
+
+/**
+   @return The time of one unit of the model, i.e. time / g(n).
+ */
+double
+cpunit::ComplexityFit::get_coefficient() const {
+  return coefficient;
+}
+
+/**
+   @return The root mean square error of the fit, relative to the mean time.
+ */
+double
+cpunit::ComplexityFit::get_rms() const {
+  return rms;
+}
+
+/**
+   Finds the model that fits the times best. 
+   @param sizes The input sizes, all greater than 1.
+   @param times The time at each input size.
+   @return The best fit.
+   @throws IllegalArgumentException unless there are at least two sizes, with one time each.
+ */
+cpunit::ComplexityFit
+cpunit::ComplexityFit::fit(const std::vector<double> &sizes, const std::vector<double> &times) {
+  if (sizes.size() < 2 || sizes.size() != times.size()) {
+    throw IllegalArgumentException("A complexity fit needs at least two sizes, with one time each.");
+  }
+  double mean = 0;
+  for (std::size_t i=0; i<times.size(); ++i) {
+    mean += times[i];
+  }
+  mean /= times.size();
+
+  ComplexityFit best;
+  for (std::size_t m=0; m<sizeof(MODELS)/sizeof(MODELS[0]); ++m) {
+    double tg = 0;
+    double gg = 0;
+    for (std::size_t i=0; i<sizes.size(); ++i) {
+      const double g = model(MODELS[m], sizes[i]);
+      tg += times[i] * g;
+      gg += g * g;
+    }
+    const double coeff = tg / gg;
+    double squares = 0;
+    for (std::size_t i=0; i<sizes.size(); ++i) {
+      const double err = times[i] - coeff * model(MODELS[m], sizes[i]);
+      squares += err * err;
+    }
+    const double r = std::sqrt(squares / sizes.size()) / (mean > 0 ? mean : 1);
+    if (m == 0 || r < best.rms) {
+      best = ComplexityFit(MODELS[m], coeff, r);
+    }
+  }
+  return best;
+}
+
+/**
+   @return The usual notation of the complexity, e.g. "O(n log n)".
+ */
+std::string
+cpunit::ComplexityFit::to_string(const Complexity c) {
+  switch (c) {
+  case O_1:         return "O(1)";
+  case O_LOG_N:     return "O(log n)";
+  case O_N:         return "O(n)";
+  case O_N_LOG_N:   return "O(n log n)";
+  case O_N_SQUARED: return "O(n^2)";
+  }
+  return "O(?)";
+}
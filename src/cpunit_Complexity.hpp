@@ -0,0 +1,77 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_COMPLEXITY_HPP
+#define CPUNIT_COMPLEXITY_HPP
+
+#include <string>
+#include <vector>
+
+namespace cpunit {
+
+  /**
+     The complexity models benchmarks are fitted to, from best to worst.
+   */
+  enum Complexity {
+    O_1,
+    O_LOG_N,
+    O_N,
+    O_N_LOG_N,
+    O_N_SQUARED
+  };
+
+  /**
+     The model that best explains how the time of a benchmark grows with its 
+     input size. Each model g is fitted as time = coefficient * g(n) by least 
+     squares, and the model with the smallest root mean square error wins.
+     The error is given relative to the mean time, so that 0.05 means 5%.
+   */
+  class ComplexityFit {
+    Complexity complexity;
+    double coefficient;
+    double rms;
+  public:
+    ComplexityFit();
+    ComplexityFit(const Complexity c, const double coefficient, const double rms);
+    ComplexityFit(const ComplexityFit &o);
+    virtual ~ComplexityFit();
+    ComplexityFit& operator = (const ComplexityFit &o);
+
+    Complexity get_complexity() const;
+    double get_coefficient() const;
+    double get_rms() const;
+
+    static ComplexityFit fit(const std::vector<double> &sizes, const std::vector<double> &times);
+    static std::string to_string(const Complexity c);
+  };
+
+}
+
+#endif // CPUNIT_COMPLEXITY_HPP
@@ -27,24 +27,47 @@
   THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include "cpunit_AllocationStats.hpp"
+#include "cpunit_AllocationTracker.hpp"
 #include "cpunit_AssertionException.hpp"
+#include "cpunit_BenchBaseline.hpp"
+#include "cpunit_BenchmarkCall.hpp"
+#include "cpunit_Clock.hpp"
+#include "cpunit_CPUnitException.hpp"
 #include "cpunit_TestStore.hpp"
 #include "cpunit_StringFlyweightStore.hpp"
 #include "cpunit_TestExecutionFacade.hpp"
+#include "cpunit_ExecutionOptions.hpp"
+#include "cpunit_ExpectationScope.hpp"
 #include "cpunit_ExecutionReport.hpp"
 #include "cpunit_ErrorReportFormat.hpp"
+#include "cpunit_FailureCache.hpp"
+#include "cpunit_Golden.hpp"
+#include "cpunit_InstructionBaseline.hpp"
+#include "cpunit_PerfCounters.hpp"
 #include "cpunit_RegInfo.hpp"
+#include "cpunit_ResourceUsage.hpp"
+#include "cpunit_ShardFilter.hpp"
+#include "cpunit_TimingDatabase.hpp"
 #include "cpunit_WrongSetupException.hpp"
 #include "cpunit_CmdLineParser.hpp"
 #include "cpunit_TimeFormat.hpp"
 #include "cpunit_trace.hpp"
 #include "cpunit_EntryPoint.hpp"
 #include "cpunit_impl_BootStream.hpp"
+#include "cpunit_impl_Diff.hpp"
+#include "cpunit_impl_PerfEventGroup.hpp"
+#include "cpunit_impl_WorkStealingPool.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <utility>
 #include <vector>
 #include <string>
 #include <iostream>
 #include <iomanip>
+#include <map>
+#include <memory>
 #include <sstream>
 
 namespace cpunit {
@@ -80,9 +103,88 @@ namespace cpunit {
       cout<<"                   %f - file name"<<endl;
       cout<<"                   %l - line number where test is registered"<<endl;
       cout<<"                   %m - error message"<<endl;  
+      cout<<"                   %c - CPU time of the test thread"<<endl;
+      cout<<"                   %w - voluntary context switches"<<endl;
+      cout<<"                   %W - involuntary context switches"<<endl;
+      cout<<"                   %r - minor page faults"<<endl;
+      cout<<"                   %R - major page faults"<<endl;
+      cout<<"                   %y - processor cycles (with --perf-counters, '-' if not counted)"<<endl;
+      cout<<"                   %i - instructions retired"<<endl;
+      cout<<"                   %x - cache misses"<<endl;
+      cout<<"                   %b - branch misses"<<endl;
+      cout<<"                   %a - heap allocations through operator new"<<endl;
+      cout<<"                   %B - bytes allocated"<<endl;
+      cout<<"                   %P - peak bytes allocated and not yet deallocated"<<endl;
       cout<<endl;
       cout<<"                   Default is '%p::%n - %m (%ts)%N(Registered at %f:%l)'."<<endl;
       cout<<endl;
+      cout<<"    --resource-usage - Also report the total CPU time, context switches and page faults of the tests."<<endl;
+      cout<<endl;
+      cout<<"    --allocations - Also report the heap allocations, bytes allocated and peak allocated bytes per suite."<<endl;
+      cout<<endl;
+      cout<<"    --detect-leaks - Fail tests that do not deallocate all memory allocated with operator new by their"<<endl;
+      cout<<"                 set-up, test and tear-down, and report where the leaked blocks were allocated."<<endl;
+      cout<<endl;
+      cout<<"    --max-expect-messages=<n> - Report the messages of at most <n> failed expectations per test (default 100)."<<endl;
+      cout<<"                 Later failures are only counted."<<endl;
+      cout<<endl;
+      cout<<"    --update-golden - Make assert_matches_golden write the output of the tests to the golden files"<<endl;
+      cout<<"                 that are missing or differ, instead of failing."<<endl;
+      cout<<endl;
+      cout<<"    --max-diff-lines=<n> - Show at most <n> lines of the difference between standard containers when"<<endl;
+      cout<<"                 assert_equals fails on them (default 40). 0 turns the difference off."<<endl;
+      cout<<endl;
+      cout<<"    --perf-counters=<events> - Count hardware events of each test and benchmark in user space, and report"<<endl;
+      cout<<"                 the tests with the highest count of the first event. <events> is a comma separated list"<<endl;
+      cout<<"                 of cycles, instructions, cache-misses and branch-misses (default all of them)."<<endl;
+      cout<<"                 Events the kernel does not allow to be counted are skipped with a warning."<<endl;
+      cout<<endl;
+      cout<<"    --instruction-baseline=<file> - Save the user space instructions retired by each passed test in <file>,"<<endl;
+      cout<<"                 keeping the other tests in it. Needs hardware performance counters."<<endl;
+      cout<<"    --instruction-compare=<file>  - Fail tests that retire more instructions than their count in <file>, by more"<<endl;
+      cout<<"                 than --max-instruction-growth (default 1%). Instruction counts hardly depend on the load of"<<endl;
+      cout<<"                 the machine, so this works where time limits are too noisy."<<endl;
+      cout<<endl;
+      cout<<"    --time-resolution=<unit> - Report times in seconds with ms, us or ns precision (default ms)."<<endl;
+      cout<<endl;
+      cout<<"    -j=<n>      - Run the tests on <n> threads (same as --jobs=<n>). The default is 1, i.e. sequential execution."<<endl;
+      cout<<"                  -j=0 uses one thread per online processor. Tests run in parallel must not share"<<endl;
+      cout<<"                  unprotected state. In non-robust mode, the first error stops tests not yet started."<<endl;
+      cout<<endl;
+      cout<<"    --procs=<n> - Run the tests in <n> forked worker processes. A test crashing its worker is reported"<<endl;
+      cout<<"                  as an ERROR, and the worker is replaced. Takes precedence over -j."<<endl;
+      cout<<endl;
+      cout<<"    --recycle-after=<n>  - Replace a worker process after it has run <n> tests (default 0, never)."<<endl;
+      cout<<endl;
+      cout<<"    --max-worker-rss=<mb> - Replace a worker process when its resident memory exceeds <mb> megabytes"<<endl;
+      cout<<"                            (default 0, no limit)."<<endl;
+      cout<<endl;
+      cout<<"    --shard-count=<n> --shard-index=<i>"<<endl;
+      cout<<"                - Partition the tests into <n> shards by a stable hash of their names, and only run"<<endl;
+      cout<<"                  (or list) shard <i>, where 0 <= <i> < <n>. Running every shard runs every test once."<<endl;
+      cout<<endl;
+      cout<<"    --shard-by-suite - Keep all tests of a suite on the same shard."<<endl;
+      cout<<endl;
+      cout<<"    --timing-db=<file> - Record the wall time and set-up time of each test in <file>, keeping a rolling"<<endl;
+      cout<<"                         mean and variance per test across runs. The file is created if missing."<<endl;
+      cout<<endl;
+      cout<<"    --schedule - Order the tests by their mean duration in the --timing-db history: longest first when"<<endl;
+      cout<<"                 running in parallel, shortest first otherwise. Tests without history are estimated by"<<endl;
+      cout<<"                 their suite. Results are reported in the usual order."<<endl;
+      cout<<endl;
+      cout<<"    --last-failed  - Run only the tests that failed in the previous run, or all tests if none of them did."<<endl;
+      cout<<"    --failed-first - Run the tests that failed in the previous run first, then the others."<<endl;
+      cout<<"    --failed-cache=<file> - Where the failures of each run are kept (default .cpunit_lastfailed)."<<endl;
+      cout<<endl;
+      cout<<"    --bench    - Run the benchmarks registered with CPUNIT_BENCH, instead of the tests, and report"<<endl;
+      cout<<"                 the mean, median, standard deviation and MAD of the time per iteration."<<endl;
+      cout<<"                 Benchmarks are selected by the patterns, and always run sequentially."<<endl;
+      cout<<"    --bench-time=<secs>  - Time to spend measuring each benchmark (default 0.5)."<<endl;
+      cout<<"    --bench-samples=<n>  - Number of samples to split the time into (default 10)."<<endl;
+      cout<<"    --bench-baseline=<file> - Save the statistics of the benchmarks in <file>, keeping the other benchmarks in it."<<endl;
+      cout<<"    --bench-compare=<file>  - Fail benchmarks that are slower than their statistics in <file> by more than"<<endl;
+      cout<<"                              --max-regression (default 5%), according to Welch's t-test at 95% confidence."<<endl;
+      cout<<endl;
       cout<<"    <pattern>  - Which tests to run. Supports name globbing with wildcards, e.g. 'SomeScope::*::test_*_OK'"<<endl;
       cout<<"                 Default is '*'."<<endl;
       cout<<endl;
@@ -92,6 +194,7 @@ namespace cpunit {
       cout<<"    ./test_runner -a            -- Try to run all tests, even if there are errors."<<endl;
       cout<<"    ./test_runner -av           -- Run all tests in verbose mode, printing the name of each test just prior to execution."<<endl;
       cout<<"    ./test_runner -af=%e%p::%n  -- Run all tests and display error messages as e.g. 'FAILURE MyTests::test_stuff'."<<endl;
+      cout<<"    ./test_runner -a --jobs=8   -- Run all tests on 8 threads."<<endl;
       cout<<endl;
       cout<<"Experimental options:"<<endl;
       cout<<endl;
@@ -102,22 +205,231 @@ namespace cpunit {
       cout<<"                        are reported as FAILED."<<endl;
       cout<<endl;
       cout<<"                        Default max-time is 1.0e10, i.e. about 317 years."<<endl;
+      cout<<endl;
+      cout<<"    --timeout=<secs> - Interrupt a test that runs for more than <secs> seconds. The stack of the stuck"<<endl;
+      cout<<"                       thread is reported with a TIME GUARD ERROR, and the run is terminated, or, with"<<endl;
+      cout<<"                       --procs, the worker process is replaced and the run continues. Default is 0, no timeout."<<endl;
+      cout<<endl;
+      cout<<"    --clock=<source> - Time tests with 'monotonic' (the default) or 'tsc', the processor time stamp"<<endl;
+      cout<<"                       counter. The counter is cheaper to read, but only used if it is invariant."<<endl;
     }
 
     const std::string error_format_token("-f");
     const std::string robust_token("-a");
     const std::string max_time_token("--max-time");
+    const std::string jobs_token("--jobs");
+    const std::string jobs_short_token("-j");
+    const std::string procs_token("--procs");
+    const std::string recycle_after_token("--recycle-after");
+    const std::string max_worker_rss_token("--max-worker-rss");
+    const std::string shard_index_token("--shard-index");
+    const std::string shard_count_token("--shard-count");
+    const std::string shard_by_suite_token("--shard-by-suite");
+    const std::string timing_db_token("--timing-db");
+    const std::string timeout_token("--timeout");
+    const std::string resource_usage_token("--resource-usage");
+    const std::string schedule_token("--schedule");
+    const std::string last_failed_token("--last-failed");
+    const std::string failed_first_token("--failed-first");
+    const std::string failed_cache_token("--failed-cache");
+    const std::string bench_token("--bench");
+    const std::string bench_time_token("--bench-time");
+    const std::string bench_samples_token("--bench-samples");
+    const std::string bench_baseline_token("--bench-baseline");
+    const std::string bench_compare_token("--bench-compare");
+    const std::string max_regression_token("--max-regression");
+    const std::string clock_token("--clock");
+    const std::string time_resolution_token("--time-resolution");
+    const std::string perf_counters_token("--perf-counters");
+    const std::string allocations_token("--allocations");
+    const std::string detect_leaks_token("--detect-leaks");
+    const std::string max_expect_messages_token("--max-expect-messages");
+    const std::string max_diff_lines_token("--max-diff-lines");
+    const std::string update_golden_token("--update-golden");
+    const std::string instruction_baseline_token("--instruction-baseline");
+    const std::string instruction_compare_token("--instruction-compare");
+    const std::string max_instruction_growth_token("--max-instruction-growth");
+
+    std::size_t get_jobs(const CmdLineParser &parser) {
+      std::size_t jobs = 1;
+      if (parser.has(jobs_token)) {
+	jobs = parser.value_of<std::size_t>(jobs_token);
+      } else if (parser.has(jobs_short_token)) {
+	jobs = parser.value_of<std::size_t>(jobs_short_token);
+      }
+      if (jobs == 0) {
+	jobs = impl::WorkStealingPool::hardware_concurrency();
+      }
+      return jobs;
+    }
+
+    /**
+       Selects the clock and the resolution of reported times. 
+       Unknown values are warned about, and the defaults kept.
+    */
+    void configure_timing(const CmdLineParser &parser) {
+      const std::string clock = parser.value_of<std::string>(clock_token);
+      Clock::Source source = Clock::MONOTONIC;
+      if (clock == "tsc") {
+	source = Clock::TSC;
+      } else if (clock != "monotonic") {
+	std::cerr<<"Unknown "<<clock_token<<" '"<<clock<<"', using monotonic."<<std::endl;
+      }
+      if (!Clock::use(source)) {
+	std::cerr<<"No invariant TSC on this machine, using monotonic."<<std::endl;
+      }
+
+      const std::string unit = parser.value_of<std::string>(time_resolution_token);
+      TimeFormat::Resolution resolution = TimeFormat::MILLISECONDS;
+      if (!TimeFormat::parse_resolution(unit, resolution)) {
+	std::cerr<<"Unknown "<<time_resolution_token<<" '"<<unit<<"', using ms."<<std::endl;
+      }
+      TimeFormat::set_default_resolution(resolution);
+    }
 
     void print_version_info() {
       cout<< "CPUnit version " << CPUNIT_VERSION << "." <<endl;
       cout<< "Get the latest version at https://github.com/offa/CPUnit" << endl;
     }
       
-    bool report_result(const std::vector<cpunit::ExecutionReport> &result, const std::string &format, ostream &out) {
+    /**
+       @return true if instruction counts are to be recorded or compared.
+    */
+    bool uses_instruction_baseline(const CmdLineParser &parser) {
+      return parser.has(instruction_baseline_token) || parser.has(instruction_compare_token);
+    }
+
+    /**
+       Translates the --perf-counters event list, adding the instructions if an 
+       instruction baseline is used, and leaves out the events the machine 
+       cannot count, with a warning.
+       @return The events to count, as a set of PerfCounters::mask_of bits.
+    */
+    unsigned get_perf_events(const CmdLineParser &parser) {
+      unsigned requested = uses_instruction_baseline(parser) ? PerfCounters::mask_of(PerfCounters::INSTRUCTIONS) : 0;
+      if (!parser.has(perf_counters_token) && requested == 0) {
+	return 0;
+      }
+      const std::string names = parser.has(perf_counters_token) ? parser.value_of<std::string>(perf_counters_token) : "instructions";
+      std::size_t end = 0;
+      for (std::size_t pos=0; pos<names.length(); pos = end + 1) {
+	end = names.find(',', pos);
+	if (end == std::string::npos) {
+	  end = names.length();
+	}
+	const std::string name = names.substr(pos, end - pos);
+	PerfCounters::Event e;
+	if (PerfCounters::parse(name, e)) {
+	  requested |= PerfCounters::mask_of(e);
+	} else if (!name.empty()) {
+	  std::cerr<<"Unknown event '"<<name<<"' in "<<perf_counters_token<<", ignoring it."<<std::endl;
+	}
+      }
+      if (names.empty()) {
+	requested = PerfCounters::mask_of(PerfCounters::NUM_EVENTS) - 1;
+      }
+
+      std::string problem;
+      const unsigned supported = impl::PerfEventGroup::probe(requested, problem);
+      if (supported == 0 && requested != 0) {
+	std::cerr<<"Hardware performance counters are not available: "<<problem<<". Running without them."<<std::endl;
+      } else {
+	for (int i=0; i<PerfCounters::NUM_EVENTS; ++i) {
+	  const PerfCounters::Event e = static_cast<PerfCounters::Event>(i);
+	  if ((requested & ~supported & PerfCounters::mask_of(e)) != 0) {
+	    std::cerr<<"Unable to count "<<PerfCounters::name_of(e)<<": "<<problem<<'.'<<std::endl;
+	  }
+	}
+      }
+      return supported;
+    }
+
+    void write_counter(const PerfCounters &c, const PerfCounters::Event e, ostream &out) {
+      out<<std::setw(16);
+      if (c.has(e)) {
+	out<<c.get(e);
+      } else {
+	out<<'-';
+      }
+    }
+
+    /**
+       Writes the counters of the tests with the highest count of the 
+       first of the given events, and the total counts of all tests.
+    */
+    void report_perf_counters(const std::vector<cpunit::ExecutionReport> &result, const unsigned events, ostream &out) {
+      const std::size_t TOP = 10;
+      std::vector<PerfCounters::Event> columns;
+      for (int i=0; i<PerfCounters::NUM_EVENTS; ++i) {
+	if ((events & PerfCounters::mask_of(static_cast<PerfCounters::Event>(i))) != 0) {
+	  columns.push_back(static_cast<PerfCounters::Event>(i));
+	}
+      }
+      if (columns.empty()) {
+	return;
+      }
+      PerfCounters total;
+      std::vector<std::pair<uint64_t, std::size_t> > ranked;
+      for (std::size_t i=0; i<result.size(); ++i) {
+	const PerfCounters &c = result[i].get_perf_counters();
+	total += c;
+	if (c.has(columns[0])) {
+	  ranked.push_back(std::make_pair(c.get(columns[0]), i));
+	}
+      }
+      std::sort(ranked.begin(), ranked.end(), std::greater<std::pair<uint64_t, std::size_t> >());
+      if (ranked.size() > TOP) {
+	ranked.resize(TOP);
+      }
+
+      out<<std::endl<<"Performance counters, by "<<PerfCounters::name_of(columns[0])<<':'<<std::endl;
+      for (std::size_t k=0; k<columns.size(); ++k) {
+	out<<std::setw(16)<<PerfCounters::name_of(columns[k]);
+      }
+      out<<"  Test"<<std::endl;
+      for (std::size_t i=0; i<ranked.size(); ++i) {
+	const cpunit::ExecutionReport &r = result[ranked[i].second];
+	for (std::size_t k=0; k<columns.size(); ++k) {
+	  write_counter(r.get_perf_counters(), columns[k], out);
+	}
+	out<<"  "<<r.get_test().get_path()<<"::"<<r.get_test().get_name()<<std::endl;
+      }
+      for (std::size_t k=0; k<columns.size(); ++k) {
+	write_counter(total, columns[k], out);
+      }
+      out<<"  Total ("<<result.size()<<" tests)"<<std::endl;
+    }
+
+    /**
+       Writes the heap allocations of the tests, summed up per suite.
+       The peak of a suite is the highest peak of its tests.
+    */
+    void report_allocations(const std::vector<cpunit::ExecutionReport> &result, ostream &out) {
+      std::map<std::string, std::pair<std::size_t, AllocationStats> > suites;
+      AllocationStats total;
+      for (std::size_t i=0; i<result.size(); ++i) {
+	std::pair<std::size_t, AllocationStats> &suite = suites[result[i].get_test().get_path()];
+	++suite.first;
+	suite.second += result[i].get_allocation_stats();
+	total += result[i].get_allocation_stats();
+      }
+      out<<std::endl<<"Heap allocations per suite:"<<std::endl;
+      out<<std::setw(8)<<"Tests"<<std::setw(14)<<"Allocations"<<std::setw(16)<<"Bytes"<<std::setw(14)<<"Peak bytes"<<"  Suite"<<std::endl;
+      for (std::map<std::string, std::pair<std::size_t, AllocationStats> >::const_iterator it = suites.begin(); it != suites.end(); ++it) {
+	const AllocationStats &a = it->second.second;
+	out<<std::setw(8)<<it->second.first<<std::setw(14)<<a.get_allocations()<<std::setw(16)<<a.get_bytes();
+	out<<std::setw(14)<<a.get_peak_bytes()<<"  "<<(it->first.empty() ? "<global>" : it->first)<<std::endl;
+      }
+      out<<std::setw(8)<<result.size()<<std::setw(14)<<total.get_allocations()<<std::setw(16)<<total.get_bytes();
+      out<<std::setw(14)<<total.get_peak_bytes()<<"  Total"<<std::endl;
+    }
+
+    bool report_result(const std::vector<cpunit::ExecutionReport> &result, const std::string &format, ostream &out, const bool resource_usage, const bool allocations, const unsigned perf_events) {
       CPUNIT_ITRACE("EntryPoint - Reporting result with error report format '"<<format<<'\'');
       const cpunit::ErrorReportFormat formatter(format);
       int errors = 0;
       double time_spent = 0;
+      ResourceUsage usage;
       for (std::size_t i=0; i<result.size(); i++) {
 	if (result[i].get_execution_result() != cpunit::ExecutionReport::OK) {
 	  CPUNIT_DTRACE("EntryPoint - Reporting error for "<<result[i].get_test().to_string());
@@ -125,8 +437,18 @@ namespace cpunit {
 	  errors++;
 	}
 	time_spent += result[i].get_time_spent();
+	usage += result[i].get_resource_usage();
       }
       out<<std::endl<<"Time: "<<std::setprecision(3)<<cpunit::TimeFormat(time_spent)<<std::endl;
+      if (resource_usage) {
+	out<<"CPU time: "<<cpunit::TimeFormat(usage.get_cpu_time());
+	out<<"  Context switches: "<<usage.get_voluntary_switches()<<" voluntary, "<<usage.get_involuntary_switches()<<" involuntary";
+	out<<"  Page faults: "<<usage.get_minor_faults()<<" minor, "<<usage.get_major_faults()<<" major"<<std::endl;
+      }
+      if (allocations) {
+	report_allocations(result, out);
+      }
+      report_perf_counters(result, perf_events, out);
       out<<std::endl;
       if (errors == 0) {
 	out<<"OK ("<<result.size()<<" tests)"<<std::endl;
@@ -136,11 +458,97 @@ namespace cpunit {
       return errors == 0;
     }
 
-    void list_tests(const std::vector<std::string> &patterns) {
+    /**
+       @param parser The command line.
+       @param token  The option to read.
+       @param n      Receives the value of the option.
+       @return true if the value is a plain, non-negative number.
+    */
+    bool read_shard_number(const CmdLineParser &parser, const std::string &token, std::size_t &n) {
+      const std::string value = parser.value_of<std::string>(token);
+      if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+	return false;
+      }
+      std::istringstream iss(value);
+      return static_cast<bool>(iss>>n);
+    }
+
+    /**
+       Checks --shard-index and --shard-count, and reports a usage error if they 
+       do not pick one of the shards.
+       @return true if 0 <= index < count.
+    */
+    bool check_shard(const CmdLineParser &parser) {
+      std::size_t index = 0;
+      std::size_t count = 0;
+      if (read_shard_number(parser, shard_index_token, index) && 
+	  read_shard_number(parser, shard_count_token, count) && 
+	  index < count) {
+	return true;
+      }
+      std::cerr<<"Illegal "<<shard_index_token<<" '"<<parser.value_of<std::string>(shard_index_token)
+	       <<"' and "<<shard_count_token<<" '"<<parser.value_of<std::string>(shard_count_token)
+	       <<"'. The count must be at least 1, and the index in [0, count)."<<std::endl;
+      return false;
+    }
+
+    ShardFilter get_shard_filter(const CmdLineParser &parser) {
+      return ShardFilter(parser.value_of<std::size_t>(shard_index_token),
+			 parser.value_of<std::size_t>(shard_count_token),
+			 parser.has(shard_by_suite_token));
+    }
+
+    /**
+       @return The timing database given by --timing-db, or NULL if there is none,
+               or it cannot be loaded.
+    */
+    std::auto_ptr<TimingDatabase> load_timing_db(const CmdLineParser &parser) {
+      std::auto_ptr<TimingDatabase> result;
+      if (parser.has(timing_db_token)) {
+	const std::string path = parser.value_of<std::string>(timing_db_token);
+	try {
+	  result.reset(new TimingDatabase(path));
+	} catch (CPUnitException &e) {
+	  std::cerr<<"Not recording timings: "<<e.what()<<std::endl;
+	}
+      }
+      return result;
+    }
+
+    void save_timing_db(TimingDatabase &db, const std::vector<ExecutionReport> &result) {
+      try {
+	db.record(result);
+	db.save();
+      } catch (CPUnitException &e) {
+	std::cerr<<"Unable to save timings: "<<e.what()<<std::endl;
+      }
+    }
+
+    /**
+       Stores the failures of this run for the next one. Failing to do so 
+       is only worth a warning if the cache is actually in use.
+    */
+    void save_failure_cache(FailureCache &cache, const CmdLineParser &parser) {
+      try {
+	cache.save();
+      } catch (CPUnitException &e) {
+	if (parser.has(last_failed_token) || parser.has(failed_first_token)) {
+	  std::cerr<<"Unable to save failed tests: "<<e.what()<<std::endl;
+	}
+      }
+    }
+
+    void list_tests(const std::vector<std::string> &patterns, const ShardFilter &shard, const bool benchmarks) {
       std::vector<cpunit::RegInfo> tests;
       for (std::size_t i=0; i<patterns.size(); i++) {
-	std::vector<cpunit::RegInfo> p_tests = cpunit::TestStore::get_instance().get_tests(patterns[i]);
-	tests.insert(tests.end(), p_tests.begin(), p_tests.end());
+	std::vector<cpunit::RegInfo> p_tests = benchmarks 
+	  ? cpunit::TestStore::get_instance().get_benchmarks(patterns[i])
+	  : cpunit::TestStore::get_instance().get_tests(patterns[i]);
+	for (std::size_t j=0; j<p_tests.size(); j++) {
+	  if (shard.accepts(p_tests[j])) {
+	    tests.push_back(p_tests[j]);
+	  }
+	}
       }
       for (std::size_t i=0; i<tests.size(); i++) {
 	std::cout<<tests[i].get_path()<<"::"<<tests[i].get_name()<<std::endl;
@@ -148,6 +556,168 @@ namespace cpunit {
       std::cout<<tests.size()<<" tests in total."<<std::endl;
     }
 
+    /**
+       Gives the benchmarks matching the patterns the settings of the command line.
+    */
+    void configure_benchmarks(const std::vector<std::string> &patterns, const BenchmarkCall::Settings &settings) {
+      for (std::size_t i=0; i<patterns.size(); i++) {
+	std::vector<TestUnit> units = cpunit::TestStore::get_instance().get_benchmark_units(patterns[i]);
+	for (std::size_t j=0; j<units.size(); j++) {
+	  BenchmarkCall *bench = dynamic_cast<BenchmarkCall*>(units[j].get_test());
+	  if (bench != NULL) {
+	    bench->set_settings(settings);
+	  }
+	}
+      }
+    }
+
+    /**
+       @return The benchmarks matching the patterns that ran to completion.
+    */
+    std::vector<const BenchmarkCall*> measured_benchmarks(const std::vector<std::string> &patterns) {
+      std::vector<const BenchmarkCall*> result;
+      for (std::size_t i=0; i<patterns.size(); i++) {
+	std::vector<TestUnit> units = cpunit::TestStore::get_instance().get_benchmark_units(patterns[i]);
+	for (std::size_t j=0; j<units.size(); j++) {
+	  const BenchmarkCall *bench = dynamic_cast<const BenchmarkCall*>(units[j].get_test());
+	  if (bench != NULL && bench->has_result()) {
+	    result.push_back(bench);
+	  }
+	}
+      }
+      return result;
+    }
+
+    void report_benchmarks(const std::vector<const BenchmarkCall*> &benchmarks, ostream &out) {
+      out<<std::endl<<std::left<<std::setw(48)<<"Benchmark"<<std::right<<std::setw(12)<<"Iterations";
+      out<<std::setw(12)<<"Mean"<<std::setw(12)<<"Median"<<std::setw(12)<<"Stddev"<<std::setw(12)<<"MAD"<<std::endl;
+      for (std::size_t i=0; i<benchmarks.size(); i++) {
+	const std::vector<BenchmarkCall::Measurement> &ms = benchmarks[i]->get_measurements();
+	for (std::size_t j=0; j<ms.size(); j++) {
+	  const BenchStatistics &stats = ms[j].statistics;
+	  const RegInfo ri = benchmarks[i]->get_measurement_info(j);
+	  out<<std::left<<std::setw(48)<<(ri.get_path() + "::" + ri.get_name())<<std::right<<std::setw(12)<<ms[j].iterations;
+	  out<<std::setw(12)<<BenchStatistics::format(stats.get_mean());
+	  out<<std::setw(12)<<BenchStatistics::format(stats.get_median());
+	  out<<std::setw(12)<<BenchStatistics::format(stats.get_stddev());
+	  out<<std::setw(12)<<BenchStatistics::format(stats.get_mad())<<std::endl;
+	}
+	if (benchmarks[i]->has_fit()) {
+	  const RegInfo &ri = benchmarks[i]->get_reg_info();
+	  const ComplexityFit &fit = benchmarks[i]->get_fit();
+	  out<<std::left<<std::setw(48)<<(ri.get_path() + "::" + ri.get_name() + "/BigO")<<std::right;
+	  out<<std::setw(24)<<ComplexityFit::to_string(fit.get_complexity());
+	  std::ostringstream rms;
+	  rms<<std::fixed<<std::setprecision(1)<<(100 * fit.get_rms())<<'%';
+	  out<<std::setw(12)<<"RMS"<<std::setw(12)<<rms.str()<<std::endl;
+	}
+      }
+    }
+
+    /**
+       @param token    The option to read.
+       @param fallback The value to use if the option is illegal.
+       @return The value of the option as a fraction. Accepts both '5%' and '0.05'.
+    */
+    double get_fraction(const CmdLineParser &parser, const std::string &token, const double fallback) {
+      std::string value = parser.value_of<std::string>(token);
+      const bool percent = !value.empty() && value[value.length() - 1] == '%';
+      if (percent) {
+	value.erase(value.length() - 1);
+      }
+      std::istringstream in(value);
+      double result = 0;
+      if (!(in>>result) || result < 0) {
+	std::cerr<<"Illegal "<<token<<" '"<<parser.value_of<std::string>(token)<<"', using "<<(100 * fallback)<<"%."<<std::endl;
+	return fallback;
+      }
+      return percent ? result / 100 : result;
+    }
+
+    /**
+       @return The baseline given by --bench-compare, or NULL if there is none,
+               or it cannot be read.
+    */
+    std::auto_ptr<BenchBaseline> load_bench_reference(const CmdLineParser &parser) {
+      std::auto_ptr<BenchBaseline> result;
+      if (parser.has(bench_compare_token)) {
+	result.reset(new BenchBaseline(parser.value_of<std::string>(bench_compare_token)));
+	try {
+	  result->load();
+	} catch (CPUnitException &e) {
+	  std::cerr<<"Not comparing benchmarks: "<<e.what()<<std::endl;
+	  result.reset();
+	}
+      }
+      return result;
+    }
+
+    /**
+       Adds the measured benchmarks to the --bench-baseline file, keeping
+       the benchmarks of the file that did not run.
+    */
+    void save_bench_baseline(const CmdLineParser &parser, const std::vector<const BenchmarkCall*> &benchmarks) {
+      BenchBaseline baseline(parser.value_of<std::string>(bench_baseline_token));
+      try {
+	baseline.load();
+      } catch (CPUnitException &) {
+	CPUNIT_ITRACE("EntryPoint - Creating the benchmark baseline "<<baseline.get_file_name());
+      }
+      for (std::size_t i=0; i<benchmarks.size(); i++) {
+	const std::vector<BenchmarkCall::Measurement> &ms = benchmarks[i]->get_measurements();
+	for (std::size_t j=0; j<ms.size(); j++) {
+	  baseline.record(benchmarks[i]->get_measurement_info(j), ms[j].statistics);
+	}
+      }
+      try {
+	baseline.save();
+      } catch (CPUnitException &e) {
+	std::cerr<<"Unable to save the benchmark baseline: "<<e.what()<<std::endl;
+      }
+    }
+
+    /**
+       @return The baseline given by --instruction-compare, or NULL if there is none,
+               or it cannot be read.
+    */
+    std::auto_ptr<InstructionBaseline> load_instruction_reference(const CmdLineParser &parser) {
+      std::auto_ptr<InstructionBaseline> result;
+      if (parser.has(instruction_compare_token)) {
+	result.reset(new InstructionBaseline(parser.value_of<std::string>(instruction_compare_token)));
+	try {
+	  result->load();
+	} catch (CPUnitException &e) {
+	  std::cerr<<"Not comparing instruction counts: "<<e.what()<<std::endl;
+	  result.reset();
+	}
+      }
+      return result;
+    }
+
+    /**
+       Adds the instruction counts of the passed tests to the --instruction-baseline 
+       file, keeping the tests of the file that did not run or failed.
+    */
+    void save_instruction_baseline(const CmdLineParser &parser, const std::vector<ExecutionReport> &result) {
+      InstructionBaseline baseline(parser.value_of<std::string>(instruction_baseline_token));
+      try {
+	baseline.load();
+      } catch (CPUnitException &) {
+	CPUNIT_ITRACE("EntryPoint - Creating the instruction baseline "<<baseline.get_file_name());
+      }
+      for (std::size_t i=0; i<result.size(); i++) {
+	const PerfCounters &c = result[i].get_perf_counters();
+	if (result[i].get_execution_result() == ExecutionReport::OK && c.has(PerfCounters::INSTRUCTIONS)) {
+	  baseline.record(result[i].get_test(), c.get(PerfCounters::INSTRUCTIONS));
+	}
+      }
+      try {
+	baseline.save();
+      } catch (CPUnitException &e) {
+	std::cerr<<"Unable to save the instruction baseline: "<<e.what()<<std::endl;
+      }
+    }
+
     /**
        Offers objects objects in which you can register function pointers
        with signature "void foo()", which will be called from the destructor
@@ -198,10 +768,25 @@ namespace cpunit {
    */
   CmdLineParser get_cmd_line_parser() {
     CmdLineParser parser;
-    parser.add_legal("-h --help -L --list -v --verbose -V --version -a --all -f --max-time");
+    parser.add_legal("-h --help -L --list -v --verbose -V --version -a --all -f --max-time -j --jobs --procs --recycle-after --max-worker-rss --shard-index --shard-count --shard-by-suite --timing-db --schedule --last-failed --failed-first --failed-cache --timeout --resource-usage --allocations --detect-leaks --max-expect-messages --max-diff-lines --update-golden --clock --time-resolution --perf-counters --instruction-baseline --instruction-compare --max-instruction-growth --bench --bench-time --bench-samples --bench-baseline --bench-compare --max-regression");
     const char *defaults[] = {
       "-f=%p::%n - %m (%ts)%N(Registered at %f:%l)",
       "--max-time=1e+10",
+      "--procs=0",
+      "--recycle-after=0",
+      "--max-worker-rss=0",
+      "--max-expect-messages=100",
+      "--max-diff-lines=40",
+      "--shard-index=0",
+      "--shard-count=1",
+      "--failed-cache=.cpunit_lastfailed",
+      "--timeout=0",
+      "--bench-time=0.5",
+      "--bench-samples=10",
+      "--max-regression=5%",
+      "--max-instruction-growth=1%",
+      "--clock=monotonic",
+      "--time-resolution=ms",
     };
     const int argc = sizeof(defaults)/sizeof(char*);
     parser.parse(argc, defaults);
@@ -240,6 +825,8 @@ namespace cpunit {
     afc.insert(cpunit::StringFlyweightStore::dispose);
     afc.insert(cpunit::impl::BootStream::dispose);
 
+    std::auto_ptr<FailureCache> failures;
+
     try {
       CPUNIT_ITRACE("EntryPoint - Actual arguments:"<<parser.to_string());
 
@@ -252,8 +839,11 @@ namespace cpunit {
 	usage();
 	return 0;
       }
+      if (!check_shard(parser)) {
+	return 1;
+      }
       if(parser.has_one_of("-L --list")) {
-	list_tests(patterns);
+	list_tests(patterns, get_shard_filter(parser), parser.has(bench_token));
 	return 0;
       }
       if(parser.has_one_of("-V --version")) {
@@ -261,15 +851,102 @@ namespace cpunit {
 	return 0;
       }
       
+      configure_timing(parser);
+      if (parser.has(detect_leaks_token) && !AllocationTracker::set_leak_detection(true)) {
+	std::cerr<<"Ignoring "<<detect_leaks_token<<", since the test program is not linked with -lCPUnitAllocationHooks."<<std::endl;
+      }
+      if (parser.has(allocations_token) && !AllocationTracker::is_enabled()) {
+	std::cerr<<"The heap allocations are all zero, since the test program is not linked with -lCPUnitAllocationHooks."<<std::endl;
+      }
+      ExpectationScope::set_default_max_messages(parser.value_of<std::size_t>(max_expect_messages_token));
+      impl::Diff::set_default_max_lines(parser.value_of<std::size_t>(max_diff_lines_token));
+      GoldenFiles::set_update(parser.has(update_golden_token));
+
       const bool verbose = parser.has("-v") || parser.has("--verbose");
       const bool robust  = parser.has("-a") || parser.has("--all");
       
       CPUNIT_ITRACE("EntryPoint - verbose="<<verbose<<" robust="<<robust);
       
       const std::string report_format = parser.value_of<std::string>(error_format_token);
-      const double max_time = parser.value_of<double>(max_time_token);
-      const std::vector<cpunit::ExecutionReport> result = cpunit::TestExecutionFacade().execute(patterns, max_time, verbose, robust);
-      bool all_well = report_result(result, report_format, std::cout);
+      ExecutionOptions options;
+      options.set_max_time(parser.value_of<double>(max_time_token));
+      options.set_timeout(parser.value_of<double>(timeout_token));
+      options.set_verbose(verbose);
+      options.set_robust(robust);
+      options.set_jobs(get_jobs(parser));
+      options.set_procs(parser.value_of<std::size_t>(procs_token));
+      options.set_recycle_after(parser.value_of<std::size_t>(recycle_after_token));
+      options.set_max_worker_rss(parser.value_of<std::size_t>(max_worker_rss_token));
+      options.set_shard(parser.value_of<std::size_t>(shard_index_token),
+			parser.value_of<std::size_t>(shard_count_token),
+			parser.has(shard_by_suite_token));
+      options.set_perf_events(get_perf_events(parser));
+
+      if (parser.has(bench_token)) {
+	if (options.get_jobs() > 1 || options.get_procs() > 0) {
+	  std::cerr<<"Benchmarks are run sequentially, ignoring -j and --procs."<<std::endl;
+	}
+	options.set_benchmarks(true);
+	const std::auto_ptr<BenchBaseline> reference = load_bench_reference(parser);
+	BenchmarkCall::Settings settings(parser.value_of<double>(bench_time_token), 
+					 parser.value_of<std::size_t>(bench_samples_token),
+					 reference.get(),
+					 get_fraction(parser, max_regression_token, 0.05));
+	configure_benchmarks(patterns, settings);
+	const std::vector<cpunit::ExecutionReport> result = cpunit::TestExecutionFacade().execute(patterns, options);
+	// The reference goes out of scope with this block.
+	settings.baseline = NULL;
+	configure_benchmarks(patterns, settings);
+	const std::vector<const BenchmarkCall*> measured = measured_benchmarks(patterns);
+	report_benchmarks(measured, std::cout);
+	if (parser.has(bench_baseline_token)) {
+	  save_bench_baseline(parser, measured);
+	}
+	return report_result(result, report_format, std::cout, parser.has(resource_usage_token), parser.has(allocations_token), parser.has(perf_counters_token) ? options.get_perf_events() : 0) ? 0 : 1;
+      }
+
+      failures.reset(new FailureCache(parser.value_of<std::string>(failed_cache_token)));
+      if (parser.has(last_failed_token)) {
+	options.set_rerun(failures.get(), ExecutionOptions::LAST_FAILED);
+      } else if (parser.has(failed_first_token)) {
+	options.set_rerun(failures.get(), ExecutionOptions::FAILED_FIRST);
+      }
+
+      std::auto_ptr<TimingDatabase> timing_db = load_timing_db(parser);
+      if (parser.has(schedule_token)) {
+	if (timing_db.get() != NULL) {
+	  options.set_schedule_db(timing_db.get());
+	} else {
+	  std::cerr<<"Ignoring "<<schedule_token<<", which needs "<<timing_db_token<<'.'<<std::endl;
+	}
+      }
+
+      bool count_instructions = uses_instruction_baseline(parser);
+      if (count_instructions && (options.get_perf_events() & PerfCounters::mask_of(PerfCounters::INSTRUCTIONS)) == 0) {
+	std::cerr<<"Ignoring "<<instruction_baseline_token<<" and "<<instruction_compare_token<<", which need instructions to be counted."<<std::endl;
+	count_instructions = false;
+      }
+      std::auto_ptr<InstructionBaseline> instruction_reference;
+      if (count_instructions) {
+	instruction_reference = load_instruction_reference(parser);
+      }
+
+      std::vector<cpunit::ExecutionReport> result = cpunit::TestExecutionFacade().execute(patterns, options);
+      if (instruction_reference.get() != NULL) {
+	const double max_growth = get_fraction(parser, max_instruction_growth_token, 0.01);
+	for (std::size_t i=0; i<result.size(); i++) {
+	  result[i] = instruction_reference->check(result[i], max_growth);
+	}
+      }
+      if (count_instructions && parser.has(instruction_baseline_token)) {
+	save_instruction_baseline(parser, result);
+      }
+      if (timing_db.get() != NULL) {
+	save_timing_db(*timing_db, result);
+      }
+      failures->update(result);
+      save_failure_cache(*failures, parser);
+      bool all_well = report_result(result, report_format, std::cout, parser.has(resource_usage_token), parser.has(allocations_token), parser.has(perf_counters_token) ? options.get_perf_events() : 0);
       
       int exit_value = 0;
       if (!all_well) {
@@ -277,6 +954,10 @@ namespace cpunit {
       }
       return exit_value;
     } catch (AssertionException &e) {
+      if (failures.get() != NULL && e.get_test() != NULL) {
+	failures->add(*e.get_test());
+	save_failure_cache(*failures, parser);
+      }
       std::cout<<"Terminated due to AssertionException: "<<std::endl<<e.what()<<std::endl;
       return 1;
     } catch (const char* msg) {
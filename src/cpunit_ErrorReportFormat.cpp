@@ -36,6 +36,23 @@
 
 #include <sstream>
 
+namespace {
+  std::string to_string(const long n) {
+    std::ostringstream oss;
+    oss<<n;
+    return oss.str();
+  }
+
+  std::string to_string(const cpunit::PerfCounters &c, const cpunit::PerfCounters::Event e) {
+    if (!c.has(e)) {
+      return "-";
+    }
+    std::ostringstream oss;
+    oss<<c.get(e);
+    return oss.str();
+  }
+}
+
 cpunit::ErrorReportFormat::ErrorReportFormat()
 {}
 
@@ -91,6 +108,30 @@ cpunit::ErrorReportFormat::format(const ExecutionReport &r, const Fragment f) co
     return "\n";
   case TABULATOR:
     return "\t";
+  case CPU_TIME:
+    return TimeFormat(r.get_resource_usage().get_cpu_time()).get_formatted_time();
+  case VOLUNTARY_SWITCHES:
+    return to_string(r.get_resource_usage().get_voluntary_switches());
+  case INVOLUNTARY_SWITCHES:
+    return to_string(r.get_resource_usage().get_involuntary_switches());
+  case MINOR_FAULTS:
+    return to_string(r.get_resource_usage().get_minor_faults());
+  case MAJOR_FAULTS:
+    return to_string(r.get_resource_usage().get_major_faults());
+  case CYCLES:
+    return to_string(r.get_perf_counters(), PerfCounters::CYCLES);
+  case INSTRUCTIONS:
+    return to_string(r.get_perf_counters(), PerfCounters::INSTRUCTIONS);
+  case CACHE_MISSES:
+    return to_string(r.get_perf_counters(), PerfCounters::CACHE_MISSES);
+  case BRANCH_MISSES:
+    return to_string(r.get_perf_counters(), PerfCounters::BRANCH_MISSES);
+  case ALLOCATIONS:
+    return to_string(static_cast<long>(r.get_allocation_stats().get_allocations()));
+  case ALLOCATED_BYTES:
+    return to_string(static_cast<long>(r.get_allocation_stats().get_bytes()));
+  case PEAK_BYTES:
+    return to_string(static_cast<long>(r.get_allocation_stats().get_peak_bytes()));
   default:
     throw "Unknown fragment type."; 
   }
@@ -147,9 +188,45 @@ cpunit::ErrorReportFormat::handle_fragment_identifier(const char c) {
   case 'T':
     fragments.push_back(TABULATOR);
     break;
+  case 'c':
+    fragments.push_back(CPU_TIME);
+    break;
+  case 'w':
+    fragments.push_back(VOLUNTARY_SWITCHES);
+    break;
+  case 'W':
+    fragments.push_back(INVOLUNTARY_SWITCHES);
+    break;
+  case 'r':
+    fragments.push_back(MINOR_FAULTS);
+    break;
+  case 'R':
+    fragments.push_back(MAJOR_FAULTS);
+    break;
+  case 'y':
+    fragments.push_back(CYCLES);
+    break;
+  case 'i':
+    fragments.push_back(INSTRUCTIONS);
+    break;
+  case 'x':
+    fragments.push_back(CACHE_MISSES);
+    break;
+  case 'b':
+    fragments.push_back(BRANCH_MISSES);
+    break;
+  case 'a':
+    fragments.push_back(ALLOCATIONS);
+    break;
+  case 'B':
+    fragments.push_back(ALLOCATED_BYTES);
+    break;
+  case 'P':
+    fragments.push_back(PEAK_BYTES);
+    break;
   default:
     std::ostringstream oss;
-    oss<<"Unknown flag in error format: '%"<<c<<"', must be one of [p n f l m e t N T].";
+    oss<<"Unknown flag in error format: '%"<<c<<"', must be one of [p n f l m e t N T c w W r R y i x b a B P].";
     throw WrongSetupException(oss.str());
   }
 }
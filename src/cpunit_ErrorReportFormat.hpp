@@ -48,7 +48,19 @@ namespace cpunit {
       MESSAGE,
       ERROR_TYPE,
       NEWLINE,
-      TABULATOR
+      TABULATOR,
+      CPU_TIME,
+      VOLUNTARY_SWITCHES,
+      INVOLUNTARY_SWITCHES,
+      MINOR_FAULTS,
+      MAJOR_FAULTS,
+      CYCLES,
+      INSTRUCTIONS,
+      CACHE_MISSES,
+      BRANCH_MISSES,
+      ALLOCATIONS,
+      ALLOCATED_BYTES,
+      PEAK_BYTES
     };
 
     // invariant: msg_parts.size() == fragments.size() + 1
@@ -0,0 +1,308 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cpunit_ExecutionOptions.hpp"
+
+cpunit::ExecutionOptions::ExecutionOptions() :
+  max_time(1e+10),
+  timeout(0),
+  verbose(false),
+  robust(false),
+  jobs(1),
+  procs(0),
+  recycle_after(0),
+  max_worker_rss(0),
+  shard_index(0),
+  shard_count(1),
+  shard_by_suite(false),
+  schedule_db(NULL),
+  failure_cache(NULL),
+  rerun_mode(RUN_ALL),
+  benchmarks(false),
+  perf_events(0)
+{}
+
+cpunit::ExecutionOptions::ExecutionOptions(const ExecutionOptions &o) :
+  max_time(o.max_time),
+  timeout(o.timeout),
+  verbose(o.verbose),
+  robust(o.robust),
+  jobs(o.jobs),
+  procs(o.procs),
+  recycle_after(o.recycle_after),
+  max_worker_rss(o.max_worker_rss),
+  shard_index(o.shard_index),
+  shard_count(o.shard_count),
+  shard_by_suite(o.shard_by_suite),
+  schedule_db(o.schedule_db),
+  failure_cache(o.failure_cache),
+  rerun_mode(o.rerun_mode),
+  benchmarks(o.benchmarks),
+  perf_events(o.perf_events)
+{}
+
+cpunit::ExecutionOptions::~ExecutionOptions()
+{}
+
+cpunit::ExecutionOptions&
+cpunit::ExecutionOptions::operator = (const ExecutionOptions &o) {
+  if (&o != this) {
+    max_time = o.max_time;
+    timeout = o.timeout;
+    verbose = o.verbose;
+    robust = o.robust;
+    jobs = o.jobs;
+    procs = o.procs;
+    recycle_after = o.recycle_after;
+    max_worker_rss = o.max_worker_rss;
+    shard_index = o.shard_index;
+    shard_count = o.shard_count;
+    shard_by_suite = o.shard_by_suite;
+    schedule_db = o.schedule_db;
+    failure_cache = o.failure_cache;
+    rerun_mode = o.rerun_mode;
+    benchmarks = o.benchmarks;
+    perf_events = o.perf_events;
+  }
+  return *this;
+}
+
+/**
+   @return The maximal legal running time for a single test, in seconds.
+ */
+double
+cpunit::ExecutionOptions::get_max_time() const {
+  return max_time;
+}
+
+void
+cpunit::ExecutionOptions::set_max_time(const double t) {
+  max_time = t;
+}
+
+bool
+cpunit::ExecutionOptions::is_verbose() const {
+  return verbose;
+}
+
+void
+cpunit::ExecutionOptions::set_verbose(const bool v) {
+  verbose = v;
+}
+
+/**
+   @return true if all tests are to be run, false if execution
+           is to stop at the first failing test.
+ */
+bool
+cpunit::ExecutionOptions::is_robust() const {
+  return robust;
+}
+
+void
+cpunit::ExecutionOptions::set_robust(const bool r) {
+  robust = r;
+}
+
+/**
+   @return The number of threads to execute tests on.
+           1 means sequential execution on the calling thread.
+ */
+std::size_t
+cpunit::ExecutionOptions::get_jobs() const {
+  return jobs;
+}
+
+void
+cpunit::ExecutionOptions::set_jobs(const std::size_t j) {
+  jobs = j;
+}
+
+/**
+   @return The number of worker processes to execute tests in.
+           0 means that tests are executed in-process.
+           Takes precedence over get_jobs.
+ */
+std::size_t
+cpunit::ExecutionOptions::get_procs() const {
+  return procs;
+}
+
+void
+cpunit::ExecutionOptions::set_procs(const std::size_t p) {
+  procs = p;
+}
+
+/**
+   @return The number of tests a worker process executes before
+           it is replaced by a fresh one, 0 for never.
+ */
+std::size_t
+cpunit::ExecutionOptions::get_recycle_after() const {
+  return recycle_after;
+}
+
+void
+cpunit::ExecutionOptions::set_recycle_after(const std::size_t n) {
+  recycle_after = n;
+}
+
+/**
+   @return The resident memory, in megabytes, above which a worker
+           process is replaced after its current test, 0 for no limit.
+ */
+std::size_t
+cpunit::ExecutionOptions::get_max_worker_rss() const {
+  return max_worker_rss;
+}
+
+void
+cpunit::ExecutionOptions::set_max_worker_rss(const std::size_t mb) {
+  max_worker_rss = mb;
+}
+
+/**
+   @return The shard of the tests to execute, in the range [0, get_shard_count()).
+   @see ShardFilter
+ */
+std::size_t
+cpunit::ExecutionOptions::get_shard_index() const {
+  return shard_index;
+}
+
+/**
+   @return The number of shards the tests are partitioned into. 1 means no sharding.
+ */
+std::size_t
+cpunit::ExecutionOptions::get_shard_count() const {
+  return shard_count;
+}
+
+/**
+   @return true if whole suites are kept on one shard.
+ */
+bool
+cpunit::ExecutionOptions::is_shard_by_suite() const {
+  return shard_by_suite;
+}
+
+void
+cpunit::ExecutionOptions::set_shard(const std::size_t index, const std::size_t count, const bool by_suite) {
+  shard_index = index;
+  shard_count = count;
+  shard_by_suite = by_suite;
+}
+
+/**
+   @return The timing history to order the tests by, or NULL to execute
+           the tests in registration order.
+ */
+const cpunit::TimingDatabase*
+cpunit::ExecutionOptions::get_schedule_db() const {
+  return schedule_db;
+}
+
+/**
+   Makes the tests execute longest first when run in parallel, so that
+   long tests do not start last, and shortest first when run sequentially,
+   to report failures early. The reports are in registration order regardless.
+   @param db The timing history to estimate the durations from. It is not
+             copied, and must outlive the execution.
+ */
+void
+cpunit::ExecutionOptions::set_schedule_db(const TimingDatabase *db) {
+  schedule_db = db;
+}
+
+/**
+   @return The failures of the previous run, or NULL if there is none.
+ */
+const cpunit::FailureCache*
+cpunit::ExecutionOptions::get_failure_cache() const {
+  return failure_cache;
+}
+
+cpunit::ExecutionOptions::RerunMode
+cpunit::ExecutionOptions::get_rerun_mode() const {
+  return rerun_mode;
+}
+
+/**
+   @param cache The failures of the previous run. It is not copied, 
+                and must outlive the execution.
+   @param mode  How to make use of the failures.
+ */
+void
+cpunit::ExecutionOptions::set_rerun(const FailureCache *cache, const RerunMode mode) {
+  failure_cache = cache;
+  rerun_mode = mode;
+}
+
+/**
+   @return The number of seconds after which a running test is interrupted, 
+           or 0 if tests may run forever. Unlike max-time, the timeout is 
+           enforced while the test is running.
+ */
+double
+cpunit::ExecutionOptions::get_timeout() const {
+  return timeout;
+}
+
+void
+cpunit::ExecutionOptions::set_timeout(const double t) {
+  timeout = t;
+}
+
+/**
+   @return true if the benchmarks, rather than the tests, are to be run.
+           Benchmarks are always run sequentially.
+ */
+bool
+cpunit::ExecutionOptions::is_benchmarks() const {
+  return benchmarks;
+}
+
+void
+cpunit::ExecutionOptions::set_benchmarks(const bool b) {
+  benchmarks = b;
+}
+
+/**
+   @return The hardware performance counters to read around each test,
+           as a set of PerfCounters::mask_of bits. 0 means none.
+ */
+unsigned
+cpunit::ExecutionOptions::get_perf_events() const {
+  return perf_events;
+}
+
+void
+cpunit::ExecutionOptions::set_perf_events(const unsigned events) {
+  perf_events = events;
+}
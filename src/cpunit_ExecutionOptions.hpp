@@ -0,0 +1,126 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CPUNIT_EXECUTIONOPTIONS_HPP
+#define CPUNIT_EXECUTIONOPTIONS_HPP
+
+#include <cstddef>
+
+namespace cpunit {
+
+  class FailureCache;
+  class TimingDatabase;
+
+  /**
+     Holds the settings controlling how the TestExecutionFacade
+     executes the selected tests. A default constructed object
+     gives the classic behaviour: sequential execution, stopping
+     on the first error, and no time limit worth mentioning.
+   */
+  class ExecutionOptions {
+  public:
+
+    /**
+       How to make use of the failures of the previous run.
+     */
+    enum RerunMode {
+      RUN_ALL,          // Ignore the previous failures
+      LAST_FAILED,      // Run only the tests that failed
+      FAILED_FIRST      // Run the tests that failed before the others
+    };
+
+  private:
+    double max_time;
+    double timeout;
+    bool verbose;
+    bool robust;
+    std::size_t jobs;
+    std::size_t procs;
+    std::size_t recycle_after;
+    std::size_t max_worker_rss;
+    std::size_t shard_index;
+    std::size_t shard_count;
+    bool shard_by_suite;
+    const TimingDatabase *schedule_db;
+    const FailureCache *failure_cache;
+    RerunMode rerun_mode;
+    bool benchmarks;
+    unsigned perf_events;
+  public:
+    ExecutionOptions();
+    ExecutionOptions(const ExecutionOptions &o);
+    virtual ~ExecutionOptions();
+    ExecutionOptions& operator = (const ExecutionOptions &o);
+
+    double get_max_time() const;
+    void set_max_time(const double t);
+
+    double get_timeout() const;
+    void set_timeout(const double t);
+
+    bool is_verbose() const;
+    void set_verbose(const bool v);
+
+    bool is_robust() const;
+    void set_robust(const bool r);
+
+    std::size_t get_jobs() const;
+    void set_jobs(const std::size_t j);
+
+    std::size_t get_procs() const;
+    void set_procs(const std::size_t p);
+
+    std::size_t get_recycle_after() const;
+    void set_recycle_after(const std::size_t n);
+
+    std::size_t get_max_worker_rss() const;
+    void set_max_worker_rss(const std::size_t mb);
+
+    std::size_t get_shard_index() const;
+    std::size_t get_shard_count() const;
+    bool is_shard_by_suite() const;
+    void set_shard(const std::size_t index, const std::size_t count, const bool by_suite);
+
+    const TimingDatabase* get_schedule_db() const;
+    void set_schedule_db(const TimingDatabase *db);
+
+    const FailureCache* get_failure_cache() const;
+    RerunMode get_rerun_mode() const;
+    void set_rerun(const FailureCache *cache, const RerunMode mode);
+
+    bool is_benchmarks() const;
+    void set_benchmarks(const bool b);
+
+    unsigned get_perf_events() const;
+    void set_perf_events(const unsigned events);
+  };
+
+}
+
+#endif // CPUNIT_EXECUTIONOPTIONS_HPP
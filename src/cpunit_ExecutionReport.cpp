@@ -37,21 +37,33 @@ cpunit::ExecutionReport::ExecutionReport() :
   t(),
   error_message(),
   test(NULL),
-  time_spent(initTime)
+  time_spent(initTime),
+  set_up_time(.0),
+  usage(),
+  counters(),
+  allocations()
 {}
 
 cpunit::ExecutionReport::ExecutionReport(const ExecutionResult _t, const std::string _msg, const RegInfo &_test, const double _time_spent) :
   t(_t),
   error_message(_msg),
   test(&_test),
-  time_spent(_time_spent)
+  time_spent(_time_spent),
+  set_up_time(.0),
+  usage(),
+  counters(),
+  allocations()
 {}
 
 cpunit::ExecutionReport::ExecutionReport(const ExecutionReport &o) :
   t(o.t),
   error_message(o.error_message),
   test(o.test),
-  time_spent(o.time_spent)
+  time_spent(o.time_spent),
+  set_up_time(o.set_up_time),
+  usage(o.usage),
+  counters(o.counters),
+  allocations(o.allocations)
 {}
 
 cpunit::ExecutionReport::~ExecutionReport()
@@ -64,6 +76,10 @@ cpunit::ExecutionReport::operator = (const ExecutionReport &o) {
     error_message = o.error_message;
     test = o.test;
     time_spent = o.time_spent;
+    set_up_time = o.set_up_time;
+    usage = o.usage;
+    counters = o.counters;
+    allocations = o.allocations;
   }
   return *this;
 }
@@ -106,6 +122,61 @@ cpunit::ExecutionReport::get_time_spent() const {
   return time_spent;
 }
 
+/**
+   @param t The part of the time spent that went to the set-up of the test.
+ */
+void
+cpunit::ExecutionReport::set_set_up_time(const double t) {
+  set_up_time = t;
+}
+
+/**
+   @return The part of get_time_spent() that went to the set-up of the test, 
+           or 0 if the test has no set-up.
+ */
+double
+cpunit::ExecutionReport::get_set_up_time() const {
+  return set_up_time;
+}
+
+/**
+   @param u The CPU time, context switches and page faults of the test, including its set-up.
+ */
+void
+cpunit::ExecutionReport::set_resource_usage(const ResourceUsage &u) {
+  usage = u;
+}
+
+const cpunit::ResourceUsage&
+cpunit::ExecutionReport::get_resource_usage() const {
+  return usage;
+}
+
+/**
+   @param c The hardware performance counters of the test, including its set-up.
+ */
+void
+cpunit::ExecutionReport::set_perf_counters(const PerfCounters &c) {
+  counters = c;
+}
+
+const cpunit::PerfCounters&
+cpunit::ExecutionReport::get_perf_counters() const {
+  return counters;
+}
+
+/**
+   @param a The heap allocations of the test, including its set-up.
+ */
+void
+cpunit::ExecutionReport::set_allocation_stats(const AllocationStats &a) {
+  allocations = a;
+}
+
+const cpunit::AllocationStats&
+cpunit::ExecutionReport::get_allocation_stats() const {
+  return allocations;
+}
 
 std::string
 cpunit::ExecutionReport::translate(const ExecutionResult r) {
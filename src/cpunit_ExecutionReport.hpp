@@ -31,7 +31,10 @@
 #ifndef CPUNIT_EXECUTIONREPORT_HPP
 #define CPUNIT_EXECUTIONREPORT_HPP
 
+#include "cpunit_AllocationStats.hpp"
+#include "cpunit_PerfCounters.hpp"
 #include "cpunit_RegInfo.hpp"
+#include "cpunit_ResourceUsage.hpp"
 
 #include <string>
 
@@ -53,6 +56,10 @@ namespace cpunit {
     std::string error_message;
     const RegInfo * test;
     double time_spent;
+    double set_up_time;
+    ResourceUsage usage;
+    PerfCounters counters;
+    AllocationStats allocations;
 
     static const double initTime;
 
@@ -70,6 +77,14 @@ namespace cpunit {
     const RegInfo& get_test() const;
     void set_time_spent(const double t);
     double get_time_spent() const;
+    void set_set_up_time(const double t);
+    double get_set_up_time() const;
+    void set_resource_usage(const ResourceUsage &u);
+    const ResourceUsage& get_resource_usage() const;
+    void set_perf_counters(const PerfCounters &c);
+    const PerfCounters& get_perf_counters() const;
+    void set_allocation_stats(const AllocationStats &a);
+    const AllocationStats& get_allocation_stats() const;
 
     static std::string translate(const ExecutionResult r);
   };
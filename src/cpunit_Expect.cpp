@@ -0,0 +1,253 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+#include "cpunit_Expect.hpp"
+#include "cpunit_Assert.hpp"
+#include <cstring>
+
+/**
+   Records a failed expectation with a message like the one of the
+   corresponding assert.
+   @param kind The kind of expectation, e.g. "TRUE".
+   @param msg  The text given to the expectation.
+   @throws AssertionException if the thread does not run a test.
+*/
+void cpunit::priv::expect_failed(const char *kind, const std::string &msg) {
+  if (!ExpectationScope::wants_message()) {
+    ExpectationScope::add_failure("");
+    return;
+  }
+  ExpectationScope::add_failure(std::string("EXPECT ") + kind + " FAILED - " + msg);
+}
+
+/**
+   Checks that a statement is <tt>true</tt>, and lets the test go on if it is not.
+   @param msg       A text to be displayed together with the error message if the expectation fails.
+   @param statement The statement to check for truthfulness.
+   @see ExpectationScope
+*/
+void cpunit::expect_true(const std::string &msg, const bool statement) {
+  if (!statement) {
+    priv::expect_failed("TRUE", msg);
+  }
+}
+
+/**
+   Checks that a statement is <tt>true</tt>, and lets the test go on if it is not.
+   The message is only copied into a std::string if the expectation fails.
+   @param msg       A text to be displayed together with the error message if the expectation fails.
+   @param statement The statement to check for truthfulness.
+*/
+void cpunit::expect_true(const char *msg, const bool statement) {
+  if (!statement) {
+    priv::expect_failed("TRUE", msg);
+  }
+}
+
+/**
+   Checks that a statement is <tt>true</tt>, and lets the test go on if it is not.
+   @param statement The statement to check for truthfulness.
+*/
+void cpunit::expect_true(const bool statement) {
+  expect_true("", statement);
+}
+
+/**
+   Checks that a statement is <tt>false</tt>, and lets the test go on if it is not.
+   @param msg       A text to be displayed together with the error message if the expectation fails.
+   @param statement The statement to check for falseness.
+*/
+void cpunit::expect_false(const std::string &msg, const bool statement) {
+  if (statement) {
+    priv::expect_failed("FALSE", msg);
+  }
+}
+
+/**
+   Checks that a statement is <tt>false</tt>, and lets the test go on if it is not.
+   The message is only copied into a std::string if the expectation fails.
+   @param msg       A text to be displayed together with the error message if the expectation fails.
+   @param statement The statement to check for falseness.
+*/
+void cpunit::expect_false(const char *msg, const bool statement) {
+  if (statement) {
+    priv::expect_failed("FALSE", msg);
+  }
+}
+
+/**
+   Checks that a statement is <tt>false</tt>, and lets the test go on if it is not.
+   @param statement The statement to check for falseness.
+*/
+void cpunit::expect_false(const bool statement) {
+  expect_false("", statement);
+}
+
+/**
+   Check that two floating point numbers are sufficiently closed to be reckoned as equal,
+   and let the test go on if they are not.
+   The expected and actual values are considered equal if abs(expected - actual) <= error.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected value.
+   @param actual   The actual value to test against the facit 'expected'.
+   @param error    The maximal allowed difference between 'expected' and 'actual'.
+*/
+void cpunit::expect_equals(const std::string &msg, const float expected, const float actual, const float error) {
+  if (priv::abs(expected - actual) > error) {
+    priv::expect_equals_failed(msg, expected, actual);
+  }
+}
+
+/**
+   Check that two floating point numbers are sufficiently closed to be reckoned as equal,
+   and let the test go on if they are not.
+   @param expected The expected value.
+   @param actual   The actual value to test against the facit 'expected'.
+   @param error    The maximal allowed difference between 'expected' and 'actual'.
+*/
+void cpunit::expect_equals(const float expected, const float actual, const float error) {
+  expect_equals("", expected, actual, error);
+}
+
+/**
+   Check that two double precision floating point numbers are sufficiently closed to be 
+   reckoned as equal, and let the test go on if they are not.
+   The expected and actual values are considered equal if abs(expected - actual) <= error.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected value.
+   @param actual   The actual value to test against the facit 'expected'.
+   @param error    The maximal allowed difference between 'expected' and 'actual'.
+*/
+void cpunit::expect_equals(const std::string &msg, const double expected, const double actual, const double error) {
+  if (priv::abs(expected - actual) > error) {
+    priv::expect_equals_failed(msg, expected, actual);
+  }
+}
+
+/**
+   Check that two double precision floating point numbers are sufficiently closed to be 
+   reckoned as equal, and let the test go on if they are not.
+   @param expected The expected value.
+   @param actual   The actual value to test against the facit 'expected'.
+   @param error    The maximal allowed difference between 'expected' and 'actual'.
+*/
+void cpunit::expect_equals(const double expected, const double actual, const double error) {
+  expect_equals("", expected, actual, error);
+}
+
+/**
+   Check that two C-strings are equal, comparing their characters, and let the
+   test go on if they are not.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected value.
+   @param actual   The actual value to test against the facit 'expected'.
+*/
+void cpunit::expect_equals(const std::string &msg, const char *expected, const  char *actual) {
+  if (std::strcmp(expected, actual) != 0) {
+    priv::expect_equals_failed(msg, std::string(expected), std::string(actual));
+  }
+}
+
+/**
+   Check that two C-strings are equal, comparing their characters, and let the
+   test go on if they are not.
+   @param expected The expected value.
+   @param actual   The actual value to test against the facit 'expected'.
+*/
+void cpunit::expect_equals(const char *expected, const char *actual) {
+  if (std::strcmp(expected, actual) != 0) {
+    priv::expect_equals_failed("", std::string(expected), std::string(actual));
+  }
+}
+
+/**
+   Check that two strings are equal, using the == operator of std::string, and
+   let the test go on if they are not.
+   @param msg      A text to be displayed together with the error message if the comparison fails.
+   @param expected The expected value.
+   @param actual   The actual value to test against the facit 'expected'.
+*/
+void cpunit::expect_equals(const std::string &msg, const std::string &expected, const std::string &actual) {
+  if (!(expected == actual)) {
+    priv::expect_equals_failed(msg, expected, actual);
+  }
+}
+
+/**
+   Check that two strings are equal, using the == operator of std::string, and
+   let the test go on if they are not.
+   @param expected The expected value.
+   @param actual   The actual value to test against the facit 'expected'.
+*/
+void cpunit::expect_equals(const std::string &expected, const std::string &actual) {
+  if (!(expected == actual)) {
+    priv::expect_equals_failed(std::string(), expected, actual);
+  }
+}
+
+/**
+   Checks that a pointer is not <tt>NULL</tt>, and lets the test go on if it is.
+   @param msg  A text to be displayed together with the error message if the expectation fails.
+   @param data The pointer to test.
+*/
+void cpunit::expect_not_null(const std::string &msg, const void *data) {
+  if (data == NULL) {
+    priv::expect_failed("NOT NULL", msg);
+  }
+}
+
+/**
+   Checks that a pointer is not <tt>NULL</tt>, and lets the test go on if it is.
+   @param data The pointer to test.
+*/
+void cpunit::expect_not_null(const void *data) {
+  expect_not_null("", data);
+}
+
+/**
+   Checks that a pointer is <tt>NULL</tt>, and lets the test go on if it is not.
+   @param msg  A text to be displayed together with the error message if the expectation fails.
+   @param data The pointer to test.
+*/
+void cpunit::expect_null(const std::string &msg, const void *data) {
+  if (data != NULL) {
+    priv::expect_failed("NULL", msg);
+  }
+}
+
+/**
+   Checks that a pointer is <tt>NULL</tt>, and lets the test go on if it is not.
+   @param data The pointer to test.
+*/
+void cpunit::expect_null(const void *data) {
+  expect_null("", data);
+}
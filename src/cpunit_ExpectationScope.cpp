@@ -0,0 +1,139 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+#include "cpunit_ExpectationScope.hpp"
+#include "cpunit_AssertionException.hpp"
+#include "cpunit_trace.hpp"
+
+#include <sstream>
+
+namespace {
+  // The innermost scope of each thread, or NULL outside of tests.
+  __thread cpunit::ExpectationScope *current = NULL;
+}
+
+std::size_t cpunit::ExpectationScope::default_max_messages = 100;
+
+/**
+   Makes this the scope collecting the failed expectations of the thread.
+   @param max The number of failure messages to keep.
+ */
+cpunit::ExpectationScope::ExpectationScope(const std::size_t max) :
+  previous(current),
+  max_messages(max),
+  failures(0),
+  messages()
+{
+  current = this;
+}
+
+/**
+   Gives the collecting back to the enclosing scope, if any.
+   Failures not fetched by to_string() are lost.
+ */
+cpunit::ExpectationScope::~ExpectationScope() {
+  current = previous;
+}
+
+bool
+cpunit::ExpectationScope::has_failures() const {
+  return failures > 0;
+}
+
+/**
+   @return The number of failed expectations, including the ones whose messages were dropped.
+ */
+std::size_t
+cpunit::ExpectationScope::get_failures() const {
+  return failures;
+}
+
+/**
+   @return A message listing the failed expectations, one per line,
+           in the order they failed.
+ */
+std::string
+cpunit::ExpectationScope::to_string() const {
+  std::ostringstream oss;
+  oss<<"EXPECTATIONS FAILED - "<<failures<<(failures == 1 ? " expectation" : " expectations")<<" failed:";
+  for (std::size_t i=0; i<messages.size(); ++i) {
+    oss<<std::endl<<"  "<<messages[i];
+  }
+  if (failures > messages.size()) {
+    oss<<std::endl<<"  ("<<failures - messages.size()<<" more)";
+  }
+  return oss.str();
+}
+
+/**
+   Sets the number of failure messages kept by scopes constructed without
+   a cap. Called once, from --max-expect-messages, before any tests are run.
+   @param max The number of messages to keep.
+ */
+void
+cpunit::ExpectationScope::set_default_max_messages(const std::size_t max) {
+  CPUNIT_ITRACE("ExpectationScope - Keeping at most "<<max<<" messages.");
+  default_max_messages = max;
+}
+
+std::size_t
+cpunit::ExpectationScope::get_default_max_messages() {
+  return default_max_messages;
+}
+
+/**
+   @return false if the message of a failure would be dropped, so that 
+           formatting it can be skipped. add_failure must still be called
+           to count the failure.
+ */
+bool
+cpunit::ExpectationScope::wants_message() {
+  return current == NULL || current->messages.size() < current->max_messages;
+}
+
+/**
+   Records a failed expectation in the innermost scope of the thread.
+   @param message The message of the failure. Ignored beyond the cap.
+   @throw AssertionException with the message if the thread has no scope, 
+                             as on threads started by the test.
+ */
+void
+cpunit::ExpectationScope::add_failure(const std::string &message) {
+  if (current == NULL) {
+    throw AssertionException(message);
+  }
+  CPUNIT_DTRACE("ExpectationScope - Failure: "<<message);
+  ++current->failures;
+  if (current->messages.size() < current->max_messages) {
+    current->messages.push_back(message);
+  }
+}
@@ -0,0 +1,78 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+#ifndef CPUNIT_EXPECTATIONSCOPE_HPP
+#define CPUNIT_EXPECTATIONSCOPE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace cpunit {
+
+  /**
+     Collects the failed expectations of the thread while it exists, so that a
+     test keeps running past them. Scopes nest, and the innermost one collects.
+     Only the first messages up to the cap of the scope are kept, but all
+     failures are counted. The BasicTestRunner opens one around each
+     set-up, test and tear-down, and turns the failures into a single
+     AssertionException when the function returns.
+     @see expect_true
+   */
+  class ExpectationScope {
+    ExpectationScope *const previous;
+    const std::size_t max_messages;
+    std::size_t failures;
+    std::vector<std::string> messages;
+
+    static std::size_t default_max_messages;
+
+    // No copy.
+    ExpectationScope(const ExpectationScope&);
+    ExpectationScope& operator = (const ExpectationScope&);
+  public:
+    explicit ExpectationScope(const std::size_t max = get_default_max_messages());
+    ~ExpectationScope();
+
+    bool has_failures() const;
+    std::size_t get_failures() const;
+    std::string to_string() const;
+
+    static void set_default_max_messages(const std::size_t max);
+    static std::size_t get_default_max_messages();
+    static bool wants_message();
+    static void add_failure(const std::string &message);
+  };
+
+}
+
+#endif // CPUNIT_EXPECTATIONSCOPE_HPP
@@ -0,0 +1,208 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_FailureCache.hpp"
+#include "cpunit_trace.hpp"
+#include "cpunit_impl_AtomicFile.hpp"
+#include "cpunit_impl_Hash.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace {
+  const std::size_t NOT_FOUND = static_cast<std::size_t>(-1);
+  const char SEPARATOR = '\t';
+}
+
+/**
+   Loads the cache from the given file. A missing or unreadable file
+   gives an empty cache, and malformed lines are skipped.
+   @param file_name The name of the cache file.
+ */
+cpunit::FailureCache::FailureCache(const std::string &fn) :
+  file_name(fn),
+  entries(),
+  index()
+{
+  std::ifstream in(file_name.c_str());
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    Entry e;
+    if (std::getline(fields, e.path, SEPARATOR) &&
+	std::getline(fields, e.name, SEPARATOR) &&
+	std::getline(fields, e.file, SEPARATOR) &&
+	std::getline(fields, e.line)) {
+      entries.push_back(e);
+    } else {
+      CPUNIT_DTRACE("FailureCache - Skipping malformed line '"<<line<<"' in "<<file_name);
+    }
+  }
+  rebuild_index();
+  CPUNIT_ITRACE("FailureCache - Loaded "<<entries.size()<<" failed tests from "<<file_name);
+}
+
+cpunit::FailureCache::FailureCache(const FailureCache &o) :
+  file_name(o.file_name),
+  entries(o.entries),
+  index(o.index)
+{}
+
+cpunit::FailureCache::~FailureCache()
+{}
+
+cpunit::FailureCache&
+cpunit::FailureCache::operator = (const FailureCache &o) {
+  if (&o != this) {
+    file_name = o.file_name;
+    entries = o.entries;
+    index = o.index;
+  }
+  return *this;
+}
+
+const std::string&
+cpunit::FailureCache::get_file_name() const {
+  return file_name;
+}
+
+/**
+   @return The number of failed tests in the cache.
+ */
+std::size_t
+cpunit::FailureCache::size() const {
+  return entries.size();
+}
+
+/**
+   @return true if the test failed the last time it ran.
+ */
+bool
+cpunit::FailureCache::contains(const RegInfo &test) const {
+  return find(test.get_path(), test.get_name()) != NOT_FOUND;
+}
+
+/**
+   Adds a failed test to the cache, if it is not already there.
+ */
+void
+cpunit::FailureCache::add(const RegInfo &test) {
+  if (contains(test)) {
+    return;
+  }
+  Entry e;
+  e.path = test.get_path();
+  e.name = test.get_name();
+  e.file = test.get_file();
+  e.line = test.get_line();
+  const Slot slot(impl::hash_test(e.path, e.name), entries.size());
+  entries.push_back(e);
+  index.insert(std::upper_bound(index.begin(), index.end(), slot), slot);
+}
+
+/**
+   Merges the result of a run into the cache: The tests that failed are
+   added, the ones that passed are removed, and tests that did not run
+   keep the state they had.
+   @param reports The reports of the executed tests.
+ */
+void
+cpunit::FailureCache::update(const std::vector<ExecutionReport> &reports) {
+  std::vector<char> passed(entries.size(), false);
+  std::vector<const RegInfo*> failed;
+  for (std::size_t i=0; i<reports.size(); ++i) {
+    const RegInfo &ri = reports[i].get_test();
+    const std::size_t at = find(ri.get_path(), ri.get_name());
+    if (reports[i].get_execution_result() == ExecutionReport::OK) {
+      if (at != NOT_FOUND) {
+	passed[at] = true;
+      }
+    } else if (at == NOT_FOUND) {
+      failed.push_back(&ri);
+    }
+  }
+
+  std::vector<Entry> kept;
+  for (std::size_t i=0; i<entries.size(); ++i) {
+    if (!passed[i]) {
+      kept.push_back(entries[i]);
+    }
+  }
+  entries.swap(kept);
+  rebuild_index();
+  for (std::size_t i=0; i<failed.size(); ++i) {
+    add(*failed[i]);
+  }
+}
+
+/**
+   Writes the cache to its file, replacing the old file atomically.
+   @throws CPUnitException if the file cannot be written.
+ */
+void
+cpunit::FailureCache::save() const {
+  std::ostringstream out;
+  out<<"# Tests that failed in the last CPUnit run: path, name, file and line."<<std::endl;
+  for (std::size_t i=0; i<entries.size(); ++i) {
+    const Entry &e = entries[i];
+    out<<e.path<<SEPARATOR<<e.name<<SEPARATOR<<e.file<<SEPARATOR<<e.line<<std::endl;
+  }
+  impl::write_file_atomically(file_name, out.str());
+}
+
+void
+cpunit::FailureCache::rebuild_index() {
+  index.clear();
+  index.reserve(entries.size());
+  for (std::size_t i=0; i<entries.size(); ++i) {
+    index.push_back(Slot(impl::hash_test(entries[i].path, entries[i].name), i));
+  }
+  std::sort(index.begin(), index.end());
+}
+
+/**
+   @return The position of the test in entries, or NOT_FOUND.
+ */
+std::size_t
+cpunit::FailureCache::find(const std::string &path, const std::string &name) const {
+  const uint64_t key = impl::hash_test(path, name);
+  std::vector<Slot>::const_iterator it = std::lower_bound(index.begin(), index.end(), Slot(key, 0));
+  for (; it != index.end() && it->first == key; ++it) {
+    const Entry &e = entries[it->second];
+    if (e.path == path && e.name == name) {
+      return it->second;
+    }
+  }
+  return NOT_FOUND;
+}
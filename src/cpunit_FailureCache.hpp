@@ -0,0 +1,83 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_FAILURECACHE_HPP
+#define CPUNIT_FAILURECACHE_HPP
+
+#include "cpunit_ExecutionReport.hpp"
+#include "cpunit_RegInfo.hpp"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+namespace cpunit {
+
+  /**
+     The set of tests that did not pass when they last ran, kept in a 
+     small text file between runs. Each line holds the path, name, file 
+     and line of one test, separated by tabs. Tests are looked up by the 
+     stable hash of their name in a sorted index, so selecting the failed
+     tests out of a large test set does not require any globbing.
+   */
+  class FailureCache {
+    struct Entry {
+      std::string path;
+      std::string name;
+      std::string file;
+      std::string line;
+    };
+    typedef std::pair<uint64_t, std::size_t> Slot;
+
+    std::string file_name;
+    std::vector<Entry> entries;
+    std::vector<Slot> index;
+
+    void rebuild_index();
+    std::size_t find(const std::string &path, const std::string &name) const;
+  public:
+    explicit FailureCache(const std::string &file_name);
+    FailureCache(const FailureCache &o);
+    virtual ~FailureCache();
+    FailureCache& operator = (const FailureCache &o);
+
+    const std::string& get_file_name() const;
+    std::size_t size() const;
+    bool contains(const RegInfo &test) const;
+    void add(const RegInfo &test);
+    void update(const std::vector<ExecutionReport> &reports);
+    void save() const;
+  };
+
+}
+
+#endif // CPUNIT_FAILURECACHE_HPP
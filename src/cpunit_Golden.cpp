@@ -0,0 +1,293 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+#include "cpunit_Golden.hpp"
+#include "cpunit_AssertionException.hpp"
+#include "cpunit_trace.hpp"
+#include "cpunit_impl_AtomicFile.hpp"
+#include "cpunit_impl_Diff.hpp"
+#include "cpunit_impl_MappedFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+  // The files are compared with memcmp in chunks of this size.
+  const std::size_t CHUNK = 1 << 20;
+
+  // The lines of context shown before the first differing line.
+  const std::size_t CONTEXT_LINES = 2;
+
+  // At most this many lines of each file are diffed, from the first difference on.
+  const std::size_t MAX_LINES_DIFFED = 1 << 20;
+
+  /**
+     A line of a file, without its '\n'. The line points into the file.
+   */
+  struct Line {
+    const char *begin;
+    std::size_t length;
+  };
+
+  /**
+     Compares the lines of two files, and writes them as they are.
+   */
+  class LineDiff : public cpunit::impl::Diff {
+    const std::vector<Line> &expected;
+    const std::vector<Line> &actual;
+
+  protected:
+    bool equal(const std::size_t i, const std::size_t j) const {
+      return expected[i].length == actual[j].length && std::memcmp(expected[i].begin, actual[j].begin, expected[i].length) == 0;
+    }
+
+    void write_element(std::ostream &out, const bool e, const std::size_t index) const {
+      const Line &line = e ? expected[index] : actual[index];
+      out.write(line.begin, line.length);
+    }
+
+  public:
+    LineDiff(const std::vector<Line> &e, const std::vector<Line> &a, const std::size_t max_lines) :
+      Diff(e.size(), a.size(), max_lines),
+      expected(e),
+      actual(a)
+    {}
+  };
+
+  /**
+     @return The offset of the first differing byte, or the length of 
+             the shorter data if one is the start of the other.
+   */
+  std::size_t first_difference(const char *expected, const std::size_t n, const char *actual, const std::size_t m) {
+    const std::size_t common = std::min(n, m);
+    for (std::size_t begin=0; begin<common; begin+=CHUNK) {
+      const std::size_t length = std::min(CHUNK, common - begin);
+      if (std::memcmp(expected + begin, actual + begin, length) != 0) {
+	std::size_t i = begin;
+	while (expected[i] == actual[i]) {
+	  ++i;
+	}
+	return i;
+      }
+    }
+    return common;
+  }
+
+  std::size_t count_lines(const char *data, const std::size_t n) {
+    std::size_t count = 0;
+    const char *end = data + n;
+    for (const char *p = data; p < end; ++count) {
+      const void *nl = std::memchr(p, '\n', end - p);
+      if (nl == NULL) {
+	break;
+      }
+      p = static_cast<const char*>(nl) + 1;
+    }
+    return count;
+  }
+
+  /**
+     Splits data into lines, up to MAX_LINES_DIFFED of them.
+     @return false if there were more lines.
+   */
+  bool split_lines(const char *data, const std::size_t n, std::vector<Line> &lines) {
+    const char *p = data;
+    const char *end = data + n;
+    while (p < end && lines.size() < MAX_LINES_DIFFED) {
+      const void *nl = std::memchr(p, '\n', end - p);
+      const char *line_end = nl == NULL ? end : static_cast<const char*>(nl);
+      Line line;
+      line.begin = p;
+      line.length = line_end - p;
+      lines.push_back(line);
+      p = nl == NULL ? end : line_end + 1;
+    }
+    return p == end;
+  }
+
+  /**
+     Describes where the output differs from the golden file, with a diff
+     of the lines from a few lines before the first difference on.
+   */
+  std::string describe(const std::string &path, const char *golden, const std::size_t golden_size, const char *data, const std::size_t n, const std::size_t max_lines) {
+    const std::size_t first = first_difference(golden, golden_size, data, n);
+    std::ostringstream oss;
+    oss<<"The output differs from '"<<path<<"' at byte "<<first<<" (the file has "<<golden_size<<" bytes, the output "<<n<<").";
+    if (max_lines == 0) {
+      return oss.str();
+    }
+
+    // Back up to the start of the line, and of a few lines before it.
+    std::size_t start = first;
+    std::size_t lines = 0;
+    while (start > 0) {
+      if (golden[start - 1] == '\n') {
+	if (lines == CONTEXT_LINES) {
+	  break;
+	}
+	++lines;
+      }
+      --start;
+    }
+    std::vector<Line> expected;
+    std::vector<Line> actual;
+    const bool all_expected = split_lines(golden + start, golden_size - start, expected);
+    const bool all_actual = split_lines(data + start, n - start, actual);
+    LineDiff diff(expected, actual, max_lines);
+    diff.set_numbering(count_lines(golden, start) + 1, "line");
+    diff.compute();
+    if (diff.get_edits().size() <= 1) {
+      oss<<std::endl<<"The lines are the same, but one ends with a newline.";
+    }
+    diff.write_hunks(oss);
+    if (!all_expected || !all_actual) {
+      oss<<std::endl<<"Only the first "<<MAX_LINES_DIFFED<<" lines from line "<<count_lines(golden, start) + 1<<" were diffed.";
+    }
+    return oss.str();
+  }
+}
+
+bool cpunit::GoldenFiles::update = false;
+
+/**
+   Sets whether assert_matches_golden replaces the golden files that differ 
+   from the output, instead of failing. Called once, from --update-golden,
+   before any tests are run.
+   @param u true to replace the files.
+ */
+void
+cpunit::GoldenFiles::set_update(const bool u) {
+  CPUNIT_ITRACE("GoldenFiles - Updating golden files: "<<u);
+  update = u;
+}
+
+bool
+cpunit::GoldenFiles::is_updating() {
+  return update;
+}
+
+/**
+   Check that data equals the contents of a golden file, which holds the output
+   expected of a test. The file is mapped into memory and compared chunk by chunk,
+   so large files are neither read nor copied. With --update-golden, the file is
+   instead replaced by the data if they differ, or created if it is missing, by
+   writing a temporary file and renaming it over the file. Tests running at the 
+   same time then see either the old or the new file.
+   @param msg  A text to be displayed together with the error message if the comparison fails.
+   @param path The golden file, relative to the working directory of the test program.
+   @param data The output of the test.
+   @param n    The number of bytes of data.
+   @throw AssertionException if the golden file is missing or differs from data. The
+                             message gives the first differing byte and a diff of the 
+                             lines around it.
+   @throw CPUnitException if the golden file cannot be read or written.
+*/
+void
+cpunit::assert_matches_golden(const std::string &msg, const std::string &path, const void *data, const std::size_t n) {
+  priv::assert_matches_golden(msg, path, data, n, GoldenFiles::is_updating(), impl::Diff::get_default_max_lines());
+}
+
+/**
+   Check that data equals the contents of a golden file, or replace the file.
+   The mode and diff length are parameters, rather than the command-line 
+   options, so that tests of the golden files do not depend on them.
+   @param msg       A text to be displayed together with the error message if the comparison fails.
+   @param path      The golden file, relative to the working directory of the test program.
+   @param data      The output of the test.
+   @param n         The number of bytes of data.
+   @param update    true to replace the golden file if it differs, as with --update-golden.
+   @param max_lines The number of lines of the diff, as with --max-diff-lines.
+   @throw AssertionException if the golden file is missing or differs from data.
+   @throw CPUnitException if the golden file cannot be read or written.
+*/
+void
+cpunit::priv::assert_matches_golden(const std::string &msg, const std::string &path, const void *data, const std::size_t n, const bool update, const std::size_t max_lines) {
+  const char *output = static_cast<const char*>(data);
+  impl::MappedFile golden(path);
+  const bool same = golden.is_found() && golden.size() == n && 
+    first_difference(golden.get_data(), golden.size(), output, n) == n;
+  if (same) {
+    return;
+  }
+  if (update) {
+    CPUNIT_ITRACE("GoldenFiles - Writing "<<n<<" bytes to '"<<path<<"'.");
+    impl::write_file_atomically(path, output, n);
+    return;
+  }
+
+  std::ostringstream oss;
+  oss<<"ASSERT MATCHES GOLDEN FAILED - "<<msg<<' ';
+  if (golden.is_found()) {
+    oss<<describe(path, golden.get_data(), golden.size(), output, n, max_lines);
+  } else {
+    oss<<"The golden file '"<<path<<"' does not exist. Run with --update-golden to create it.";
+  }
+  throw AssertionException(oss.str());
+}
+
+/**
+   Check that data equals the contents of a golden file.
+   @param path The golden file, relative to the working directory of the test program.
+   @param data The output of the test.
+   @param n    The number of bytes of data.
+   @throw AssertionException if the golden file is missing or differs from data.
+*/
+void
+cpunit::assert_matches_golden(const std::string &path, const void *data, const std::size_t n) {
+  assert_matches_golden(std::string(), path, data, n);
+}
+
+/**
+   Check that a string equals the contents of a golden file.
+   @param msg  A text to be displayed together with the error message if the comparison fails.
+   @param path The golden file, relative to the working directory of the test program.
+   @param data The output of the test.
+   @throw AssertionException if the golden file is missing or differs from data.
+*/
+void
+cpunit::assert_matches_golden(const std::string &msg, const std::string &path, const std::string &data) {
+  assert_matches_golden(msg, path, data.data(), data.length());
+}
+
+/**
+   Check that a string equals the contents of a golden file.
+   @param path The golden file, relative to the working directory of the test program.
+   @param data The output of the test.
+   @throw AssertionException if the golden file is missing or differs from data.
+*/
+void
+cpunit::assert_matches_golden(const std::string &path, const std::string &data) {
+  assert_matches_golden(std::string(), path, data.data(), data.length());
+}
@@ -0,0 +1,66 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+#ifndef CPUNIT_GOLDEN_HPP
+#define CPUNIT_GOLDEN_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace cpunit {
+
+  void assert_matches_golden(const std::string &msg, const std::string &path, const std::string &data);
+  void assert_matches_golden(const std::string &path, const std::string &data);
+
+  void assert_matches_golden(const std::string &msg, const std::string &path, const void *data, const std::size_t n);
+  void assert_matches_golden(const std::string &path, const void *data, const std::size_t n);
+
+  namespace priv {
+    void assert_matches_golden(const std::string &msg, const std::string &path, const void *data, const std::size_t n, const bool update, const std::size_t max_lines);
+  }
+
+  /**
+     Tells assert_matches_golden whether to check the output against the 
+     golden files, or to replace the golden files that differ with it.
+   */
+  class GoldenFiles {
+    static bool update;
+
+    // Only static members.
+    GoldenFiles();
+  public:
+    static void set_update(const bool u);
+    static bool is_updating();
+  };
+}
+
+#endif // CPUNIT_GOLDEN_HPP
@@ -0,0 +1,186 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_InstructionBaseline.hpp"
+#include "cpunit_CPUnitException.hpp"
+#include "cpunit_trace.hpp"
+#include "cpunit_impl_AtomicFile.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+  const char SEPARATOR = '\t';
+}
+
+/**
+   Creates an empty baseline. Call load() to read the file.
+   @param file_name The name of the baseline file.
+ */
+cpunit::InstructionBaseline::InstructionBaseline(const std::string &fn) :
+  file_name(fn),
+  entries()
+{}
+
+cpunit::InstructionBaseline::InstructionBaseline(const InstructionBaseline &o) :
+  file_name(o.file_name),
+  entries(o.entries)
+{}
+
+cpunit::InstructionBaseline::~InstructionBaseline()
+{}
+
+cpunit::InstructionBaseline&
+cpunit::InstructionBaseline::operator = (const InstructionBaseline &o) {
+  if (&o != this) {
+    file_name = o.file_name;
+    entries = o.entries;
+  }
+  return *this;
+}
+
+const std::string&
+cpunit::InstructionBaseline::get_file_name() const {
+  return file_name;
+}
+
+/**
+   @return The number of tests in the baseline.
+ */
+std::size_t
+cpunit::InstructionBaseline::size() const {
+  return entries.size();
+}
+
+/**
+   Reads the file, adding its tests. Malformed lines are skipped.
+   @throws CPUnitException if the file cannot be read.
+ */
+void
+cpunit::InstructionBaseline::load() {
+  std::ifstream in(file_name.c_str());
+  if (!in) {
+    throw CPUnitException("Unable to read the instruction baseline " + file_name);
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string path, name;
+    uint64_t instructions;
+    if (std::getline(fields, path, SEPARATOR) &&
+	std::getline(fields, name, SEPARATOR) &&
+	fields>>instructions) {
+      entries[path + "::" + name] = instructions;
+    } else {
+      CPUNIT_DTRACE("InstructionBaseline - Skipping malformed line '"<<line<<"' in "<<file_name);
+    }
+  }
+  CPUNIT_ITRACE("InstructionBaseline - Loaded "<<entries.size()<<" tests from "<<file_name);
+}
+
+/**
+   @param test         The test to look up.
+   @param instructions Set to the instruction count of the test, if it is found.
+   @return true if the test is in the baseline.
+ */
+bool
+cpunit::InstructionBaseline::lookup(const RegInfo &test, uint64_t &instructions) const {
+  const std::map<std::string, uint64_t>::const_iterator it = entries.find(key_of(test));
+  if (it == entries.end()) {
+    return false;
+  }
+  instructions = it->second;
+  return true;
+}
+
+/**
+   Adds the instruction count of a test, replacing any previous one.
+ */
+void
+cpunit::InstructionBaseline::record(const RegInfo &test, const uint64_t instructions) {
+  entries[key_of(test)] = instructions;
+}
+
+/**
+   Writes the baseline to its file, replacing the old file atomically.
+   @throws CPUnitException if the file cannot be written.
+ */
+void
+cpunit::InstructionBaseline::save() const {
+  std::ostringstream out;
+  out<<"# CPUnit instruction baseline: path, name, and the user space instructions retired by the test and its set-up."<<std::endl;
+  for (std::map<std::string, uint64_t>::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+    const std::size_t sep = it->first.rfind("::");
+    out<<it->first.substr(0, sep)<<SEPARATOR<<it->first.substr(sep + 2)<<SEPARATOR<<it->second<<std::endl;
+  }
+  impl::write_file_atomically(file_name, out.str());
+}
+
+/**
+   Compares the instruction count of a passed test with the baseline.
+   @param r          The report of the test.
+   @param max_growth The allowed growth of the count, as a fraction of the baseline.
+   @return r, or a FAILURE report with the same times and counters, 
+           if the count exceeds the baseline by more than max_growth.
+ */
+cpunit::ExecutionReport
+cpunit::InstructionBaseline::check(const ExecutionReport &r, const double max_growth) const {
+  uint64_t reference = 0;
+  const PerfCounters &c = r.get_perf_counters();
+  if (r.get_execution_result() != ExecutionReport::OK || !c.has(PerfCounters::INSTRUCTIONS) || 
+      !lookup(r.get_test(), reference)) {
+    return r;
+  }
+  const uint64_t instructions = c.get(PerfCounters::INSTRUCTIONS);
+  if (instructions <= reference * (1 + max_growth)) {
+    return r;
+  }
+  std::ostringstream oss;
+  oss<<"INSTRUCTION COUNT REGRESSION - Retired "<<instructions<<" instructions vs baseline "<<reference;
+  if (reference > 0) {
+    oss<<" ("<<std::showpos<<std::fixed<<std::setprecision(1)<<(100.0 * instructions / reference - 100)<<"%)"<<std::noshowpos;
+  }
+  oss<<", exceeding max-instruction-growth="<<std::setprecision(1)<<(100 * max_growth)<<'%';
+  ExecutionReport result(ExecutionReport::FAILURE, oss.str(), r.get_test(), r.get_time_spent());
+  result.set_set_up_time(r.get_set_up_time());
+  result.set_resource_usage(r.get_resource_usage());
+  result.set_perf_counters(c);
+  result.set_allocation_stats(r.get_allocation_stats());
+  return result;
+}
+
+std::string
+cpunit::InstructionBaseline::key_of(const RegInfo &test) {
+  return test.get_path() + "::" + test.get_name();
+}
@@ -0,0 +1,76 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_INSTRUCTIONBASELINE_HPP
+#define CPUNIT_INSTRUCTIONBASELINE_HPP
+
+#include "cpunit_ExecutionReport.hpp"
+#include "cpunit_RegInfo.hpp"
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <stdint.h>
+
+namespace cpunit {
+
+  /**
+     The user space instructions retired by each test, saved in a text file
+     for later runs to be compared against. Each line holds the path and name
+     of a test, followed by its instruction count, separated by tabs.
+
+     Unlike the time, the instruction count of a test hardly depends on the
+     load of the machine, so a small growth can be told from noise.
+   */
+  class InstructionBaseline {
+    std::string file_name;
+    std::map<std::string, uint64_t> entries;
+
+    static std::string key_of(const RegInfo &test);
+  public:
+    explicit InstructionBaseline(const std::string &file_name);
+    InstructionBaseline(const InstructionBaseline &o);
+    virtual ~InstructionBaseline();
+    InstructionBaseline& operator = (const InstructionBaseline &o);
+
+    const std::string& get_file_name() const;
+    std::size_t size() const;
+
+    void load();
+    bool lookup(const RegInfo &test, uint64_t &instructions) const;
+    void record(const RegInfo &test, const uint64_t instructions);
+    void save() const;
+
+    ExecutionReport check(const ExecutionReport &r, const double max_growth) const;
+  };
+
+}
+
+#endif // CPUNIT_INSTRUCTIONBASELINE_HPP
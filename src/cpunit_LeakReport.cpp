@@ -0,0 +1,126 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_LeakReport.hpp"
+
+#include <cstdlib>
+#include <execinfo.h>
+#include <sstream>
+
+cpunit::LeakReport::LeakReport() :
+  blocks(0),
+  bytes(0),
+  samples()
+{}
+
+cpunit::LeakReport::LeakReport(const LeakReport &o) :
+  blocks(o.blocks),
+  bytes(o.bytes),
+  samples(o.samples)
+{}
+
+cpunit::LeakReport::~LeakReport()
+{}
+
+cpunit::LeakReport&
+cpunit::LeakReport::operator = (const LeakReport &o) {
+  if (&o != this) {
+    blocks = o.blocks;
+    bytes = o.bytes;
+    samples = o.samples;
+  }
+  return *this;
+}
+
+/**
+   Adds a leaked block. Its call stack is kept if it is among the
+   MAX_SAMPLES largest blocks so far.
+ */
+void
+cpunit::LeakReport::add(const Block &b) {
+  ++blocks;
+  bytes += b.size;
+  if (samples.size() < MAX_SAMPLES) {
+    samples.push_back(b);
+    return;
+  }
+  std::size_t smallest = 0;
+  for (std::size_t i=1; i<samples.size(); ++i) {
+    if (samples[i].size < samples[smallest].size) {
+      smallest = i;
+    }
+  }
+  if (b.size > samples[smallest].size) {
+    samples[smallest] = b;
+  }
+}
+
+bool
+cpunit::LeakReport::is_empty() const {
+  return blocks == 0;
+}
+
+std::size_t
+cpunit::LeakReport::get_blocks() const {
+  return blocks;
+}
+
+std::size_t
+cpunit::LeakReport::get_bytes() const {
+  return bytes;
+}
+
+/**
+   @return A failure message with the leaked bytes and the symbolized 
+           call stacks of the largest blocks.
+ */
+std::string
+cpunit::LeakReport::to_string() const {
+  std::ostringstream oss;
+  oss<<"MEMORY LEAK - Leaked "<<bytes<<" bytes in "<<blocks<<(blocks == 1 ? " block" : " blocks");
+  for (std::size_t i=0; i<samples.size(); ++i) {
+    const Block &b = samples[i];
+    oss<<std::endl<<"  "<<b.size<<" bytes allocated at:";
+    char **symbols = backtrace_symbols(b.frames, b.depth);
+    for (int k=0; k<b.depth; ++k) {
+      oss<<std::endl<<"    #"<<k<<' ';
+      if (symbols != NULL) {
+	oss<<symbols[k];
+      } else {
+	oss<<b.frames[k];
+      }
+    }
+    std::free(symbols);
+  }
+  if (samples.size() < blocks) {
+    oss<<std::endl<<"  ("<<(blocks - samples.size())<<" more)";
+  }
+  return oss.str();
+}
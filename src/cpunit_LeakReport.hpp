@@ -0,0 +1,81 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_LEAKREPORT_HPP
+#define CPUNIT_LEAKREPORT_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace cpunit {
+
+  /**
+     The heap blocks a test allocated through operator new and did not 
+     deallocate before its tear-down had finished. The call stacks of the
+     largest blocks are kept as return addresses, and only turned into 
+     symbols by to_string().
+     @see AllocationTracker
+   */
+  class LeakReport {
+  public:
+    static const int MAX_FRAMES = 8;
+    static const std::size_t MAX_SAMPLES = 3;
+
+    /**
+       A leaked block and the call stack allocating it, innermost first.
+     */
+    struct Block {
+      std::size_t size;
+      int depth;
+      void *frames[MAX_FRAMES];
+    };
+
+  private:
+    std::size_t blocks;
+    std::size_t bytes;
+    std::vector<Block> samples;
+
+  public:
+    LeakReport();
+    LeakReport(const LeakReport &o);
+    virtual ~LeakReport();
+    LeakReport& operator = (const LeakReport &o);
+
+    void add(const Block &b);
+    bool is_empty() const;
+    std::size_t get_blocks() const;
+    std::size_t get_bytes() const;
+    std::string to_string() const;
+  };
+
+}
+
+#endif // CPUNIT_LEAKREPORT_HPP
@@ -32,13 +32,30 @@
 #ifndef CPUNIT_OSTREAMS_HPP
 #define CPUNIT_OSTREAMS_HPP
 
+#include <cstddef>
 #include <ostream>
+#include <utility>
 #include <vector>
 #include <map>
 #include <set>
 #include <list>
 #include <deque>
 
+#if __cplusplus >= 201103L
+#include <array>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#endif
+
+#if __cplusplus >= 201703L
+#include <optional>
+#endif
+
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
 namespace cpunit {
   
   template<class T, class A>
@@ -62,6 +79,59 @@ namespace cpunit {
   template<class K, class T, class C, class A>
   std::ostream& operator<<(std::ostream &out, const std::multimap<K, T, C, A> &m);
 
+  template<class T1, class T2>
+  std::ostream& operator<<(std::ostream &out, const std::pair<T1, T2> &p);
+
+#if __cplusplus >= 201103L
+  template<class T, std::size_t N>
+  std::ostream& operator<<(std::ostream &out, const std::array<T, N> &a);
+
+  template<class... T>
+  std::ostream& operator<<(std::ostream &out, const std::tuple<T...> &t);
+
+  template<class T, class H, class P, class A>
+  std::ostream& operator<<(std::ostream &out, const std::unordered_set<T, H, P, A> &s);
+
+  template<class T, class H, class P, class A>
+  std::ostream& operator<<(std::ostream &out, const std::unordered_multiset<T, H, P, A> &s);
+
+  template<class K, class T, class H, class P, class A>
+  std::ostream& operator<<(std::ostream &out, const std::unordered_map<K, T, H, P, A> &m);
+
+  template<class K, class T, class H, class P, class A>
+  std::ostream& operator<<(std::ostream &out, const std::unordered_multimap<K, T, H, P, A> &m);
+
+  namespace impl {
+    /**
+       Writes the first N elements of a tuple, separated by ", ".
+     */
+    template<class Tuple, std::size_t N>
+    struct TupleWriter {
+      static void write(std::ostream &out, const Tuple &t);
+    };
+
+    template<class Tuple>
+    struct TupleWriter<Tuple, 1> {
+      static void write(std::ostream &out, const Tuple &t);
+    };
+
+    template<class Tuple>
+    struct TupleWriter<Tuple, 0> {
+      static void write(std::ostream &out, const Tuple &t);
+    };
+  }
+#endif
+
+#if __cplusplus >= 201703L
+  template<class T>
+  std::ostream& operator<<(std::ostream &out, const std::optional<T> &o);
+#endif
+
+#if __cplusplus >= 202002L
+  template<class T, std::size_t E>
+  std::ostream& operator<<(std::ostream &out, const std::span<T, E> &s);
+#endif
+
   template<class Iterator>
   std::ostream& stream_objects(std::ostream &out, const Iterator &start, const int count, const char* bounds);
 
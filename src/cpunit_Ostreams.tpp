@@ -118,3 +118,85 @@ cpunit::operator << (std::ostream &out, const std::multimap<K, T, C, A> &m) {
   return stream_pairs(out, m.begin(), m.size(), "{}");
 }
 
+template<class T1, class T2>
+std::ostream& 
+cpunit::operator << (std::ostream &out, const std::pair<T1, T2> &p) {
+  return out<<'('<<p.first<<", "<<p.second<<')';
+}
+
+#if __cplusplus >= 201103L
+template<class T, std::size_t N>
+std::ostream& 
+cpunit::operator << (std::ostream &out, const std::array<T, N> &a) {
+  return stream_objects(out, a.begin(), a.size(), "[]");
+}
+
+template<class... T>
+std::ostream& 
+cpunit::operator << (std::ostream &out, const std::tuple<T...> &t) {
+  out<<'(';
+  impl::TupleWriter<std::tuple<T...>, sizeof...(T)>::write(out, t);
+  return out<<')';
+}
+
+template<class Tuple, std::size_t N>
+void
+cpunit::impl::TupleWriter<Tuple, N>::write(std::ostream &out, const Tuple &t) {
+  TupleWriter<Tuple, N - 1>::write(out, t);
+  out<<", "<<std::get<N - 1>(t);
+}
+
+template<class Tuple>
+void
+cpunit::impl::TupleWriter<Tuple, 1>::write(std::ostream &out, const Tuple &t) {
+  out<<std::get<0>(t);
+}
+
+template<class Tuple>
+void
+cpunit::impl::TupleWriter<Tuple, 0>::write(std::ostream &, const Tuple &) 
+{}
+
+template<class T, class H, class P, class A>
+std::ostream& 
+cpunit::operator << (std::ostream &out, const std::unordered_set<T, H, P, A> &s) {
+  return stream_objects(out, s.begin(), s.size(), "{}");
+}
+
+template<class T, class H, class P, class A>
+std::ostream& 
+cpunit::operator << (std::ostream &out, const std::unordered_multiset<T, H, P, A> &s) {
+  return stream_objects(out, s.begin(), s.size(), "{}");
+}
+
+template<class K, class T, class H, class P, class A>
+std::ostream& 
+cpunit::operator << (std::ostream &out, const std::unordered_map<K, T, H, P, A> &m) {
+  return stream_pairs(out, m.begin(), m.size(), "{}");
+}
+
+template<class K, class T, class H, class P, class A>
+std::ostream& 
+cpunit::operator << (std::ostream &out, const std::unordered_multimap<K, T, H, P, A> &m) {
+  return stream_pairs(out, m.begin(), m.size(), "{}");
+}
+#endif
+
+#if __cplusplus >= 201703L
+template<class T>
+std::ostream& 
+cpunit::operator << (std::ostream &out, const std::optional<T> &o) {
+  if (o) {
+    return out<<*o;
+  }
+  return out<<"nullopt";
+}
+#endif
+
+#if __cplusplus >= 202002L
+template<class T, std::size_t E>
+std::ostream& 
+cpunit::operator << (std::ostream &out, const std::span<T, E> &s) {
+  return stream_objects(out, s.begin(), s.size(), "[]");
+}
+#endif
@@ -0,0 +1,54 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_PerfCounterRunner.hpp"
+#include "cpunit_trace.hpp"
+#include "cpunit_impl_PerfEventGroup.hpp"
+
+/**
+   @param e The events to count, as a set of PerfCounters::mask_of bits.
+ */
+cpunit::PerfCounterRunner::PerfCounterRunner(const unsigned e) :
+  TestRunnerDecorator(),
+  events(e) {
+    CPUNIT_ITRACE("PerfCounterRunner - instantiated.");
+}
+
+cpunit::PerfCounterRunner::~PerfCounterRunner() {
+  CPUNIT_ITRACE("PerfCounterRunner - destroyed.");
+}
+
+cpunit::ExecutionReport
+cpunit::PerfCounterRunner::run(Callable& tu) const  {
+  const PerfCounters before = impl::PerfEventGroup::of_this_thread(events);
+  ExecutionReport result = inner_run(tu);
+  result.set_perf_counters(impl::PerfEventGroup::of_this_thread(events) - before);
+  return result;
+}
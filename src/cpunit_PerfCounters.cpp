@@ -0,0 +1,170 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_PerfCounters.hpp"
+
+namespace {
+  const char *NAMES[cpunit::PerfCounters::NUM_EVENTS] = {
+    "cycles",
+    "instructions",
+    "cache-misses",
+    "branch-misses"
+  };
+}
+
+cpunit::PerfCounters::PerfCounters() :
+  measured(0)
+{
+  for (int i=0; i<NUM_EVENTS; ++i) {
+    values[i] = 0;
+  }
+}
+
+cpunit::PerfCounters::PerfCounters(const PerfCounters &o) :
+  measured(o.measured)
+{
+  for (int i=0; i<NUM_EVENTS; ++i) {
+    values[i] = o.values[i];
+  }
+}
+
+cpunit::PerfCounters::~PerfCounters()
+{}
+
+cpunit::PerfCounters&
+cpunit::PerfCounters::operator = (const PerfCounters &o) {
+  if (&o != this) {
+    for (int i=0; i<NUM_EVENTS; ++i) {
+      values[i] = o.values[i];
+    }
+    measured = o.measured;
+  }
+  return *this;
+}
+
+/**
+   @return true if no counter is measured.
+ */
+bool
+cpunit::PerfCounters::is_empty() const {
+  return measured == 0;
+}
+
+/**
+   @param e The event to check.
+   @return true if the counter of e is measured.
+ */
+bool
+cpunit::PerfCounters::has(const Event e) const {
+  return (measured & mask_of(e)) != 0;
+}
+
+/**
+   @param e The event to get the count of.
+   @return The number of times e occurred, or 0 if it is not measured.
+ */
+uint64_t
+cpunit::PerfCounters::get(const Event e) const {
+  return values[e];
+}
+
+/**
+   Sets the counter of e, and marks it as measured.
+   @param e     The event to set the count of.
+   @param value The number of times e occurred.
+ */
+void
+cpunit::PerfCounters::set(const Event e, const uint64_t value) {
+  values[e] = value;
+  measured |= mask_of(e);
+}
+
+/**
+   @param o A snapshot taken before this one.
+   @return The counts between o and this snapshot, for the events measured in both.
+ */
+cpunit::PerfCounters
+cpunit::PerfCounters::operator - (const PerfCounters &o) const {
+  PerfCounters result;
+  for (int i=0; i<NUM_EVENTS; ++i) {
+    const Event e = static_cast<Event>(i);
+    if (has(e) && o.has(e)) {
+      result.set(e, values[i] > o.values[i] ? values[i] - o.values[i] : 0);
+    }
+  }
+  return result;
+}
+
+/**
+   Adds the counters of o. A counter measured in either is measured in the sum.
+ */
+cpunit::PerfCounters&
+cpunit::PerfCounters::operator += (const PerfCounters &o) {
+  for (int i=0; i<NUM_EVENTS; ++i) {
+    values[i] += o.values[i];
+  }
+  measured |= o.measured;
+  return *this;
+}
+
+/**
+   @param e An event.
+   @return The bit representing e in a set of events.
+ */
+unsigned
+cpunit::PerfCounters::mask_of(const Event e) {
+  return 1U << e;
+}
+
+/**
+   @param e An event.
+   @return The name of e, as given to --perf-counters.
+ */
+const char*
+cpunit::PerfCounters::name_of(const Event e) {
+  return NAMES[e];
+}
+
+/**
+   Translates an event name, as returned by name_of.
+   @param name The name to translate.
+   @param e    Receives the event if the name is known.
+   @return true if the name is known.
+ */
+bool
+cpunit::PerfCounters::parse(const std::string &name, Event &e) {
+  for (int i=0; i<NUM_EVENTS; ++i) {
+    if (name == NAMES[i]) {
+      e = static_cast<Event>(i);
+      return true;
+    }
+  }
+  return false;
+}
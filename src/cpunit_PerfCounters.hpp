@@ -0,0 +1,81 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_PERFCOUNTERS_HPP
+#define CPUNIT_PERFCOUNTERS_HPP
+
+#include <string>
+#include <stdint.h>
+
+namespace cpunit {
+
+  /**
+     The hardware performance counters of a test: cycles, instructions,
+     cache misses and branch misses, as counted by the processor while
+     the test thread was running in user space.
+     Counters that were not requested, or not supported by the machine,
+     are not measured, and has() tells them from counters that are zero.
+     Together with the wall time, this tells why a test got slower.
+   */
+  class PerfCounters {
+  public:
+    enum Event {
+      CYCLES,
+      INSTRUCTIONS,
+      CACHE_MISSES,
+      BRANCH_MISSES,
+      NUM_EVENTS
+    };
+
+  private:
+    uint64_t values[NUM_EVENTS];
+    unsigned measured;
+  public:
+    PerfCounters();
+    PerfCounters(const PerfCounters &o);
+    virtual ~PerfCounters();
+    PerfCounters& operator = (const PerfCounters &o);
+
+    bool is_empty() const;
+    bool has(const Event e) const;
+    uint64_t get(const Event e) const;
+    void set(const Event e, const uint64_t value);
+
+    PerfCounters operator - (const PerfCounters &o) const;
+    PerfCounters& operator += (const PerfCounters &o);
+
+    static unsigned mask_of(const Event e);
+    static const char* name_of(const Event e);
+    static bool parse(const std::string &name, Event &e);
+  };
+
+}
+
+#endif // CPUNIT_PERFCOUNTERS_HPP
@@ -0,0 +1,162 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_ResourceUsage.hpp"
+
+#include <ctime>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+cpunit::ResourceUsage::ResourceUsage() :
+  cpu_time(.0),
+  voluntary_switches(0),
+  involuntary_switches(0),
+  minor_faults(0),
+  major_faults(0)
+{}
+
+cpunit::ResourceUsage::ResourceUsage(const double cpu, const long vcsw, const long ivcsw, const long minflt, const long majflt) :
+  cpu_time(cpu),
+  voluntary_switches(vcsw),
+  involuntary_switches(ivcsw),
+  minor_faults(minflt),
+  major_faults(majflt)
+{}
+
+cpunit::ResourceUsage::ResourceUsage(const ResourceUsage &o) :
+  cpu_time(o.cpu_time),
+  voluntary_switches(o.voluntary_switches),
+  involuntary_switches(o.involuntary_switches),
+  minor_faults(o.minor_faults),
+  major_faults(o.major_faults)
+{}
+
+cpunit::ResourceUsage::~ResourceUsage()
+{}
+
+cpunit::ResourceUsage&
+cpunit::ResourceUsage::operator = (const ResourceUsage &o) {
+  if (&o != this) {
+    cpu_time = o.cpu_time;
+    voluntary_switches = o.voluntary_switches;
+    involuntary_switches = o.involuntary_switches;
+    minor_faults = o.minor_faults;
+    major_faults = o.major_faults;
+  }
+  return *this;
+}
+
+/**
+   @return The CPU time, user and system, in seconds.
+ */
+double
+cpunit::ResourceUsage::get_cpu_time() const {
+  return cpu_time;
+}
+
+/**
+   @return The number of times the thread gave up the CPU, e.g. to wait for I/O or a lock.
+ */
+long
+cpunit::ResourceUsage::get_voluntary_switches() const {
+  return voluntary_switches;
+}
+
+/**
+   @return The number of times the thread was preempted, e.g. by other processes.
+ */
+long
+cpunit::ResourceUsage::get_involuntary_switches() const {
+  return involuntary_switches;
+}
+
+/**
+   @return The number of page faults served without I/O.
+ */
+long
+cpunit::ResourceUsage::get_minor_faults() const {
+  return minor_faults;
+}
+
+/**
+   @return The number of page faults requiring I/O.
+ */
+long
+cpunit::ResourceUsage::get_major_faults() const {
+  return major_faults;
+}
+
+cpunit::ResourceUsage
+cpunit::ResourceUsage::operator - (const ResourceUsage &o) const {
+  return ResourceUsage(cpu_time - o.cpu_time,
+		       voluntary_switches - o.voluntary_switches,
+		       involuntary_switches - o.involuntary_switches,
+		       minor_faults - o.minor_faults,
+		       major_faults - o.major_faults);
+}
+
+cpunit::ResourceUsage&
+cpunit::ResourceUsage::operator += (const ResourceUsage &o) {
+  cpu_time += o.cpu_time;
+  voluntary_switches += o.voluntary_switches;
+  involuntary_switches += o.involuntary_switches;
+  minor_faults += o.minor_faults;
+  major_faults += o.major_faults;
+  return *this;
+}
+
+/**
+   Takes a snapshot of the resources used by the calling thread so far.
+   Where per-thread figures are not available, the figures of the
+   whole process are used instead.
+ */
+cpunit::ResourceUsage
+cpunit::ResourceUsage::of_this_thread() {
+  double cpu = .0;
+  rusage ru;
+#ifdef RUSAGE_THREAD
+  const int rc = getrusage(RUSAGE_THREAD, &ru);
+#else
+  const int rc = getrusage(RUSAGE_SELF, &ru);
+#endif
+#ifdef CLOCK_THREAD_CPUTIME_ID
+  timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+    cpu = ts.tv_sec + ts.tv_nsec / 1e9;
+  } else
+#endif
+  if (rc == 0) {
+    cpu = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+  }
+  if (rc != 0) {
+    return ResourceUsage(cpu, 0, 0, 0, 0);
+  }
+  return ResourceUsage(cpu, ru.ru_nvcsw, ru.ru_nivcsw, ru.ru_minflt, ru.ru_majflt);
+}
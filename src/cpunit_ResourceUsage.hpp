@@ -0,0 +1,71 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_RESOURCEUSAGE_HPP
+#define CPUNIT_RESOURCEUSAGE_HPP
+
+namespace cpunit {
+
+  /**
+     The CPU time, context switches and page faults of a thread.
+     A snapshot is taken with of_this_thread(), and the usage of a
+     test is the difference between the snapshots after and before it.
+     Together with the wall time, this tells a slow test from a test 
+     that was slowed down by a busy machine.
+   */
+  class ResourceUsage {
+    double cpu_time;
+    long voluntary_switches;
+    long involuntary_switches;
+    long minor_faults;
+    long major_faults;
+  public:
+    ResourceUsage();
+    ResourceUsage(const double cpu_time, const long voluntary_switches, const long involuntary_switches,
+		  const long minor_faults, const long major_faults);
+    ResourceUsage(const ResourceUsage &o);
+    virtual ~ResourceUsage();
+    ResourceUsage& operator = (const ResourceUsage &o);
+
+    double get_cpu_time() const;
+    long get_voluntary_switches() const;
+    long get_involuntary_switches() const;
+    long get_minor_faults() const;
+    long get_major_faults() const;
+
+    ResourceUsage operator - (const ResourceUsage &o) const;
+    ResourceUsage& operator += (const ResourceUsage &o);
+
+    static ResourceUsage of_this_thread();
+  };
+
+}
+
+#endif // CPUNIT_RESOURCEUSAGE_HPP
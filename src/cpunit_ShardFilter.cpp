@@ -0,0 +1,106 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cpunit_ShardFilter.hpp"
+#include "cpunit_WrongSetupException.hpp"
+#include "cpunit_impl_Hash.hpp"
+#include "cpunit_trace.hpp"
+
+#include <sstream>
+
+/**
+   @param i        The shard to select, in the range [0, n).
+   @param n        The total number of shards.
+   @param by_suite If true, all tests of a suite end up on the same shard.
+   @throws WrongSetupException if n is 0 or i is not less than n.
+ */
+cpunit::ShardFilter::ShardFilter(const std::size_t i, const std::size_t n, const bool suite) :
+  index(i),
+  count(n),
+  by_suite(suite)
+{
+  if (count == 0 || index >= count) {
+    std::ostringstream oss;
+    oss<<"Illegal shard specification: index "<<index<<" of "<<count<<" shards. The index must be in [0, shard-count).";
+    throw WrongSetupException(oss.str());
+  }
+}
+
+cpunit::ShardFilter::ShardFilter(const ShardFilter &o) :
+  index(o.index),
+  count(o.count),
+  by_suite(o.by_suite)
+{}
+
+cpunit::ShardFilter::~ShardFilter()
+{}
+
+cpunit::ShardFilter&
+cpunit::ShardFilter::operator = (const ShardFilter &o) {
+  if (&o != this) {
+    index = o.index;
+    count = o.count;
+    by_suite = o.by_suite;
+  }
+  return *this;
+}
+
+/**
+   @return The shard the test belongs to, in the range [0, count).
+ */
+std::size_t
+cpunit::ShardFilter::shard_of(const RegInfo &ri) const {
+  const uint64_t h = by_suite ? impl::hash_string(ri.get_path()) : impl::hash_test(ri.get_path(), ri.get_name());
+  return static_cast<std::size_t>(h % count);
+}
+
+bool
+cpunit::ShardFilter::accepts(const RegInfo &ri) const {
+  return shard_of(ri) == index;
+}
+
+/**
+   @param tests The tests to select from.
+   @return The tests of this shard, in the order they were passed.
+ */
+std::vector<cpunit::TestUnit>
+cpunit::ShardFilter::apply(const std::vector<TestUnit> &tests) const {
+  if (count == 1) {
+    return tests;
+  }
+  std::vector<TestUnit> result;
+  for (std::size_t i=0; i<tests.size(); ++i) {
+    TestUnit tu = tests[i];
+    if (accepts(tu.get_test()->get_reg_info())) {
+      result.push_back(tu);
+    }
+  }
+  CPUNIT_ITRACE("ShardFilter - Shard "<<index<<'/'<<count<<" selected "<<result.size()<<" of "<<tests.size()<<" tests.");
+  return result;
+}
@@ -0,0 +1,65 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CPUNIT_SHARDFILTER_HPP
+#define CPUNIT_SHARDFILTER_HPP
+
+#include "cpunit_RegInfo.hpp"
+#include "cpunit_TestUnit.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace cpunit {
+
+  /**
+     Selects one slice out of a deterministic partition of the tests, so that
+     several machines can each run their own part of the test set without
+     coordinating. A test belongs to shard <tt>hash % count</tt>, where
+     <tt>hash</tt> is a stable hash of its fully qualified name, or of its
+     suite path only if whole suites are to be kept on one shard.
+   */
+  class ShardFilter {
+    std::size_t index;
+    std::size_t count;
+    bool by_suite;
+  public:
+    ShardFilter(const std::size_t index, const std::size_t count, const bool by_suite);
+    ShardFilter(const ShardFilter &o);
+    virtual ~ShardFilter();
+    ShardFilter& operator = (const ShardFilter &o);
+
+    std::size_t shard_of(const RegInfo &ri) const;
+    bool accepts(const RegInfo &ri) const;
+    std::vector<TestUnit> apply(const std::vector<TestUnit> &tests) const;
+  };
+
+}
+
+#endif // CPUNIT_SHARDFILTER_HPP
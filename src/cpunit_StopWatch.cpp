@@ -30,49 +30,43 @@
 
 
 #include "cpunit_StopWatch.hpp"
-#include <ctime>
-
-#ifdef WIN32
-# include <windows.h>
-#elif __linux__ || __unix__
-# include <sys/time.h>
-#endif /* System */
+#include "cpunit_Clock.hpp"
 
 cpunit::StopWatch::StopWatch() :
-  duration(.0)
+  started(0),
+  elapsed(0)
 {}
 
 cpunit::StopWatch::~StopWatch()
 {}
 
+/**
+   @return The last measured interval in milliseconds.
+ */
 double
 cpunit::StopWatch::time() const {
-  return duration;
+  return elapsed / 1e6;
 }
 
-void cpunit::StopWatch::start()
-{
-    duration = now_ms();
+/**
+   @return The last measured interval in nanoseconds.
+ */
+uint64_t
+cpunit::StopWatch::elapsed_ns() const {
+  return elapsed;
 }
 
-double cpunit::StopWatch::stop()
+void cpunit::StopWatch::start()
 {
-    duration = ( now_ms() - duration );
-    
-    return duration / 1000.0;
+    started = Clock::now();
 }
 
-double cpunit::StopWatch::now_ms() const
+/**
+   @return The time since start() in seconds.
+ */
+double cpunit::StopWatch::stop()
 {
-#ifdef WIN32
-    return timeGetTime();
-#elif __linux__ || __unix__
-    struct timeval tv;
-    gettimeofday(&tv, 0);
+    elapsed = Clock::elapsed(started, Clock::now());
     
-    return ( tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0 );
-#else
-    return static_cast<double>(::time(NULL) * 1000.0);
-#endif /* System */
+    return elapsed / 1e9;
 }
-
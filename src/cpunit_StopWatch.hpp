@@ -31,10 +31,16 @@
 #ifndef CPUNIT_STOPWATCH_HPP
 #define CPUNIT_STOPWATCH_HPP
 
+#include <stdint.h>
+
 namespace cpunit {
 
+  /**
+     Measures intervals on the Clock, with the cost of reading it subtracted.
+   */
   class StopWatch {
-    double duration;
+    uint64_t started;
+    uint64_t elapsed;
   public:
     StopWatch();
     virtual ~StopWatch();
@@ -42,9 +48,7 @@ namespace cpunit {
     void start();
     double stop();
     double time() const;
-    
-  private:
-      double now_ms() const;
+    uint64_t elapsed_ns() const;
   };
 
 }
@@ -30,6 +30,7 @@
 
 
 #include "cpunit_StringFlyweightStore.hpp"
+#include "cpunit_AllocationTracker.hpp"
 #include "cpunit_trace.hpp"
 
 cpunit::StringFlyweightStore *cpunit::StringFlyweightStore::INSTANCE(NULL);
@@ -37,7 +38,8 @@ cpunit::StringFlyweightStore *cpunit::StringFlyweightStore::INSTANCE(NULL);
 cpunit::StringFlyweightStore::StringFlyweightStore() :
   store(),
   users(0),
-  disposed(false) {
+  disposed(false),
+  lock() {
   CPUNIT_DTRACE("StringFlyweightStore::StringFlyweightStore()");
 }
 
@@ -83,6 +85,9 @@ cpunit::StringFlyweightStore::get_instance() {
 
 const std::string*
 cpunit::StringFlyweightStore::intern(const std::string &s) {
+  impl::MutexLock l(lock);
+  // Interned strings live until the store is disposed, and are no leaks of the test interning them.
+  LeakRecordingScope not_recording(false);
   std::auto_ptr<std::string> ps(new std::string(s));
   str_ptr_set::const_iterator it = store.find(ps.get());
   if (it != store.end()) {
@@ -96,13 +101,20 @@ cpunit::StringFlyweightStore::intern(const std::string &s) {
 
 void
 cpunit::StringFlyweightStore::add_user() {
+  impl::MutexLock l(lock);
   ++users;
 }
 
 void
 cpunit::StringFlyweightStore::remove_user() {
-  --users;
-  if (disposed) {
+  bool do_dispose = false;
+  {
+    impl::MutexLock l(lock);
+    --users;
+    do_dispose = disposed;
+  }
+  // Outside the lock, since dispose may delete this object.
+  if (do_dispose) {
     dispose();
   }
 }
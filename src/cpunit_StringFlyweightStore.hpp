@@ -30,6 +30,8 @@
 #ifndef CPUNIT_STRINGFLYWEIGHTSTORE_HPP
 #define CPUNIT_STRINGFLYWEIGHTSTORE_HPP
 
+#include "cpunit_impl_Mutex.hpp"
+
 #include <string>
 #include <memory>
 #include <set>
@@ -41,6 +43,8 @@ namespace cpunit {
    * Used to reduce the RAM footprint, which can be large due to 
    * heavy use of strings in the test framework.
    * The store is implemented as a singleton.
+   * Interning and user counting are thread safe, as RegInfo objects
+   * may be created and copied while tests execute on several threads.
    */
   class StringFlyweightStore {
     
@@ -58,6 +62,7 @@ namespace cpunit {
     str_ptr_set store;
     int users;
     bool disposed;
+    impl::Mutex lock;
 
   public:
 
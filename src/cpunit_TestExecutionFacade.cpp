@@ -29,6 +29,7 @@
 
 
 
+#include "cpunit_AllocationTracker.hpp"
 #include "cpunit_AssertionException.hpp"
 #include "cpunit_Callable.hpp"
 #include "cpunit_TestStore.hpp"
@@ -36,20 +37,335 @@
 #include "cpunit_TestRunner.hpp"
 #include "cpunit_RunAllTestRunner.hpp"
 #include "cpunit_SafeTearDown.hpp"
+#include "cpunit_ShardFilter.hpp"
 #include "cpunit_BasicTestRunner.hpp"
 #include "cpunit_ExecutionReport.hpp"
+#include "cpunit_FailureCache.hpp"
 #include "cpunit_TimeFormat.hpp"
 #include "cpunit_TimeGuardRunner.hpp"
 #include "cpunit_trace.hpp"
+#include "cpunit_impl_ProcessPool.hpp"
+#include "cpunit_impl_Schedule.hpp"
+#include "cpunit_impl_SharedReportTable.hpp"
+#include "cpunit_impl_Watchdog.hpp"
+#include "cpunit_impl_WorkStealingPool.hpp"
 
 #include <exception>
 #include <iostream>
 #include <iomanip>
+#include <memory>
+#include <sstream>
 #include <vector>
 #include <algorithm>
 #include <string>
+#include <unistd.h>
 
-cpunit::TestExecutionFacade::TestExecutionFacade() {
+namespace {
+
+  // Make sure a newline is allways sent to the stream at the end.
+  struct NewlineAppender {
+    std::ostream& out;
+    NewlineAppender(std::ostream& out_) :
+      out(out_)
+    {}
+
+    ~NewlineAppender() {
+      out<<std::endl<<std::flush;
+    }
+  };
+
+  // Time a worker process gets to report its own timeout before it is killed.
+  const double KILL_GRACE = 2.0;
+
+  // Exit status of a worker process ended by its watchdog.
+  const int TIMED_OUT_STATUS = 124;
+
+  /**
+     Ends the process when a test exceeds the timeout, since there is no
+     way to stop the stuck thread. Writes directly to the file descriptor,
+     as the stuck thread may hold the lock of std::cout.
+   */
+  class AbortOnTimeout : public cpunit::impl::Watchdog::Handler {
+  public:
+    void timed_out(const cpunit::RegInfo &test, const std::string &message) {
+      std::ostringstream oss;
+      oss<<std::endl<<"Terminated due to timeout: "<<std::endl;
+      oss<<test.get_path()<<"::"<<test.get_name()<<" registered at "<<test.get_file()<<':'<<test.get_line()<<' ';
+      oss<<message<<std::endl;
+      const std::string text = oss.str();
+      if (write(STDOUT_FILENO, text.data(), text.length()) < 0) {
+	// Nowhere left to report to.
+      }
+      _exit(1);
+    }
+  };
+
+  /**
+     Stores a TIME GUARD ERROR report for the test running in a worker 
+     process, and ends the worker. The pool replaces it, and the parent 
+     picks up the report when the worker is found dead.
+   */
+  class StoreOnTimeout : public cpunit::impl::Watchdog::Handler {
+    cpunit::impl::SharedReportTable &table;
+    const double timeout;
+  public:
+    std::size_t item;
+
+    StoreOnTimeout(cpunit::impl::SharedReportTable &t, const double to) :
+      table(t),
+      timeout(to),
+      item(0)
+    {}
+
+    void timed_out(const cpunit::RegInfo &test, const std::string &message) {
+      table.store(item, cpunit::ExecutionReport(cpunit::ExecutionReport::ERROR, message, test, timeout), true);
+      _exit(TIMED_OUT_STATUS);
+    }
+  };
+
+  /**
+     @return A watchdog enforcing the timeout of the options, or NULL if there is none.
+   */
+  std::auto_ptr<cpunit::impl::Watchdog> make_watchdog(const cpunit::ExecutionOptions &options, cpunit::impl::Watchdog::Handler &handler) {
+    std::auto_ptr<cpunit::impl::Watchdog> result;
+    if (options.get_timeout() > 0) {
+      result.reset(new cpunit::impl::Watchdog(options.get_timeout(), handler));
+    }
+    return result;
+  }
+
+  struct FailedBefore {
+    const cpunit::FailureCache &cache;
+    const std::vector<const cpunit::RegInfo*> &infos;
+    FailedBefore(const cpunit::FailureCache &c, const std::vector<const cpunit::RegInfo*> &i) :
+      cache(c),
+      infos(i)
+    {}
+    bool operator () (const std::size_t i) const {
+      return cache.contains(*infos[i]);
+    }
+  };
+
+  std::vector<std::size_t> registration_order(const std::size_t n) {
+    std::vector<std::size_t> order(n);
+    for (std::size_t i=0; i<n; ++i) {
+      order[i] = i;
+    }
+    return order;
+  }
+
+  /**
+     @param parallel Whether the tests are to run in parallel.
+     @return The order to execute the tests in: registration order, or if
+             there is a timing history, longest first for parallel runs and
+             shortest first for sequential ones.
+   */
+  std::vector<std::size_t> execution_order(std::vector<cpunit::TestUnit> &tests, const cpunit::ExecutionOptions &options, const bool parallel) {
+    std::vector<const cpunit::RegInfo*> infos(tests.size());
+    for (std::size_t i=0; i<tests.size(); ++i) {
+      infos[i] = &tests[i].get_test()->get_reg_info();
+    }
+
+    std::vector<std::size_t> order;
+    const cpunit::TimingDatabase *db = options.get_schedule_db();
+    if (db == NULL) {
+      order = registration_order(tests.size());
+    } else {
+      CPUNIT_ITRACE("TestExecutionFacade - Scheduling "<<tests.size()<<" tests "<<(parallel ? "longest" : "shortest")<<" first.");
+      order = cpunit::impl::order_by_duration(cpunit::impl::estimate_durations(infos, *db), parallel);
+    }
+
+    const cpunit::FailureCache *cache = options.get_failure_cache();
+    if (cache != NULL && options.get_rerun_mode() == cpunit::ExecutionOptions::FAILED_FIRST) {
+      std::stable_partition(order.begin(), order.end(), FailedBefore(*cache, infos));
+    }
+    return order;
+  }
+
+  /**
+     In LAST_FAILED mode, removes the tests that did not fail in the previous run.
+     If none of the tests failed, all are kept.
+   */
+  void select_failed(std::vector<cpunit::TestUnit> &tests, const cpunit::ExecutionOptions &options) {
+    const cpunit::FailureCache *cache = options.get_failure_cache();
+    if (cache == NULL || options.get_rerun_mode() != cpunit::ExecutionOptions::LAST_FAILED) {
+      return;
+    }
+    std::vector<cpunit::TestUnit> failed;
+    for (std::size_t i=0; i<tests.size(); ++i) {
+      if (cache->contains(tests[i].get_test()->get_reg_info())) {
+	failed.push_back(tests[i]);
+      }
+    }
+    CPUNIT_ITRACE("TestExecutionFacade - "<<failed.size()<<" of "<<tests.size()<<" tests failed in the previous run.");
+    if (!failed.empty()) {
+      tests.swap(failed);
+    }
+  }
+
+  /**
+     @return A failure for a passed test that leaked, keeping the measurements of r.
+   */
+  cpunit::ExecutionReport leak_failure(const cpunit::ExecutionReport &r, const cpunit::LeakReport &leaks) {
+    cpunit::ExecutionReport result(cpunit::ExecutionReport::FAILURE, leaks.to_string(), r.get_test(), r.get_time_spent());
+    result.set_set_up_time(r.get_set_up_time());
+    result.set_resource_usage(r.get_resource_usage());
+    result.set_perf_counters(r.get_perf_counters());
+    result.set_allocation_stats(r.get_allocation_stats());
+    return result;
+  }
+
+  /**
+     @return The reports of the executed tests, in registration order.
+   */
+  std::vector<cpunit::ExecutionReport> collect(const std::vector<cpunit::ExecutionReport> &reports, const std::vector<char> &executed) {
+    std::vector<cpunit::ExecutionReport> result;
+    for (std::size_t i=0; i<reports.size(); ++i) {
+      if (executed[i]) {
+	result.push_back(reports[i]);
+      }
+    }
+    return result;
+  }
+}
+
+/**
+   Executes the tests of one worker thread in parallel mode.
+   Each worker owns its own TestRunner chain, so the only shared
+   state is the result table and the progress output.
+ */
+class cpunit::TestExecutionFacade::ParallelJob : public impl::WorkStealingPool::Job {
+  TestExecutionFacade &facade;
+  std::vector<TestUnit> &tests;
+  const ExecutionOptions &options;
+  const TestRunnerFactory &trf;
+  impl::WorkStealingPool &pool;
+  std::vector<TestRunner*> runners;
+  std::vector<ExecutionReport> &reports;
+  std::vector<char> &executed;
+
+  // No copy.
+  ParallelJob(const ParallelJob&);
+  ParallelJob& operator = (const ParallelJob&);
+public:
+  ParallelJob(TestExecutionFacade &f, std::vector<TestUnit> &t, const ExecutionOptions &o, 
+	      const TestRunnerFactory &factory, impl::WorkStealingPool &p,
+	      std::vector<ExecutionReport> &r, std::vector<char> &e) :
+    facade(f),
+    tests(t),
+    options(o),
+    trf(factory),
+    pool(p),
+    runners(),
+    reports(r),
+    executed(e)
+  {
+    for (std::size_t i=0; i<pool.get_num_workers(); ++i) {
+      runners.push_back(trf.create().release());
+    }
+  }
+
+  ~ParallelJob() {
+    for (std::size_t i=0; i<runners.size(); ++i) {
+      delete runners[i];
+    }
+  }
+
+  void run(const std::size_t item, const std::size_t worker) {
+    ExecutionReport res;
+    try {
+      executed[item] = facade.run_test_unit(tests[item], *runners[worker], trf, res);
+    } catch (...) {
+      // The robust runner chain catches everything thrown by the tests,
+      // so this is a framework error. Report it rather than losing the thread.
+      res = ExecutionReport(ExecutionReport::ERROR, "Unknown exception in worker thread.", tests[item].get_test()->get_reg_info(), .0);
+      executed[item] = true;
+    }
+    reports[item] = res;
+    if (!options.is_robust() && res.get_execution_result() != ExecutionReport::OK) {
+      pool.cancel();
+    }
+    facade.report_done(tests[item], res, options.is_verbose());
+  }
+};
+
+/**
+   Executes tests in forked worker processes.
+   run is called in the workers and stores the report in the shared table;
+   done and crashed are called in the parent process.
+ */
+class cpunit::TestExecutionFacade::ProcessJob : public impl::ProcessPool::Job {
+  TestExecutionFacade &facade;
+  std::vector<TestUnit> &tests;
+  const ExecutionOptions &options;
+  const TestRunnerFactory &trf;
+  impl::ProcessPool &pool;
+  impl::SharedReportTable &table;
+  StoreOnTimeout *on_timeout;
+  std::auto_ptr<TestRunner> runner;
+  std::vector<ExecutionReport> &reports;
+  std::vector<char> &executed;
+
+  // No copy.
+  ProcessJob(const ProcessJob&);
+  ProcessJob& operator = (const ProcessJob&);
+
+  void finish(const std::size_t item, const ExecutionReport &res, const bool exec) {
+    reports[item] = res;
+    executed[item] = exec;
+    if (!options.is_robust() && res.get_execution_result() != ExecutionReport::OK) {
+      pool.cancel();
+    }
+    facade.report_done(tests[item], res, options.is_verbose());
+  }
+public:
+  ProcessJob(TestExecutionFacade &f, std::vector<TestUnit> &t, const ExecutionOptions &o, 
+	     const TestRunnerFactory &factory, impl::ProcessPool &p, impl::SharedReportTable &tab,
+	     StoreOnTimeout *sot, std::vector<ExecutionReport> &r, std::vector<char> &e) :
+    facade(f),
+    tests(t),
+    options(o),
+    trf(factory),
+    pool(p),
+    table(tab),
+    on_timeout(sot),
+    runner(factory.create()),
+    reports(r),
+    executed(e)
+  {}
+
+  void run(const std::size_t item) {
+    if (on_timeout != NULL) {
+      on_timeout->item = item;
+    }
+    ExecutionReport res;
+    bool exec = true;
+    try {
+      exec = facade.run_test_unit(tests[item], *runner, trf, res);
+    } catch (...) {
+      res = ExecutionReport(ExecutionReport::ERROR, "Unknown exception in worker process.", tests[item].get_test()->get_reg_info(), .0);
+    }
+    table.store(item, res, exec);
+  }
+
+  void done(const std::size_t item) {
+    const RegInfo &ri = tests[item].get_test()->get_reg_info();
+    finish(item, table.load(item, ri), table.is_executed(item));
+  }
+
+  void crashed(const std::size_t item, const std::string &reason) {
+    const RegInfo &ri = tests[item].get_test()->get_reg_info();
+    if (table.is_done(item)) {
+      // The worker stored a report before dying, e.g. on a timeout.
+      finish(item, table.load(item, ri), table.is_executed(item));
+    } else {
+      finish(item, ExecutionReport(ExecutionReport::ERROR, reason, ri, .0), true);
+    }
+  }
+};
+
+cpunit::TestExecutionFacade::TestExecutionFacade() :
+  output_lock() {
   CPUNIT_DTRACE("TestExecutionFacade::TestExecutionFacade()");
 }
 
@@ -59,53 +375,169 @@ cpunit::TestExecutionFacade::~TestExecutionFacade() {
 
 std::vector<cpunit::ExecutionReport>
 cpunit::TestExecutionFacade::execute(const std::vector<std::string> &patterns, const double max_time, const bool verbose, const bool robust) {
-  CPUNIT_ITRACE("TestExecutionFacade::execute Running subtree matching '"<<patterns<<"' in "<<(robust ? "" : "non-")<<"robust mode.");
+  ExecutionOptions options;
+  options.set_max_time(max_time);
+  options.set_verbose(verbose);
+  options.set_robust(robust);
+  return execute(patterns, options);
+}
+
+std::vector<cpunit::ExecutionReport>
+cpunit::TestExecutionFacade::execute(const std::vector<std::string> &patterns, const ExecutionOptions &options) {
+  CPUNIT_ITRACE("TestExecutionFacade::execute Running subtree matching '"<<patterns<<"' in "<<(options.is_robust() ? "" : "non-")<<"robust mode.");
   std::vector<TestUnit> tests;
   for (std::size_t i=0; i<patterns.size(); ++i) {
-    std::vector<TestUnit> part = TestStore::get_instance().get_test_units(patterns[i]);
+    std::vector<TestUnit> part = options.is_benchmarks() 
+      ? TestStore::get_instance().get_benchmark_units(patterns[i])
+      : TestStore::get_instance().get_test_units(patterns[i]);
     tests.insert(tests.end(), part.begin(), part.end());
   }
-  TestRunnerFactory trf(robust, max_time);
-  return execute(tests, verbose, trf);
+  tests = ShardFilter(options.get_shard_index(), options.get_shard_count(), options.is_shard_by_suite()).apply(tests);
+  select_failed(tests, options);
+
+  // Benchmarks running side by side would disturb each other's measurements.
+  const bool sequential = options.is_benchmarks();
+  if (!sequential && options.get_procs() > 0 && !tests.empty()) {
+    return execute_forked(tests, options);
+  }
+  if (!sequential && options.get_jobs() > 1 && tests.size() > 1) {
+    return execute_parallel(tests, options);
+  }
+  AbortOnTimeout on_timeout;
+  std::auto_ptr<impl::Watchdog> watchdog = make_watchdog(options, on_timeout);
+  TestRunnerFactory trf(options.is_robust(), options.get_max_time(), watchdog.get(), options.get_perf_events());
+  return execute(tests, execution_order(tests, options, false), options.is_verbose(), trf);
 }
 
 std::vector<cpunit::ExecutionReport>
-cpunit::TestExecutionFacade::execute(std::vector<TestUnit> &tests, const bool verbose, const TestRunnerFactory &trf) {
+cpunit::TestExecutionFacade::execute(std::vector<TestUnit> &tests, const std::vector<std::size_t> &order, const bool verbose, const TestRunnerFactory &trf) {
 
   // Make sure a newline is allways sent to std::cout at the end.
-  struct NewlineAppender {
-    std::ostream& out;
-    NewlineAppender(std::ostream& out_) :
-      out(out_)
-    {}
-
-    ~NewlineAppender() {
-      out<<std::endl<<std::flush;
-    }
-  } nla(std::cout);
+  NewlineAppender nla(std::cout);
 
   // Create one test runner for set-up and tests.
   // Tear down uses a temporary, since its test runner may have to outlive
   // this scope.
   std::auto_ptr<TestRunner> runner = trf.create();
 
-  std::vector<ExecutionReport> result;
-  for (std::size_t i=0; i<tests.size(); i++) {
+  std::vector<ExecutionReport> reports(tests.size());
+  std::vector<char> executed(tests.size(), false);
+  for (std::size_t k=0; k<order.size(); k++) {
+    const std::size_t i = order[k];
     if (verbose) {
       const RegInfo &ri = tests[i].get_test()->get_reg_info();
       std::cout<<"Running "<<ri.get_path()<<"::"<<ri.get_name()<<' '<<std::flush;
     }
 
-    Callable* setUp    = tests[i].get_set_up();
-    Callable* test     = tests[i].get_test();
-    Callable* tearDown = tests[i].get_tear_down();
+    ExecutionReport res;
+    executed[i] = run_test_unit(tests[i], *runner, trf, res);
+    reports[i] = res;
+
+    if (verbose) {
+      std::cout<<"\t"<<TimeFormat(res.get_time_spent())<<"s " << "\t";
+    }
+    
+    if (verbose) {
+      std::cout << report_progress_str(res.get_execution_result())<<std::flush;
+      std::cout<<std::endl;
+    }
+    else {
+      std::cout << report_progress(res.get_execution_result())<<std::flush;
+    }
+  }
+  return collect(reports, executed);
+}
+
+/**
+   Executes the tests on a pool of worker threads.
+   The workers always run a robust TestRunner chain, so that failures are
+   reported rather than thrown across threads. In non-robust mode, the first 
+   failure cancels all tests that are not yet started.
+   @return The reports of the executed tests, in the order of the passed tests.
+ */
+std::vector<cpunit::ExecutionReport>
+cpunit::TestExecutionFacade::execute_parallel(std::vector<TestUnit> &tests, const ExecutionOptions &options) {
+  CPUNIT_ITRACE("TestExecutionFacade::execute_parallel - Running "<<tests.size()<<" tests on "<<options.get_jobs()<<" threads.");
+
+  NewlineAppender nla(std::cout);
 
+  AbortOnTimeout on_timeout;
+  std::auto_ptr<impl::Watchdog> watchdog = make_watchdog(options, on_timeout);
+  const TestRunnerFactory trf(true, options.get_max_time(), watchdog.get(), options.get_perf_events());
+  impl::WorkStealingPool pool(std::min(options.get_jobs(), tests.size()));
+
+  std::vector<ExecutionReport> reports(tests.size());
+  std::vector<char> executed(tests.size(), false);
+  const std::vector<std::size_t> order = execution_order(tests, options, true);
+
+  ParallelJob job(*this, tests, options, trf, pool, reports, executed);
+  pool.run(order, job);
+
+  return collect(reports, executed);
+}
+
+/**
+   Executes the tests in a pool of forked worker processes.
+   The workers are forked here, after static registration is complete, so every 
+   worker sees the same TestStore as the parent. A worker that crashes is reported
+   as an ERROR for the test it was running, and is replaced by a new one.
+   Fail-fast handling and the order of the result are as for execute_parallel.
+ */
+std::vector<cpunit::ExecutionReport>
+cpunit::TestExecutionFacade::execute_forked(std::vector<TestUnit> &tests, const ExecutionOptions &options) {
+  CPUNIT_ITRACE("TestExecutionFacade::execute_forked - Running "<<tests.size()<<" tests in "<<options.get_procs()<<" processes.");
+
+  NewlineAppender nla(std::cout);
+
+  impl::ProcessPool pool(options.get_procs(), options.get_recycle_after(), options.get_max_worker_rss());
+  impl::SharedReportTable table(tests.size());
+
+  // The watchdog thread is started by the first test in each worker process.
+  StoreOnTimeout on_timeout(table, options.get_timeout());
+  std::auto_ptr<impl::Watchdog> watchdog = make_watchdog(options, on_timeout);
+  const TestRunnerFactory trf(true, options.get_max_time(), watchdog.get(), options.get_perf_events());
+  if (watchdog.get() != NULL) {
+    // In case the worker is too stuck for its own watchdog to end it.
+    pool.set_item_timeout(options.get_timeout() + KILL_GRACE);
+  }
+
+  std::vector<ExecutionReport> reports(tests.size());
+  std::vector<char> executed(tests.size(), false);
+  const std::vector<std::size_t> order = execution_order(tests, options, true);
+
+  ProcessJob job(*this, tests, options, trf, pool, table, watchdog.get() != NULL ? &on_timeout : NULL, reports, executed);
+  pool.run(order, job);
+
+  return collect(reports, executed);
+}
+
+/**
+   Runs set-up, test and tear-down for one test unit.
+   @param tu     The test unit to execute.
+   @param runner The TestRunner chain to run set-up and test with.
+   @param trf    The factory creating the TestRunner for the tear-down.
+   @param result Receives the report of the test, or of the set-up if that failed.
+                 With leak detection enabled, a passed test fails if the blocks
+                 allocated by its set-up, test or tear-down are not all deallocated
+                 when the tear-down has finished.
+   @return true if the test was executed, false if the set-up failed.
+ */
+bool
+cpunit::TestExecutionFacade::run_test_unit(TestUnit &tu, const TestRunner &runner, const TestRunnerFactory &trf, ExecutionReport &result) const {
+  Callable* setUp    = tu.get_set_up();
+  Callable* test     = tu.get_test();
+  Callable* tearDown = tu.get_tear_down();
+
+  AllocationTracker::start_leak_check();
+
+  bool executed = false;
+  {
     SafeTearDown td(tearDown, trf.create());
 
     ExecutionReport res;
 
     if (setUp != NULL) {
-      res = runner->run(*setUp);
+      res = runner.run(*setUp);
     } else {
       res = ExecutionReport(ExecutionReport::OK, "No set-up", RegInfo(), .0);
     }
@@ -113,25 +545,48 @@ cpunit::TestExecutionFacade::execute(std::vector<TestUnit> &tests, const bool ve
     if (res.get_execution_result() == ExecutionReport::OK) {
 
       const double timeSoFar = res.get_time_spent();
+      ResourceUsage usage = res.get_resource_usage();
+      PerfCounters counters = res.get_perf_counters();
+      AllocationStats allocations = res.get_allocation_stats();
 
-      res = runner->run(*test);
+      res = runner.run(*test);
       res.set_time_spent(res.get_time_spent() + timeSoFar);
-      result.push_back(res);
-    } 
-
-    if (verbose) {
-      std::cout<<"\t"<<TimeFormat(res.get_time_spent())<<"s " << "\t";
-    }
-    
-    if (verbose) {
-      std::cout << report_progress_str(res.get_execution_result())<<std::flush;
-      std::cout<<std::endl;
-    }
-    else {
-      std::cout << report_progress(res.get_execution_result())<<std::flush;
+      res.set_set_up_time(timeSoFar);
+      usage += res.get_resource_usage();
+      res.set_resource_usage(usage);
+      counters += res.get_perf_counters();
+      res.set_perf_counters(counters);
+      allocations += res.get_allocation_stats();
+      res.set_allocation_stats(allocations);
+      executed = true;
     }
+    result = res;
+  }
+
+  const LeakReport leaks = AllocationTracker::end_leak_check();
+  if (!leaks.is_empty() && result.get_execution_result() == ExecutionReport::OK) {
+    CPUNIT_DTRACE("TestExecutionFacade::run_test_unit - "<<leaks.get_bytes()<<" bytes leaked.");
+    result = leak_failure(result, leaks);
+  }
+  return executed;
+}
+
+/**
+   Writes the progress of a test finished on a worker thread.
+   In verbose mode, the full line is written at once, since
+   the tests finish in an unspecified order.
+ */
+void
+cpunit::TestExecutionFacade::report_done(TestUnit &tu, const ExecutionReport &r, const bool verbose) {
+  impl::MutexLock l(output_lock);
+  if (verbose) {
+    const RegInfo &ri = tu.get_test()->get_reg_info();
+    std::cout<<"Running "<<ri.get_path()<<"::"<<ri.get_name()<<' ';
+    std::cout<<"\t"<<TimeFormat(r.get_time_spent())<<"s " << "\t";
+    std::cout<<report_progress_str(r.get_execution_result())<<std::endl;
+  } else {
+    std::cout<<report_progress(r.get_execution_result())<<std::flush;
   }
-  return result;
 }
 
 char
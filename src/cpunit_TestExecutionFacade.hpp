@@ -33,8 +33,10 @@
 #define CPUNIT_TESTMANAGER_HPP
 
 #include "cpunit_TestUnit.hpp"
+#include "cpunit_ExecutionOptions.hpp"
 #include "cpunit_ExecutionReport.hpp"
 #include "cpunit_TestRunnerFactory.hpp"
+#include "cpunit_impl_Mutex.hpp"
 
 #include <memory>
 #include <ostream>
@@ -46,15 +48,31 @@ namespace cpunit {
   class TestRunner;
 
   class TestExecutionFacade {
-    std::vector<ExecutionReport> execute(std::vector<TestUnit> &tests, const bool verbose, const TestRunnerFactory &trf);    
+    class ParallelJob;
+    friend class ParallelJob;
+    class ProcessJob;
+    friend class ProcessJob;
+
+    impl::Mutex output_lock;
+
+    std::vector<ExecutionReport> execute(std::vector<TestUnit> &tests, const std::vector<std::size_t> &order, const bool verbose, const TestRunnerFactory &trf);    
+    std::vector<ExecutionReport> execute_parallel(std::vector<TestUnit> &tests, const ExecutionOptions &options);
+    std::vector<ExecutionReport> execute_forked(std::vector<TestUnit> &tests, const ExecutionOptions &options);
+    bool run_test_unit(TestUnit &tu, const TestRunner &runner, const TestRunnerFactory &trf, ExecutionReport &result) const;
+    void report_done(TestUnit &tu, const ExecutionReport &r, const bool verbose);
     char report_progress(const ExecutionReport::ExecutionResult r) const;
     std::string report_progress_str(const ExecutionReport::ExecutionResult r) const;
     std::auto_ptr<TestRunner> get_test_runner(const bool robust, const double max_time) const;
+
+    // No copy.
+    TestExecutionFacade(const TestExecutionFacade&);
+    TestExecutionFacade& operator = (const TestExecutionFacade&);
   public:
     TestExecutionFacade();
     virtual ~TestExecutionFacade();
 
     std::vector<ExecutionReport> execute(const std::vector<std::string> &patterns, const double max_time, const bool verbose, const bool robust);
+    std::vector<ExecutionReport> execute(const std::vector<std::string> &patterns, const ExecutionOptions &options);
   };
 
 }
@@ -1,18 +1,24 @@
 
 #include "cpunit_TestRunnerFactory.hpp"
+#include "cpunit_AllocationRunner.hpp"
 #include "cpunit_RunAllTestRunner.hpp"
 #include "cpunit_BasicTestRunner.hpp"
+#include "cpunit_PerfCounterRunner.hpp"
 #include "cpunit_TimeGuardRunner.hpp"
 #include "cpunit_trace.hpp"
 
-cpunit::TestRunnerFactory::TestRunnerFactory(const bool rob, const double maxT) :
+cpunit::TestRunnerFactory::TestRunnerFactory(const bool rob, const double maxT, impl::Watchdog *w, const unsigned perf) :
   robust(rob),
-  maxTime(maxT)
+  maxTime(maxT),
+  watchdog(w),
+  perf_events(perf)
 {}
 
 cpunit::TestRunnerFactory::TestRunnerFactory(const TestRunnerFactory& o) :
   robust(o.robust),
-  maxTime(o.maxTime)
+  maxTime(o.maxTime),
+  watchdog(o.watchdog),
+  perf_events(o.perf_events)
 {}
 
 cpunit::TestRunnerFactory::~TestRunnerFactory()
@@ -22,6 +28,8 @@ cpunit::TestRunnerFactory&
 cpunit::TestRunnerFactory::operator=(const TestRunnerFactory& o) {
   robust  = o.robust;
   maxTime = o.maxTime;
+  watchdog = o.watchdog;
+  perf_events = o.perf_events;
   return *this;
 }
 
@@ -41,9 +49,21 @@ cpunit::TestRunnerFactory::create() const {
     std::auto_ptr<TestRunnerDecorator> d2(new RunAllTestRunner);
     d2->set_inner(leaf.release());
 
+    // Add a layer of allocation counting
+    std::auto_ptr<TestRunnerDecorator> da(new AllocationRunner);
+    da->set_inner(d2.release());
+
+    // Add a layer of hardware performance counting, if requested
+    std::auto_ptr<TestRunner> counted(da.release());
+    if (perf_events != 0) {
+      std::auto_ptr<TestRunnerDecorator> pc(new PerfCounterRunner(perf_events));
+      pc->set_inner(counted.release());
+      counted.reset(pc.release());
+    }
+
     // Add a layer of time taking
-    std::auto_ptr<TestRunnerDecorator> d3(new TimeGuardRunner(maxTime));
-    d3->set_inner(d2.release());
+    std::auto_ptr<TestRunnerDecorator> d3(new TimeGuardRunner(maxTime, watchdog));
+    d3->set_inner(counted.release());
 
     // Add a new layer of exception handling in case the max-time is exceeded
     std::auto_ptr<TestRunnerDecorator> d4(new RunAllTestRunner);
@@ -53,8 +73,19 @@ cpunit::TestRunnerFactory::create() const {
   } else {
     CPUNIT_ITRACE("TestExecutionFacade::get_test_runner - Returning BasicTestRunner");
 
+    // Add layers of allocation and hardware performance counting.
+    // A failing test ends the run, so its counters are of no interest.
+    std::auto_ptr<TestRunnerDecorator> da(new AllocationRunner);
+    da->set_inner(leaf.release());
+    leaf.reset(da.release());
+    if (perf_events != 0) {
+      std::auto_ptr<TestRunnerDecorator> pc(new PerfCounterRunner(perf_events));
+      pc->set_inner(leaf.release());
+      leaf.reset(pc.release());
+    }
+
     // Add a layer of time taking over the executing test runner
-    std::auto_ptr<TestRunnerDecorator> d1(new TimeGuardRunner(maxTime));
+    std::auto_ptr<TestRunnerDecorator> d1(new TimeGuardRunner(maxTime, watchdog));
     d1->set_inner(leaf.release());
 
     return std::auto_ptr<TestRunner>(d1.release());
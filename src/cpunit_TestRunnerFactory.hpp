@@ -3,15 +3,22 @@
 #define CPUNIT_TESTRUNNERFACTORY_HPP
 
 #include "cpunit_TestRunner.hpp"
+#include <cstddef>
 #include <memory>
 
 namespace cpunit {
 
+  namespace impl {
+    class Watchdog;
+  }
+
   class TestRunnerFactory {
     bool robust;
     double maxTime;
+    impl::Watchdog *watchdog;
+    unsigned perf_events;
   public:
-    TestRunnerFactory(const bool rob, const double maxT);
+    TestRunnerFactory(const bool rob, const double maxT, impl::Watchdog *w = NULL, const unsigned perf = 0);
     TestRunnerFactory(const TestRunnerFactory&);
     virtual ~TestRunnerFactory();
     TestRunnerFactory& operator=(const TestRunnerFactory&);
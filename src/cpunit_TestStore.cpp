@@ -119,6 +119,21 @@ cpunit::TestStore::insert_test(Callable *test) {
   n->add_test(test);
 }
 
+/**
+   Inserts a benchmark for the suite named in the passed Callable object.
+   Benchmarks share the set-up and tear-down methods of their suite,
+   but are not returned by the test query methods.
+   @param bench A Callable pointer to the benchmark to register.
+                The test store takes over control of the Callable object.
+   @throws WrongSetupException if the benchmark is already registered.
+ */
+void 
+cpunit::TestStore::insert_benchmark(Callable *bench) {
+  CPUNIT_ITRACE("TestStore::insert_benchmark in "<<bench->get_reg_info().get_path()<<": "<<bench->get_reg_info().get_name());
+  TestTreeNode *n = find_node(bench->get_reg_info().get_path(), true);
+  n->add_benchmark(bench);
+}
+
 /**
    Returns a selection of tests in terms of {@link TestUnit TestUnits}.
    @param pattern The glob pattern to match against. Passing "*" will
@@ -149,6 +164,34 @@ cpunit::TestStore::get_tests(const std::string &pattern) {
   return result;
 }
 
+/**
+   Returns a selection of benchmarks in terms of {@link TestUnit TestUnits}.
+   @param pattern The glob pattern to match against.
+   @return The matched benchmarks.
+ */
+std::vector<cpunit::TestUnit> 
+cpunit::TestStore::get_benchmark_units(const std::string &pattern) {
+  std::vector<TestUnit> result;
+  GlobMatcher m(pattern);
+  root->extract_benchmark_matches(result, m);
+  return result;
+}
+
+/**
+   Returns a selection of benchmarks in terms of {@link RegInfo RegInfos}.
+   @param pattern The glob pattern to match against.
+   @return The matched benchmarks.
+ */
+std::vector<cpunit::RegInfo> 
+cpunit::TestStore::get_benchmarks(const std::string &pattern) {
+  std::vector<TestUnit> tus = get_benchmark_units(pattern);
+  std::vector<RegInfo> result(tus.size());
+  for (std::size_t i=0; i<tus.size(); i++) {
+    result[i] = tus[i].get_test()->get_reg_info();
+  }
+  return result;
+}
+
 /**
    Decomposes scoped name into a vector of path elements.
    E.g., passing "cpunit::info", will cause the resulting vector
@@ -66,9 +66,12 @@ namespace cpunit {
     void insert_set_up(Callable *su);
     void insert_tear_down(Callable *td);
     void insert_test(Callable *test);
+    void insert_benchmark(Callable *bench);
 
     std::vector<TestUnit> get_test_units(const std::string &pattern);
     std::vector<RegInfo> get_tests(const std::string &pattern);
+    std::vector<TestUnit> get_benchmark_units(const std::string &pattern);
+    std::vector<RegInfo> get_benchmarks(const std::string &pattern);
   };
 
 }
@@ -39,6 +39,7 @@
 
 cpunit::TestTreeNode::TestTreeNode(const std::string &l_name)
   : tests()
+  , benchmarks()
   , children()
   , setUp(NULL)
   , tearDown(NULL)
@@ -55,6 +56,11 @@ cpunit::TestTreeNode::~TestTreeNode() {
     delete tit->second;
     tit++;
   }
+  tit = benchmarks.begin();
+  while (tit != benchmarks.end()) {
+    delete tit->second;
+    tit++;
+  }
 
   ChildMap::iterator cit = children.begin();
   while (cit != children.end()) {
@@ -108,13 +114,30 @@ cpunit::TestTreeNode::register_tear_down(Callable *t) {
 void 
 cpunit::TestTreeNode::add_test(Callable *test) {
   CPUNIT_DTRACE("TestTreeNode::add_test called in '"<<get_path()<<"' with method "<<test->get_reg_info().get_name());
-  if(tests.find(test->get_reg_info().get_name()) != tests.end()) {
+  insert(tests, test);
+}
+
+/**
+   Adds a benchmark. Benchmarks are kept apart from the tests, 
+   and are only extracted by extract_benchmark_matches.
+   @param bench The benchmark to add. The node takes over control of the object.
+   @throws WrongSetupException if the benchmark is already registered.
+ */
+void 
+cpunit::TestTreeNode::add_benchmark(Callable *bench) {
+  CPUNIT_DTRACE("TestTreeNode::add_benchmark called in '"<<get_path()<<"' with method "<<bench->get_reg_info().get_name());
+  insert(benchmarks, bench);
+}
+
+void 
+cpunit::TestTreeNode::insert(TestMap &map, Callable *test) {
+  if(map.find(test->get_reg_info().get_name()) != map.end()) {
     std::stringstream msg;
-    msg<<"The test '"<<test->get_reg_info().to_string()<<"' already exists in the namespace, registered at "<<tests.find(test->get_reg_info().get_name())->second->get_reg_info().to_string();
+    msg<<"The test '"<<test->get_reg_info().to_string()<<"' already exists in the namespace, registered at "<<map.find(test->get_reg_info().get_name())->second->get_reg_info().to_string();
     delete test;
     throw WrongSetupException(msg.str());
   }
-  tests.insert(std::make_pair(test->get_reg_info().get_name(), test));
+  map.insert(std::make_pair(test->get_reg_info().get_name(), test));
 }
 
 void cpunit::TestTreeNode::add_child(TestTreeNode *child) {
@@ -134,8 +157,19 @@ cpunit::TestTreeNode::get_children() {
 
 void 
 cpunit::TestTreeNode::extract_matches(std::vector<TestUnit>& result, const GlobMatcher& m) {
-  TestMap::iterator tit = tests.begin();
-  while (tit != tests.end()) {
+  extract(result, m, false);
+}
+
+void 
+cpunit::TestTreeNode::extract_benchmark_matches(std::vector<TestUnit>& result, const GlobMatcher& m) {
+  extract(result, m, true);
+}
+
+void 
+cpunit::TestTreeNode::extract(std::vector<TestUnit>& result, const GlobMatcher& m, const bool bench) {
+  TestMap &map = bench ? benchmarks : tests;
+  TestMap::iterator tit = map.begin();
+  while (tit != map.end()) {
     std::string full_name = tit->second->get_reg_info().get_path() + "::" + tit->second->get_reg_info().get_name();
     CPUNIT_DTRACE("Checking match for '"<<full_name<<'\'');
     if (m.matches(full_name)) {
@@ -147,7 +181,7 @@ cpunit::TestTreeNode::extract_matches(std::vector<TestUnit>& result, const GlobM
 
   ChildMap::iterator cit = children.begin();
   while (cit != children.end()) {
-    cit->second->extract_matches(result, m);
+    cit->second->extract(result, m, bench);
     cit++;
   }
 }
@@ -50,12 +50,16 @@ namespace cpunit {
     typedef std::map<std::string, TestTreeNode*> ChildMap;
 
     TestMap tests;
+    TestMap benchmarks;
     ChildMap children;
     Callable *setUp, *tearDown;
     TestTreeNode const *parent;
     const std::string *local_name;
     const StringFlyweightStoreUsage counter;
 
+    void insert(TestMap &map, Callable *test);
+    void extract(std::vector<TestUnit>& result, const GlobMatcher& m, const bool bench);
+
   public:
     TestTreeNode(const std::string &loc_name);
     virtual ~TestTreeNode();
@@ -67,11 +71,13 @@ namespace cpunit {
     void register_set_up(Callable *s);
     void register_tear_down(Callable *t);
     void add_test(Callable *test);
+    void add_benchmark(Callable *bench);
     void add_child(TestTreeNode *child);
 
     std::map<std::string, TestTreeNode*> get_children();
 
     void extract_matches(std::vector<TestUnit>& result, const GlobMatcher& m);
+    void extract_benchmark_matches(std::vector<TestUnit>& result, const GlobMatcher& m);
   };
 
 }
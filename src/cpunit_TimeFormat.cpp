@@ -33,8 +33,24 @@
 #include <iomanip>
 #include <sstream>
 
+cpunit::TimeFormat::Resolution cpunit::TimeFormat::default_resolution = cpunit::TimeFormat::MILLISECONDS;
+
+/**
+   Formats the time with the default resolution.
+   @param s The time in seconds.
+ */
 cpunit::TimeFormat::TimeFormat(const double s) :
-  secs(s)
+  secs(s),
+  resolution(default_resolution)
+{}
+
+/**
+   @param s The time in seconds.
+   @param r The number of decimals to print.
+ */
+cpunit::TimeFormat::TimeFormat(const double s, const Resolution r) :
+  secs(s),
+  resolution(r)
 {}
 
 cpunit::TimeFormat::~TimeFormat()
@@ -43,13 +59,46 @@ cpunit::TimeFormat::~TimeFormat()
 std::string
 cpunit::TimeFormat::get_formatted_time() const {
   std::ostringstream oss;
-  oss<<std::fixed<<std::setprecision(3);
+  oss<<std::fixed<<std::setprecision(static_cast<int>(resolution));
   oss<<secs;
   // ::sprintf(buffer, "%4.3f", secs);
   //return std::string(buffer);
   return oss.str();
 }
 
+/**
+   Sets the resolution used by TimeFormat(double). 
+   Should be called before any tests are started.
+ */
+void
+cpunit::TimeFormat::set_default_resolution(const Resolution r) {
+  default_resolution = r;
+}
+
+cpunit::TimeFormat::Resolution
+cpunit::TimeFormat::get_default_resolution() {
+  return default_resolution;
+}
+
+/**
+   @param unit One of "ms", "us" and "ns".
+   @param r    Set to the corresponding resolution.
+   @return false if the unit is not known, in which case r is unchanged.
+ */
+bool
+cpunit::TimeFormat::parse_resolution(const std::string &unit, Resolution &r) {
+  if (unit == "ms") {
+    r = MILLISECONDS;
+  } else if (unit == "us") {
+    r = MICROSECONDS;
+  } else if (unit == "ns") {
+    r = NANOSECONDS;
+  } else {
+    return false;
+  }
+  return true;
+}
+
 std::ostream&
 cpunit::operator << (std::ostream &out, const TimeFormat &f) {
   out<<f.get_formatted_time();
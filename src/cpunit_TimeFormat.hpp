@@ -36,13 +36,33 @@
 
 namespace cpunit {
 
+  /**
+     Formats a number of seconds with a fixed number of decimals, 
+     given by the resolution. The default resolution is milliseconds.
+   */
   class TimeFormat {
+  public:
+    enum Resolution {
+      MILLISECONDS = 3,
+      MICROSECONDS = 6,
+      NANOSECONDS = 9
+    };
+
+  private:
     const double secs;
+    const Resolution resolution;
+
+    static Resolution default_resolution;
   public:
     explicit TimeFormat(const double seconds);
+    TimeFormat(const double seconds, const Resolution r);
     virtual ~TimeFormat();
 
     std::string get_formatted_time() const;
+
+    static void set_default_resolution(const Resolution r);
+    static Resolution get_default_resolution();
+    static bool parse_resolution(const std::string &unit, Resolution &r);
   };
 
   std::ostream& operator << (std::ostream &out, const TimeFormat &f);
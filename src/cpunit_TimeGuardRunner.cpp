@@ -30,16 +30,19 @@
 
 
 #include "cpunit_Assert.hpp"
+#include "cpunit_ResourceUsage.hpp"
 #include "cpunit_StopWatch.hpp"
 #include "cpunit_TimeGuardRunner.hpp"
 #include "cpunit_TimeFormat.hpp"
 #include "cpunit_trace.hpp"
+#include "cpunit_impl_Watchdog.hpp"
 #include <string>
 #include <sstream>
 
-cpunit::TimeGuardRunner::TimeGuardRunner(const double max) :
+cpunit::TimeGuardRunner::TimeGuardRunner(const double max, impl::Watchdog *w) :
   TestRunnerDecorator(),
-  max_time(max) {
+  max_time(max),
+  watchdog(w) {
     CPUNIT_ITRACE("TimeGuardRunner - instantiated.");
 }
 
@@ -49,10 +52,16 @@ cpunit::TimeGuardRunner::~TimeGuardRunner() {
 
 cpunit::ExecutionReport
 cpunit::TimeGuardRunner::run(Callable& tu) const  {
+  const ResourceUsage before = ResourceUsage::of_this_thread();
   StopWatch sw;
   sw.start();
-  ExecutionReport result = inner_run(tu);
+  ExecutionReport result;
+  {
+    impl::WatchdogGuard guard(watchdog, tu.get_reg_info());
+    result = inner_run(tu);
+  }
   result.set_time_spent(sw.stop());
+  result.set_resource_usage(ResourceUsage::of_this_thread() - before);
 
   if (result.get_time_spent() > max_time) {
     CPUNIT_DTRACE("TimeGuardRunner::run failed, test took "<<result.get_time_spent()<<"s. vs "<<max_time<<'s');
@@ -34,12 +34,25 @@
 
 #include "cpunit_TestRunnerDecorator.hpp"
 
+#include <cstddef>
+
 namespace cpunit {
 
+  namespace impl {
+    class Watchdog;
+  }
+
+  /**
+     Measures the time spent by a test, and fails it if exceeding max_time.
+     Since the check is made once the test has returned, it cannot stop a test
+     that hangs. For that, a Watchdog may be given, which is armed while the 
+     test runs.
+   */
   class TimeGuardRunner : public TestRunnerDecorator {
     const double max_time;
+    impl::Watchdog *watchdog;
   public:
-    explicit TimeGuardRunner(const double max);
+    explicit TimeGuardRunner(const double max, impl::Watchdog *watchdog = NULL);
     virtual ~TimeGuardRunner();
     
     virtual cpunit::ExecutionReport run(Callable&) const;
@@ -0,0 +1,390 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_TimingDatabase.hpp"
+#include "cpunit_CPUnitException.hpp"
+#include "cpunit_trace.hpp"
+#include "cpunit_impl_Hash.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+  const char MAGIC[8] = { 'C', 'P', 'U', 'T', 'D', 'B', '0', '1' };
+  const uint32_t VERSION = 1;
+  const uint32_t ENDIAN_MARK = 0x01020304UL;
+
+  struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endian_mark;
+  };
+
+  /**
+     The fixed size part of a record. The name follows directly after.
+   */
+  struct RecordHeader {
+    uint64_t key;
+    uint32_t name_length;
+    uint32_t count;
+    double last_time;
+    double last_set_up_time;
+    double mean;
+    double variance;
+  };
+
+  const std::size_t NO_OFFSET = static_cast<std::size_t>(-1);
+
+  std::size_t padded(const std::size_t n) {
+    return (n + 7) & ~static_cast<std::size_t>(7);
+  }
+
+  std::string qualified_name(const cpunit::RegInfo &ri) {
+    return ri.get_path() + "::" + ri.get_name();
+  }
+
+  void write_at(const int fd, const void *buf, const std::size_t len, const std::size_t offset, const std::string &path) {
+    const char *p = static_cast<const char*>(buf);
+    std::size_t put = 0;
+    while (put < len) {
+      const ssize_t n = pwrite(fd, p + put, len - put, offset + put);
+      if (n < 0 && errno == EINTR) {
+	continue;
+      }
+      if (n <= 0) {
+	throw cpunit::CPUnitException("Unable to write timing database '" + path + "': " + std::strerror(errno));
+      }
+      put += n;
+    }
+  }
+
+  /**
+     Closes a file descriptor, and thereby releases any lock on it, when going out of scope.
+   */
+  struct FdCloser {
+    const int fd;
+    FdCloser(const int f) : fd(f) {}
+    ~FdCloser() { close(fd); }
+  };
+}
+
+const uint32_t cpunit::TimingDatabase::WINDOW;
+
+cpunit::TimingDatabase::Entry::Entry() :
+  count(0),
+  last_time(.0),
+  last_set_up_time(.0),
+  mean(.0),
+  variance(.0)
+{}
+
+/**
+   Adds one run to the history.
+   @param time        The wall time of the run, in seconds, including set-up.
+   @param set_up_time The set-up time of the run, in seconds.
+ */
+void
+cpunit::TimingDatabase::Entry::add(const double time, const double set_up_time) {
+  const double alpha = 1.0 / (count < WINDOW ? count + 1 : WINDOW);
+  const double diff = time - mean;
+  const double incr = alpha * diff;
+  mean += incr;
+  variance = (1.0 - alpha) * (variance + diff * incr);
+  last_time = time;
+  last_set_up_time = set_up_time;
+  if (count < 0xffffffffUL) {
+    ++count;
+  }
+}
+
+/**
+   Loads the database in the given file. A missing file gives an empty database,
+   which is created by the first call to save().
+   @param path The name of the database file.
+   @throws CPUnitException if the file exists, but cannot be read, or is not a timing database.
+ */
+cpunit::TimingDatabase::TimingDatabase(const std::string &p) :
+  path(p),
+  data(NULL),
+  length(0),
+  valid_length(0),
+  index(),
+  pending()
+{
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      CPUNIT_ITRACE("TimingDatabase - '"<<path<<"' does not exist, starting empty.");
+      return;
+    }
+    throw CPUnitException("Unable to open timing database '" + path + "': " + std::strerror(errno));
+  }
+  FdCloser closer(fd);
+  load(fd);
+}
+
+cpunit::TimingDatabase::~TimingDatabase() {
+  unload();
+}
+
+const std::string&
+cpunit::TimingDatabase::get_path() const {
+  return path;
+}
+
+/**
+   @return The number of tests with a recorded history, including the ones not yet saved.
+ */
+std::size_t
+cpunit::TimingDatabase::size() const {
+  std::size_t result = index.size();
+  for (std::map<std::string, Pending>::const_iterator it = pending.begin(); it != pending.end(); ++it) {
+    if (it->second.offset == NO_OFFSET) {
+      ++result;
+    }
+  }
+  return result;
+}
+
+/**
+   @param test  The test to look up.
+   @param entry Receives the history of the test, if found.
+   @return true if the test has a recorded history.
+ */
+bool
+cpunit::TimingDatabase::lookup(const RegInfo &test, Entry &entry) const {
+  const std::string name = qualified_name(test);
+  std::map<std::string, Pending>::const_iterator it = pending.find(name);
+  if (it != pending.end()) {
+    entry = it->second.entry;
+    return true;
+  }
+  const std::size_t offset = find(impl::hash_string(name), name);
+  if (offset == NO_OFFSET) {
+    return false;
+  }
+  RecordHeader rh;
+  std::memcpy(&rh, data + offset, sizeof(rh));
+  entry.count = rh.count;
+  entry.last_time = rh.last_time;
+  entry.last_set_up_time = rh.last_set_up_time;
+  entry.mean = rh.mean;
+  entry.variance = rh.variance;
+  return true;
+}
+
+/**
+   Adds the timings of the reports to the history. The changes are kept in
+   memory until save() is called.
+ */
+void
+cpunit::TimingDatabase::record(const std::vector<ExecutionReport> &reports) {
+  for (std::size_t i=0; i<reports.size(); ++i) {
+    record(reports[i]);
+  }
+}
+
+void
+cpunit::TimingDatabase::record(const ExecutionReport &report) {
+  const std::string name = qualified_name(report.get_test());
+  std::map<std::string, Pending>::iterator it = pending.find(name);
+  if (it == pending.end()) {
+    Pending p;
+    p.key = impl::hash_string(name);
+    p.offset = find(p.key, name);
+    lookup(report.get_test(), p.entry);
+    it = pending.insert(std::make_pair(name, p)).first;
+  }
+  it->second.entry.add(report.get_time_spent(), report.get_set_up_time());
+}
+
+/**
+   Writes the recorded changes to the file, and reloads it.
+   The file is locked while it is written, so that several test
+   processes may share one database. Changes to a test made by
+   another process since this database was loaded are overwritten.
+   @throws CPUnitException if the file cannot be written.
+ */
+void
+cpunit::TimingDatabase::save() {
+  if (pending.empty()) {
+    return;
+  }
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0) {
+    throw CPUnitException("Unable to open timing database '" + path + "': " + std::strerror(errno));
+  }
+  FdCloser closer(fd);
+  if (flock(fd, LOCK_EX) != 0) {
+    throw CPUnitException("Unable to lock timing database '" + path + "': " + std::strerror(errno));
+  }
+
+  // Pick up whatever other processes have written since we loaded.
+  unload();
+  load(fd);
+
+  std::size_t end = valid_length;
+  if (end == 0) {
+    FileHeader fh;
+    std::memcpy(fh.magic, MAGIC, sizeof(MAGIC));
+    fh.version = VERSION;
+    fh.endian_mark = ENDIAN_MARK;
+    write_at(fd, &fh, sizeof(fh), 0, path);
+    end = sizeof(fh);
+  }
+
+  std::vector<char> appended;
+  for (std::map<std::string, Pending>::const_iterator it = pending.begin(); it != pending.end(); ++it) {
+    const std::string &name = it->first;
+    const Entry &e = it->second.entry;
+    RecordHeader rh;
+    rh.key = it->second.key;
+    rh.name_length = static_cast<uint32_t>(name.length());
+    rh.count = e.count;
+    rh.last_time = e.last_time;
+    rh.last_set_up_time = e.last_set_up_time;
+    rh.mean = e.mean;
+    rh.variance = e.variance;
+
+    const std::size_t offset = find(rh.key, name);
+    if (offset != NO_OFFSET) {
+      write_at(fd, &rh, sizeof(rh), offset, path);
+    } else {
+      const std::size_t at = appended.size();
+      appended.resize(at + sizeof(rh) + padded(name.length()), '\0');
+      std::memcpy(&appended[at], &rh, sizeof(rh));
+      std::memcpy(&appended[at + sizeof(rh)], name.data(), name.length());
+    }
+  }
+  if (!appended.empty()) {
+    write_at(fd, &appended[0], appended.size(), end, path);
+    end += appended.size();
+  }
+
+  // Cut off a torn record left by an interrupted writer, if we did not overwrite it.
+  struct stat st;
+  if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) > end) {
+    if (ftruncate(fd, end) != 0) {
+      throw CPUnitException("Unable to truncate timing database '" + path + "': " + std::strerror(errno));
+    }
+  }
+  CPUNIT_ITRACE("TimingDatabase - Saved "<<pending.size()<<" tests to '"<<path<<"', appending "<<appended.size()<<" bytes.");
+
+  pending.clear();
+  unload();
+  load(fd);
+}
+
+/**
+   Maps the file and builds the index.
+   A record running past the end of the file, as left by an interrupted
+   writer, is ignored, and overwritten by the next save().
+ */
+void
+cpunit::TimingDatabase::load(const int fd) {
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    throw CPUnitException("Unable to stat timing database '" + path + "': " + std::strerror(errno));
+  }
+  const std::size_t file_size = static_cast<std::size_t>(st.st_size);
+  if (file_size == 0) {
+    return;
+  }
+  if (file_size < sizeof(FileHeader)) {
+    throw CPUnitException("'" + path + "' is not a timing database.");
+  }
+
+  void *p = mmap(NULL, file_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED) {
+    throw CPUnitException("Unable to map timing database '" + path + "': " + std::strerror(errno));
+  }
+  data = static_cast<const char*>(p);
+  length = file_size;
+
+  FileHeader fh;
+  std::memcpy(&fh, data, sizeof(fh));
+  if (std::memcmp(fh.magic, MAGIC, sizeof(MAGIC)) != 0 || fh.version != VERSION || fh.endian_mark != ENDIAN_MARK) {
+    unload();
+    throw CPUnitException("'" + path + "' is not a timing database of this version and platform.");
+  }
+
+  std::size_t offset = sizeof(FileHeader);
+  while (offset + sizeof(RecordHeader) <= file_size) {
+    RecordHeader rh;
+    std::memcpy(&rh, data + offset, sizeof(rh));
+    const std::size_t next = offset + sizeof(rh) + padded(rh.name_length);
+    if (next > file_size) {
+      break;
+    }
+    index.push_back(Slot(rh.key, offset));
+    offset = next;
+  }
+  std::sort(index.begin(), index.end());
+  CPUNIT_ITRACE("TimingDatabase - Loaded "<<index.size()<<" tests from '"<<path<<"'.");
+  if (offset < file_size) {
+    CPUNIT_DTRACE("TimingDatabase - Ignoring "<<(file_size - offset)<<" trailing bytes.");
+  }
+  valid_length = offset;
+}
+
+void
+cpunit::TimingDatabase::unload() {
+  if (data != NULL) {
+    munmap(const_cast<char*>(data), length);
+  }
+  data = NULL;
+  length = 0;
+  valid_length = 0;
+  index.clear();
+}
+
+/**
+   @return The offset of the record of the named test, or NO_OFFSET if it has none.
+ */
+std::size_t
+cpunit::TimingDatabase::find(const uint64_t key, const std::string &name) const {
+  std::vector<Slot>::const_iterator it = std::lower_bound(index.begin(), index.end(), Slot(key, 0));
+  for (; it != index.end() && it->first == key; ++it) {
+    RecordHeader rh;
+    std::memcpy(&rh, data + it->second, sizeof(rh));
+    if (rh.name_length == name.length() && 
+	std::memcmp(data + it->second + sizeof(rh), name.data(), name.length()) == 0) {
+      return it->second;
+    }
+  }
+  return NO_OFFSET;
+}
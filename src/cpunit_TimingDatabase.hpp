@@ -0,0 +1,116 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_TIMINGDATABASE_HPP
+#define CPUNIT_TIMINGDATABASE_HPP
+
+#include "cpunit_ExecutionReport.hpp"
+#include "cpunit_RegInfo.hpp"
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+namespace cpunit {
+
+  /**
+     Persistent per-test timing history, kept in a binary file.
+
+     The file is a 16 byte header followed by variable length records,
+     each a fixed size part (key, counters and timings) and the fully 
+     qualified test name, padded to a multiple of 8 bytes. The file is 
+     memory mapped when loaded, and indexed by a sorted array of
+     (key, offset) pairs, where the key is the stable hash of the test name.
+     Saving rewrites the fixed part of known tests in place, and appends 
+     records for new tests, so the file is never rewritten as a whole.
+
+     The mean and variance of the wall time are rolling: they are exact
+     for the first WINDOW runs of a test, and exponentially weighted with
+     a factor 1/WINDOW after that, so that they follow tests whose 
+     durations change over time.
+   */
+  class TimingDatabase {
+  public:
+    static const uint32_t WINDOW = 32;
+
+    /**
+       The timing history of one test.
+     */
+    struct Entry {
+      uint32_t count;          // Number of recorded runs.
+      double last_time;        // Wall time of the last run, in seconds, including set-up.
+      double last_set_up_time; // Set-up time of the last run, in seconds.
+      double mean;             // Rolling mean of the wall time.
+      double variance;         // Rolling variance of the wall time.
+
+      Entry();
+      void add(const double time, const double set_up_time);
+    };
+
+  private:
+    struct Pending {
+      uint64_t key;
+      std::size_t offset;
+      Entry entry;
+    };
+    typedef std::pair<uint64_t, std::size_t> Slot;
+
+    std::string path;
+    const char *data;
+    std::size_t length;
+    std::size_t valid_length;
+    std::vector<Slot> index;
+    std::map<std::string, Pending> pending;
+
+    void load(const int fd);
+    void unload();
+    std::size_t find(const uint64_t key, const std::string &name) const;
+
+    // No copy.
+    TimingDatabase(const TimingDatabase&);
+    TimingDatabase& operator = (const TimingDatabase&);
+  public:
+    explicit TimingDatabase(const std::string &path);
+    virtual ~TimingDatabase();
+
+    const std::string& get_path() const;
+    std::size_t size() const;
+    bool lookup(const RegInfo &test, Entry &entry) const;
+    void record(const std::vector<ExecutionReport> &reports);
+    void record(const ExecutionReport &report);
+    void save();
+  };
+
+}
+
+#endif // CPUNIT_TIMINGDATABASE_HPP
@@ -0,0 +1,79 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#ifndef CPUNIT_IMPL_ALLOCATIONCOUNTERS_HPP
+#define CPUNIT_IMPL_ALLOCATIONCOUNTERS_HPP
+
+#include "cpunit_impl_LiveBlockTable.hpp"
+
+#include <cstddef>
+
+namespace cpunit {
+  namespace impl {
+
+    /**
+       The counters of one thread, kept by AllocationTracker and updated by
+       the replacement operators of the CPUnitAllocationHooks library. Live 
+       bytes are signed, since a block may be deallocated by another thread 
+       than the one allocating it.
+     */
+    struct AllocationCounters {
+      std::size_t allocations;
+      std::size_t deallocations;
+      std::size_t bytes;
+      long live;
+      long peak;
+      std::size_t mark_allocations;
+      std::size_t mark_deallocations;
+      std::size_t mark_bytes;
+      long mark_live;
+      bool forbidden;
+      std::size_t refused;
+      unsigned long leak_serial;
+      bool recording;
+      std::size_t recorded;
+    };
+
+    // Zero-initialized, so it is usable by operator new before any constructors have run.
+    extern __thread AllocationCounters allocation_counters;
+
+    // The blocks recorded by leak checks, created when leak detection is enabled.
+    extern LiveBlockTable *live_blocks;
+
+    /**
+       Defined by the CPUnitAllocationHooks library. Prepares the call 
+       stacks of recorded blocks to leave out the allocation functions.
+     */
+    void prepare_leak_recording();
+  }
+}
+
+#endif // CPUNIT_IMPL_ALLOCATIONCOUNTERS_HPP
@@ -0,0 +1,637 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+#include "cpunit_impl_ArrayCompare.hpp"
+#include "cpunit_impl_FloatCompare.hpp"
+#include "cpunit_trace.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#if !defined(CPUNIT_NO_SIMD) && (defined(__x86_64__) || defined(__i386__)) && \
+  (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+# include <immintrin.h>
+# define CPUNIT_HAS_SIMD
+#endif
+
+namespace {
+
+  /**
+     Matches elements with impl::is_close. The vector kernels 
+     compute the same, in the same precision.
+   */
+  template<class T>
+  struct CloseMatcher {
+    const T abs_tol;
+    const T rel_tol;
+
+    CloseMatcher(const T abs, const T rel) :
+      abs_tol(abs),
+      rel_tol(rel)
+    {}
+
+    bool operator () (const T expected, const T actual) const {
+      return cpunit::impl::is_close(expected, actual, abs_tol, rel_tol);
+    }
+  };
+
+  /**
+     Matches elements with impl::within_ulps.
+   */
+  template<class T>
+  struct UlpMatcher {
+    const uint64_t max_ulps;
+
+    explicit UlpMatcher(const uint64_t max) :
+      max_ulps(max)
+    {}
+
+    bool operator () (const T expected, const T actual) const {
+      return cpunit::impl::within_ulps(expected, actual, max_ulps);
+    }
+  };
+
+  /**
+     Matches bytes that are equal.
+   */
+  struct ByteMatcher {
+    bool operator () (const unsigned char expected, const unsigned char actual) const {
+      return expected == actual;
+    }
+  };
+
+  // Byte arrays are compared with memcmp in chunks of this size, and only
+  // the chunks that differ are scanned to count the differing bytes.
+  const std::size_t BYTE_CHUNK = 1 << 16;
+
+  template<class T, class M>
+  cpunit::impl::ArrayMismatches find_scalar(const T *expected, const T *actual, const std::size_t begin, const std::size_t n, const M &matches, cpunit::impl::ArrayMismatches m) {
+    for (std::size_t i=begin; i<n; ++i) {
+      if (!matches(expected[i], actual[i])) {
+	if (m.count == 0) {
+	  m.first = i;
+	}
+	++m.count;
+      }
+    }
+    return m;
+  }
+
+  cpunit::impl::ArrayMismatches no_mismatches(const std::size_t n) {
+    cpunit::impl::ArrayMismatches m;
+    m.count = 0;
+    m.first = n;
+    return m;
+  }
+
+  /**
+     Adds the elements set in a mask of differing elements, 
+     the lowest bit being the element at index i.
+   */
+  inline void add_mismatches(cpunit::impl::ArrayMismatches &m, const std::size_t i, const unsigned int mask) {
+    if (mask != 0) {
+      if (m.count == 0) {
+	m.first = i + __builtin_ctz(mask);
+      }
+      m.count += __builtin_popcount(mask);
+    }
+  }
+
+#ifdef CPUNIT_HAS_SIMD
+
+  __attribute__((target("sse2")))
+  cpunit::impl::ArrayMismatches find_sse2(const float *expected, const float *actual, const std::size_t n, const float abs_tol, const float rel_tol) {
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 inf  = _mm_set1_ps(std::numeric_limits<float>::infinity());
+    const __m128 at   = _mm_set1_ps(abs_tol);
+    const __m128 rt   = _mm_set1_ps(rel_tol);
+    cpunit::impl::ArrayMismatches m = no_mismatches(n);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      const __m128 e    = _mm_loadu_ps(expected + i);
+      const __m128 a    = _mm_loadu_ps(actual + i);
+      const __m128 ae   = _mm_andnot_ps(sign, e);
+      const __m128 diff = _mm_andnot_ps(sign, _mm_sub_ps(a, e));
+      const __m128 tol  = _mm_add_ps(at, _mm_mul_ps(rt, ae));
+      const __m128 ok   = _mm_or_ps(_mm_cmpeq_ps(e, a), _mm_and_ps(_mm_cmplt_ps(ae, inf), _mm_cmple_ps(diff, tol)));
+      add_mismatches(m, i, ~_mm_movemask_ps(ok) & 0xF);
+    }
+    return find_scalar(expected, actual, i, n, CloseMatcher<float>(abs_tol, rel_tol), m);
+  }
+
+  __attribute__((target("sse2")))
+  cpunit::impl::ArrayMismatches find_sse2(const double *expected, const double *actual, const std::size_t n, const double abs_tol, const double rel_tol) {
+    const __m128d sign = _mm_set1_pd(-0.0);
+    const __m128d inf  = _mm_set1_pd(std::numeric_limits<double>::infinity());
+    const __m128d at   = _mm_set1_pd(abs_tol);
+    const __m128d rt   = _mm_set1_pd(rel_tol);
+    cpunit::impl::ArrayMismatches m = no_mismatches(n);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+      const __m128d e    = _mm_loadu_pd(expected + i);
+      const __m128d a    = _mm_loadu_pd(actual + i);
+      const __m128d ae   = _mm_andnot_pd(sign, e);
+      const __m128d diff = _mm_andnot_pd(sign, _mm_sub_pd(a, e));
+      const __m128d tol  = _mm_add_pd(at, _mm_mul_pd(rt, ae));
+      const __m128d ok   = _mm_or_pd(_mm_cmpeq_pd(e, a), _mm_and_pd(_mm_cmplt_pd(ae, inf), _mm_cmple_pd(diff, tol)));
+      add_mismatches(m, i, ~_mm_movemask_pd(ok) & 0x3);
+    }
+    return find_scalar(expected, actual, i, n, CloseMatcher<double>(abs_tol, rel_tol), m);
+  }
+
+  __attribute__((target("avx2")))
+  cpunit::impl::ArrayMismatches find_avx2(const float *expected, const float *actual, const std::size_t n, const float abs_tol, const float rel_tol) {
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 inf  = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+    const __m256 at   = _mm256_set1_ps(abs_tol);
+    const __m256 rt   = _mm256_set1_ps(rel_tol);
+    cpunit::impl::ArrayMismatches m = no_mismatches(n);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      const __m256 e    = _mm256_loadu_ps(expected + i);
+      const __m256 a    = _mm256_loadu_ps(actual + i);
+      const __m256 ae   = _mm256_andnot_ps(sign, e);
+      const __m256 diff = _mm256_andnot_ps(sign, _mm256_sub_ps(a, e));
+      const __m256 tol  = _mm256_add_ps(at, _mm256_mul_ps(rt, ae));
+      const __m256 ok   = _mm256_or_ps(_mm256_cmp_ps(e, a, _CMP_EQ_OQ), 
+				       _mm256_and_ps(_mm256_cmp_ps(ae, inf, _CMP_LT_OQ), _mm256_cmp_ps(diff, tol, _CMP_LE_OQ)));
+      add_mismatches(m, i, ~_mm256_movemask_ps(ok) & 0xFF);
+    }
+    return find_scalar(expected, actual, i, n, CloseMatcher<float>(abs_tol, rel_tol), m);
+  }
+
+  __attribute__((target("avx2")))
+  cpunit::impl::ArrayMismatches find_avx2(const double *expected, const double *actual, const std::size_t n, const double abs_tol, const double rel_tol) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d inf  = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    const __m256d at   = _mm256_set1_pd(abs_tol);
+    const __m256d rt   = _mm256_set1_pd(rel_tol);
+    cpunit::impl::ArrayMismatches m = no_mismatches(n);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      const __m256d e    = _mm256_loadu_pd(expected + i);
+      const __m256d a    = _mm256_loadu_pd(actual + i);
+      const __m256d ae   = _mm256_andnot_pd(sign, e);
+      const __m256d diff = _mm256_andnot_pd(sign, _mm256_sub_pd(a, e));
+      const __m256d tol  = _mm256_add_pd(at, _mm256_mul_pd(rt, ae));
+      const __m256d ok   = _mm256_or_pd(_mm256_cmp_pd(e, a, _CMP_EQ_OQ), 
+					_mm256_and_pd(_mm256_cmp_pd(ae, inf, _CMP_LT_OQ), _mm256_cmp_pd(diff, tol, _CMP_LE_OQ)));
+      add_mismatches(m, i, ~_mm256_movemask_pd(ok) & 0xF);
+    }
+    return find_scalar(expected, actual, i, n, CloseMatcher<double>(abs_tol, rel_tol), m);
+  }
+
+  // The largest distance in ulps of two floats, which is below 2^32.
+  uint32_t max_float_ulps(const uint64_t max_ulps) {
+    return max_ulps > 0xFFFFFFFFu ? 0xFFFFFFFFu : static_cast<uint32_t>(max_ulps);
+  }
+
+  /**
+     The ulp kernels map the bits of each element to a signed integer with
+     the order of the values, as impl::within_ulps does with an unsigned one.
+     The distance fits the unsigned integer, and is compared to the maximum
+     with the sign bits flipped, as there are no unsigned vector compares.
+   */
+  __attribute__((target("sse2")))
+  cpunit::impl::ArrayMismatches find_ulps_sse2(const float *expected, const float *actual, const std::size_t n, const uint64_t max_ulps) {
+    const __m128i magnitude = _mm_set1_epi32(0x7FFFFFFF);
+    const __m128i inf       = _mm_set1_epi32(0x7F800000);
+    const __m128i flip      = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    const __m128i max       = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(max_float_ulps(max_ulps))), flip);
+    cpunit::impl::ArrayMismatches m = no_mismatches(n);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      const __m128i be   = _mm_castps_si128(_mm_loadu_ps(expected + i));
+      const __m128i ba   = _mm_castps_si128(_mm_loadu_ps(actual + i));
+      const __m128i me   = _mm_and_si128(be, magnitude);
+      const __m128i ma   = _mm_and_si128(ba, magnitude);
+      const __m128i ne   = _mm_srai_epi32(be, 31);
+      const __m128i na   = _mm_srai_epi32(ba, 31);
+      const __m128i oe   = _mm_sub_epi32(_mm_xor_si128(me, ne), ne);
+      const __m128i oa   = _mm_sub_epi32(_mm_xor_si128(ma, na), na);
+      const __m128i gt   = _mm_cmpgt_epi32(oe, oa);
+      const __m128i dist = _mm_or_si128(_mm_and_si128(gt, _mm_sub_epi32(oe, oa)), _mm_andnot_si128(gt, _mm_sub_epi32(oa, oe)));
+      const __m128i far  = _mm_cmpgt_epi32(_mm_xor_si128(dist, flip), max);
+      const __m128i nan  = _mm_or_si128(_mm_cmpgt_epi32(me, inf), _mm_cmpgt_epi32(ma, inf));
+      const __m128i infs = _mm_or_si128(_mm_cmpeq_epi32(me, inf), _mm_cmpeq_epi32(ma, inf));
+      const __m128i bad  = _mm_or_si128(_mm_or_si128(far, nan), _mm_andnot_si128(_mm_cmpeq_epi32(oe, oa), infs));
+      add_mismatches(m, i, _mm_movemask_ps(_mm_castsi128_ps(bad)));
+    }
+    return find_scalar(expected, actual, i, n, UlpMatcher<float>(max_ulps), m);
+  }
+
+  // SSE2 has no 64 bit compares, so doubles are compared one by one.
+  cpunit::impl::ArrayMismatches find_ulps_sse2(const double *expected, const double *actual, const std::size_t n, const uint64_t max_ulps) {
+    return find_scalar(expected, actual, 0, n, UlpMatcher<double>(max_ulps), no_mismatches(n));
+  }
+
+  __attribute__((target("avx2")))
+  cpunit::impl::ArrayMismatches find_ulps_avx2(const float *expected, const float *actual, const std::size_t n, const uint64_t max_ulps) {
+    const __m256i magnitude = _mm256_set1_epi32(0x7FFFFFFF);
+    const __m256i inf       = _mm256_set1_epi32(0x7F800000);
+    const __m256i flip      = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+    const __m256i max       = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(max_float_ulps(max_ulps))), flip);
+    cpunit::impl::ArrayMismatches m = no_mismatches(n);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      const __m256i be   = _mm256_castps_si256(_mm256_loadu_ps(expected + i));
+      const __m256i ba   = _mm256_castps_si256(_mm256_loadu_ps(actual + i));
+      const __m256i me   = _mm256_and_si256(be, magnitude);
+      const __m256i ma   = _mm256_and_si256(ba, magnitude);
+      const __m256i ne   = _mm256_srai_epi32(be, 31);
+      const __m256i na   = _mm256_srai_epi32(ba, 31);
+      const __m256i oe   = _mm256_sub_epi32(_mm256_xor_si256(me, ne), ne);
+      const __m256i oa   = _mm256_sub_epi32(_mm256_xor_si256(ma, na), na);
+      const __m256i gt   = _mm256_cmpgt_epi32(oe, oa);
+      const __m256i dist = _mm256_or_si256(_mm256_and_si256(gt, _mm256_sub_epi32(oe, oa)), _mm256_andnot_si256(gt, _mm256_sub_epi32(oa, oe)));
+      const __m256i far  = _mm256_cmpgt_epi32(_mm256_xor_si256(dist, flip), max);
+      const __m256i nan  = _mm256_or_si256(_mm256_cmpgt_epi32(me, inf), _mm256_cmpgt_epi32(ma, inf));
+      const __m256i infs = _mm256_or_si256(_mm256_cmpeq_epi32(me, inf), _mm256_cmpeq_epi32(ma, inf));
+      const __m256i bad  = _mm256_or_si256(_mm256_or_si256(far, nan), _mm256_andnot_si256(_mm256_cmpeq_epi32(oe, oa), infs));
+      add_mismatches(m, i, _mm256_movemask_ps(_mm256_castsi256_ps(bad)));
+    }
+    return find_scalar(expected, actual, i, n, UlpMatcher<float>(max_ulps), m);
+  }
+
+  __attribute__((target("avx2")))
+  cpunit::impl::ArrayMismatches find_ulps_avx2(const double *expected, const double *actual, const std::size_t n, const uint64_t max_ulps) {
+    const uint64_t sign     = static_cast<uint64_t>(1) << 63;
+    const __m256i magnitude = _mm256_set1_epi64x(static_cast<int64_t>(~sign));
+    const __m256i inf       = _mm256_set1_epi64x(static_cast<int64_t>(cpunit::impl::floatcompare::bits_of(std::numeric_limits<double>::infinity())));
+    const __m256i flip      = _mm256_set1_epi64x(static_cast<int64_t>(sign));
+    const __m256i max       = _mm256_set1_epi64x(static_cast<int64_t>(max_ulps ^ sign));
+    const __m256i zero      = _mm256_setzero_si256();
+    cpunit::impl::ArrayMismatches m = no_mismatches(n);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      const __m256i be   = _mm256_castpd_si256(_mm256_loadu_pd(expected + i));
+      const __m256i ba   = _mm256_castpd_si256(_mm256_loadu_pd(actual + i));
+      const __m256i me   = _mm256_and_si256(be, magnitude);
+      const __m256i ma   = _mm256_and_si256(ba, magnitude);
+      const __m256i ne   = _mm256_cmpgt_epi64(zero, be);
+      const __m256i na   = _mm256_cmpgt_epi64(zero, ba);
+      const __m256i oe   = _mm256_sub_epi64(_mm256_xor_si256(me, ne), ne);
+      const __m256i oa   = _mm256_sub_epi64(_mm256_xor_si256(ma, na), na);
+      const __m256i gt   = _mm256_cmpgt_epi64(oe, oa);
+      const __m256i dist = _mm256_or_si256(_mm256_and_si256(gt, _mm256_sub_epi64(oe, oa)), _mm256_andnot_si256(gt, _mm256_sub_epi64(oa, oe)));
+      const __m256i far  = _mm256_cmpgt_epi64(_mm256_xor_si256(dist, flip), max);
+      const __m256i nan  = _mm256_or_si256(_mm256_cmpgt_epi64(me, inf), _mm256_cmpgt_epi64(ma, inf));
+      const __m256i infs = _mm256_or_si256(_mm256_cmpeq_epi64(me, inf), _mm256_cmpeq_epi64(ma, inf));
+      const __m256i bad  = _mm256_or_si256(_mm256_or_si256(far, nan), _mm256_andnot_si256(_mm256_cmpeq_epi64(oe, oa), infs));
+      add_mismatches(m, i, _mm256_movemask_pd(_mm256_castsi256_pd(bad)));
+    }
+    return find_scalar(expected, actual, i, n, UlpMatcher<double>(max_ulps), m);
+  }
+
+  __attribute__((target("sse2")))
+  cpunit::impl::ArrayMismatches find_bytes_sse2(const unsigned char *expected, const unsigned char *actual, const std::size_t begin, const std::size_t n, cpunit::impl::ArrayMismatches m) {
+    std::size_t i = begin;
+    for (; i + 16 <= n; i += 16) {
+      const __m128i e  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(expected + i));
+      const __m128i a  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(actual + i));
+      add_mismatches(m, i, ~_mm_movemask_epi8(_mm_cmpeq_epi8(e, a)) & 0xFFFF);
+    }
+    return find_scalar(expected, actual, i, n, ByteMatcher(), m);
+  }
+
+  __attribute__((target("avx2")))
+  cpunit::impl::ArrayMismatches find_bytes_avx2(const unsigned char *expected, const unsigned char *actual, const std::size_t begin, const std::size_t n, cpunit::impl::ArrayMismatches m) {
+    std::size_t i = begin;
+    for (; i + 32 <= n; i += 32) {
+      const __m256i e  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(expected + i));
+      const __m256i a  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(actual + i));
+      add_mismatches(m, i, ~static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(e, a))));
+    }
+    return find_scalar(expected, actual, i, n, ByteMatcher(), m);
+  }
+
+  cpunit::impl::SimdLevel detect_simd_level() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      return cpunit::impl::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+      return cpunit::impl::SSE2;
+    }
+    return cpunit::impl::SCALAR;
+  }
+
+#else
+
+  cpunit::impl::SimdLevel detect_simd_level() {
+    return cpunit::impl::SCALAR;
+  }
+
+#endif // CPUNIT_HAS_SIMD
+
+  const cpunit::impl::SimdLevel best_level = detect_simd_level();
+
+  template<class T>
+  cpunit::impl::ArrayMismatches find_close(const T *expected, const T *actual, const std::size_t n, const T abs_tol, const T rel_tol, const cpunit::impl::SimdLevel level) {
+    CPUNIT_DTRACE("ArrayCompare - Comparing "<<n<<" elements at SIMD level "<<level);
+#ifdef CPUNIT_HAS_SIMD
+    switch (level) {
+    case cpunit::impl::AVX2:
+      return find_avx2(expected, actual, n, abs_tol, rel_tol);
+    case cpunit::impl::SSE2:
+      return find_sse2(expected, actual, n, abs_tol, rel_tol);
+    default:
+      break;
+    }
+#else
+    (void)level;
+#endif
+    return find_scalar(expected, actual, 0, n, CloseMatcher<T>(abs_tol, rel_tol), no_mismatches(n));
+  }
+
+  template<class T>
+  cpunit::impl::ArrayMismatches find_ulps(const T *expected, const T *actual, const std::size_t n, const uint64_t max_ulps, const cpunit::impl::SimdLevel level) {
+    CPUNIT_DTRACE("ArrayCompare - Comparing "<<n<<" elements within "<<max_ulps<<" ulps at SIMD level "<<level);
+#ifdef CPUNIT_HAS_SIMD
+    switch (level) {
+    case cpunit::impl::AVX2:
+      return find_ulps_avx2(expected, actual, n, max_ulps);
+    case cpunit::impl::SSE2:
+      return find_ulps_sse2(expected, actual, n, max_ulps);
+    default:
+      break;
+    }
+#else
+    (void)level;
+#endif
+    return find_scalar(expected, actual, 0, n, UlpMatcher<T>(max_ulps), no_mismatches(n));
+  }
+
+  /**
+     Counts the differing bytes of [begin, end), which are known to differ.
+   */
+  cpunit::impl::ArrayMismatches find_bytes(const unsigned char *expected, const unsigned char *actual, const std::size_t begin, const std::size_t end, const cpunit::impl::SimdLevel level, const cpunit::impl::ArrayMismatches &m) {
+#ifdef CPUNIT_HAS_SIMD
+    switch (level) {
+    case cpunit::impl::AVX2:
+      return find_bytes_avx2(expected, actual, begin, end, m);
+    case cpunit::impl::SSE2:
+      return find_bytes_sse2(expected, actual, begin, end, m);
+    default:
+      break;
+    }
+#else
+    (void)level;
+#endif
+    return find_scalar(expected, actual, begin, end, ByteMatcher(), m);
+  }
+
+  /**
+     Writes a line of a hex dump: the offset, up to 16 bytes in hex, and
+     the same bytes as ASCII, with '.' for the ones not printable.
+   */
+  void write_dump_line(std::ostream &out, const char mark, const int offset_width, const unsigned char *data, const std::size_t offset, const std::size_t count) {
+    out<<std::endl<<' '<<mark<<std::hex<<std::setfill('0')<<std::setw(offset_width)<<offset<<' ';
+    for (std::size_t i=0; i<16; ++i) {
+      out<<(i == 8 ? "  " : " ");
+      if (i < count) {
+	out<<std::setw(2)<<static_cast<unsigned int>(data[offset + i]);
+      } else {
+	out<<"  ";
+      }
+    }
+    out<<std::dec<<std::setfill(' ')<<"  |";
+    for (std::size_t i=0; i<count; ++i) {
+      const unsigned char c = data[offset + i];
+      out<<(c >= 0x20 && c < 0x7F ? static_cast<char>(c) : '.');
+    }
+    out<<'|';
+  }
+
+  // The digits needed to tell apart any two values of T.
+  template<class T>
+  int max_digits10() {
+    return 2 + std::numeric_limits<T>::digits * 3010 / 10000;
+  }
+
+  template<class T, class M>
+  std::string describe(const T *expected, const T *actual, const std::size_t n, const M &matches, const cpunit::impl::ArrayMismatches &m) {
+    T max_abs = 0;
+    T max_rel = 0;
+    for (std::size_t i=0; i<n; ++i) {
+      if (expected[i] != actual[i]) {
+	const T abs_err = std::fabs(actual[i] - expected[i]);
+	const T rel_err = abs_err / std::fabs(expected[i]);
+	if (abs_err > max_abs) {
+	  max_abs = abs_err;
+	}
+	if (rel_err > max_rel) {
+	  max_rel = rel_err;
+	}
+      }
+    }
+
+    std::ostringstream oss;
+    oss<<m.count<<" of "<<n<<" elements differ, max abs error "<<max_abs<<", max rel error "<<max_rel<<':';
+    oss.precision(max_digits10<T>());
+    std::size_t shown = 0;
+    for (std::size_t i=m.first; i<n && shown<cpunit::impl::MAX_MISMATCHES_SHOWN; ++i) {
+      if (!matches(expected[i], actual[i])) {
+	oss<<std::endl<<"  ["<<i<<"] expected <"<<expected[i]<<">, was <"<<actual[i]<<'>';
+	++shown;
+      }
+    }
+    if (m.count > shown) {
+      oss<<std::endl<<"  ("<<m.count - shown<<" more)";
+    }
+    return oss.str();
+  }
+}
+
+/**
+   @return The widest instruction set supported by the processor, 
+           or SCALAR if compiled with -D CPUNIT_NO_SIMD.
+ */
+cpunit::impl::SimdLevel
+cpunit::impl::best_simd_level() {
+  return best_level;
+}
+
+/**
+   @param level An instruction set.
+   @return true if find_mismatches can use the instruction set.
+ */
+bool
+cpunit::impl::is_supported(const SimdLevel level) {
+  return level <= best_level;
+}
+
+/**
+   Compares two arrays element by element. Two elements match if they are
+   equal, or if the expected one is finite and they differ by at most 
+   abs_tol + rel_tol * |expected|. NaN matches nothing.
+   @param expected The expected values.
+   @param actual   The actual values.
+   @param n        The number of elements of each array.
+   @param abs_tol  The absolute tolerance. 0 for exact comparison.
+   @param rel_tol  The tolerance relative to the expected value. 0 for exact comparison.
+   @param level    The instruction set to use. Must be supported.
+   @return The number of elements not matching, and the index of the first.
+ */
+cpunit::impl::ArrayMismatches
+cpunit::impl::find_mismatches(const float *expected, const float *actual, const std::size_t n, const float abs_tol, const float rel_tol, const SimdLevel level) {
+  return find_close(expected, actual, n, abs_tol, rel_tol, level);
+}
+
+/**
+   Compares two arrays element by element, as find_mismatches for float arrays.
+ */
+cpunit::impl::ArrayMismatches
+cpunit::impl::find_mismatches(const double *expected, const double *actual, const std::size_t n, const double abs_tol, const double rel_tol, const SimdLevel level) {
+  return find_close(expected, actual, n, abs_tol, rel_tol, level);
+}
+
+/**
+   Describes the differences found by find_mismatches.
+   @return The number of differing elements, the largest absolute and relative 
+           differences of the arrays, and the first MAX_MISMATCHES_SHOWN differing
+           elements, one per line.
+ */
+std::string
+cpunit::impl::describe_mismatches(const float *expected, const float *actual, const std::size_t n, const float abs_tol, const float rel_tol, const ArrayMismatches &m) {
+  return describe(expected, actual, n, CloseMatcher<float>(abs_tol, rel_tol), m);
+}
+
+/**
+   Describes the differences found by find_mismatches, as describe_mismatches for float arrays.
+ */
+std::string
+cpunit::impl::describe_mismatches(const double *expected, const double *actual, const std::size_t n, const double abs_tol, const double rel_tol, const ArrayMismatches &m) {
+  return describe(expected, actual, n, CloseMatcher<double>(abs_tol, rel_tol), m);
+}
+
+/**
+   Compares two arrays element by element. Two elements match if they are at
+   most max_ulps representable values apart, as decided by impl::within_ulps.
+   @param expected The expected values.
+   @param actual   The actual values.
+   @param n        The number of elements of each array.
+   @param max_ulps The largest distance accepted.
+   @param level    The instruction set to use. Must be supported.
+   @return The number of elements not matching, and the index of the first.
+ */
+cpunit::impl::ArrayMismatches
+cpunit::impl::find_ulp_mismatches(const float *expected, const float *actual, const std::size_t n, const uint64_t max_ulps, const SimdLevel level) {
+  return find_ulps(expected, actual, n, max_ulps, level);
+}
+
+/**
+   Compares two arrays element by element, as find_ulp_mismatches for float arrays.
+   SSE2 has no 64 bit integer compares, so at that level the elements are 
+   compared one by one.
+ */
+cpunit::impl::ArrayMismatches
+cpunit::impl::find_ulp_mismatches(const double *expected, const double *actual, const std::size_t n, const uint64_t max_ulps, const SimdLevel level) {
+  return find_ulps(expected, actual, n, max_ulps, level);
+}
+
+/**
+   Describes the differences found by find_ulp_mismatches, as describe_mismatches does.
+ */
+std::string
+cpunit::impl::describe_ulp_mismatches(const float *expected, const float *actual, const std::size_t n, const uint64_t max_ulps, const ArrayMismatches &m) {
+  return describe(expected, actual, n, UlpMatcher<float>(max_ulps), m);
+}
+
+/**
+   Describes the differences found by find_ulp_mismatches, as describe_mismatches does.
+ */
+std::string
+cpunit::impl::describe_ulp_mismatches(const double *expected, const double *actual, const std::size_t n, const uint64_t max_ulps, const ArrayMismatches &m) {
+  return describe(expected, actual, n, UlpMatcher<double>(max_ulps), m);
+}
+
+/**
+   Compares two byte arrays. Chunks of the arrays are compared with memcmp, 
+   and the differing bytes of the chunks that differ are counted with
+   the given instruction set, so equal arrays take one pass of memcmp.
+   @param expected The expected bytes.
+   @param actual   The actual bytes.
+   @param n        The number of bytes of each array.
+   @param level    The instruction set to use. Must be supported.
+   @return The number of differing bytes, and the offset of the first.
+ */
+cpunit::impl::ArrayMismatches
+cpunit::impl::find_byte_mismatches(const unsigned char *expected, const unsigned char *actual, const std::size_t n, const SimdLevel level) {
+  CPUNIT_DTRACE("ArrayCompare - Comparing "<<n<<" bytes at SIMD level "<<level);
+  ArrayMismatches m = no_mismatches(n);
+  for (std::size_t begin=0; begin<n; begin+=BYTE_CHUNK) {
+    const std::size_t end = n - begin < BYTE_CHUNK ? n : begin + BYTE_CHUNK;
+    if (std::memcmp(expected + begin, actual + begin, end - begin) != 0) {
+      m = find_bytes(expected, actual, begin, end, level, m);
+    }
+  }
+  return m;
+}
+
+/**
+   Describes the differences found by find_byte_mismatches.
+   @return The number of differing bytes and the offset of the first, followed 
+           by a hex dump of the lines around it. Lines that differ are dumped
+           from both arrays, marked with '-' for the expected, and '+' for the 
+           actual bytes.
+ */
+std::string
+cpunit::impl::describe_byte_mismatches(const unsigned char *expected, const unsigned char *actual, const std::size_t n, const ArrayMismatches &m) {
+  std::ostringstream oss;
+  oss<<m.count<<" of "<<n<<" bytes differ, the first at offset "<<m.first<<" (0x"<<std::hex<<m.first<<std::dec<<"):";
+  const int offset_width = static_cast<uint64_t>(n) > 0xFFFFFFFFu ? 16 : 8;
+  const std::size_t line = m.first / 16;
+  const std::size_t lines = (n + 15) / 16;
+  const std::size_t from = line < DUMP_CONTEXT_LINES ? 0 : line - DUMP_CONTEXT_LINES;
+  const std::size_t to = lines - line <= DUMP_CONTEXT_LINES ? lines : line + DUMP_CONTEXT_LINES + 1;
+  if (from > 0) {
+    oss<<std::endl<<"  ...";
+  }
+  for (std::size_t l=from; l<to; ++l) {
+    const std::size_t offset = 16 * l;
+    const std::size_t count = n - offset < 16 ? n - offset : 16;
+    if (std::memcmp(expected + offset, actual + offset, count) == 0) {
+      write_dump_line(oss, ' ', offset_width, expected, offset, count);
+    } else {
+      write_dump_line(oss, '-', offset_width, expected, offset, count);
+      write_dump_line(oss, '+', offset_width, actual, offset, count);
+    }
+  }
+  if (to < lines) {
+    oss<<std::endl<<"  ...";
+  }
+  return oss.str();
+}
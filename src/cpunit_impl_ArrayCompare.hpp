@@ -0,0 +1,99 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+#ifndef CPUNIT_IMPL_ARRAYCOMPARE_HPP
+#define CPUNIT_IMPL_ARRAYCOMPARE_HPP
+
+#include <cstddef>
+#include <string>
+#include <stdint.h>
+
+namespace cpunit {
+  namespace impl {
+
+    // The number of differing elements listed in the message of a failed array assert.
+    const std::size_t MAX_MISMATCHES_SHOWN = 10;
+
+    // The number of 16 byte lines dumped before and after the first differing byte.
+    const std::size_t DUMP_CONTEXT_LINES = 2;
+
+    /**
+       The instruction sets the array comparisons can use. Which ones
+       are available is decided when the program runs.
+     */
+    enum SimdLevel {
+      SCALAR,
+      SSE2,
+      AVX2
+    };
+
+    /**
+       The number of differing elements of two arrays, and the index of 
+       the first, or the length of the arrays if none differ.
+     */
+    struct ArrayMismatches {
+      std::size_t count;
+      std::size_t first;
+    };
+
+    SimdLevel best_simd_level();
+    bool is_supported(const SimdLevel level);
+
+    ArrayMismatches find_mismatches(const float *expected, const float *actual, const std::size_t n, 
+				    const float abs_tol, const float rel_tol, const SimdLevel level);
+    ArrayMismatches find_mismatches(const double *expected, const double *actual, const std::size_t n, 
+				    const double abs_tol, const double rel_tol, const SimdLevel level);
+
+    std::string describe_mismatches(const float *expected, const float *actual, const std::size_t n, 
+				    const float abs_tol, const float rel_tol, const ArrayMismatches &m);
+    std::string describe_mismatches(const double *expected, const double *actual, const std::size_t n, 
+				    const double abs_tol, const double rel_tol, const ArrayMismatches &m);
+
+    ArrayMismatches find_ulp_mismatches(const float *expected, const float *actual, const std::size_t n, 
+					const uint64_t max_ulps, const SimdLevel level);
+    ArrayMismatches find_ulp_mismatches(const double *expected, const double *actual, const std::size_t n, 
+					const uint64_t max_ulps, const SimdLevel level);
+
+    std::string describe_ulp_mismatches(const float *expected, const float *actual, const std::size_t n, 
+					const uint64_t max_ulps, const ArrayMismatches &m);
+    std::string describe_ulp_mismatches(const double *expected, const double *actual, const std::size_t n, 
+					const uint64_t max_ulps, const ArrayMismatches &m);
+
+    ArrayMismatches find_byte_mismatches(const unsigned char *expected, const unsigned char *actual, const std::size_t n, 
+					 const SimdLevel level);
+
+    std::string describe_byte_mismatches(const unsigned char *expected, const unsigned char *actual, const std::size_t n, 
+					 const ArrayMismatches &m);
+  }
+}
+
+#endif // CPUNIT_IMPL_ARRAYCOMPARE_HPP
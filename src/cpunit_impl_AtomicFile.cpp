@@ -0,0 +1,95 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_impl_AtomicFile.hpp"
+#include "cpunit_CPUnitException.hpp"
+#include "cpunit_impl_Mutex.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+  cpunit::impl::Mutex counter_lock;
+  unsigned long counter = 0;
+
+  // Tells apart the temporary files of the threads of a process.
+  unsigned long next_count() {
+    cpunit::impl::MutexLock lock(counter_lock);
+    return counter++;
+  }
+}
+
+void
+cpunit::impl::write_file_atomically(const std::string &path, const std::string &content) {
+  write_file_atomically(path, content.data(), content.length());
+}
+
+void
+cpunit::impl::write_file_atomically(const std::string &path, const char *data, const std::size_t length) {
+  std::ostringstream tmp;
+  tmp<<path<<".tmp."<<getpid()<<'.'<<next_count();
+  const std::string tmp_path = tmp.str();
+
+  const int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw CPUnitException("Unable to create '" + tmp_path + "': " + std::strerror(errno));
+  }
+  std::size_t put = 0;
+  while (put < length) {
+    const ssize_t n = write(fd, data + put, length - put);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      const int err = errno;
+      close(fd);
+      std::remove(tmp_path.c_str());
+      throw CPUnitException("Unable to write '" + tmp_path + "': " + std::strerror(err));
+    }
+    put += n;
+  }
+  // Without this, a crash after the rename may leave an empty file behind.
+  const bool synced = fsync(fd) == 0;
+  const int sync_err = errno;
+  close(fd);
+  if (!synced) {
+    std::remove(tmp_path.c_str());
+    throw CPUnitException("Unable to write '" + tmp_path + "': " + std::strerror(sync_err));
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    const int err = errno;
+    std::remove(tmp_path.c_str());
+    throw CPUnitException("Unable to replace '" + path + "': " + std::strerror(err));
+  }
+}
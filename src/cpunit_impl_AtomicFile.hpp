@@ -0,0 +1,56 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_IMPL_ATOMICFILE_HPP
+#define CPUNIT_IMPL_ATOMICFILE_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace cpunit {
+  namespace impl {
+
+    /**
+       Replaces the contents of a file, so that readers see either the old 
+       or the new contents, and never a partially written file. The data is
+       written to a temporary file in the same directory, which is then 
+       renamed over the target. The temporary file is unique to the call,
+       so threads and processes may replace the same file at once, and the 
+       last rename wins.
+       @param path    The file to write.
+       @param content The new contents of the file.
+       @throws CPUnitException if the file cannot be written.
+     */
+    void write_file_atomically(const std::string &path, const std::string &content);
+    void write_file_atomically(const std::string &path, const char *data, const std::size_t length);
+  }
+}
+
+#endif // CPUNIT_IMPL_ATOMICFILE_HPP
@@ -0,0 +1,439 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+#include "cpunit_impl_Diff.hpp"
+#include "cpunit_trace.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+  // The number of kept elements shown before and after each change.
+  const std::size_t CONTEXT = 2;
+
+  // The edit distance searched for a split is at least this, ...
+  const std::ptrdiff_t MIN_COST = 64;
+
+  // ... or as high as allowed by this many element comparisons.
+  const std::ptrdiff_t MAX_WORK = 1 << 24;
+
+  /**
+     A hunk of the diff being written. Its header gives the first index 
+     and the number of elements of each sequence, so the lines are
+     collected before it is written.
+   */
+  struct Hunk {
+    bool open;
+    std::size_t a;
+    std::size_t b;
+    std::size_t a_length;
+    std::size_t b_length;
+    std::ostringstream lines;
+
+    Hunk() :
+      open(false),
+      a(0),
+      b(0),
+      a_length(0),
+      b_length(0),
+      lines()
+    {}
+
+    void start(const std::size_t a_, const std::size_t b_) {
+      open = true;
+      a = a_;
+      b = b_;
+      a_length = 0;
+      b_length = 0;
+      lines.str("");
+    }
+
+    void close(std::ostream &out, const std::size_t first_index) {
+      if (open) {
+	out<<std::endl<<"  @@ -"<<first_index + a<<','<<a_length<<" +"<<first_index + b<<','<<b_length<<" @@"<<lines.str();
+	open = false;
+      }
+    }
+  };
+}
+
+std::size_t cpunit::impl::Diff::default_max_lines = 40;
+
+/**
+   @param n_         The length of the expected sequence.
+   @param m_         The length of the actual sequence.
+   @param max_lines_ The number of lines write_hunks() writes. The search
+                     stops after one more removed or added element.
+ */
+cpunit::impl::Diff::Diff(const std::size_t n_, const std::size_t m_, const std::size_t max_lines_) :
+  n(n_),
+  m(m_),
+  max_lines(max_lines_),
+  max_changes(max_lines_ + 1),
+  changes(0),
+  aligned(true),
+  stopped(false),
+  first_index(0),
+  unit("index"),
+  edits(),
+  forward(),
+  backward()
+{}
+
+cpunit::impl::Diff::~Diff()
+{}
+
+/**
+   Finds the edits. Besides the edits found, it only takes memory
+   linear in the lengths of the sequences.
+ */
+void
+cpunit::impl::Diff::compute() {
+  CPUNIT_DTRACE("Diff::compute - Comparing sequences of "<<n<<" and "<<m<<" elements.");
+  diff(0, n, 0, m);
+  std::vector<std::ptrdiff_t>().swap(forward);
+  std::vector<std::ptrdiff_t>().swap(backward);
+}
+
+/**
+   @return The runs of kept, removed and added elements, in order.
+ */
+const std::vector<cpunit::impl::Diff::Edit>&
+cpunit::impl::Diff::get_edits() const {
+  return edits;
+}
+
+/**
+   @return false if the search stopped before reaching the end of the sequences.
+ */
+bool
+cpunit::impl::Diff::is_complete() const {
+  return !stopped;
+}
+
+/**
+   @return false if part of the sequences was too costly to align, and is
+           reported as removed and added instead.
+ */
+bool
+cpunit::impl::Diff::is_aligned() const {
+  return aligned;
+}
+
+/**
+   Sets how write_hunks numbers the elements.
+   @param first The number of the first element of each sequence.
+   @param name  What an element is called, like "index" or "line".
+ */
+void
+cpunit::impl::Diff::set_numbering(const std::size_t first, const char *name) {
+  first_index = first;
+  unit = name;
+}
+
+/**
+   Sets the number of lines of a diff written to the message of a failed 
+   assert. Called once, from --max-diff-lines, before any tests are run.
+   @param max The number of lines.
+ */
+void
+cpunit::impl::Diff::set_default_max_lines(const std::size_t max) {
+  CPUNIT_ITRACE("Diff - Writing at most "<<max<<" lines.");
+  default_max_lines = max;
+}
+
+std::size_t
+cpunit::impl::Diff::get_default_max_lines() {
+  return default_max_lines;
+}
+
+/**
+   Finds the edits turning [a_lo, a_hi) of the expected sequence into [b_lo, b_hi)
+   of the actual one. Common ends are kept, and the rest is split where a shortest 
+   edit script passes its middle, and diffed recursively.
+ */
+void
+cpunit::impl::Diff::diff(std::size_t a_lo, std::size_t a_hi, std::size_t b_lo, std::size_t b_hi) {
+  if (changes >= max_changes) {
+    stopped = true;
+    return;
+  }
+
+  std::size_t prefix = 0;
+  while (a_lo + prefix < a_hi && b_lo + prefix < b_hi && equal(a_lo + prefix, b_lo + prefix)) {
+    ++prefix;
+  }
+  add(KEEP, a_lo, b_lo, prefix);
+  a_lo += prefix;
+  b_lo += prefix;
+
+  std::size_t suffix = 0;
+  while (a_hi - suffix > a_lo && b_hi - suffix > b_lo && equal(a_hi - suffix - 1, b_hi - suffix - 1)) {
+    ++suffix;
+  }
+  a_hi -= suffix;
+  b_hi -= suffix;
+
+  std::size_t x = 0;
+  std::size_t y = 0;
+  if (a_lo == a_hi) {
+    add(ADD, a_lo, b_lo, b_hi - b_lo);
+  } else if (b_lo == b_hi) {
+    add(REMOVE, a_lo, b_lo, a_hi - a_lo);
+  } else if (bisect(a_lo, a_hi, b_lo, b_hi, x, y)) {
+    diff(a_lo, x, b_lo, y);
+    diff(x, a_hi, y, b_hi);
+  } else {
+    add(REMOVE, a_lo, b_lo, a_hi - a_lo);
+    add(ADD, a_hi, b_lo, b_hi - b_lo);
+  }
+  add(KEEP, a_hi, b_hi, suffix);
+}
+
+/**
+   Searches for the middle of a shortest edit script from both ends at once, 
+   keeping the furthest point reached on each diagonal. The edit distance 
+   searched is bounded, to keep the work bounded.
+   @param x Receives the index of the expected sequence to split at.
+   @param y Receives the index of the actual sequence to split at.
+   @return false if the edit distance is too high to search, or the 
+           sequences have no elements in common.
+ */
+bool
+cpunit::impl::Diff::bisect(const std::size_t a_lo, const std::size_t a_hi, const std::size_t b_lo, const std::size_t b_hi, std::size_t &x, std::size_t &y) {
+  const std::ptrdiff_t a_length = a_hi - a_lo;
+  const std::ptrdiff_t b_length = b_hi - b_lo;
+  const std::ptrdiff_t full_d = (a_length + b_length + 1) / 2;
+  const std::ptrdiff_t max_d = std::min(full_d, std::max(MIN_COST, MAX_WORK / (a_length + b_length)));
+  const std::ptrdiff_t offset = max_d + 1;
+  const std::ptrdiff_t length = 2 * max_d + 3;
+  forward.assign(length, -1);
+  backward.assign(length, -1);
+  forward[offset + 1] = 0;
+  backward[offset + 1] = 0;
+
+  const std::ptrdiff_t delta = a_length - b_length;
+  // With an odd delta, the searches meet on a forward step, otherwise on a backward one.
+  const bool front = (delta & 1) != 0;
+  std::ptrdiff_t k1_start = 0;
+  std::ptrdiff_t k1_end = 0;
+  std::ptrdiff_t k2_start = 0;
+  std::ptrdiff_t k2_end = 0;
+  for (std::ptrdiff_t d=0; d<max_d; ++d) {
+    for (std::ptrdiff_t k1=-d+k1_start; k1<=d-k1_end; k1+=2) {
+      const std::ptrdiff_t k1_offset = offset + k1;
+      std::ptrdiff_t x1;
+      if (k1 == -d || (k1 != d && forward[k1_offset - 1] < forward[k1_offset + 1])) {
+	x1 = forward[k1_offset + 1];
+      } else {
+	x1 = forward[k1_offset - 1] + 1;
+      }
+      std::ptrdiff_t y1 = x1 - k1;
+      while (x1 < a_length && y1 < b_length && equal(a_lo + x1, b_lo + y1)) {
+	++x1;
+	++y1;
+      }
+      forward[k1_offset] = x1;
+      if (x1 > a_length) {
+	// Ran off the right of the graph.
+	k1_end += 2;
+      } else if (y1 > b_length) {
+	// Ran off the bottom of the graph.
+	k1_start += 2;
+      } else if (front) {
+	const std::ptrdiff_t k2_offset = offset + delta - k1;
+	if (k2_offset >= 0 && k2_offset < length && backward[k2_offset] != -1 && x1 >= a_length - backward[k2_offset]) {
+	  x = a_lo + x1;
+	  y = b_lo + y1;
+	  return true;
+	}
+      }
+    }
+
+    for (std::ptrdiff_t k2=-d+k2_start; k2<=d-k2_end; k2+=2) {
+      const std::ptrdiff_t k2_offset = offset + k2;
+      std::ptrdiff_t x2;
+      if (k2 == -d || (k2 != d && backward[k2_offset - 1] < backward[k2_offset + 1])) {
+	x2 = backward[k2_offset + 1];
+      } else {
+	x2 = backward[k2_offset - 1] + 1;
+      }
+      std::ptrdiff_t y2 = x2 - k2;
+      while (x2 < a_length && y2 < b_length && equal(a_hi - x2 - 1, b_hi - y2 - 1)) {
+	++x2;
+	++y2;
+      }
+      backward[k2_offset] = x2;
+      if (x2 > a_length) {
+	k2_end += 2;
+      } else if (y2 > b_length) {
+	k2_start += 2;
+      } else if (!front) {
+	const std::ptrdiff_t k1_offset = offset + delta - k2;
+	if (k1_offset >= 0 && k1_offset < length && forward[k1_offset] != -1) {
+	  const std::ptrdiff_t x1 = forward[k1_offset];
+	  const std::ptrdiff_t y1 = offset + x1 - k1_offset;
+	  if (x1 >= a_length - x2) {
+	    x = a_lo + x1;
+	    y = b_lo + y1;
+	    return true;
+	  }
+	}
+      }
+    }
+  }
+  // Searching the full edit distance only fails for sequences without common elements.
+  if (max_d < full_d) {
+    CPUNIT_DTRACE("Diff::bisect - Gave up aligning ["<<a_lo<<", "<<a_hi<<") with ["<<b_lo<<", "<<b_hi<<").");
+    aligned = false;
+  }
+  return false;
+}
+
+/**
+   Appends a run, merging it with the previous one if it is of the same kind.
+ */
+void
+cpunit::impl::Diff::add(const Kind kind, const std::size_t a, const std::size_t b, const std::size_t length) {
+  if (length == 0 || stopped) {
+    return;
+  }
+  if (kind != KEEP) {
+    changes += length;
+  }
+  if (!edits.empty() && edits.back().kind == kind) {
+    edits.back().length += length;
+    return;
+  }
+  Edit e;
+  e.kind = kind;
+  e.a = a;
+  e.b = b;
+  e.length = length;
+  edits.push_back(e);
+}
+
+/**
+   Writes elements [from, to) of one of the sequences, one per line.
+ */
+void
+cpunit::impl::Diff::write_run(std::ostream &out, const char mark, const bool expected, const std::size_t from, const std::size_t to) const {
+  for (std::size_t i=from; i<to; ++i) {
+    out<<std::endl<<"  "<<mark;
+    write_element(out, expected, i);
+  }
+}
+
+/**
+   Writes the index of the first difference, followed by the changes in hunks 
+   with a few kept elements of context, like a unified diff. The removed 
+   elements are marked with '-', and the added ones with '+'. The output 
+   stops after the number of lines given to the constructor.
+   @param out The stream to write to.
+ */
+void
+cpunit::impl::Diff::write_hunks(std::ostream &out) const {
+  std::size_t first = edits.size();
+  std::size_t last = 0;
+  for (std::size_t i=0; i<edits.size(); ++i) {
+    if (edits[i].kind != KEEP) {
+      first = std::min(first, i);
+      last = i;
+    }
+  }
+  if (first == edits.size()) {
+    return;
+  }
+  out<<std::endl<<"First difference at "<<unit<<' '<<first_index + edits[first].a<<", expected (-) and actual (+):";
+
+  Hunk hunk;
+  std::size_t budget = max_lines;
+  bool truncated = false;
+  for (std::size_t i=0; i<edits.size() && !truncated; ++i) {
+    const Edit &e = edits[i];
+    // The elements of the run to write, at the start and at the end of it.
+    std::size_t head = e.length;
+    std::size_t tail = 0;
+    if (e.kind == KEEP) {
+      if (i < first) {
+	head = 0;
+	tail = std::min(CONTEXT, e.length);
+      } else if (i > last) {
+	head = std::min(CONTEXT, e.length);
+      } else if (e.length > 2 * CONTEXT) {
+	head = CONTEXT;
+	tail = CONTEXT;
+      }
+    }
+    if (!hunk.open && head > 0) {
+      hunk.start(e.a, e.b);
+    }
+
+    const std::size_t written = std::min(head, budget);
+    switch (e.kind) {
+    case KEEP:
+      write_run(hunk.lines, ' ', true, e.a, e.a + written);
+      hunk.a_length += written;
+      hunk.b_length += written;
+      break;
+    case REMOVE:
+      write_run(hunk.lines, '-', true, e.a, e.a + written);
+      hunk.a_length += written;
+      break;
+    case ADD:
+      write_run(hunk.lines, '+', false, e.b, e.b + written);
+      hunk.b_length += written;
+      break;
+    }
+    budget -= written;
+    truncated = written < head || (budget == 0 && i < last);
+
+    if (tail > 0 && !truncated) {
+      hunk.close(out, first_index);
+      hunk.start(e.a + e.length - tail, e.b + e.length - tail);
+      const std::size_t context = std::min(tail, budget);
+      write_run(hunk.lines, ' ', true, e.a + e.length - tail, e.a + e.length - tail + context);
+      hunk.a_length += context;
+      hunk.b_length += context;
+      budget -= context;
+      truncated = context < tail;
+    }
+  }
+  hunk.close(out, first_index);
+  if (truncated || !is_complete()) {
+    out<<std::endl<<"  ...";
+  }
+  if (!aligned) {
+    out<<std::endl<<"  (Parts of the sequences differed too much to be aligned, and are shown as removed and added.)";
+  }
+}
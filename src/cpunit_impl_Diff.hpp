@@ -0,0 +1,175 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+#ifndef CPUNIT_IMPL_DIFF_HPP
+#define CPUNIT_IMPL_DIFF_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace cpunit {
+  namespace impl {
+
+    /**
+       Finds a shortest edit script turning one sequence into another, with
+       the linear space variant of Myers' O(ND) algorithm. The sequences are
+       only seen through equal() and write_element(), implemented by subclasses.
+       The search stops when enough elements are found to differ to fill the
+       lines of the diff, and an alignment too costly to find is given up, 
+       with the rest of the sequences reported as replaced.
+       @see write_sequence_diff
+     */
+    class Diff {
+    public:
+      enum Kind {
+	KEEP,
+	REMOVE,
+	ADD
+      };
+
+      /**
+	 A run of elements kept, removed from the expected sequence, or 
+	 added from the actual one, starting at index a of the expected 
+	 and b of the actual sequence.
+       */
+      struct Edit {
+	Kind kind;
+	std::size_t a;
+	std::size_t b;
+	std::size_t length;
+      };
+
+    private:
+      const std::size_t n;
+      const std::size_t m;
+      const std::size_t max_lines;
+      const std::size_t max_changes;
+      std::size_t changes;
+      bool aligned;
+      bool stopped;
+      std::size_t first_index;
+      const char *unit;
+      std::vector<Edit> edits;
+      std::vector<std::ptrdiff_t> forward;
+      std::vector<std::ptrdiff_t> backward;
+
+      static std::size_t default_max_lines;
+
+      void diff(std::size_t a_lo, std::size_t a_hi, std::size_t b_lo, std::size_t b_hi);
+      bool bisect(const std::size_t a_lo, const std::size_t a_hi, const std::size_t b_lo, const std::size_t b_hi, std::size_t &x, std::size_t &y);
+      void add(const Kind kind, const std::size_t a, const std::size_t b, const std::size_t length);
+
+      // No copy.
+      Diff(const Diff&);
+      Diff& operator = (const Diff&);
+
+      void write_run(std::ostream &out, const char mark, const bool expected, const std::size_t from, const std::size_t to) const;
+
+    protected:
+      virtual bool equal(const std::size_t i, const std::size_t j) const = 0;
+      virtual void write_element(std::ostream &out, const bool expected, const std::size_t index) const = 0;
+
+    public:
+      Diff(const std::size_t n, const std::size_t m, const std::size_t max_lines);
+      virtual ~Diff();
+
+      void compute();
+      const std::vector<Edit>& get_edits() const;
+      bool is_complete() const;
+      bool is_aligned() const;
+      void set_numbering(const std::size_t first, const char *name);
+      void write_hunks(std::ostream &out) const;
+
+      static void set_default_max_lines(const std::size_t max);
+      static std::size_t get_default_max_lines();
+    };
+
+    /**
+       Compares the elements of two sequences with ==, through an iterator 
+       to each element.
+     */
+    template<class Iterator>
+    class SequenceDiff : public Diff {
+      const std::vector<Iterator> &expected;
+      const std::vector<Iterator> &actual;
+
+    protected:
+      bool equal(const std::size_t i, const std::size_t j) const;
+      void write_element(std::ostream &out, const bool e, const std::size_t index) const;
+
+    public:
+      SequenceDiff(const std::vector<Iterator> &e, const std::vector<Iterator> &a, const std::size_t max_lines);
+    };
+
+    template<class T>
+    void write_diff_element(std::ostream &out, const T &t);
+
+    template<class K, class V>
+    void write_diff_element(std::ostream &out, const std::pair<K, V> &p);
+
+    template<class Iterator>
+    void write_sequence_diff(std::ostream &out, Iterator e_begin, Iterator e_end, Iterator a_begin, Iterator a_end, const std::size_t max_lines = Diff::get_default_max_lines());
+
+    template<class Iterator, class Less>
+    void write_set_diff(std::ostream &out, Iterator e_begin, Iterator e_end, Iterator a_begin, Iterator a_end, const Less &less, const std::size_t max_lines = Diff::get_default_max_lines());
+
+    template<class Iterator, class Less>
+    void write_map_diff(std::ostream &out, Iterator e_begin, Iterator e_end, Iterator a_begin, Iterator a_end, const Less &less, const std::size_t max_lines = Diff::get_default_max_lines());
+
+    /**
+       The key of an element of an unordered set is the element itself.
+     */
+    struct ElementKey {
+      template<class T>
+      const T& operator () (const T &t) const;
+    };
+
+    /**
+       The key of an element of an unordered map is the first of the pair.
+     */
+    struct PairKey {
+      template<class P>
+      const typename P::first_type& operator () (const P &p) const;
+    };
+
+    template<class Container, class KeyOf>
+    void write_unordered_diff(std::ostream &out, const Container &expected, const Container &actual, const KeyOf &key_of, const bool keyed, const std::size_t max_lines = Diff::get_default_max_lines());
+  }
+}
+
+#include "cpunit_impl_Diff.tpp"
+
+#endif // CPUNIT_IMPL_DIFF_HPP
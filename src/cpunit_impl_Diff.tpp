@@ -0,0 +1,314 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+#include "cpunit_Ostreams.hpp"
+
+/**
+   @param e         An iterator to each element of the expected sequence.
+   @param a         An iterator to each element of the actual sequence.
+   @param max_lines The number of lines of the diff.
+ */
+template<class Iterator>
+cpunit::impl::SequenceDiff<Iterator>::SequenceDiff(const std::vector<Iterator> &e, const std::vector<Iterator> &a, const std::size_t max_lines) :
+  Diff(e.size(), a.size(), max_lines),
+  expected(e),
+  actual(a)
+{}
+
+template<class Iterator>
+bool
+cpunit::impl::SequenceDiff<Iterator>::equal(const std::size_t i, const std::size_t j) const {
+  return *expected[i] == *actual[j];
+}
+
+template<class Iterator>
+void
+cpunit::impl::SequenceDiff<Iterator>::write_element(std::ostream &out, const bool e, const std::size_t index) const {
+  write_diff_element(out, e ? *expected[index] : *actual[index]);
+}
+
+template<class T>
+void
+cpunit::impl::write_diff_element(std::ostream &out, const T &t) {
+  using cpunit::operator<<;
+  out<<t;
+}
+
+/**
+   Writes an element of a map the way the map itself is written.
+ */
+template<class K, class V>
+void
+cpunit::impl::write_diff_element(std::ostream &out, const std::pair<K, V> &p) {
+  using cpunit::operator<<;
+  out<<'('<<p.first<<" - "<<p.second<<')';
+}
+
+/**
+   Writes where two sequences differ, as found by a SequenceDiff, after the
+   message of a failed assert.
+   @tparam Iterator A forward iterator type.
+   @param out       The stream to write to.
+   @param e_begin   The start of the expected sequence.
+   @param e_end     The end of the expected sequence.
+   @param a_begin   The start of the actual sequence.
+   @param a_end     The end of the actual sequence.
+   @param max_lines The number of lines to write, 0 for none.
+ */
+template<class Iterator>
+void
+cpunit::impl::write_sequence_diff(std::ostream &out, Iterator e_begin, Iterator e_end, Iterator a_begin, Iterator a_end, const std::size_t max_lines) {
+  if (max_lines == 0) {
+    return;
+  }
+  std::vector<Iterator> expected;
+  for (Iterator it = e_begin; it != e_end; ++it) {
+    expected.push_back(it);
+  }
+  std::vector<Iterator> actual;
+  for (Iterator it = a_begin; it != a_end; ++it) {
+    actual.push_back(it);
+  }
+  SequenceDiff<Iterator> diff(expected, actual, max_lines);
+  diff.compute();
+  diff.write_hunks(out);
+}
+
+/**
+   Writes the elements of two sorted sequences only found in one of them, 
+   after the message of a failed assert. The missing elements are marked
+   with '-', and the unexpected ones with '+'.
+   @tparam Iterator A forward iterator type.
+   @tparam Less     The ordering of the elements.
+   @param out       The stream to write to.
+   @param e_begin   The start of the expected sequence.
+   @param e_end     The end of the expected sequence.
+   @param a_begin   The start of the actual sequence.
+   @param a_end     The end of the actual sequence.
+   @param less      The ordering both sequences are sorted by.
+   @param max_lines The number of elements to write, 0 for none.
+ */
+template<class Iterator, class Less>
+void
+cpunit::impl::write_set_diff(std::ostream &out, Iterator e_begin, Iterator e_end, Iterator a_begin, Iterator a_end, const Less &less, const std::size_t max_lines) {
+  std::size_t budget = max_lines;
+  if (budget == 0) {
+    return;
+  }
+  std::ostringstream lines;
+  std::size_t missing = 0;
+  std::size_t unexpected = 0;
+  while (e_begin != e_end || a_begin != a_end) {
+    if (a_begin == a_end || (e_begin != e_end && less(*e_begin, *a_begin))) {
+      if (budget > 0) {
+	lines<<std::endl<<"  -";
+	write_diff_element(lines, *e_begin);
+	--budget;
+      }
+      ++missing;
+      ++e_begin;
+    } else if (e_begin == e_end || less(*a_begin, *e_begin)) {
+      if (budget > 0) {
+	lines<<std::endl<<"  +";
+	write_diff_element(lines, *a_begin);
+	--budget;
+      }
+      ++unexpected;
+      ++a_begin;
+    } else {
+      ++e_begin;
+      ++a_begin;
+    }
+  }
+  out<<std::endl<<missing<<" missing (-) and "<<unexpected<<" unexpected (+) elements:"<<lines.str();
+  if (missing + unexpected > max_lines) {
+    out<<std::endl<<"  ...";
+  }
+}
+
+/**
+   Writes the keys of two sorted maps only found in one of them, and the 
+   keys mapped to different values, after the message of a failed assert.
+   The missing entries are marked with '-', and the unexpected ones with '+'.
+   @tparam Iterator A forward iterator type over pairs of keys and values.
+   @tparam Less     The ordering of the keys.
+   @param out       The stream to write to.
+   @param e_begin   The start of the expected map.
+   @param e_end     The end of the expected map.
+   @param a_begin   The start of the actual map.
+   @param a_end     The end of the actual map.
+   @param less      The ordering both maps are sorted by.
+   @param max_lines The number of entries to write, 0 for none.
+ */
+template<class Iterator, class Less>
+void
+cpunit::impl::write_map_diff(std::ostream &out, Iterator e_begin, Iterator e_end, Iterator a_begin, Iterator a_end, const Less &less, const std::size_t max_lines) {
+  std::size_t budget = max_lines;
+  if (budget == 0) {
+    return;
+  }
+  std::ostringstream lines;
+  std::size_t missing = 0;
+  std::size_t unexpected = 0;
+  std::size_t changed = 0;
+  while (e_begin != e_end || a_begin != a_end) {
+    const bool remove = a_begin == a_end || (e_begin != e_end && less(e_begin->first, a_begin->first));
+    const bool add = !remove && (e_begin == e_end || less(a_begin->first, e_begin->first));
+    const bool change = !remove && !add && !(e_begin->second == a_begin->second);
+    if ((remove || change) && budget > 0) {
+      lines<<std::endl<<"  -";
+      write_diff_element(lines, *e_begin);
+      --budget;
+    }
+    if ((add || change) && budget > 0) {
+      lines<<std::endl<<"  +";
+      write_diff_element(lines, *a_begin);
+      --budget;
+    }
+    if (remove) {
+      ++missing;
+    } else if (add) {
+      ++unexpected;
+    } else if (change) {
+      ++changed;
+    }
+    if (!add) {
+      ++e_begin;
+    }
+    if (!remove) {
+      ++a_begin;
+    }
+  }
+  out<<std::endl<<missing<<" missing (-), "<<unexpected<<" unexpected (+) and "<<changed<<" changed keys:"<<lines.str();
+  if (missing + unexpected + 2 * changed > max_lines) {
+    out<<std::endl<<"  ...";
+  }
+}
+
+template<class T>
+const T&
+cpunit::impl::ElementKey::operator () (const T &t) const {
+  return t;
+}
+
+template<class P>
+const typename P::first_type&
+cpunit::impl::PairKey::operator () (const P &p) const {
+  return p.first;
+}
+
+/**
+   Writes the elements of two unordered containers only found in one of them,
+   after the message of a failed assert. Each key is looked up in the other 
+   container, so this takes time linear in the sizes, except for the 
+   elements sharing a key, which are matched pairwise with ==. The missing
+   elements are marked with '-', and the unexpected ones with '+'.
+   @tparam Container An unordered set, multiset, map or multimap.
+   @tparam KeyOf     ElementKey for sets, PairKey for maps.
+   @param out       The stream to write to.
+   @param expected  The expected container.
+   @param actual    The actual container.
+   @param key_of    Gets the key of an element.
+   @param keyed     If elements of equal keys, but different values, are
+                    counted as changed keys, as for maps.
+   @param max_lines The number of elements to write, 0 for none.
+ */
+template<class Container, class KeyOf>
+void
+cpunit::impl::write_unordered_diff(std::ostream &out, const Container &expected, const Container &actual, const KeyOf &key_of, const bool keyed, const std::size_t max_lines) {
+  typedef typename Container::const_iterator Iterator;
+  std::size_t budget = max_lines;
+  if (budget == 0) {
+    return;
+  }
+  std::ostringstream lines;
+  std::size_t missing = 0;
+  std::size_t unexpected = 0;
+  std::size_t changed = 0;
+  std::vector<Iterator> unmatched;
+  for (Iterator it = expected.begin(); it != expected.end(); ) {
+    const std::pair<Iterator, Iterator> e = expected.equal_range(key_of(*it));
+    const std::pair<Iterator, Iterator> a = actual.equal_range(key_of(*it));
+    it = e.second;
+
+    unmatched.clear();
+    for (Iterator i = a.first; i != a.second; ++i) {
+      unmatched.push_back(i);
+    }
+    std::size_t removed = 0;
+    for (Iterator i = e.first; i != e.second; ++i) {
+      std::size_t j = 0;
+      while (j < unmatched.size() && !(*i == *unmatched[j])) {
+	++j;
+      }
+      if (j < unmatched.size()) {
+	unmatched.erase(unmatched.begin() + j);
+      } else {
+	if (budget > 0) {
+	  lines<<std::endl<<"  -";
+	  write_diff_element(lines, *i);
+	  --budget;
+	}
+	++removed;
+      }
+    }
+    for (std::size_t j=0; j<unmatched.size() && budget > 0; ++j) {
+      lines<<std::endl<<"  +";
+      write_diff_element(lines, *unmatched[j]);
+      --budget;
+    }
+    const std::size_t replaced = keyed ? std::min(removed, unmatched.size()) : 0;
+    changed += replaced;
+    missing += removed - replaced;
+    unexpected += unmatched.size() - replaced;
+  }
+
+  for (Iterator it = actual.begin(); it != actual.end(); ++it) {
+    if (expected.find(key_of(*it)) == expected.end()) {
+      if (budget > 0) {
+	lines<<std::endl<<"  +";
+	write_diff_element(lines, *it);
+	--budget;
+      }
+      ++unexpected;
+    }
+  }
+
+  if (keyed) {
+    out<<std::endl<<missing<<" missing (-), "<<unexpected<<" unexpected (+) and "<<changed<<" changed keys:"<<lines.str();
+  } else {
+    out<<std::endl<<missing<<" missing (-) and "<<unexpected<<" unexpected (+) elements:"<<lines.str();
+  }
+  if (missing + unexpected + 2 * changed > max_lines) {
+    out<<std::endl<<"  ...";
+  }
+}
@@ -0,0 +1,62 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_impl_Expression.hpp"
+#include "cpunit_AssertionException.hpp"
+
+#include <sstream>
+
+/**
+   Throws the AssertionException of a failed CPUNIT_CHECK.
+   @param expansion The operands of the statement.
+   @param file      The file of the check.
+   @param line      The line of the check.
+   @param statement The statement as written.
+   @throw AssertionException allways.
+ */
+void
+cpunit::impl::fail_check(const std::string &expansion, const char *file, const int line, const char *statement) {
+  throw AssertionException(describe_failure("CHECK", expansion, file, line, statement));
+}
+
+/**
+   @param kind      The macro failing, e.g. "CHECK".
+   @param expansion The operands of the statement.
+   @param file      The file of the macro.
+   @param line      The line of the macro.
+   @param statement The statement as written.
+   @return The message of a failed CPUNIT_CHECK or CPUNIT_EXPECT.
+ */
+std::string
+cpunit::impl::describe_failure(const char *kind, const std::string &expansion, const char *file, const int line, const char *statement) {
+  std::ostringstream oss;
+  oss<<kind<<" FAILED - At line "<<line<<" of "<<file<<" Stmt: '"<<statement<<"' With: "<<expansion;
+  return oss.str();
+}
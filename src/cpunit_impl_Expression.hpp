@@ -0,0 +1,166 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_IMPL_EXPRESSION_HPP
+#define CPUNIT_IMPL_EXPRESSION_HPP
+
+#include "cpunit_Ostreams.hpp"
+
+#include <ostream>
+#include <string>
+
+namespace cpunit {
+  namespace impl {
+
+    /**
+       Tells at compile time whether a type can be written to a std::ostream,
+       by the cpunit printers, or by an operator << found by argument dependent
+       lookup. Works without C++11 decltype, by giving the expression a
+       fallback operator that is only chosen if there is no other.
+     */
+    namespace streamable {
+      struct No {
+	char c[2];
+      };
+
+      struct Any {
+	template<class T>
+	Any(const T&);
+      };
+
+      No operator << (std::ostream &out, const Any &x);
+      using cpunit::operator <<;
+
+      char test(std::ostream &out);
+      No test(const No &no);
+
+      std::ostream& a_stream();
+      template<class T>
+      const T& an_object();
+
+      template<class T>
+      struct IsStreamable {
+	static const bool value = sizeof(test(a_stream() << an_object<T>())) == 1;
+      };
+
+      /**
+	 Writes an operand of a failed check, or {?} if it cannot be written.
+       */
+      template<class T, bool S = IsStreamable<T>::value>
+      struct Printer {
+	static void print(std::ostream &out, const T &t);
+      };
+
+      template<class T>
+      struct Printer<T, false> {
+	static void print(std::ostream &out, const T &t);
+      };
+
+      template<>
+      struct Printer<bool, true> {
+	static void print(std::ostream &out, const bool &t);
+      };
+    }
+
+    /**
+       A comparison captured by CPUNIT_CHECK, with its operands by reference
+       and its result evaluated.
+     */
+    template<class L, class R>
+    class BinaryExpression {
+      const L &lhs;
+      const char *op;
+      const R &rhs;
+      const bool result;
+
+      // No assignment.
+      BinaryExpression& operator = (const BinaryExpression&);
+    public:
+      BinaryExpression(const L &lhs, const char *op, const R &rhs, const bool result);
+
+      bool passed() const;
+      void describe(std::ostream &out) const;
+    };
+
+    /**
+       The left operand of a comparison captured by CPUNIT_CHECK, or the 
+       whole statement if it has no comparison.
+     */
+    template<class L>
+    class UnaryExpression {
+      const L &lhs;
+
+      // No assignment.
+      UnaryExpression& operator = (const UnaryExpression&);
+    public:
+      explicit UnaryExpression(const L &lhs);
+
+      bool passed() const;
+      void describe(std::ostream &out) const;
+
+      template<class R> BinaryExpression<L, R> operator == (const R &rhs) const;
+      template<class R> BinaryExpression<L, R> operator != (const R &rhs) const;
+      template<class R> BinaryExpression<L, R> operator <  (const R &rhs) const;
+      template<class R> BinaryExpression<L, R> operator <= (const R &rhs) const;
+      template<class R> BinaryExpression<L, R> operator >  (const R &rhs) const;
+      template<class R> BinaryExpression<L, R> operator >= (const R &rhs) const;
+    };
+
+    /**
+       Starts the capture of a statement in CPUNIT_CHECK. Operator <= binds
+       weaker than arithmetic, but stronger than the comparisons, so in
+       <tt>ExpressionDecomposer() <= a + 1 == b</tt> it takes <tt>a + 1</tt>.
+     */
+    struct ExpressionDecomposer {
+      template<class L>
+      UnaryExpression<L> operator <= (const L &lhs) const;
+    };
+
+    template<class E>
+    void check(const E &e, const char *file, const int line, const char *statement);
+
+    template<class E>
+    void fail_check(const E &e, const char *file, const int line, const char *statement);
+
+    void fail_check(const std::string &expansion, const char *file, const int line, const char *statement);
+
+    template<class E>
+    void expect(const E &e, const char *file, const int line, const char *statement);
+
+    template<class E>
+    void fail_expect(const E &e, const char *file, const int line, const char *statement);
+
+    std::string describe_failure(const char *kind, const std::string &expansion, const char *file, const int line, const char *statement);
+  }
+}
+
+#include "cpunit_impl_Expression.tpp"
+
+#endif // CPUNIT_IMPL_EXPRESSION_HPP
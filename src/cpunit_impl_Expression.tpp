@@ -0,0 +1,217 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_ExpectationScope.hpp"
+
+#include <sstream>
+
+template<class T, bool S>
+void
+cpunit::impl::streamable::Printer<T, S>::print(std::ostream &out, const T &t) {
+  out<<t;
+}
+
+template<class T>
+void
+cpunit::impl::streamable::Printer<T, false>::print(std::ostream &out, const T&) {
+  out<<"{?}";
+}
+
+inline void
+cpunit::impl::streamable::Printer<bool, true>::print(std::ostream &out, const bool &t) {
+  out<<(t ? "true" : "false");
+}
+
+template<class L, class R>
+cpunit::impl::BinaryExpression<L, R>::BinaryExpression(const L &l, const char *o, const R &r, const bool res) :
+  lhs(l),
+  op(o),
+  rhs(r),
+  result(res)
+{}
+
+template<class L, class R>
+inline bool
+cpunit::impl::BinaryExpression<L, R>::passed() const {
+  return result;
+}
+
+/**
+   Writes the operands and the operator, e.g. <tt>&lt;1&gt; == &lt;2&gt;</tt>.
+ */
+template<class L, class R>
+void
+cpunit::impl::BinaryExpression<L, R>::describe(std::ostream &out) const {
+  out<<'<';
+  streamable::Printer<L>::print(out, lhs);
+  out<<"> "<<op<<" <";
+  streamable::Printer<R>::print(out, rhs);
+  out<<'>';
+}
+
+template<class L>
+cpunit::impl::UnaryExpression<L>::UnaryExpression(const L &l) :
+  lhs(l)
+{}
+
+template<class L>
+inline bool
+cpunit::impl::UnaryExpression<L>::passed() const {
+  return static_cast<bool>(lhs);
+}
+
+template<class L>
+void
+cpunit::impl::UnaryExpression<L>::describe(std::ostream &out) const {
+  out<<'<';
+  streamable::Printer<L>::print(out, lhs);
+  out<<'>';
+}
+
+// The operands are compared as written in the test, where a comparison of e.g. size() 
+// with a non-negative constant does not cause a warning.
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#endif
+
+template<class L>
+template<class R>
+inline cpunit::impl::BinaryExpression<L, R>
+cpunit::impl::UnaryExpression<L>::operator == (const R &rhs) const {
+  return BinaryExpression<L, R>(lhs, "==", rhs, lhs == rhs);
+}
+
+template<class L>
+template<class R>
+inline cpunit::impl::BinaryExpression<L, R>
+cpunit::impl::UnaryExpression<L>::operator != (const R &rhs) const {
+  return BinaryExpression<L, R>(lhs, "!=", rhs, lhs != rhs);
+}
+
+template<class L>
+template<class R>
+inline cpunit::impl::BinaryExpression<L, R>
+cpunit::impl::UnaryExpression<L>::operator < (const R &rhs) const {
+  return BinaryExpression<L, R>(lhs, "<", rhs, lhs < rhs);
+}
+
+template<class L>
+template<class R>
+inline cpunit::impl::BinaryExpression<L, R>
+cpunit::impl::UnaryExpression<L>::operator <= (const R &rhs) const {
+  return BinaryExpression<L, R>(lhs, "<=", rhs, lhs <= rhs);
+}
+
+template<class L>
+template<class R>
+inline cpunit::impl::BinaryExpression<L, R>
+cpunit::impl::UnaryExpression<L>::operator > (const R &rhs) const {
+  return BinaryExpression<L, R>(lhs, ">", rhs, lhs > rhs);
+}
+
+template<class L>
+template<class R>
+inline cpunit::impl::BinaryExpression<L, R>
+cpunit::impl::UnaryExpression<L>::operator >= (const R &rhs) const {
+  return BinaryExpression<L, R>(lhs, ">=", rhs, lhs >= rhs);
+}
+
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
+template<class L>
+inline cpunit::impl::UnaryExpression<L>
+cpunit::impl::ExpressionDecomposer::operator <= (const L &lhs) const {
+  return UnaryExpression<L>(lhs);
+}
+
+/**
+   Fails the test if a captured statement is false. The operands are
+   only written to a string if it is.
+   @param e         The captured statement.
+   @param file      The file of the check.
+   @param line      The line of the check.
+   @param statement The statement as written.
+   @throw AssertionException if the statement is false.
+ */
+template<class E>
+inline void
+cpunit::impl::check(const E &e, const char *file, const int line, const char *statement) {
+  if (!e.passed()) {
+    fail_check(e, file, line, statement);
+  }
+}
+
+/**
+   Throws the AssertionException of a failed CPUNIT_CHECK. Kept apart 
+   from check, so that the passing path is small enough to be inlined.
+ */
+template<class E>
+void
+cpunit::impl::fail_check(const E &e, const char *file, const int line, const char *statement) {
+  std::ostringstream oss;
+  e.describe(oss);
+  fail_check(oss.str(), file, line, statement);
+}
+
+/**
+   Records a failed expectation if a captured statement is false, 
+   and lets the test go on.
+   @param e         The captured statement.
+   @param file      The file of the expectation.
+   @param line      The line of the expectation.
+   @param statement The statement as written.
+   @see ExpectationScope
+ */
+template<class E>
+inline void
+cpunit::impl::expect(const E &e, const char *file, const int line, const char *statement) {
+  if (!e.passed()) {
+    fail_expect(e, file, line, statement);
+  }
+}
+
+/**
+   Records the failure of a CPUNIT_EXPECT. The operands are not written
+   if the message would be dropped anyway.
+ */
+template<class E>
+void
+cpunit::impl::fail_expect(const E &e, const char *file, const int line, const char *statement) {
+  if (!ExpectationScope::wants_message()) {
+    ExpectationScope::add_failure("");
+    return;
+  }
+  std::ostringstream oss;
+  e.describe(oss);
+  ExpectationScope::add_failure(describe_failure("EXPECT", oss.str(), file, line, statement));
+}
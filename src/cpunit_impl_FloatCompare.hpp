@@ -0,0 +1,70 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+#ifndef CPUNIT_IMPL_FLOATCOMPARE_HPP
+#define CPUNIT_IMPL_FLOATCOMPARE_HPP
+
+#include <stdint.h>
+
+namespace cpunit {
+  namespace impl {
+
+    /**
+       The unsigned integer type with the size of a floating point type.
+     */
+    template<class T>
+    struct FloatBits;
+
+    template<>
+    struct FloatBits<float> {
+      typedef uint32_t UInt;
+    };
+
+    template<>
+    struct FloatBits<double> {
+      typedef uint64_t UInt;
+    };
+
+    template<class T>
+    uint64_t ulp_distance(const T a, const T b);
+
+    template<class T>
+    bool within_ulps(const T expected, const T actual, const uint64_t max_ulps);
+
+    template<class T>
+    bool is_close(const T expected, const T actual, const T abs_tol, const T rel_tol);
+  }
+}
+
+#include "cpunit_impl_FloatCompare.tpp"
+
+#endif // CPUNIT_IMPL_FLOATCOMPARE_HPP
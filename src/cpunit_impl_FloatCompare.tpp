@@ -0,0 +1,127 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace cpunit {
+  namespace impl {
+    namespace floatcompare {
+
+      template<class T>
+      inline typename FloatBits<T>::UInt bits_of(const T x) {
+	typename FloatBits<T>::UInt u;
+	std::memcpy(&u, &x, sizeof(u));
+	return u;
+      }
+
+      template<class T>
+      inline typename FloatBits<T>::UInt sign_bit() {
+	typedef typename FloatBits<T>::UInt UInt;
+	return static_cast<UInt>(1) << (sizeof(UInt) * 8 - 1);
+      }
+
+      /**
+	 Maps the bits of a value to an unsigned integer with the same order 
+	 as the value, so that adjacent values map to adjacent integers, and 
+	 both zeros to the same integer. Branch free.
+       */
+      template<class T>
+      inline typename FloatBits<T>::UInt ordered(const typename FloatBits<T>::UInt bits) {
+	typedef typename FloatBits<T>::UInt UInt;
+	const UInt magnitude = bits & ~sign_bit<T>();
+	const UInt negative  = static_cast<UInt>(0) - (bits >> (sizeof(UInt) * 8 - 1));
+	return sign_bit<T>() + ((magnitude ^ negative) - negative);
+      }
+    }
+  }
+}
+
+/**
+   @return The number of representable values between a and b, 0 if they are
+           equal or both zero. Infinity is one step beyond the largest finite 
+           value. Meaningless if either is NaN.
+ */
+template<class T>
+inline uint64_t
+cpunit::impl::ulp_distance(const T a, const T b) {
+  typedef typename FloatBits<T>::UInt UInt;
+  const UInt oa = floatcompare::ordered<T>(floatcompare::bits_of(a));
+  const UInt ob = floatcompare::ordered<T>(floatcompare::bits_of(b));
+  return oa > ob ? oa - ob : ob - oa;
+}
+
+/**
+   Tells whether two values are at most max_ulps representable values apart.
+   NaN is not within any distance of anything, and infinity only of itself, 
+   while +0 and -0 are equal. Computed without branches, since nearly all 
+   comparisons pass.
+   @param expected The expected value.
+   @param actual   The actual value.
+   @param max_ulps The largest distance accepted.
+   @return true if the values are within the distance.
+ */
+template<class T>
+inline bool
+cpunit::impl::within_ulps(const T expected, const T actual, const uint64_t max_ulps) {
+  typedef typename FloatBits<T>::UInt UInt;
+  const UInt inf = floatcompare::bits_of(std::numeric_limits<T>::infinity());
+  const UInt be  = floatcompare::bits_of(expected);
+  const UInt ba  = floatcompare::bits_of(actual);
+  const UInt me  = be & ~floatcompare::sign_bit<T>();
+  const UInt ma  = ba & ~floatcompare::sign_bit<T>();
+  const UInt oe  = floatcompare::ordered<T>(be);
+  const UInt oa  = floatcompare::ordered<T>(ba);
+  const UInt distance = oe > oa ? oe - oa : oa - oe;
+
+  const bool nan = (me > inf) | (ma > inf);
+  const bool infinite = (me == inf) | (ma == inf);
+  return (distance <= max_ulps) & !nan & (!infinite | (oe == oa));
+}
+
+/**
+   Tells whether two values are equal, or if expected is finite and they
+   differ by at most abs_tol + rel_tol * |expected|. NaN is not close to 
+   anything, and infinity only to itself. Computed without branches.
+   @param expected The expected value.
+   @param actual   The actual value.
+   @param abs_tol  The absolute tolerance.
+   @param rel_tol  The tolerance relative to the expected value.
+   @return true if the values are close.
+ */
+template<class T>
+inline bool
+cpunit::impl::is_close(const T expected, const T actual, const T abs_tol, const T rel_tol) {
+  const T e = std::fabs(expected);
+  return (expected == actual)
+    | ((e < std::numeric_limits<T>::infinity()) & (std::fabs(actual - expected) <= abs_tol + rel_tol * e));
+}
@@ -0,0 +1,62 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CPUNIT_IMPL_HASH_HPP
+#define CPUNIT_IMPL_HASH_HPP
+
+#include <string>
+#include <stdint.h>
+
+namespace cpunit {
+  namespace impl {
+
+    /**
+       The FNV-1a offset basis, 0xcbf29ce484222325, written so that it
+       does not need a long long literal.
+     */
+    const uint64_t HASH_SEED = (static_cast<uint64_t>(0xcbf29ce4UL) << 32) | 0x84222325UL;
+
+    /**
+       64 bit FNV-1a hash of a string.
+       The value depends on nothing but the bytes of the string, so it is 
+       stable across runs, machines and builds, and may be persisted.
+       @param s    The string to hash.
+       @param seed A previous hash value to continue from, for hashing 
+                   several strings as one.
+     */
+    uint64_t hash_string(const std::string &s, const uint64_t seed = HASH_SEED);
+
+    /**
+       @return The stable hash of the fully qualified test name, i.e. "path::name".
+     */
+    uint64_t hash_test(const std::string &path, const std::string &name);
+  }
+}
+
+#endif // CPUNIT_IMPL_HASH_HPP
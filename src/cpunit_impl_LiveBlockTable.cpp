@@ -0,0 +1,200 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_impl_LiveBlockTable.hpp"
+
+#include <cstdlib>
+
+namespace {
+  const std::size_t INITIAL_BUCKETS = 1024;
+
+  class Lock {
+    pthread_mutex_t &mutex;
+
+    // No copy.
+    Lock(const Lock&);
+    Lock& operator = (const Lock&);
+  public:
+    explicit Lock(pthread_mutex_t &m) : mutex(m) {
+      pthread_mutex_lock(&mutex);
+    }
+    ~Lock() {
+      pthread_mutex_unlock(&mutex);
+    }
+  };
+}
+
+cpunit::impl::LiveBlockTable::LiveBlockTable() :
+  mutex(),
+  buckets(NULL),
+  bucket_count(0),
+  count(0),
+  last_serial(0)
+{
+  pthread_mutex_init(&mutex, NULL);
+}
+
+std::size_t
+cpunit::impl::LiveBlockTable::bucket_of(const void *p) const {
+  // Blocks are at least 16 bytes apart, so the low bits carry no information.
+  std::size_t h = reinterpret_cast<std::size_t>(p) >> 4;
+  h ^= h >> 15;
+  return h & (bucket_count - 1);
+}
+
+/**
+   Doubles the number of buckets. Keeps the old buckets if out of memory.
+ */
+void
+cpunit::impl::LiveBlockTable::grow() {
+  const std::size_t old_count = bucket_count;
+  Entry **old_buckets = buckets;
+  const std::size_t new_count = old_count == 0 ? INITIAL_BUCKETS : 2 * old_count;
+  Entry **new_buckets = static_cast<Entry**>(std::calloc(new_count, sizeof(Entry*)));
+  if (new_buckets == NULL) {
+    return;
+  }
+  buckets = new_buckets;
+  bucket_count = new_count;
+  for (std::size_t i=0; i<old_count; ++i) {
+    Entry *e = old_buckets[i];
+    while (e != NULL) {
+      Entry *next = e->next;
+      const std::size_t b = bucket_of(e->p);
+      e->next = buckets[b];
+      buckets[b] = e;
+      e = next;
+    }
+  }
+  std::free(old_buckets);
+}
+
+/**
+   @return A serial number for a new leak check, never 0.
+ */
+unsigned long
+cpunit::impl::LiveBlockTable::next_serial() {
+  Lock l(mutex);
+  if (++last_serial == 0) {
+    ++last_serial;
+  }
+  return last_serial;
+}
+
+/**
+   Records a live block.
+   @param p      The address of the block.
+   @param serial The leak check the block belongs to.
+   @param b      The size and call stack of the block.
+   @return false if out of memory, in which case the block is not recorded.
+ */
+bool
+cpunit::impl::LiveBlockTable::insert(const void *p, const unsigned long serial, const LeakReport::Block &b) {
+  Entry *e = static_cast<Entry*>(std::malloc(sizeof(Entry)));
+  if (e == NULL) {
+    return false;
+  }
+  e->p = p;
+  e->serial = serial;
+  e->block = b;
+
+  Lock l(mutex);
+  if (count >= bucket_count) {
+    grow();
+    if (bucket_count == 0) {
+      std::free(e);
+      return false;
+    }
+  }
+  const std::size_t i = bucket_of(p);
+  e->next = buckets[i];
+  buckets[i] = e;
+  ++count;
+  return true;
+}
+
+/**
+   Forgets a block, if recorded.
+ */
+void
+cpunit::impl::LiveBlockTable::erase(const void *p) {
+  Entry *found = NULL;
+  {
+    Lock l(mutex);
+    if (bucket_count == 0) {
+      return;
+    }
+    for (Entry **e = &buckets[bucket_of(p)]; *e != NULL; e = &(*e)->next) {
+      if ((*e)->p == p) {
+	found = *e;
+	*e = found->next;
+	--count;
+	break;
+      }
+    }
+  }
+  std::free(found);
+}
+
+/**
+   Forgets all blocks of a leak check.
+   @param serial The leak check.
+   @return The blocks forgotten.
+ */
+cpunit::LeakReport
+cpunit::impl::LiveBlockTable::remove_all(const unsigned long serial) {
+  Entry *removed = NULL;
+  {
+    Lock l(mutex);
+    for (std::size_t i=0; i<bucket_count; ++i) {
+      Entry **e = &buckets[i];
+      while (*e != NULL) {
+	if ((*e)->serial == serial) {
+	  Entry *found = *e;
+	  *e = found->next;
+	  found->next = removed;
+	  removed = found;
+	  --count;
+	} else {
+	  e = &(*e)->next;
+	}
+      }
+    }
+  }
+  // Built outside the lock, since the report allocates with operator new.
+  LeakReport result;
+  while (removed != NULL) {
+    Entry *next = removed->next;
+    result.add(removed->block);
+    std::free(removed);
+    removed = next;
+  }
+  return result;
+}
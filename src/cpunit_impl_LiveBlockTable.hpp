@@ -0,0 +1,80 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_IMPL_LIVEBLOCKTABLE_HPP
+#define CPUNIT_IMPL_LIVEBLOCKTABLE_HPP
+
+#include "cpunit_LeakReport.hpp"
+
+#include <cstddef>
+#include <pthread.h>
+
+namespace cpunit {
+  namespace impl {
+
+    /**
+       The live heap blocks recorded for leak detection, hashed on their address.
+       Every block belongs to a leak check, identified by a serial number.
+       Used from within operator new and delete, so the table allocates its
+       memory with malloc only, and has no destructor, since blocks may be
+       deallocated during static destruction.
+     */
+    class LiveBlockTable {
+      struct Entry {
+	const void *p;
+	unsigned long serial;
+	LeakReport::Block block;
+	Entry *next;
+      };
+
+      pthread_mutex_t mutex;
+      Entry **buckets;
+      std::size_t bucket_count;
+      std::size_t count;
+      unsigned long last_serial;
+
+      std::size_t bucket_of(const void *p) const;
+      void grow();
+
+      // No copy.
+      LiveBlockTable(const LiveBlockTable&);
+      LiveBlockTable& operator = (const LiveBlockTable&);
+    public:
+      LiveBlockTable();
+
+      unsigned long next_serial();
+      bool insert(const void *p, const unsigned long serial, const LeakReport::Block &b);
+      void erase(const void *p);
+      LeakReport remove_all(const unsigned long serial);
+    };
+  }
+}
+
+#endif // CPUNIT_IMPL_LIVEBLOCKTABLE_HPP
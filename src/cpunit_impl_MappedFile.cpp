@@ -0,0 +1,107 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#include "cpunit_impl_MappedFile.hpp"
+#include "cpunit_CPUnitException.hpp"
+#include "cpunit_trace.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+   Maps a file. A missing file is mapped as empty, and is_found() tells it apart.
+   @param path The file to map.
+   @throws CPUnitException if the file exists, but cannot be mapped.
+ */
+cpunit::impl::MappedFile::MappedFile(const std::string &path) :
+  data(NULL),
+  length(0),
+  found(false)
+{
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      return;
+    }
+    throw CPUnitException("Unable to open '" + path + "': " + std::strerror(errno));
+  }
+  found = true;
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    const int err = errno;
+    close(fd);
+    throw CPUnitException("Unable to stat '" + path + "': " + std::strerror(err));
+  }
+  length = static_cast<std::size_t>(st.st_size);
+  if (length > 0) {
+    void *p = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+      const int err = errno;
+      close(fd);
+      throw CPUnitException("Unable to map '" + path + "': " + std::strerror(err));
+    }
+    data = static_cast<const char*>(p);
+  }
+  // The mapping outlives the descriptor.
+  close(fd);
+  CPUNIT_DTRACE("MappedFile - Mapped "<<length<<" bytes of '"<<path<<"'.");
+}
+
+cpunit::impl::MappedFile::~MappedFile() {
+  if (data != NULL) {
+    munmap(const_cast<char*>(data), length);
+  }
+}
+
+/**
+   @return false if the file did not exist.
+ */
+bool
+cpunit::impl::MappedFile::is_found() const {
+  return found;
+}
+
+/**
+   @return The contents of the file, or NULL if it is missing or empty.
+ */
+const char*
+cpunit::impl::MappedFile::get_data() const {
+  return data;
+}
+
+std::size_t
+cpunit::impl::MappedFile::size() const {
+  return length;
+}
@@ -0,0 +1,74 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CPUNIT_IMPL_MUTEX_HPP
+#define CPUNIT_IMPL_MUTEX_HPP
+
+#include <pthread.h>
+
+namespace cpunit {
+  namespace impl {
+
+    /**
+       Thin, non-copyable wrapper around a POSIX mutex.
+       Used to protect the few pieces of shared state that
+       are touched when tests are executed on several threads.
+     */
+    class Mutex {
+      pthread_mutex_t mutex;
+
+      // No copy.
+      Mutex(const Mutex&);
+      Mutex& operator = (const Mutex&);
+    public:
+      Mutex();
+      ~Mutex();
+
+      void lock();
+      void unlock();
+    };
+
+    /**
+       Scoped lock. Locks the mutex in the constructor
+       and unlocks it in the destructor.
+     */
+    class MutexLock {
+      Mutex &mutex;
+
+      // No copy.
+      MutexLock(const MutexLock&);
+      MutexLock& operator = (const MutexLock&);
+    public:
+      explicit MutexLock(Mutex &m);
+      ~MutexLock();
+    };
+  }
+}
+
+#endif // CPUNIT_IMPL_MUTEX_HPP
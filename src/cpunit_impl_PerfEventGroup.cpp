@@ -0,0 +1,217 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_impl_PerfEventGroup.hpp"
+#include "cpunit_AllocationTracker.hpp"
+#include "cpunit_trace.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <unistd.h>
+
+#ifdef __linux__
+# include <fcntl.h>
+# include <linux/perf_event.h>
+# include <sys/syscall.h>
+# define CPUNIT_HAS_PERF_EVENTS
+#endif
+
+namespace {
+
+  pthread_key_t group_key;
+  pthread_once_t group_key_once = PTHREAD_ONCE_INIT;
+
+  void delete_group(void *group) {
+    delete static_cast<cpunit::impl::PerfEventGroup*>(group);
+  }
+
+  void create_group_key() {
+    pthread_key_create(&group_key, delete_group);
+  }
+
+#ifdef CPUNIT_HAS_PERF_EVENTS
+  const uint64_t CONFIGS[cpunit::PerfCounters::NUM_EVENTS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+  };
+
+  /**
+     Opens a counter of e for the calling thread, in the group led by leader,
+     or as a new group if leader is -1.
+     @return The file descriptor of the counter, or -1 with errno set.
+   */
+  int open_counter(const cpunit::PerfCounters::Event e, const int leader) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = CONFIGS[e];
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+    if (fd >= 0) {
+      fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    return fd;
+  }
+#endif
+}
+
+/**
+   Opens the counters of the given events that the machine supports.
+   @param events The events to count, as a set of PerfCounters::mask_of bits.
+ */
+cpunit::impl::PerfEventGroup::PerfEventGroup(const unsigned events) :
+  size(0),
+  requested(events),
+  owner(getpid())
+{
+#ifdef CPUNIT_HAS_PERF_EVENTS
+  for (int i=0; i<PerfCounters::NUM_EVENTS; ++i) {
+    const PerfCounters::Event e = static_cast<PerfCounters::Event>(i);
+    if ((events & PerfCounters::mask_of(e)) == 0) {
+      continue;
+    }
+    const int fd = open_counter(e, size == 0 ? -1 : fds[0]);
+    if (fd >= 0) {
+      fds[size] = fd;
+      order[size] = e;
+      ++size;
+    } else {
+      CPUNIT_DTRACE("PerfEventGroup - Unable to open "<<PerfCounters::name_of(e)<<": "<<std::strerror(errno));
+    }
+  }
+#endif
+}
+
+cpunit::impl::PerfEventGroup::~PerfEventGroup() {
+  for (int i=size-1; i>=0; --i) {
+    close(fds[i]);
+  }
+}
+
+/**
+   @return The events actually counted by this group.
+ */
+unsigned
+cpunit::impl::PerfEventGroup::get_events() const {
+  unsigned result = 0;
+  for (int i=0; i<size; ++i) {
+    result |= PerfCounters::mask_of(order[i]);
+  }
+  return result;
+}
+
+/**
+   @return The counts of the group since it was opened, or no counts
+           if the group has not been scheduled on the processor yet.
+ */
+cpunit::PerfCounters
+cpunit::impl::PerfEventGroup::read() const {
+  PerfCounters result;
+#ifdef CPUNIT_HAS_PERF_EVENTS
+  if (size == 0) {
+    return result;
+  }
+  // nr, time enabled, time running, and one value per counter.
+  uint64_t buf[3 + PerfCounters::NUM_EVENTS];
+  const ssize_t n = ::read(fds[0], buf, sizeof(buf));
+  if (n < static_cast<ssize_t>((3 + size) * sizeof(uint64_t)) || buf[2] == 0) {
+    return result;
+  }
+  const double scale = buf[1] > buf[2] ? static_cast<double>(buf[1]) / buf[2] : 1.0;
+  for (int i=0; i<size; ++i) {
+    result.set(order[i], scale == 1.0 ? buf[3 + i] : static_cast<uint64_t>(buf[3 + i] * scale));
+  }
+#endif
+  return result;
+}
+
+/**
+   Reads the counters of the calling thread, opening them on the first call.
+   Subtract two snapshots to get the counts in between.
+   @param events The events to count, as a set of PerfCounters::mask_of bits.
+   @return The counts of the thread so far.
+ */
+cpunit::PerfCounters
+cpunit::impl::PerfEventGroup::of_this_thread(const unsigned events) {
+  pthread_once(&group_key_once, create_group_key);
+  PerfEventGroup *group = static_cast<PerfEventGroup*>(pthread_getspecific(group_key));
+  if (group == NULL || group->requested != events || group->owner != getpid()) {
+    delete group;
+    // The group lives as long as the thread, and is no leak of the test opening it.
+    LeakRecordingScope not_recording(false);
+    group = new PerfEventGroup(events);
+    pthread_setspecific(group_key, group);
+  }
+  return group->read();
+}
+
+/**
+   Checks which of the given events can be counted on this machine,
+   by opening and closing a counter of each.
+   @param events  The events to check, as a set of PerfCounters::mask_of bits.
+   @param problem Receives the reason the first unsupported event failed.
+   @return The supported events.
+ */
+unsigned
+cpunit::impl::PerfEventGroup::probe(const unsigned events, std::string &problem) {
+#ifdef CPUNIT_HAS_PERF_EVENTS
+  unsigned result = 0;
+  for (int i=0; i<PerfCounters::NUM_EVENTS; ++i) {
+    const PerfCounters::Event e = static_cast<PerfCounters::Event>(i);
+    if ((events & PerfCounters::mask_of(e)) == 0) {
+      continue;
+    }
+    const int fd = open_counter(e, -1);
+    if (fd >= 0) {
+      close(fd);
+      result |= PerfCounters::mask_of(e);
+    } else if (problem.empty()) {
+      problem = std::strerror(errno);
+      if (errno == EACCES || errno == EPERM) {
+	problem += " (see /proc/sys/kernel/perf_event_paranoid)";
+      } else if (errno == ENOENT || errno == EOPNOTSUPP) {
+	problem += " (no hardware counters available, e.g. in a virtual machine)";
+      }
+    }
+  }
+  return result;
+#else
+  if (events != 0) {
+    problem = "perf_event_open is not supported on this platform";
+  }
+  return 0;
+#endif
+}
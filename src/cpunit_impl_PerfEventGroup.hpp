@@ -0,0 +1,75 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_IMPL_PERFEVENTGROUP_HPP
+#define CPUNIT_IMPL_PERFEVENTGROUP_HPP
+
+#include "cpunit_PerfCounters.hpp"
+
+#include <string>
+#include <sys/types.h>
+
+namespace cpunit {
+  namespace impl {
+
+    /**
+       A group of hardware performance counters of the calling thread, opened
+       with perf_event_open(2) and read with a single system call.
+       Only user space is counted. When the kernel has to multiplex the 
+       counters, the counts are scaled by the fraction of time they ran.
+
+       Each thread has its own group, created on the first call to
+       of_this_thread(). A forked process replaces the group inherited from
+       its parent, since that one counts the parent.
+     */
+    class PerfEventGroup {
+      int fds[PerfCounters::NUM_EVENTS];
+      PerfCounters::Event order[PerfCounters::NUM_EVENTS];
+      int size;
+      unsigned requested;
+      pid_t owner;
+
+      // No copy.
+      PerfEventGroup(const PerfEventGroup&);
+      PerfEventGroup& operator = (const PerfEventGroup&);
+    public:
+      explicit PerfEventGroup(const unsigned events);
+      ~PerfEventGroup();
+
+      unsigned get_events() const;
+      PerfCounters read() const;
+
+      static PerfCounters of_this_thread(const unsigned events);
+      static unsigned probe(const unsigned events, std::string &problem);
+    };
+  }
+}
+
+#endif // CPUNIT_IMPL_PERFEVENTGROUP_HPP
@@ -0,0 +1,454 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cpunit_impl_ProcessPool.hpp"
+#include "cpunit_Clock.hpp"
+#include "cpunit_CPUnitException.hpp"
+#include "cpunit_WrongSetupException.hpp"
+#include "cpunit_trace.hpp"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+  /**
+     The message a worker sends back for each finished item.
+   */
+  struct Ack {
+    std::size_t item;
+    int retiring;
+  };
+
+  bool read_fully(const int fd, void *buf, const std::size_t len) {
+    char *p = static_cast<char*>(buf);
+    std::size_t got = 0;
+    while (got < len) {
+      const ssize_t n = read(fd, p + got, len - got);
+      if (n < 0 && errno == EINTR) {
+	continue;
+      }
+      if (n <= 0) {
+	return false;
+      }
+      got += n;
+    }
+    return true;
+  }
+
+  bool write_fully(const int fd, const void *buf, const std::size_t len) {
+    const char *p = static_cast<const char*>(buf);
+    std::size_t put = 0;
+    while (put < len) {
+      const ssize_t n = write(fd, p + put, len - put);
+      if (n < 0 && errno == EINTR) {
+	continue;
+      }
+      if (n <= 0) {
+	return false;
+      }
+      put += n;
+    }
+    return true;
+  }
+
+  void close_fd(int &fd) {
+    if (fd >= 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+}
+
+const std::size_t cpunit::impl::ProcessPool::NO_ITEM(static_cast<std::size_t>(-1));
+
+cpunit::impl::ProcessPool::Job::~Job()
+{}
+
+/**
+   @param workers       The number of worker processes. Must be at least 1.
+   @param recycle_after The number of items after which a worker is replaced, 0 for never.
+   @param max_rss_mb    The resident memory in megabytes above which a worker is replaced
+                        after its current item, 0 for no limit.
+   @throws WrongSetupException if workers is 0.
+ */
+cpunit::impl::ProcessPool::ProcessPool(const std::size_t workers, const std::size_t recycle, const std::size_t max_rss) :
+  num_workers(workers),
+  recycle_after(recycle),
+  max_rss_mb(max_rss),
+  workers(),
+  cancelled(false),
+  item_timeout(0)
+{
+  if (num_workers == 0) {
+    throw WrongSetupException("The number of worker processes must be at least 1.");
+  }
+}
+
+cpunit::impl::ProcessPool::~ProcessPool()
+{}
+
+/**
+   Executes job for every item in the worker processes, and returns when
+   all items are done, or the pool is cancelled and the running items are done.
+   All workers are terminated before the method returns.
+   @param items The items to execute, in the preferred order of execution.
+   @param job   The work to perform for each item.
+   @throws CPUnitException if no worker process can be started.
+ */
+void
+cpunit::impl::ProcessPool::run(const std::vector<std::size_t> &items, Job &job) {
+  std::deque<std::size_t> pending(items.begin(), items.end());
+
+  // A worker dying between two items must not take the parent down with SIGPIPE.
+  struct sigaction ignore, old_action;
+  std::memset(&ignore, 0, sizeof(ignore));
+  ignore.sa_handler = SIG_IGN;
+  sigaction(SIGPIPE, &ignore, &old_action);
+
+  Worker none;
+  none.pid = -1;
+  none.cmd_fd = -1;
+  none.ack_fd = -1;
+  none.item = NO_ITEM;
+  none.started = 0;
+  none.timed_out = false;
+  workers.assign(std::min(num_workers, items.size()), none);
+  for (std::size_t w=0; w<workers.size(); ++w) {
+    spawn(w, job);
+  }
+
+  std::vector<pollfd> fds;
+  std::vector<std::size_t> owners;
+  for (;;) {
+    for (std::size_t w=0; w<workers.size(); ++w) {
+      while (workers[w].pid > 0 && workers[w].item == NO_ITEM && !cancelled && !pending.empty()) {
+	if (!dispatch(w, pending)) {
+	  reap(w, job);
+	  spawn(w, job);
+	}
+      }
+    }
+
+    fds.clear();
+    owners.clear();
+    for (std::size_t w=0; w<workers.size(); ++w) {
+      if (workers[w].pid > 0 && workers[w].item != NO_ITEM) {
+	pollfd p;
+	p.fd = workers[w].ack_fd;
+	p.events = POLLIN;
+	p.revents = 0;
+	fds.push_back(p);
+	owners.push_back(w);
+      }
+    }
+    if (fds.empty()) {
+      break;
+    }
+
+    const int ready = poll(&fds[0], fds.size(), poll_timeout_ms());
+    if (ready < 0) {
+      if (errno == EINTR) {
+	continue;
+      }
+      throw CPUnitException(std::string("poll failed: ") + std::strerror(errno));
+    }
+    kill_overdue();
+    if (ready == 0) {
+      continue;
+    }
+
+    for (std::size_t i=0; i<fds.size(); ++i) {
+      if (fds[i].revents == 0) {
+	continue;
+      }
+      const std::size_t w = owners[i];
+      Ack ack;
+      if (read_fully(workers[w].ack_fd, &ack, sizeof(ack))) {
+	workers[w].item = NO_ITEM;
+	job.done(ack.item);
+	if (ack.retiring) {
+	  CPUNIT_DTRACE("ProcessPool - Recycling worker "<<w);
+	  reap(w, job);
+	  if (!cancelled && !pending.empty()) {
+	    spawn(w, job);
+	  }
+	}
+      } else {
+	reap(w, job);
+	if (!cancelled && !pending.empty()) {
+	  spawn(w, job);
+	}
+      }
+    }
+  }
+
+  // Closing the command pipes makes the idle workers exit.
+  for (std::size_t w=0; w<workers.size(); ++w) {
+    close_fd(workers[w].cmd_fd);
+  }
+  for (std::size_t w=0; w<workers.size(); ++w) {
+    reap(w, job);
+  }
+  workers.clear();
+  sigaction(SIGPIPE, &old_action, NULL);
+}
+
+/**
+   Stops the pool from dispatching new items.
+   Items that are already running run to completion.
+ */
+void
+cpunit::impl::ProcessPool::cancel() {
+  cancelled = true;
+}
+
+bool
+cpunit::impl::ProcessPool::is_cancelled() const {
+  return cancelled;
+}
+
+/**
+   Makes the pool kill a worker whose item runs for longer than the given
+   time. The item is then reported as crashed.
+   @param seconds The longest time an item may run, or 0 for no limit.
+ */
+void
+cpunit::impl::ProcessPool::set_item_timeout(const double seconds) {
+  item_timeout = seconds;
+}
+
+/**
+   @return The resident memory of the calling process in megabytes.
+ */
+std::size_t
+cpunit::impl::ProcessPool::resident_memory_mb() {
+  std::ifstream statm("/proc/self/statm");
+  std::size_t size = 0, resident = 0;
+  if (statm >> size >> resident) {
+    return resident * sysconf(_SC_PAGESIZE) / (1024 * 1024);
+  }
+  // Fall back to the peak, which is what getrusage offers.
+  rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  return ru.ru_maxrss / 1024;
+}
+
+void
+cpunit::impl::ProcessPool::spawn(const std::size_t w, Job &job) {
+  int cmd[2], ack[2];
+  if (pipe(cmd) != 0) {
+    throw CPUnitException(std::string("Unable to create pipe: ") + std::strerror(errno));
+  }
+  if (pipe(ack) != 0) {
+    close(cmd[0]);
+    close(cmd[1]);
+    throw CPUnitException(std::string("Unable to create pipe: ") + std::strerror(errno));
+  }
+
+  // Anything buffered would otherwise be written once by each process.
+  std::cout<<std::flush;
+  std::cerr<<std::flush;
+  std::fflush(NULL);
+
+  const pid_t pid = fork();
+  if (pid < 0) {
+    close(cmd[0]);
+    close(cmd[1]);
+    close(ack[0]);
+    close(ack[1]);
+    throw CPUnitException(std::string("Unable to fork worker process: ") + std::strerror(errno));
+  }
+
+  if (pid == 0) {
+    for (std::size_t i=0; i<workers.size(); ++i) {
+      close_fd(workers[i].cmd_fd);
+      close_fd(workers[i].ack_fd);
+    }
+    close(cmd[1]);
+    close(ack[0]);
+    workers[w].cmd_fd = cmd[0];
+    workers[w].ack_fd = ack[1];
+    worker_main(w, job);
+    // Skip static destructors and atexit handlers; they belong to the parent.
+    _exit(0);
+  }
+
+  close(cmd[0]);
+  close(ack[1]);
+  workers[w].pid = pid;
+  workers[w].cmd_fd = cmd[1];
+  workers[w].ack_fd = ack[0];
+  workers[w].item = NO_ITEM;
+  workers[w].timed_out = false;
+  CPUNIT_DTRACE("ProcessPool - Started worker "<<w<<" as pid "<<pid);
+}
+
+void
+cpunit::impl::ProcessPool::worker_main(const std::size_t w, Job &job) {
+  std::size_t count = 0;
+  std::size_t item = 0;
+  while (read_fully(workers[w].cmd_fd, &item, sizeof(item))) {
+    job.run(item);
+    std::cout<<std::flush;
+    std::cerr<<std::flush;
+    std::fflush(NULL);
+
+    ++count;
+    Ack ack;
+    ack.item = item;
+    ack.retiring = retire() || (recycle_after > 0 && count >= recycle_after);
+    if (!write_fully(workers[w].ack_fd, &ack, sizeof(ack)) || ack.retiring) {
+      break;
+    }
+  }
+}
+
+bool
+cpunit::impl::ProcessPool::retire() const {
+  return max_rss_mb > 0 && resident_memory_mb() >= max_rss_mb;
+}
+
+/**
+   @return How long to wait for acknowledgements before the first running 
+           item is overdue, or -1 to wait forever.
+ */
+int
+cpunit::impl::ProcessPool::poll_timeout_ms() const {
+  if (item_timeout <= 0) {
+    return -1;
+  }
+  const uint64_t now = Clock::now();
+  bool found = false;
+  double first = 0;
+  for (std::size_t w=0; w<workers.size(); ++w) {
+    if (workers[w].pid > 0 && workers[w].item != NO_ITEM && !workers[w].timed_out) {
+      const double elapsed = (now - workers[w].started) / 1e9;
+      const double left = item_timeout - elapsed;
+      if (!found || left < first) {
+	first = left;
+	found = true;
+      }
+    }
+  }
+  if (!found) {
+    return -1;
+  }
+  if (first <= 0) {
+    return 0;
+  }
+  // Round up, so that the item is overdue when poll returns.
+  return static_cast<int>(first * 1000) + 1;
+}
+
+/**
+   Kills the workers whose item has exceeded the item timeout. They are 
+   reaped, and the item reported as crashed, when their pipe closes.
+ */
+void
+cpunit::impl::ProcessPool::kill_overdue() {
+  if (item_timeout <= 0) {
+    return;
+  }
+  const uint64_t now = Clock::now();
+  for (std::size_t w=0; w<workers.size(); ++w) {
+    Worker &worker = workers[w];
+    if (worker.pid > 0 && worker.item != NO_ITEM && !worker.timed_out) {
+      const double elapsed = (now - worker.started) / 1e9;
+      if (elapsed >= item_timeout) {
+	CPUNIT_DTRACE("ProcessPool - Killing worker "<<w<<", item "<<worker.item<<" exceeded "<<item_timeout<<'s');
+	worker.timed_out = true;
+	kill(worker.pid, SIGKILL);
+      }
+    }
+  }
+}
+
+bool
+cpunit::impl::ProcessPool::dispatch(const std::size_t w, std::deque<std::size_t> &pending) {
+  const std::size_t item = pending.front();
+  if (!write_fully(workers[w].cmd_fd, &item, sizeof(item))) {
+    return false;
+  }
+  pending.pop_front();
+  workers[w].item = item;
+  workers[w].started = Clock::now();
+  return true;
+}
+
+/**
+   Waits for worker w to terminate, and reports its running item, if any, as crashed.
+ */
+void
+cpunit::impl::ProcessPool::reap(const std::size_t w, Job &job) {
+  Worker &worker = workers[w];
+  close_fd(worker.cmd_fd);
+  close_fd(worker.ack_fd);
+  if (worker.pid <= 0) {
+    return;
+  }
+  int status = 0;
+  while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR)
+    {}
+  worker.pid = -1;
+  if (worker.item != NO_ITEM) {
+    const std::size_t item = worker.item;
+    worker.item = NO_ITEM;
+    if (worker.timed_out) {
+      std::ostringstream oss;
+      oss<<"TIME GUARD ERROR - Worker process killed after running the test for more than "<<item_timeout<<"s.";
+      job.crashed(item, oss.str());
+    } else {
+      job.crashed(item, describe(status));
+    }
+  }
+}
+
+std::string
+cpunit::impl::ProcessPool::describe(const int status) {
+  std::ostringstream oss;
+  if (WIFSIGNALED(status)) {
+    oss<<"Worker process killed by signal "<<WTERMSIG(status)<<" ("<<strsignal(WTERMSIG(status))<<")";
+  } else if (WIFEXITED(status)) {
+    oss<<"Worker process exited with status "<<WEXITSTATUS(status);
+  } else {
+    oss<<"Worker process terminated";
+  }
+  oss<<" while running the test.";
+  return oss.str();
+}
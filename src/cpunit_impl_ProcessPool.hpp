@@ -0,0 +1,127 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CPUNIT_IMPL_PROCESSPOOL_HPP
+#define CPUNIT_IMPL_PROCESSPOOL_HPP
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <sys/types.h>
+
+namespace cpunit {
+  namespace impl {
+
+    /**
+       A pool of long-lived worker processes, forked from the calling process.
+       The parent passes item indices to idle workers over one pipe per worker,
+       and each worker acknowledges a finished item on a second pipe.
+       Results are expected to travel through shared memory; see SharedReportTable.
+
+       A worker dying while running an item is reported through Job::crashed,
+       and replaced by a fresh worker if there is more work to do. Workers
+       retire voluntarily after a given number of items, or when their
+       resident memory exceeds a given limit, and are then replaced as well.
+     */
+    class ProcessPool {
+    public:
+
+      /**
+         The work to do for each item.
+       */
+      class Job {
+      public:
+	virtual ~Job();
+
+	/**
+	   Executes an item. Called in a worker process.
+	   Implementations must not let exceptions escape.
+	 */
+	virtual void run(const std::size_t item) = 0;
+
+	/**
+	   Called in the parent process when a worker has finished an item.
+	 */
+	virtual void done(const std::size_t item) = 0;
+
+	/**
+	   Called in the parent process when a worker died while running an item.
+	   @param reason A description of how the worker died.
+	 */
+	virtual void crashed(const std::size_t item, const std::string &reason) = 0;
+      };
+
+    private:
+      static const std::size_t NO_ITEM;
+
+      struct Worker {
+	pid_t pid;
+	int cmd_fd;
+	int ack_fd;
+	std::size_t item;
+	uint64_t started;
+	bool timed_out;
+      };
+
+      const std::size_t num_workers;
+      const std::size_t recycle_after;
+      const std::size_t max_rss_mb;
+      std::vector<Worker> workers;
+      bool cancelled;
+      double item_timeout;
+
+      void spawn(const std::size_t w, Job &job);
+      void worker_main(const std::size_t w, Job &job);
+      bool dispatch(const std::size_t w, std::deque<std::size_t> &pending);
+      void reap(const std::size_t w, Job &job);
+      bool retire() const;
+      int poll_timeout_ms() const;
+      void kill_overdue();
+      static std::string describe(const int status);
+
+      // No copy.
+      ProcessPool(const ProcessPool&);
+      ProcessPool& operator = (const ProcessPool&);
+    public:
+      ProcessPool(const std::size_t workers, const std::size_t recycle_after, const std::size_t max_rss_mb);
+      ~ProcessPool();
+
+      void run(const std::vector<std::size_t> &items, Job &job);
+      void cancel();
+      bool is_cancelled() const;
+      void set_item_timeout(const double seconds);
+
+      static std::size_t resident_memory_mb();
+    };
+  }
+}
+
+#endif // CPUNIT_IMPL_PROCESSPOOL_HPP
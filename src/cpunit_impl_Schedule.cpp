@@ -0,0 +1,96 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_impl_Schedule.hpp"
+#include "cpunit_trace.hpp"
+
+#include <algorithm>
+#include <map>
+#include <string>
+
+namespace {
+
+  struct Mean {
+    double sum;
+    std::size_t n;
+    Mean() : sum(.0), n(0) {}
+    void add(const double x) { sum += x; ++n; }
+    double get() const { return n == 0 ? .0 : sum / n; }
+  };
+
+  struct ByDuration {
+    const std::vector<double> &estimates;
+    const bool longest_first;
+    ByDuration(const std::vector<double> &e, const bool l) :
+      estimates(e),
+      longest_first(l)
+    {}
+    bool operator () (const std::size_t a, const std::size_t b) const {
+      return longest_first ? estimates[a] > estimates[b] : estimates[a] < estimates[b];
+    }
+  };
+}
+
+std::vector<double>
+cpunit::impl::estimate_durations(const std::vector<const RegInfo*> &tests, const TimingDatabase &db) {
+  std::vector<double> result(tests.size(), .0);
+  std::vector<char> known(tests.size(), false);
+  std::map<std::string, Mean> suites;
+  Mean global;
+
+  TimingDatabase::Entry e;
+  for (std::size_t i=0; i<tests.size(); ++i) {
+    if (db.lookup(*tests[i], e)) {
+      result[i] = e.mean;
+      known[i] = true;
+      suites[tests[i]->get_path()].add(e.mean);
+      global.add(e.mean);
+    }
+  }
+
+  for (std::size_t i=0; i<tests.size(); ++i) {
+    if (!known[i]) {
+      std::map<std::string, Mean>::const_iterator it = suites.find(tests[i]->get_path());
+      result[i] = (it != suites.end() ? it->second.get() : global.get());
+    }
+  }
+  CPUNIT_DTRACE("estimate_durations - "<<global.n<<" of "<<tests.size()<<" tests have a history.");
+  return result;
+}
+
+std::vector<std::size_t>
+cpunit::impl::order_by_duration(const std::vector<double> &estimates, const bool longest_first) {
+  std::vector<std::size_t> order(estimates.size());
+  for (std::size_t i=0; i<order.size(); ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), ByDuration(estimates, longest_first));
+  return order;
+}
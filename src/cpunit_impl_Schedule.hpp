@@ -0,0 +1,64 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_IMPL_SCHEDULE_HPP
+#define CPUNIT_IMPL_SCHEDULE_HPP
+
+#include "cpunit_RegInfo.hpp"
+#include "cpunit_TimingDatabase.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace cpunit {
+  namespace impl {
+
+    /**
+       Estimates the duration of each test from its timing history.
+       A test without history is estimated by the mean of the known tests
+       in the same suite, or by the mean of all known tests if its suite
+       has none. With no history at all, every estimate is 0.
+       @param tests The tests to estimate.
+       @param db    The timing history.
+       @return The estimated durations in seconds, in the order of tests.
+     */
+    std::vector<double> estimate_durations(const std::vector<const RegInfo*> &tests, const TimingDatabase &db);
+
+    /**
+       @param estimates The estimated durations.
+       @param longest_first true for descending order, false for ascending.
+       @return The indices of estimates, ordered by duration. Equal estimates
+               keep their original relative order.
+     */
+    std::vector<std::size_t> order_by_duration(const std::vector<double> &estimates, const bool longest_first);
+  }
+}
+
+#endif // CPUNIT_IMPL_SCHEDULE_HPP
@@ -0,0 +1,144 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cpunit_impl_SharedReportTable.hpp"
+#include "cpunit_CPUnitException.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <sys/mman.h>
+
+namespace {
+  const char TRUNCATED[] = " [...]";
+}
+
+/**
+   Maps a zero-initialized table with room for n reports.
+   @throws CPUnitException if the memory cannot be mapped.
+ */
+cpunit::impl::SharedReportTable::SharedReportTable(const std::size_t n) :
+  records(NULL),
+  size(n)
+{
+  const std::size_t bytes = (size == 0 ? 1 : size) * sizeof(Record);
+  void *p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) {
+    throw CPUnitException(std::string("Unable to map the shared report table: ") + std::strerror(errno));
+  }
+  records = static_cast<Record*>(p);
+}
+
+cpunit::impl::SharedReportTable::~SharedReportTable() {
+  munmap(records, (size == 0 ? 1 : size) * sizeof(Record));
+}
+
+/**
+   Writes a report into record i. Called from the worker processes.
+   @param i        The record index.
+   @param r        The report to store.
+   @param executed Whether the test was executed, or the set-up failed.
+ */
+void
+cpunit::impl::SharedReportTable::store(const std::size_t i, const ExecutionReport &r, const bool executed) {
+  Record &rec = records[i];
+  rec.executed = executed ? 1 : 0;
+  rec.result = static_cast<int>(r.get_execution_result());
+  rec.time_spent = r.get_time_spent();
+  rec.set_up_time = r.get_set_up_time();
+  const ResourceUsage &u = r.get_resource_usage();
+  rec.cpu_time = u.get_cpu_time();
+  rec.usage[0] = u.get_voluntary_switches();
+  rec.usage[1] = u.get_involuntary_switches();
+  rec.usage[2] = u.get_minor_faults();
+  rec.usage[3] = u.get_major_faults();
+  const AllocationStats &a = r.get_allocation_stats();
+  rec.allocations[0] = a.get_allocations();
+  rec.allocations[1] = a.get_deallocations();
+  rec.allocations[2] = a.get_bytes();
+  rec.allocations[3] = a.get_peak_bytes();
+  const PerfCounters &c = r.get_perf_counters();
+  rec.counted = 0;
+  for (int k=0; k<PerfCounters::NUM_EVENTS; ++k) {
+    const PerfCounters::Event e = static_cast<PerfCounters::Event>(k);
+    rec.counters[k] = c.get(e);
+    if (c.has(e)) {
+      rec.counted |= PerfCounters::mask_of(e);
+    }
+  }
+
+  const std::string &msg = r.get_message();
+  if (msg.length() < MESSAGE_CAPACITY) {
+    rec.message_length = msg.length();
+  } else {
+    rec.message_length = MESSAGE_CAPACITY - sizeof(TRUNCATED);
+  }
+  std::memcpy(rec.message, msg.data(), rec.message_length);
+  if (rec.message_length < msg.length()) {
+    std::memcpy(rec.message + rec.message_length, TRUNCATED, sizeof(TRUNCATED) - 1);
+    rec.message_length += sizeof(TRUNCATED) - 1;
+  }
+  rec.done = 1;
+}
+
+bool
+cpunit::impl::SharedReportTable::is_done(const std::size_t i) const {
+  return records[i].done != 0;
+}
+
+bool
+cpunit::impl::SharedReportTable::is_executed(const std::size_t i) const {
+  return records[i].executed != 0;
+}
+
+/**
+   Reads record i back as an ExecutionReport.
+   @param i    The record index.
+   @param test The RegInfo of the test the record belongs to.
+ */
+cpunit::ExecutionReport
+cpunit::impl::SharedReportTable::load(const std::size_t i, const RegInfo &test) const {
+  const Record &rec = records[i];
+  ExecutionReport r(static_cast<ExecutionReport::ExecutionResult>(rec.result),
+		    std::string(rec.message, rec.message_length),
+		    test,
+		    rec.time_spent);
+  r.set_set_up_time(rec.set_up_time);
+  r.set_resource_usage(ResourceUsage(rec.cpu_time, rec.usage[0], rec.usage[1], rec.usage[2], rec.usage[3]));
+  PerfCounters c;
+  for (int k=0; k<PerfCounters::NUM_EVENTS; ++k) {
+    const PerfCounters::Event e = static_cast<PerfCounters::Event>(k);
+    if ((rec.counted & PerfCounters::mask_of(e)) != 0) {
+      c.set(e, rec.counters[k]);
+    }
+  }
+  r.set_perf_counters(c);
+  r.set_allocation_stats(AllocationStats(rec.allocations[0], rec.allocations[1], rec.allocations[2], rec.allocations[3]));
+  return r;
+}
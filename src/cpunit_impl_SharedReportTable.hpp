@@ -0,0 +1,86 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CPUNIT_IMPL_SHAREDREPORTTABLE_HPP
+#define CPUNIT_IMPL_SHAREDREPORTTABLE_HPP
+
+#include "cpunit_ExecutionReport.hpp"
+#include "cpunit_RegInfo.hpp"
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace cpunit {
+  namespace impl {
+
+    /**
+       A table of fixed size ExecutionReport records in shared memory.
+       The table is mapped before worker processes are forked, so workers
+       write their reports directly into memory the parent process reads.
+       Messages longer than the record capacity are truncated.
+     */
+    class SharedReportTable {
+    public:
+      static const std::size_t MESSAGE_CAPACITY = 2048;
+
+    private:
+      struct Record {
+	int done;
+	int executed;
+	int result;
+	double time_spent;
+	double set_up_time;
+	double cpu_time;
+	long usage[4];
+	unsigned counted;
+	uint64_t counters[PerfCounters::NUM_EVENTS];
+	std::size_t allocations[4];
+	std::size_t message_length;
+	char message[MESSAGE_CAPACITY];
+      };
+
+      Record *records;
+      std::size_t size;
+
+      // No copy.
+      SharedReportTable(const SharedReportTable&);
+      SharedReportTable& operator = (const SharedReportTable&);
+    public:
+      explicit SharedReportTable(const std::size_t n);
+      ~SharedReportTable();
+
+      void store(const std::size_t i, const ExecutionReport &r, const bool executed);
+      bool is_done(const std::size_t i) const;
+      bool is_executed(const std::size_t i) const;
+      ExecutionReport load(const std::size_t i, const RegInfo &test) const;
+    };
+  }
+}
+
+#endif // CPUNIT_IMPL_SHAREDREPORTTABLE_HPP
@@ -0,0 +1,131 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_impl_Statistics.hpp"
+
+#include <cmath>
+#include <math.h>
+
+namespace {
+  const int MAX_TERMS = 300;
+  const double EPSILON = 1e-14;
+  const double TINY = 1e-300;
+
+  /**
+     Evaluates the continued fraction of the incomplete beta function 
+     by the modified Lentz method.
+   */
+  double beta_fraction(const double a, const double b, const double x) {
+    double c = 1;
+    double d = 1 - (a + b) * x / (a + 1);
+    if (std::fabs(d) < TINY) {
+      d = TINY;
+    }
+    d = 1 / d;
+    double h = d;
+    for (int m=1; m<=MAX_TERMS; ++m) {
+      const double m2 = 2 * m;
+      double aa = m * (b - m) * x / ((a + m2 - 1) * (a + m2));
+      d = 1 + aa * d;
+      d = std::fabs(d) < TINY ? 1 / TINY : 1 / d;
+      c = 1 + aa / c;
+      if (std::fabs(c) < TINY) {
+	c = TINY;
+      }
+      h *= d * c;
+      aa = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1));
+      d = 1 + aa * d;
+      d = std::fabs(d) < TINY ? 1 / TINY : 1 / d;
+      c = 1 + aa / c;
+      if (std::fabs(c) < TINY) {
+	c = TINY;
+      }
+      const double delta = d * c;
+      h *= delta;
+      if (std::fabs(delta - 1) < EPSILON) {
+	break;
+      }
+    }
+    return h;
+  }
+}
+
+/**
+   @return The regularized incomplete beta function I_x(a, b), for a, b > 0 and 0 <= x <= 1.
+ */
+double
+cpunit::impl::incomplete_beta(const double a, const double b, const double x) {
+  if (x <= 0) {
+    return 0;
+  }
+  if (x >= 1) {
+    return 1;
+  }
+  const double front = std::exp(lgamma(a + b) - lgamma(a) - lgamma(b) + a * std::log(x) + b * std::log(1 - x));
+  // The continued fraction converges fast only on one side of the mean.
+  if (x < (a + 1) / (a + b + 2)) {
+    return front * beta_fraction(a, b, x) / a;
+  }
+  return 1 - front * beta_fraction(b, a, 1 - x) / b;
+}
+
+/**
+   @return The probability that a Student t distributed variable with 
+           df degrees of freedom is greater than t.
+ */
+double
+cpunit::impl::student_t_tail(const double t, const double df) {
+  const double half = 0.5 * incomplete_beta(df / 2, 0.5, df / (df + t * t));
+  return t > 0 ? half : 1 - half;
+}
+
+/**
+   Welch's t-test of whether the first mean is greater than the second,
+   allowing the two samples to have different variances.
+   Without at least two values in each sample, there is no estimate of
+   the noise, and the means are compared as they are.
+   @return The one-sided p-value: The probability of a difference at least
+           this large if the first mean is in fact not greater than the second.
+ */
+double
+cpunit::impl::welch_p_value(const double mean1, const double var1, const std::size_t n1,
+			    const double mean2, const double var2, const std::size_t n2) {
+  if (n1 < 2 || n2 < 2) {
+    return mean1 > mean2 ? 0 : 1;
+  }
+  const double se1 = var1 / n1;
+  const double se2 = var2 / n2;
+  if (se1 + se2 <= 0) {
+    return mean1 > mean2 ? 0 : 1;
+  }
+  const double t = (mean1 - mean2) / std::sqrt(se1 + se2);
+  const double df = (se1 + se2) * (se1 + se2) / (se1 * se1 / (n1 - 1) + se2 * se2 / (n2 - 1));
+  return student_t_tail(t, df);
+}
@@ -0,0 +1,274 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cpunit_impl_Watchdog.hpp"
+#include "cpunit_CPUnitException.hpp"
+#include "cpunit_TimeFormat.hpp"
+#include "cpunit_trace.hpp"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <execinfo.h>
+#include <unistd.h>
+
+namespace {
+
+  const int MAX_FRAMES = 64;
+
+  // The frames of capture_stack itself and of the signal trampoline.
+  const int SKIPPED_FRAMES = 2;
+
+  // Polls of 10ms to wait for the stuck thread to run its signal handler.
+  const int CAPTURE_POLLS = 100;
+
+  // Written by the interrupted thread only, while the watchdog thread waits.
+  void *frames[MAX_FRAMES];
+  volatile sig_atomic_t frame_count = 0;
+  volatile sig_atomic_t frames_ready = 0;
+
+  void capture_stack(int) {
+    frame_count = backtrace(frames, MAX_FRAMES);
+    frames_ready = 1;
+  }
+
+  bool before(const timespec &a, const timespec &b) {
+    return a.tv_sec < b.tv_sec || (a.tv_sec == b.tv_sec && a.tv_nsec < b.tv_nsec);
+  }
+}
+
+cpunit::impl::Watchdog::Handler::~Handler()
+{}
+
+/**
+   @param timeout The number of seconds a test may run.
+   @param handler Called when a test exceeds the timeout.
+ */
+cpunit::impl::Watchdog::Watchdog(const double t, Handler &h) :
+  timeout(t),
+  handler(h),
+  mutex(),
+  cond(),
+  watcher(),
+  started(false),
+  stopping(false),
+  slots()
+{
+  pthread_mutex_init(&mutex, NULL);
+  // Deadlines are on the monotonic clock, so the timed waits must be as well.
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&cond, &attr);
+  pthread_condattr_destroy(&attr);
+
+  // The first call to backtrace loads libgcc, which must not happen in a signal handler.
+  void *dummy[1];
+  backtrace(dummy, 1);
+}
+
+cpunit::impl::Watchdog::~Watchdog() {
+  pthread_mutex_lock(&mutex);
+  stopping = true;
+  const bool join = started;
+  pthread_cond_signal(&cond);
+  pthread_mutex_unlock(&mutex);
+  if (join) {
+    pthread_join(watcher, NULL);
+  }
+  pthread_cond_destroy(&cond);
+  pthread_mutex_destroy(&mutex);
+}
+
+double
+cpunit::impl::Watchdog::get_timeout() const {
+  return timeout;
+}
+
+/**
+   Starts the countdown for the calling thread.
+   @param test The test about to run.
+   @throws CPUnitException if the watchdog thread cannot be started.
+ */
+void
+cpunit::impl::Watchdog::arm(const RegInfo &test) {
+  pthread_mutex_lock(&mutex);
+  if (!started) {
+    const int err = pthread_create(&watcher, NULL, thread_main, this);
+    if (err != 0) {
+      pthread_mutex_unlock(&mutex);
+      throw CPUnitException(std::string("Unable to start watchdog thread: ") + std::strerror(err));
+    }
+    started = true;
+  }
+  Slot &slot = own_slot();
+  clock_gettime(CLOCK_MONOTONIC, &slot.deadline);
+  const long nsecs = static_cast<long>((timeout - static_cast<long>(timeout)) * 1e9) + slot.deadline.tv_nsec;
+  slot.deadline.tv_sec += static_cast<long>(timeout) + nsecs / 1000000000;
+  slot.deadline.tv_nsec = nsecs % 1000000000;
+  slot.test = &test;
+  slot.armed = true;
+  pthread_cond_signal(&cond);
+  pthread_mutex_unlock(&mutex);
+}
+
+/**
+   Stops the countdown for the calling thread.
+ */
+void
+cpunit::impl::Watchdog::disarm() {
+  pthread_mutex_lock(&mutex);
+  own_slot().armed = false;
+  pthread_mutex_unlock(&mutex);
+}
+
+/**
+   @return The slot of the calling thread. Must be called with the mutex held.
+ */
+cpunit::impl::Watchdog::Slot&
+cpunit::impl::Watchdog::own_slot() {
+  const pthread_t self = pthread_self();
+  for (std::size_t i=0; i<slots.size(); ++i) {
+    if (pthread_equal(slots[i].thread, self)) {
+      return slots[i];
+    }
+  }
+  Slot s;
+  s.thread = self;
+  s.armed = false;
+  s.test = NULL;
+  slots.push_back(s);
+  return slots.back();
+}
+
+void*
+cpunit::impl::Watchdog::thread_main(void *arg) {
+  static_cast<Watchdog*>(arg)->watch();
+  return NULL;
+}
+
+void
+cpunit::impl::Watchdog::watch() {
+  pthread_mutex_lock(&mutex);
+  while (!stopping) {
+    Slot *first = NULL;
+    for (std::size_t i=0; i<slots.size(); ++i) {
+      if (slots[i].armed && (first == NULL || before(slots[i].deadline, first->deadline))) {
+	first = &slots[i];
+      }
+    }
+    if (first == NULL) {
+      pthread_cond_wait(&cond, &mutex);
+      continue;
+    }
+
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (before(now, first->deadline)) {
+      // arm() may grow the slots while we wait, so wait on a copy.
+      const timespec until = first->deadline;
+      pthread_cond_timedwait(&cond, &mutex, &until);
+      continue;
+    }
+
+    first->armed = false;
+    const pthread_t thread = first->thread;
+    const RegInfo &test = *first->test;
+    pthread_mutex_unlock(&mutex);
+
+    CPUNIT_ITRACE("Watchdog - "<<test.get_path()<<"::"<<test.get_name()<<" exceeded the timeout of "<<timeout<<"s.");
+    handler.timed_out(test, describe(thread));
+
+    pthread_mutex_lock(&mutex);
+  }
+  pthread_mutex_unlock(&mutex);
+}
+
+/**
+   Interrupts the stuck thread to capture its stack.
+   @return The TIME GUARD ERROR message for the test.
+ */
+std::string
+cpunit::impl::Watchdog::describe(const pthread_t thread) const {
+  struct sigaction action, old_action;
+  std::memset(&action, 0, sizeof(action));
+  action.sa_handler = capture_stack;
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_RESTART;
+  sigaction(SIGUSR2, &action, &old_action);
+
+  frames_ready = 0;
+  if (pthread_kill(thread, SIGUSR2) == 0) {
+    for (int i=0; i<CAPTURE_POLLS && !frames_ready; ++i) {
+      usleep(10000);
+    }
+  }
+
+  std::ostringstream oss;
+  oss<<"TIME GUARD ERROR - Exceeded timeout="<<TimeFormat(timeout)<<"s, and was interrupted";
+  if (frames_ready && frame_count > SKIPPED_FRAMES) {
+    const int n = frame_count - SKIPPED_FRAMES;
+    char **symbols = backtrace_symbols(frames + SKIPPED_FRAMES, n);
+    oss<<" in:";
+    for (int i=0; i<n; ++i) {
+      oss<<std::endl<<"    #"<<i<<' ';
+      if (symbols != NULL) {
+	oss<<symbols[i];
+      } else {
+	oss<<frames[SKIPPED_FRAMES + i];
+      }
+    }
+    std::free(symbols);
+  } else {
+    oss<<". No stack trace is available.";
+  }
+  sigaction(SIGUSR2, &old_action, NULL);
+  return oss.str();
+}
+
+/**
+   @param w    The watchdog to arm, or NULL.
+   @param test The test about to run.
+ */
+cpunit::impl::WatchdogGuard::WatchdogGuard(Watchdog *w, const RegInfo &test) :
+  watchdog(w)
+{
+  if (watchdog != NULL) {
+    watchdog->arm(test);
+  }
+}
+
+cpunit::impl::WatchdogGuard::~WatchdogGuard() {
+  if (watchdog != NULL) {
+    watchdog->disarm();
+  }
+}
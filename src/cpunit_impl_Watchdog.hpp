@@ -0,0 +1,128 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef CPUNIT_IMPL_WATCHDOG_HPP
+#define CPUNIT_IMPL_WATCHDOG_HPP
+
+#include "cpunit_RegInfo.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <time.h>
+
+namespace cpunit {
+  namespace impl {
+
+    /**
+       Enforces a hard deadline on running tests. A thread arms the watchdog
+       before running a test, and disarms it afterwards. If the deadline
+       passes in between, the watchdog thread interrupts the stuck thread 
+       with SIGUSR2 to capture its stack, and passes a TIME GUARD ERROR
+       message with the stack to a Handler. The Handler is expected to end 
+       the process, since there is no safe way to stop the stuck thread.
+
+       The watchdog thread is started on the first call to arm, so a 
+       Watchdog constructed before fork() works in the child process.
+       Only one Watchdog may be active in a process at a time.
+     */
+    class Watchdog {
+    public:
+
+      /**
+         Decides what happens when a test exceeds its deadline.
+       */
+      class Handler {
+      public:
+	virtual ~Handler();
+
+	/**
+	   Called on the watchdog thread. Should not return. If it does, 
+	   the test is left running, and the watchdog disarmed for its thread.
+	   @param test    The test that exceeded the deadline.
+	   @param message The TIME GUARD ERROR message, with the stack trace.
+	 */
+	virtual void timed_out(const RegInfo &test, const std::string &message) = 0;
+      };
+
+    private:
+      struct Slot {
+	pthread_t thread;
+	bool armed;
+	// On the monotonic clock, which the wall clock being set does not move.
+	timespec deadline;
+	const RegInfo *test;
+      };
+
+      const double timeout;
+      Handler &handler;
+      pthread_mutex_t mutex;
+      pthread_cond_t cond;
+      pthread_t watcher;
+      bool started;
+      bool stopping;
+      std::vector<Slot> slots;
+
+      Slot& own_slot();
+      void watch();
+      std::string describe(const pthread_t thread) const;
+      static void* thread_main(void *arg);
+
+      // No copy.
+      Watchdog(const Watchdog&);
+      Watchdog& operator = (const Watchdog&);
+    public:
+      Watchdog(const double timeout, Handler &handler);
+      ~Watchdog();
+
+      double get_timeout() const;
+      void arm(const RegInfo &test);
+      void disarm();
+    };
+
+    /**
+       Arms a watchdog for the calling thread while in scope.
+       Does nothing if the watchdog is NULL.
+     */
+    class WatchdogGuard {
+      Watchdog *watchdog;
+
+      // No copy.
+      WatchdogGuard(const WatchdogGuard&);
+      WatchdogGuard& operator = (const WatchdogGuard&);
+    public:
+      WatchdogGuard(Watchdog *w, const RegInfo &test);
+      ~WatchdogGuard();
+    };
+  }
+}
+
+#endif // CPUNIT_IMPL_WATCHDOG_HPP
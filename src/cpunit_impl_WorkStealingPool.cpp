@@ -0,0 +1,170 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cpunit_impl_WorkStealingPool.hpp"
+#include "cpunit_WrongSetupException.hpp"
+#include "cpunit_trace.hpp"
+
+#include <unistd.h>
+
+cpunit::impl::WorkStealingPool::Job::~Job()
+{}
+
+/**
+   @param workers The number of worker threads to use. Must be at least 1.
+   @throws WrongSetupException if workers is 0.
+ */
+cpunit::impl::WorkStealingPool::WorkStealingPool(const std::size_t workers) :
+  num_workers(workers),
+  queues(),
+  job(NULL),
+  cancel_lock(),
+  cancelled(false)
+{
+  if (num_workers == 0) {
+    throw WrongSetupException("The number of worker threads must be at least 1.");
+  }
+  for (std::size_t i=0; i<num_workers; ++i) {
+    queues.push_back(new Queue);
+  }
+}
+
+cpunit::impl::WorkStealingPool::~WorkStealingPool() {
+  for (std::size_t i=0; i<queues.size(); ++i) {
+    delete queues[i];
+  }
+}
+
+/**
+   Executes job for every item, and returns when all items are
+   done, or the pool is cancelled and the running items are done.
+   @param items The items to execute, in the preferred order of execution.
+   @param j     The work to perform for each item.
+ */
+void
+cpunit::impl::WorkStealingPool::run(const std::vector<std::size_t> &items, Job &j) {
+  job = &j;
+  for (std::size_t i=0; i<items.size(); ++i) {
+    queues[i % num_workers]->items.push_back(items[i]);
+  }
+
+  std::vector<pthread_t> threads(num_workers);
+  std::vector<WorkerArg> args(num_workers);
+  std::size_t started = 0;
+  for (std::size_t w=0; w<num_workers; ++w) {
+    args[w].pool = this;
+    args[w].worker = w;
+    if (pthread_create(&threads[w], NULL, &WorkStealingPool::thread_main, &args[w]) != 0) {
+      CPUNIT_WTRACE("WorkStealingPool::run - Could only start "<<started<<" of "<<num_workers<<" threads.");
+      break;
+    }
+    ++started;
+  }
+  if (started == 0) {
+    // Nothing could be started; the calling thread does all the work.
+    work(0);
+  }
+  for (std::size_t w=0; w<started; ++w) {
+    pthread_join(threads[w], NULL);
+  }
+  // Drop whatever is left after a cancel.
+  for (std::size_t w=0; w<num_workers; ++w) {
+    queues[w]->items.clear();
+  }
+  job = NULL;
+}
+
+/**
+   Stops the pool from starting new items.
+   Items that are already started run to completion.
+ */
+void
+cpunit::impl::WorkStealingPool::cancel() {
+  MutexLock l(cancel_lock);
+  cancelled = true;
+}
+
+bool
+cpunit::impl::WorkStealingPool::is_cancelled() {
+  MutexLock l(cancel_lock);
+  return cancelled;
+}
+
+std::size_t
+cpunit::impl::WorkStealingPool::get_num_workers() const {
+  return num_workers;
+}
+
+/**
+   @return The number of online processors, or 1 if this cannot be determined.
+ */
+std::size_t
+cpunit::impl::WorkStealingPool::hardware_concurrency() {
+  const long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? static_cast<std::size_t>(n) : 1;
+}
+
+bool
+cpunit::impl::WorkStealingPool::next(const std::size_t worker, std::size_t &item) {
+  {
+    Queue &own = *queues[worker];
+    MutexLock l(own.lock);
+    if (!own.items.empty()) {
+      item = own.items.front();
+      own.items.pop_front();
+      return true;
+    }
+  }
+  for (std::size_t i=1; i<num_workers; ++i) {
+    Queue &victim = *queues[(worker + i) % num_workers];
+    MutexLock l(victim.lock);
+    if (!victim.items.empty()) {
+      item = victim.items.back();
+      victim.items.pop_back();
+      CPUNIT_DTRACE("WorkStealingPool - worker "<<worker<<" stole item "<<item);
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+cpunit::impl::WorkStealingPool::work(const std::size_t worker) {
+  std::size_t item = 0;
+  while (!is_cancelled() && next(worker, item)) {
+    job->run(item, worker);
+  }
+}
+
+void*
+cpunit::impl::WorkStealingPool::thread_main(void *arg) {
+  WorkerArg *a = static_cast<WorkerArg*>(arg);
+  a->pool->work(a->worker);
+  return NULL;
+}
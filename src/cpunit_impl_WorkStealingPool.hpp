@@ -0,0 +1,106 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef CPUNIT_IMPL_WORKSTEALINGPOOL_HPP
+#define CPUNIT_IMPL_WORKSTEALINGPOOL_HPP
+
+#include "cpunit_impl_Mutex.hpp"
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+namespace cpunit {
+  namespace impl {
+
+    /**
+       A fixed size pool of worker threads executing a numbered set of work items.
+       The items are dealt round-robin to one queue per worker. Each worker
+       takes items from the front of its own queue, and when its queue runs dry,
+       steals from the back of the other workers' queues. Hence, the order in
+       which items are passed is roughly the order in which they are started.
+     */
+    class WorkStealingPool {
+    public:
+
+      /**
+         The work to do for each item.
+         Implementations must not let exceptions escape from run.
+       */
+      class Job {
+      public:
+	virtual ~Job();
+
+	/**
+	   @param item   The index of the item to execute, as passed to WorkStealingPool::run.
+	   @param worker The index of the executing worker, in the range [0, get_num_workers()).
+	 */
+	virtual void run(const std::size_t item, const std::size_t worker) = 0;
+      };
+
+    private:
+      struct Queue {
+	Mutex lock;
+	std::deque<std::size_t> items;
+      };
+
+      struct WorkerArg {
+	WorkStealingPool *pool;
+	std::size_t worker;
+      };
+
+      const std::size_t num_workers;
+      std::vector<Queue*> queues;
+      Job *job;
+      Mutex cancel_lock;
+      bool cancelled;
+
+      bool next(const std::size_t worker, std::size_t &item);
+      void work(const std::size_t worker);
+      static void* thread_main(void *arg);
+
+      // No copy.
+      WorkStealingPool(const WorkStealingPool&);
+      WorkStealingPool& operator = (const WorkStealingPool&);
+    public:
+      explicit WorkStealingPool(const std::size_t workers);
+      ~WorkStealingPool();
+
+      void run(const std::vector<std::size_t> &items, Job &j);
+      void cancel();
+      bool is_cancelled();
+
+      std::size_t get_num_workers() const;
+
+      static std::size_t hardware_concurrency();
+    };
+  }
+}
+
+#endif // CPUNIT_IMPL_WORKSTEALINGPOOL_HPP
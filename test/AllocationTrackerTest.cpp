@@ -0,0 +1,235 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <cpunit>
+#include <cpunit_AllocationStats.hpp>
+#include <cpunit_AllocationTracker.hpp>
+#include <cpunit_BasicTestRunner.hpp>
+#include <cpunit_Callable.hpp>
+#include <cpunit_LeakReport.hpp>
+#include <cpunit_impl_LiveBlockTable.hpp>
+
+#include <new>
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+namespace AllocationTrackerTest {
+
+  using namespace cpunit;
+
+  CPUNIT_TEST(AllocationTrackerTest, test_stats_sum) {
+    AllocationStats sum;
+    sum += AllocationStats(3, 2, 100, 60);
+    sum += AllocationStats(1, 1, 10, 80);
+    assert_equals(4, static_cast<int>(sum.get_allocations()));
+    assert_equals(3, static_cast<int>(sum.get_deallocations()));
+    assert_equals(110, static_cast<int>(sum.get_bytes()));
+    assert_equals("Peak should be the highest peak.", 80, static_cast<int>(sum.get_peak_bytes()));
+  }
+
+  CPUNIT_TEST(AllocationTrackerTest, test_leak_report_keeps_largest) {
+    LeakReport leaks;
+    assert_true("Default not empty.", leaks.is_empty());
+    for (std::size_t i=1; i<=LeakReport::MAX_SAMPLES + 2; ++i) {
+      LeakReport::Block b;
+      b.size = 10 * i;
+      b.depth = 0;
+      leaks.add(b);
+    }
+    assert_equals(static_cast<int>(LeakReport::MAX_SAMPLES + 2), static_cast<int>(leaks.get_blocks()));
+    const std::string msg = leaks.to_string();
+    assert_true(msg, msg.find("MEMORY LEAK - Leaked ") == 0);
+    assert_true(msg, msg.find(CPUNIT_STR(10 * (LeakReport::MAX_SAMPLES + 2)<<" bytes allocated at:")) != std::string::npos);
+    assert_true(msg, msg.find("10 bytes allocated at:") == std::string::npos);
+    assert_true(msg, msg.find("(2 more)") != std::string::npos);
+  }
+
+  CPUNIT_TEST(AllocationTrackerTest, test_counts_allocations) {
+    AllocationTracker::mark();
+    assert_equals(0, static_cast<int>(AllocationTracker::since_mark().get_allocations()));
+    {
+      std::vector<int> v(100);
+      const AllocationStats used = AllocationTracker::since_mark();
+      assert_equals(1, static_cast<int>(used.get_allocations()));
+      assert_equals(0, static_cast<int>(used.get_deallocations()));
+      assert_true("Too few bytes.", used.get_bytes() >= 100 * sizeof(int));
+    }
+    const AllocationStats used = AllocationTracker::since_mark();
+    assert_equals(1, static_cast<int>(used.get_deallocations()));
+    assert_true("Peak below the vector.", used.get_peak_bytes() >= 100 * sizeof(int));
+  }
+
+  CPUNIT_TEST(AllocationTrackerTest, test_max_allocs) {
+    AllocationTracker::mark();
+    int *p = new int(1);
+    delete p;
+    CPUNIT_ASSERT_MAX_ALLOCS(1);
+    p = new int(2);
+    delete p;
+    try {
+      CPUNIT_ASSERT_MAX_ALLOCS(1);
+    } catch (AssertionException &e) {
+      assert_true(e.what(), std::string(e.what()).find("ALLOCATION BUDGET EXCEEDED") != std::string::npos);
+      return;
+    }
+    fail("Two allocations passed a budget of one.");
+  }
+
+  CPUNIT_TEST(AllocationTrackerTest, test_no_allocation_scope) {
+    {
+      NoAllocationScope no_allocations;
+      int x = 1;
+      x += 2;
+    }
+    bool thrown = false;
+    try {
+      NoAllocationScope no_allocations;
+      std::string s(1000, 'x');
+    } catch (AssertionException &e) {
+      thrown = true;
+      assert_true(e.what(), std::string(e.what()).find("ALLOCATION FAILURE") != std::string::npos);
+    }
+    assert_true("Allocation in scope not detected.", thrown);
+    std::string s(1000, 'y');
+  }
+
+  CPUNIT_TEST(AllocationTrackerTest, test_nothrow_in_no_allocation_scope) {
+    int *p = NULL;
+    {
+      NoAllocationScope no_allocations;
+      p = new (std::nothrow) int(1);
+    }
+    assert_true("Forbidden nothrow allocation not refused.", p == NULL);
+    // Taken here, so the runner does not fail the test.
+    assert_equals(1, static_cast<int>(AllocationTracker::take_refused_allocations()));
+    p = new (std::nothrow) int(2);
+    assert_true("Allocation refused after the scope.", p != NULL);
+    delete p;
+    assert_equals(0, static_cast<int>(AllocationTracker::take_refused_allocations()));
+  }
+
+  // Allocates with the nothrow operator new where allocations are forbidden.
+  class NoThrowAllocation : public Callable {
+  public:
+    bool refused;
+
+    NoThrowAllocation() :
+      Callable(RegInfo("AllocationTrackerTest", "nothrow", "AllocationTrackerTest.cpp", "42")),
+      refused(false)
+    {}
+
+    void run() {
+      NoAllocationScope no_allocations;
+      int *p = new (std::nothrow) int(1);
+      refused = p == NULL;
+      delete p;
+    }
+  };
+
+  CPUNIT_TEST(AllocationTrackerTest, test_refused_allocation_fails_test) {
+    NoThrowAllocation tu;
+    try {
+      BasicTestRunner().run(tu);
+    } catch (AssertionException &e) {
+      assert_true("Allocation not refused.", tu.refused);
+      assert_true(e.what(), std::string(e.what()).find("ALLOCATION FAILURE - Refused 1 nothrow allocations") != std::string::npos);
+      return;
+    }
+    fail("A refused allocation passed the test.");
+  }
+
+  CPUNIT_TEST(AllocationTrackerTest, test_live_block_table) {
+    impl::LiveBlockTable table;
+    const unsigned long first = table.next_serial();
+    const unsigned long second = table.next_serial();
+    assert_true("Serials not distinct.", first != 0 && second != 0 && first != second);
+
+    int blocks[3];
+    LeakReport::Block b;
+    b.depth = 0;
+    b.size = 10;
+    assert_true(table.insert(&blocks[0], first, b));
+    b.size = 20;
+    assert_true(table.insert(&blocks[1], first, b));
+    b.size = 40;
+    assert_true(table.insert(&blocks[2], second, b));
+    table.erase(&blocks[0]);
+
+    const LeakReport leaks = table.remove_all(first);
+    assert_equals(1, static_cast<int>(leaks.get_blocks()));
+    assert_equals(20, static_cast<int>(leaks.get_bytes()));
+    assert_true("Removed twice.", table.remove_all(first).is_empty());
+    assert_equals(40, static_cast<int>(table.remove_all(second).get_bytes()));
+  }
+
+  // The outcome of a leak check run on a thread of its own.
+  struct LeakCheck {
+    std::size_t blocks;
+    std::size_t bytes;
+    bool empty_after;
+  };
+
+  void* check_leaks(void *arg) {
+    LeakCheck *result = static_cast<LeakCheck*>(arg);
+    AllocationTracker::start_leak_check();
+    int *leaked = NULL;
+    {
+      LeakRecordingScope recording(true);
+      leaked = new int[10];
+      int *freed = new int(1);
+      delete freed;
+    }
+    int *unrecorded = new int(2);
+    const LeakReport leaks = AllocationTracker::end_leak_check();
+    delete[] leaked;
+    delete unrecorded;
+    result->blocks = leaks.get_blocks();
+    result->bytes = leaks.get_bytes();
+    result->empty_after = AllocationTracker::end_leak_check().is_empty();
+    return NULL;
+  }
+
+  // Runs the check on another thread, whose counters are its own, so that
+  // the check of the runner on this thread is left alone. Needs --detect-leaks,
+  // since the flag is process-wide.
+  CPUNIT_TEST(AllocationTrackerTest, test_leak_check) {
+    if (!AllocationTracker::is_leak_detection_enabled()) {
+      return;
+    }
+    LeakCheck result;
+    pthread_t thread;
+    assert_equals(0, pthread_create(&thread, NULL, check_leaks, &result));
+    pthread_join(thread, NULL);
+    assert_equals(1, static_cast<int>(result.blocks));
+    assert_equals(static_cast<int>(10 * sizeof(int)), static_cast<int>(result.bytes));
+    assert_true("Leaked block reported after the check.", result.empty_after);
+  }
+}
@@ -0,0 +1,203 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#include <cpunit>
+#include <cpunit_AssertionException.hpp>
+#include <cpunit_impl_ArrayCompare.hpp>
+
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace ArrayAssertTest {
+
+  using namespace cpunit;
+  using namespace cpunit::impl;
+
+  const std::size_t BENCH_SIZE = 1 << 20;
+
+  bool contains(const std::string &s, const std::string &part) {
+    return s.find(part) != std::string::npos;
+  }
+
+  template<class T>
+  std::vector<T> ramp(const std::size_t n) {
+    std::vector<T> v(n);
+    for (std::size_t i=0; i<n; ++i) {
+      v[i] = static_cast<T>(i) * static_cast<T>(0.5) - 3;
+    }
+    return v;
+  }
+
+  template<class T>
+  std::string failure_of_all_close(const std::vector<T> &e, const std::vector<T> &a, const T abs_tol, const T rel_tol) {
+    try {
+      assert_all_close("Kernel", priv::data_of(e), priv::data_of(a), e.size(), abs_tol, rel_tol);
+    } catch (AssertionException &ex) {
+      return ex.get_message();
+    }
+    return "";
+  }
+
+  // Differences of every kind, at positions that hit both the vectors and the tails.
+  template<class T>
+  void check_kernels_agree() {
+    const T inf = std::numeric_limits<T>::infinity();
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+    std::srand(17);
+    for (std::size_t n=0; n<41; ++n) {
+      std::vector<T> e = ramp<T>(n);
+      std::vector<T> a = e;
+      for (std::size_t i=0; i<n; ++i) {
+	switch (std::rand() % 9) {
+	case 0: a[i] += static_cast<T>(0.001); break;
+	case 1: a[i] += static_cast<T>(0.1); break;
+	case 2: a[i] = nan; break;
+	case 3: e[i] = a[i] = inf; break;
+	case 4: a[i] = -inf; break;
+	case 5: e[i] = inf; break;
+	case 6: e[i] = static_cast<T>(0.0); a[i] = -static_cast<T>(0.0); break;
+	default: break;
+	}
+      }
+      const ArrayMismatches exact = find_mismatches(priv::data_of(e), priv::data_of(a), n, T(0), T(0), SCALAR);
+      const ArrayMismatches close = find_mismatches(priv::data_of(e), priv::data_of(a), n, T(0.01), T(0.001), SCALAR);
+      const SimdLevel levels[] = {SSE2, AVX2};
+      for (int l=0; l<2; ++l) {
+	if (is_supported(levels[l])) {
+	  const ArrayMismatches v_exact = find_mismatches(priv::data_of(e), priv::data_of(a), n, T(0), T(0), levels[l]);
+	  const ArrayMismatches v_close = find_mismatches(priv::data_of(e), priv::data_of(a), n, T(0.01), T(0.001), levels[l]);
+	  assert_equals("Exact count", exact.count, v_exact.count);
+	  assert_equals("Exact first", exact.first, v_exact.first);
+	  assert_equals("Close count", close.count, v_close.count);
+	  assert_equals("Close first", close.first, v_close.first);
+	}
+      }
+    }
+  }
+
+  CPUNIT_TEST(ArrayAssertTest, test_equal_arrays) {
+    const std::vector<double> d = ramp<double>(37);
+    const std::vector<float> f = ramp<float>(37);
+    const int i[] = {1, 2, 3};
+    assert_array_equals(&d[0], &d[0], d.size());
+    assert_array_equals("Float", &f[0], &f[0], f.size());
+    assert_array_equals(i, i, 3);
+    assert_all_close(&d[0], &d[0], d.size(), 0.0, 0.0);
+    assert_all_close(&f[0], &f[0], 0, 1.0f, 1.0f);
+  }
+
+  CPUNIT_TEST(ArrayAssertTest, test_kernels_agree) {
+    check_kernels_agree<float>();
+    check_kernels_agree<double>();
+  }
+
+  CPUNIT_TEST(ArrayAssertTest, test_special_values) {
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double e[] = {inf, -0.0, 1e300, 1.0,  nan};
+    const double a[] = {inf, 0.0,  inf,   -inf, nan};
+    const ArrayMismatches m = find_mismatches(e, a, 5, 1e6, 1.0, best_simd_level());
+    assert_equals(std::size_t(3), m.count);
+    assert_equals(std::size_t(2), m.first);
+  }
+
+  CPUNIT_TEST(ArrayAssertTest, test_failure_message) {
+    std::vector<double> e = ramp<double>(100);
+    std::vector<double> a = e;
+    for (std::size_t i=5; i<100; i+=7) {
+      a[i] += 0.25;
+    }
+    a[40] = 3.0 * e[40];
+    const std::string msg = failure_of_all_close(e, a, 0.1, 0.0);
+    assert_true(msg, contains(msg, "ASSERT ALL CLOSE FAILED - Kernel With abs tolerance 0.1 and rel tolerance 0, 14 of 100 elements differ,"));
+    assert_true(msg, contains(msg, "max abs error 34, max rel error 2:"));
+    assert_true(msg, contains(msg, "\n  [5] expected <-0.5>, was <-0.25>"));
+    assert_true(msg, contains(msg, "\n  [40] expected <17>, was <51>"));
+    assert_true(msg, contains(msg, "\n  (4 more)"));
+    assert_false(msg, contains(msg, "[75]"));
+    assert_equals(std::string(""), failure_of_all_close(e, a, 40.0, 0.0));
+  }
+
+  CPUNIT_TEST(ArrayAssertTest, test_float_values_are_shown_in_full) {
+    const float e[] = {1.0f, 2.0f};
+    const float a[] = {1.0f, 2.0000002f};
+    try {
+      assert_array_equals(e, a, 2);
+    } catch (AssertionException &ex) {
+      const std::string msg = ex.get_message();
+      assert_true(msg, contains(msg, "ASSERT ARRAY EQUALS FAILED -  1 of 2 elements differ"));
+      assert_true(msg, contains(msg, "[1] expected <2>, was <2.00000024>"));
+      return;
+    }
+    fail("The arrays differ.");
+  }
+
+  CPUNIT_TEST(ArrayAssertTest, test_generic_arrays) {
+    const int e[] = {1, 2, 3, 4};
+    const int a[] = {1, 5, 3, 6};
+    try {
+      assert_array_equals("Ints", e, a, 4);
+    } catch (AssertionException &ex) {
+      const std::string msg = ex.get_message();
+      assert_equals(std::string("ASSERT ARRAY EQUALS FAILED - Ints 2 of 4 elements differ:\n  [1] expected <2>, was <5>\n  [3] expected <4>, was <6>"), msg);
+      return;
+    }
+    fail("The arrays differ.");
+  }
+
+  CPUNIT_BENCH(ArrayAssertTest, bench_assert_equals_loop) {
+    const std::vector<double> e = ramp<double>(BENCH_SIZE);
+    const std::vector<double> a = e;
+    while (state.keep_running()) {
+      for (std::size_t i=0; i<BENCH_SIZE; ++i) {
+	assert_equals(e[i], a[i], 1e-9);
+      }
+    }
+  }
+
+  CPUNIT_BENCH(ArrayAssertTest, bench_assert_all_close) {
+    const std::vector<double> e = ramp<double>(BENCH_SIZE);
+    const std::vector<double> a = e;
+    while (state.keep_running()) {
+      assert_all_close(&e[0], &a[0], BENCH_SIZE, 1e-9, 0.0);
+    }
+  }
+
+  CPUNIT_BENCH(ArrayAssertTest, bench_assert_all_close_scalar) {
+    const std::vector<double> e = ramp<double>(BENCH_SIZE);
+    const std::vector<double> a = e;
+    while (state.keep_running()) {
+      do_not_optimize(find_mismatches(&e[0], &a[0], BENCH_SIZE, 1e-9, 0.0, SCALAR));
+    }
+  }
+}
@@ -73,6 +73,68 @@ namespace AssertMacroTest {
     }
   }
 
+  CPUNIT_TEST(AssertMacroTest, test_passing_asserts_do_not_allocate) {
+    cpunit::NoAllocationScope no_allocations;
+    CPUNIT_ASSERT(i == 42);
+    CPUNIT_ASSERT1("A message, " << i, i == 42);
+    CPUNIT_DISPROVE(i != 42);
+    CPUNIT_DISPROVE1("A message, " << i, i != 42);
+    cpunit::assert_true("A message too long for the small string buffer.", true);
+    cpunit::assert_false("A message too long for the small string buffer.", false);
+    cpunit::assert_not_null("A message too long for the small string buffer.", &i);
+    cpunit::assert_null("A message too long for the small string buffer.", NULL);
+    cpunit::assert_equals("A C-string too long for the small string buffer.", "A C-string too long for the small string buffer.");
+    cpunit::assert_equals(42, i);
+    cpunit::assert_equals(1.0, 1.0, 0.1);
+  }
+
+  CPUNIT_TEST(AssertMacroTest, test_message_is_evaluated_on_failure_only) {
+    int evaluated = 0;
+    CPUNIT_ASSERT1("Evaluated " << ++evaluated, true);
+    CPUNIT_DISPROVE1("Evaluated " << ++evaluated, false);
+    cpunit::assert_equals(0, evaluated);
+    try {
+      CPUNIT_ASSERT1("Evaluated " << ++evaluated, false);
+    } catch (cpunit::AssertionException &e) {
+      cpunit::assert_true(e.what(), std::string(e.what()).find("Evaluated 1 Stmt: 'false'") != std::string::npos);
+    }
+    cpunit::assert_equals(1, evaluated);
+  }
+
+  // The cost of passing asserts, which should not format their messages.
+
+  CPUNIT_BENCH(AssertMacroTest, bench_CPUNIT_ASSERT) {
+    int k = 0;
+    while (state.keep_running()) {
+      cpunit::do_not_optimize(k);
+      CPUNIT_ASSERT(k >= 0);
+    }
+  }
+
+  CPUNIT_BENCH(AssertMacroTest, bench_CPUNIT_ASSERT1) {
+    int k = 0;
+    while (state.keep_running()) {
+      cpunit::do_not_optimize(k);
+      CPUNIT_ASSERT1("k was negative, k=" << k, k >= 0);
+    }
+  }
+
+  CPUNIT_BENCH(AssertMacroTest, bench_assert_true) {
+    int k = 0;
+    while (state.keep_running()) {
+      cpunit::do_not_optimize(k);
+      cpunit::assert_true("k should never be negative here.", k >= 0);
+    }
+  }
+
+  CPUNIT_BENCH(AssertMacroTest, bench_assert_equals) {
+    int k = 0;
+    while (state.keep_running()) {
+      cpunit::do_not_optimize(k);
+      cpunit::assert_equals(k, k);
+    }
+  }
+
 #ifdef SHOW_ERRORS
 
   //@will_fail
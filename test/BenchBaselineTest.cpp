@@ -0,0 +1,132 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <cpunit>
+#include <cpunit_AssertionException.hpp>
+#include <cpunit_BenchBaseline.hpp>
+#include <cpunit_BenchmarkCall.hpp>
+#include <cpunit_CPUnitException.hpp>
+#include <cpunit_impl_Statistics.hpp>
+
+#include <cstdio>
+#include <unistd.h>
+#include <vector>
+
+namespace BenchBaselineTest {
+
+  using namespace cpunit;
+
+  const std::string FILE_NAME("BenchBaselineTest.tmp");
+
+  void spin(BenchState &state) {
+    int x = 0;
+    while (state.keep_running()) {
+      do_not_optimize(++x);
+    }
+  }
+
+  BenchStatistics make_statistics(const double mean, const double spread) {
+    std::vector<double> samples;
+    for (int i=0; i<10; ++i) {
+      samples.push_back(mean + (i % 2 == 0 ? spread : -spread));
+    }
+    return BenchStatistics(samples);
+  }
+
+  CPUNIT_TEAR_DOWN(BenchBaselineTest) {
+    std::remove(FILE_NAME.c_str());
+  }
+
+  CPUNIT_TEST(BenchBaselineTest, test_incomplete_beta) {
+    assert_equals(0.5248, impl::incomplete_beta(2, 3, 0.4), 1e-4);
+    assert_equals(0.5, impl::incomplete_beta(4, 4, 0.5), 1e-12);
+    assert_equals(0.0, impl::incomplete_beta(2, 3, 0), 1e-12);
+    assert_equals(1.0, impl::incomplete_beta(2, 3, 1), 1e-12);
+  }
+
+  CPUNIT_TEST(BenchBaselineTest, test_student_t_tail) {
+    assert_equals(0.036694, impl::student_t_tail(2.0, 10), 1e-6);
+    assert_equals(0.963306, impl::student_t_tail(-2.0, 10), 1e-6);
+    assert_equals(0.5, impl::student_t_tail(0, 3), 1e-12);
+  }
+
+  CPUNIT_TEST(BenchBaselineTest, test_welch_p_value) {
+    assert_true("Separated means not significant.", impl::welch_p_value(12, 1, 10, 10, 1, 10) < 0.001);
+    assert_true("Equal means significant.", impl::welch_p_value(10, 1, 10, 10, 1, 10) > 0.4);
+    assert_true("Noisy difference significant.", impl::welch_p_value(11, 25, 10, 10, 25, 10) > 0.05);
+    assert_equals(0.0, impl::welch_p_value(2, 0, 10, 1, 0, 10), 1e-12);
+  }
+
+  CPUNIT_TEST(BenchBaselineTest, test_save_and_load) {
+    BenchBaseline out(FILE_NAME);
+    out.record(RegInfo("A::B", "bench_x", "f.cpp", "1"), make_statistics(2e-6, 1e-7));
+    out.record(RegInfo("", "bench_global", "f.cpp", "2"), make_statistics(3e-9, 0));
+    out.save();
+
+    BenchBaseline in(FILE_NAME);
+    in.load();
+    assert_equals(2, static_cast<int>(in.size()));
+    BenchBaseline::Entry e;
+    assert_true("Missing bench_x.", in.lookup(RegInfo("A::B", "bench_x", "", ""), e));
+    assert_equals(10, static_cast<int>(e.samples));
+    assert_equals(2e-6, e.mean, 1e-15);
+    assert_true("Missing bench_global.", in.lookup(RegInfo("", "bench_global", "", ""), e));
+    assert_equals(3e-9, e.mean, 1e-18);
+    assert_false("Found unknown.", in.lookup(RegInfo("A", "bench_x", "", ""), e));
+  }
+
+  CPUNIT_TEST_EX(BenchBaselineTest, test_load_missing_file, CPUnitException) {
+    BenchBaseline("/nonexisting/baseline").load();
+  }
+
+  CPUNIT_TEST(BenchBaselineTest, test_regression_gate) {
+    const RegInfo ri("BenchBaselineTest", "spin", __FILE__, "0");
+    BenchBaseline slower(FILE_NAME);
+    slower.record(ri, make_statistics(1, 1e-3));
+    BenchmarkCall faster_call(ri, spin, BenchmarkCall::Settings(0.01, 4, &slower, 0.05));
+    faster_call.run();
+
+    BenchBaseline faster(FILE_NAME);
+    faster.record(ri, make_statistics(1e-12, 1e-14));
+    // A sample preempted on a loaded machine can hide the regression
+    // from the t-test, so the measurement gets a few tries.
+    for (int attempt=0; attempt<3; ++attempt) {
+      BenchmarkCall call(ri, spin, BenchmarkCall::Settings(0.01, 4, &faster, 0.05));
+      try {
+	call.run();
+      } catch (AssertionException &e) {
+	assert_true(e.what(), std::string(e.what()).find("BENCHMARK REGRESSION") != std::string::npos);
+	assert_true("No result.", call.has_result());
+	return;
+      }
+    }
+    fail("No regression detected.");
+  }
+}
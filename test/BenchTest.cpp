@@ -0,0 +1,133 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <cpunit>
+#include <cpunit_BenchmarkCall.hpp>
+#include <cpunit_BenchStatistics.hpp>
+#include <cpunit_TestStore.hpp>
+#include <cpunit_WrongSetupException.hpp>
+
+#include <unistd.h>
+#include <vector>
+
+namespace BenchTest {
+
+  using namespace cpunit;
+
+  int loops = 0;
+
+  void count_loops(BenchState &state) {
+    while (state.keep_running()) {
+      ++loops;
+      do_not_optimize(loops);
+    }
+  }
+
+  void sleep_paused(BenchState &state) {
+    while (state.keep_running()) {
+      state.pause_timing();
+      usleep(1000);
+      state.resume_timing();
+    }
+  }
+
+  void no_loop(BenchState &) {
+  }
+
+  CPUNIT_BENCH(BenchTest, bench_registered) {
+    std::vector<int> v;
+    while (state.keep_running()) {
+      v.push_back(1);
+      clobber_memory();
+    }
+  }
+
+  CPUNIT_TEST(BenchTest, test_keep_running_counts_iterations) {
+    loops = 0;
+    BenchState state(17);
+    count_loops(state);
+    assert_equals(17, loops);
+    assert_true("Not finished.", state.is_finished());
+    assert_false("Restarted.", state.keep_running());
+    assert_equals(17, loops);
+  }
+
+  CPUNIT_TEST(BenchTest, test_paused_time_is_not_measured) {
+    BenchState state(5);
+    sleep_paused(state);
+    assert_true(CPUNIT_STR("Measured "<<state.get_elapsed()<<'s'), state.get_elapsed() < 0.004);
+  }
+
+  CPUNIT_TEST(BenchTest, test_statistics) {
+    const double values[] = { 4, 1, 3, 2, 100 };
+    const BenchStatistics stats(std::vector<double>(values, values + 5));
+    assert_equals("Mean", 22.0, stats.get_mean(), 1e-12);
+    assert_equals("Median", 3.0, stats.get_median(), 1e-12);
+    assert_equals("MAD", 1.0, stats.get_mad(), 1e-12);
+    assert_equals("Stddev", 43.6177, stats.get_stddev(), 1e-4);
+  }
+
+  CPUNIT_TEST(BenchTest, test_median_of_even_count) {
+    const double values[] = { 4, 1, 3, 2 };
+    const BenchStatistics stats(std::vector<double>(values, values + 4));
+    assert_equals(2.5, stats.get_median(), 1e-12);
+  }
+
+  CPUNIT_TEST(BenchTest, test_format) {
+    assert_equals(std::string("1.500s"), BenchStatistics::format(1.5));
+    assert_equals(std::string("12.000us"), BenchStatistics::format(12e-6));
+    assert_equals(std::string("250.0ns"), BenchStatistics::format(250e-9));
+    assert_equals(std::string("0.000s"), BenchStatistics::format(0));
+  }
+
+  CPUNIT_TEST(BenchTest, test_iterations_are_calibrated) {
+    BenchmarkCall call(RegInfo("BenchTest", "count_loops", __FILE__, "0"), count_loops, BenchmarkCall::Settings(0.02, 4, NULL, 0));
+    call.run();
+    assert_true("No result.", call.has_result());
+    assert_equals(1, static_cast<int>(call.get_measurements().size()));
+    const BenchmarkCall::Measurement &m = call.get_measurements()[0];
+    assert_equals(4, static_cast<int>(m.statistics.size()));
+    assert_true(CPUNIT_STR("Only "<<m.iterations<<" iterations"), m.iterations > 1000);
+  }
+
+  CPUNIT_TEST_EX(BenchTest, test_benchmark_must_loop, WrongSetupException) {
+    BenchmarkCall call(RegInfo("BenchTest", "no_loop", __FILE__, "0"), no_loop);
+    call.run();
+  }
+
+  CPUNIT_TEST_EX(BenchTest, test_range_starts_at_one, WrongSetupException) {
+    BenchmarkCall call(RegInfo("BenchTest", "count_loops", __FILE__, "0"), count_loops, 0, 100);
+  }
+
+  CPUNIT_TEST(BenchTest, test_benchmarks_are_not_tests) {
+    assert_equals(0, static_cast<int>(TestStore::get_instance().get_tests("BenchTest::bench_*").size()));
+    assert_equals(1, static_cast<int>(TestStore::get_instance().get_benchmarks("BenchTest::bench_*").size()));
+  }
+}
@@ -0,0 +1,157 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+#include <cpunit>
+#include <cpunit_AssertionException.hpp>
+#include <cpunit_impl_ArrayCompare.hpp>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace BytesAssertTest {
+
+  using namespace cpunit;
+  using namespace cpunit::impl;
+
+  const std::size_t BENCH_SIZE = 1 << 24;
+
+  std::string failure_of(const std::string &e, const std::string &a) {
+    try {
+      assert_bytes_equal("Frame", e.data(), a.data(), e.size());
+    } catch (AssertionException &ex) {
+      return ex.get_message();
+    }
+    return "";
+  }
+
+  std::vector<unsigned char> bytes(const std::size_t n) {
+    std::vector<unsigned char> v(n);
+    for (std::size_t i=0; i<n; ++i) {
+      v[i] = static_cast<unsigned char>(i * 7);
+    }
+    return v;
+  }
+
+  CPUNIT_TEST(BytesAssertTest, test_equal_buffers) {
+    const std::vector<unsigned char> e = bytes(1000);
+    const std::vector<unsigned char> a = e;
+    assert_bytes_equal(&e[0], &a[0], e.size());
+    assert_bytes_equal("Empty", NULL, NULL, 0);
+  }
+
+  // Differences at the edges of the vectors, the tails and the memcmp chunks.
+  CPUNIT_TEST(BytesAssertTest, test_kernels_agree) {
+    std::srand(3);
+    const std::size_t n = (1 << 16) + 100;
+    const std::vector<unsigned char> e = bytes(n);
+    for (int round=0; round<50; ++round) {
+      std::vector<unsigned char> a = e;
+      const int changes = std::rand() % 20;
+      for (int c=0; c<changes; ++c) {
+	a[std::rand() % n] ^= static_cast<unsigned char>(1 + std::rand() % 255);
+      }
+      if (round % 2 == 0) {
+	a[(1 << 16) - 1 + round % 3] ^= 1;
+      }
+      const ArrayMismatches scalar = find_byte_mismatches(&e[0], &a[0], n, SCALAR);
+      for (int level=SSE2; level<=AVX2; ++level) {
+	if (is_supported(static_cast<SimdLevel>(level))) {
+	  const ArrayMismatches m = find_byte_mismatches(&e[0], &a[0], n, static_cast<SimdLevel>(level));
+	  assert_equals("count", scalar.count, m.count);
+	  assert_equals("first", scalar.first, m.first);
+	}
+      }
+    }
+  }
+
+  CPUNIT_TEST(BytesAssertTest, test_failure_message) {
+    const std::string e("GET /index.html HTTP/1.1\r\nHost: example.com\r\nAccept: */*\r\nConnection: close\r\n\r\n");
+    std::string a = e;
+    a[21] = '0';
+    a[23] = '0';
+
+    const std::string msg = failure_of(e, a);
+    assert_equals(std::string("ASSERT BYTES EQUAL FAILED - Frame 2 of 79 bytes differ, the first at offset 21 (0x15):\n"
+			      "  00000000  47 45 54 20 2f 69 6e 64  65 78 2e 68 74 6d 6c 20  |GET /index.html |\n"
+			      " -00000010  48 54 54 50 2f 31 2e 31  0d 0a 48 6f 73 74 3a 20  |HTTP/1.1..Host: |\n"
+			      " +00000010  48 54 54 50 2f 30 2e 30  0d 0a 48 6f 73 74 3a 20  |HTTP/0.0..Host: |\n"
+			      "  00000020  65 78 61 6d 70 6c 65 2e  63 6f 6d 0d 0a 41 63 63  |example.com..Acc|\n"
+			      "  00000030  65 70 74 3a 20 2a 2f 2a  0d 0a 43 6f 6e 6e 65 63  |ept: */*..Connec|\n"
+			      "  ..."), msg);
+  }
+
+  CPUNIT_TEST(BytesAssertTest, test_dump_of_last_line) {
+    const std::string e(40, 'x');
+    std::string a = e;
+    a[39] = '\0';
+
+    const std::string msg = failure_of(e, a);
+    assert_equals(std::string("ASSERT BYTES EQUAL FAILED - Frame 1 of 40 bytes differ, the first at offset 39 (0x27):\n"
+			      "  00000000  78 78 78 78 78 78 78 78  78 78 78 78 78 78 78 78  |xxxxxxxxxxxxxxxx|\n"
+			      "  00000010  78 78 78 78 78 78 78 78  78 78 78 78 78 78 78 78  |xxxxxxxxxxxxxxxx|\n"
+			      " -00000020  78 78 78 78 78 78 78 78                           |xxxxxxxx|\n"
+			      " +00000020  78 78 78 78 78 78 78 00                           |xxxxxxx.|"), msg);
+  }
+
+  CPUNIT_TEST(BytesAssertTest, test_large_buffer) {
+    std::vector<unsigned char> e(BENCH_SIZE, 0xAB);
+    std::vector<unsigned char> a = e;
+    a[BENCH_SIZE - 100] = 0;
+    a[BENCH_SIZE - 1] = 0;
+    try {
+      assert_bytes_equal(&e[0], &a[0], e.size());
+    } catch (AssertionException &ex) {
+      const std::string msg = ex.get_message();
+      assert_true(msg, msg.find("2 of 16777216 bytes differ, the first at offset 16777116 (0xffff9c):") != std::string::npos);
+      assert_true(msg, msg.find("\n  ...\n") != std::string::npos);
+      return;
+    }
+    fail("The buffers differ.");
+  }
+
+  CPUNIT_BENCH(BytesAssertTest, bench_assert_bytes_equal) {
+    const std::vector<unsigned char> e = bytes(BENCH_SIZE);
+    const std::vector<unsigned char> a = e;
+    while (state.keep_running()) {
+      assert_bytes_equal(&e[0], &a[0], BENCH_SIZE);
+    }
+  }
+
+  CPUNIT_BENCH(BytesAssertTest, bench_count_all_different) {
+    const std::vector<unsigned char> e(BENCH_SIZE, 1);
+    const std::vector<unsigned char> a(BENCH_SIZE, 2);
+    while (state.keep_running()) {
+      do_not_optimize(find_byte_mismatches(&e[0], &a[0], BENCH_SIZE, best_simd_level()));
+    }
+  }
+}
@@ -0,0 +1,136 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <cpunit>
+#include <cpunit_AssertionException.hpp>
+
+#include <string>
+#include <vector>
+
+namespace CheckMacroTest {
+
+  using namespace cpunit;
+
+  struct Opaque {
+    int x;
+    bool operator == (const Opaque &o) const {
+      return x == o.x;
+    }
+  };
+
+  enum Color {RED, GREEN};
+
+  std::string failure_of_check(const int a, const int b) {
+    try {
+      CPUNIT_CHECK(a + 1 == b);
+    } catch (AssertionException &e) {
+      return e.what();
+    }
+    return "";
+  }
+
+  CPUNIT_TEST(CheckMacroTest, test_passing_checks) {
+    const int a = 2;
+    const std::string s("abc");
+    CPUNIT_CHECK(a == 2);
+    CPUNIT_CHECK(a != 3);
+    CPUNIT_CHECK(a < 3);
+    CPUNIT_CHECK(a <= 2);
+    CPUNIT_CHECK(a * 2 > 3);
+    CPUNIT_CHECK(a >= 2);
+    CPUNIT_CHECK(s == "abc");
+    CPUNIT_CHECK(!s.empty());
+    CPUNIT_CHECK((a == 2 && s.size() == 3));
+  }
+
+  CPUNIT_TEST(CheckMacroTest, test_failure_shows_operands) {
+    const std::string msg = failure_of_check(1, 3);
+    assert_true(msg, msg.find("CHECK FAILED - At line ") != std::string::npos);
+    assert_true(msg, msg.find("Stmt: 'a + 1 == b' With: <2> == <3>") != std::string::npos);
+    assert_equals(std::string(""), failure_of_check(2, 3));
+  }
+
+  CPUNIT_TEST(CheckMacroTest, test_operand_printers) {
+    std::vector<int> v(2, 7);
+    const bool flag = false;
+    const Opaque o1 = {1}, o2 = {2};
+    try {
+      CPUNIT_CHECK(v.size() == 3);
+      fail("Wrong size passed.");
+    } catch (AssertionException &e) {
+      assert_true(e.what(), std::string(e.what()).find("<2> == <3>") != std::string::npos);
+    }
+    try {
+      CPUNIT_CHECK(v == std::vector<int>(1, 7));
+      fail("Wrong vector passed.");
+    } catch (AssertionException &e) {
+      assert_true(e.what(), std::string(e.what()).find("<[7,7]> == <[7]>") != std::string::npos);
+    }
+    try {
+      CPUNIT_CHECK(flag);
+      fail("False passed.");
+    } catch (AssertionException &e) {
+      assert_true(e.what(), std::string(e.what()).find("With: <false>") != std::string::npos);
+    }
+    try {
+      CPUNIT_CHECK(o1 == o2);
+      fail("Different objects passed.");
+    } catch (AssertionException &e) {
+      assert_true(e.what(), std::string(e.what()).find("<{?}> == <{?}>") != std::string::npos);
+    }
+    try {
+      CPUNIT_CHECK(RED == GREEN);
+      fail("Different colors passed.");
+    } catch (AssertionException &e) {
+      assert_true(e.what(), std::string(e.what()).find("<0> == <1>") != std::string::npos);
+    }
+  }
+
+  CPUNIT_TEST(CheckMacroTest, test_operands_evaluated_once) {
+    int n = 0;
+    CPUNIT_CHECK(++n == 1);
+    assert_equals(1, n);
+  }
+
+  CPUNIT_TEST(CheckMacroTest, test_passing_check_does_not_allocate) {
+    const std::string s("A string too long for the small string buffer.");
+    NoAllocationScope no_allocations;
+    CPUNIT_CHECK(s == s);
+    CPUNIT_CHECK(s.size() > 10);
+  }
+
+  CPUNIT_BENCH(CheckMacroTest, bench_CPUNIT_CHECK) {
+    int k = 0;
+    while (state.keep_running()) {
+      do_not_optimize(k);
+      CPUNIT_CHECK(k >= 0);
+    }
+  }
+}
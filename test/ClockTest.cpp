@@ -0,0 +1,85 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <cpunit>
+#include <cpunit_Clock.hpp>
+#include <cpunit_StopWatch.hpp>
+
+#include <stdint.h>
+#include <unistd.h>
+
+namespace ClockTest {
+
+  using namespace cpunit;
+
+  CPUNIT_TEST(ClockTest, test_never_decreases) {
+    uint64_t last = Clock::now();
+    for (int i=0; i<100000; ++i) {
+      const uint64_t now = Clock::now();
+      assert_true(CPUNIT_STR("Clock went from "<<last<<" to "<<now), now >= last);
+      last = now;
+    }
+  }
+
+  CPUNIT_TEST(ClockTest, test_overhead_is_small) {
+    assert_true(CPUNIT_STR("Overhead is "<<Clock::get_overhead()<<"ns"), Clock::get_overhead() < 100000);
+  }
+
+  CPUNIT_TEST(ClockTest, test_elapsed_subtracts_overhead) {
+    const uint64_t o = Clock::get_overhead();
+    assert_equals(1000UL, static_cast<unsigned long>(Clock::elapsed(5000, 6000 + o)));
+    assert_equals(0UL, static_cast<unsigned long>(Clock::elapsed(5000, 5000)));
+  }
+
+  CPUNIT_TEST(ClockTest, test_stop_watch_measures_sleep) {
+    StopWatch sw;
+    sw.start();
+    usleep(20000);
+    const double secs = sw.stop();
+    assert_true(CPUNIT_STR("Measured "<<secs<<'s'), secs >= 0.019 && secs < 1.0);
+    assert_equals("Milliseconds", secs * 1e3, sw.time(), 1e-9);
+    assert_equals("Nanoseconds", secs * 1e9, static_cast<double>(sw.elapsed_ns()), 1e-3);
+  }
+
+  CPUNIT_TEST(ClockTest, test_tsc_agrees_with_monotonic) {
+    if (!Clock::has_invariant_tsc()) {
+      assert_false("TSC used without being invariant.", Clock::use(Clock::TSC));
+      assert_true(Clock::get_source() == Clock::MONOTONIC);
+      return;
+    }
+    assert_true("TSC refused.", Clock::use(Clock::TSC));
+    StopWatch sw;
+    sw.start();
+    usleep(20000);
+    const double secs = sw.stop();
+    Clock::use(Clock::MONOTONIC);
+    assert_true(CPUNIT_STR("Measured "<<secs<<'s'), secs >= 0.019 && secs < 1.0);
+  }
+}
@@ -0,0 +1,150 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <cpunit>
+#include <cpunit_AssertionException.hpp>
+#include <cpunit_BenchmarkCall.hpp>
+#include <cpunit_Complexity.hpp>
+#include <cpunit_IllegalArgumentException.hpp>
+#include <cpunit_WrongSetupException.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace ComplexityTest {
+
+  using namespace cpunit;
+
+  std::vector<double> sizes() {
+    std::vector<double> result;
+    for (double n=1024; n<=1024*1024; n*=2) {
+      result.push_back(n);
+    }
+    return result;
+  }
+
+  std::vector<double> times(const std::vector<double> &n, const Complexity c, const double noise) {
+    std::vector<double> result;
+    for (std::size_t i=0; i<n.size(); ++i) {
+      double t = 1e-9;
+      switch (c) {
+      case O_1:         break;
+      case O_LOG_N:     t *= std::log(n[i]); break;
+      case O_N:         t *= n[i]; break;
+      case O_N_LOG_N:   t *= n[i] * std::log(n[i]); break;
+      case O_N_SQUARED: t *= n[i] * n[i]; break;
+      }
+      result.push_back(t * (1 + (i % 2 == 0 ? noise : -noise)));
+    }
+    return result;
+  }
+
+  void quadratic(BenchState &state) {
+    const long n = state.get_range();
+    long sum = 0;
+    while (state.keep_running()) {
+      for (long i=0; i<n; ++i) {
+	for (long j=0; j<n; ++j) {
+	  sum += i ^ j;
+	}
+      }
+      do_not_optimize(sum);
+    }
+  }
+
+  CPUNIT_BENCH_COMPLEXITY(ComplexityTest, bench_sort, 1<<10, 1<<16, cpunit::O_N_LOG_N) {
+    std::vector<int> v(state.get_range());
+    while (state.keep_running()) {
+      state.pause_timing();
+      for (std::size_t i=0; i<v.size(); ++i) {
+	v[i] = std::rand();
+      }
+      state.resume_timing();
+      std::sort(v.begin(), v.end());
+      do_not_optimize(v);
+    }
+  }
+
+  CPUNIT_TEST(ComplexityTest, test_fits_exact_models) {
+    const Complexity models[] = { O_1, O_LOG_N, O_N, O_N_LOG_N, O_N_SQUARED };
+    const std::vector<double> n = sizes();
+    for (int m=0; m<5; ++m) {
+      const ComplexityFit fit = ComplexityFit::fit(n, times(n, models[m], 0));
+      assert_equals(CPUNIT_STR("Model #"<<m), ComplexityFit::to_string(models[m]), ComplexityFit::to_string(fit.get_complexity()));
+      assert_equals(CPUNIT_STR("RMS of model #"<<m), 0.0, fit.get_rms(), 1e-9);
+    }
+  }
+
+  CPUNIT_TEST(ComplexityTest, test_fits_noisy_models) {
+    const std::vector<double> n = sizes();
+    const ComplexityFit fit = ComplexityFit::fit(n, times(n, O_N_LOG_N, 0.05));
+    assert_true(ComplexityFit::to_string(fit.get_complexity()), fit.get_complexity() == O_N_LOG_N);
+    assert_true(CPUNIT_STR("RMS "<<fit.get_rms()), fit.get_rms() > 0.01 && fit.get_rms() < 0.1);
+    assert_equals(1e-9, fit.get_coefficient(), 1e-10);
+  }
+
+  CPUNIT_TEST_EX(ComplexityTest, test_fit_needs_two_sizes, IllegalArgumentException) {
+    ComplexityFit::fit(std::vector<double>(1, 8), std::vector<double>(1, 1));
+  }
+
+  CPUNIT_TEST(ComplexityTest, test_ranges_double) {
+    BenchmarkCall call(RegInfo("ComplexityTest", "quadratic", __FILE__, "0"), quadratic, 3, 20, BenchmarkCall::Settings(0.001, 2, NULL, 0));
+    call.run();
+    const std::vector<BenchmarkCall::Measurement> &ms = call.get_measurements();
+    assert_equals(4, static_cast<int>(ms.size()));
+    const long expected[] = { 3, 6, 12, 20 };
+    for (int i=0; i<4; ++i) {
+      assert_equals(CPUNIT_STR("Range #"<<i), expected[i], ms[i].range);
+    }
+    assert_true("No fit.", call.has_fit());
+    assert_equals(std::string("quadratic/12"), call.get_measurement_info(2).get_name());
+  }
+
+  CPUNIT_TEST(ComplexityTest, test_bound_is_enforced) {
+    BenchmarkCall call(RegInfo("ComplexityTest", "quadratic", __FILE__, "0"), quadratic, 16, 512, O_1, BenchmarkCall::Settings(0.01, 3, NULL, 0));
+    try {
+      call.run();
+    } catch (AssertionException &e) {
+      assert_true(e.what(), std::string(e.what()).find("COMPLEXITY FAILURE") != std::string::npos);
+      return;
+    }
+    fail(CPUNIT_STR("Fitted "<<ComplexityFit::to_string(call.get_fit().get_complexity())<<" within O(1)."));
+  }
+
+  CPUNIT_TEST_EX(ComplexityTest, test_bound_needs_a_range, WrongSetupException) {
+    BenchmarkCall call(RegInfo("ComplexityTest", "quadratic", __FILE__, "0"), quadratic, 16, 16, O_N);
+  }
+
+  CPUNIT_TEST_EX(ComplexityTest, test_bound_range_is_positive, WrongSetupException) {
+    BenchmarkCall call(RegInfo("ComplexityTest", "quadratic", __FILE__, "0"), quadratic, -4, 16, O_N);
+  }
+}
@@ -0,0 +1,340 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+#include <cpunit>
+#include <cpunit_AssertionException.hpp>
+#include <cpunit_impl_Diff.hpp>
+
+#include <cstdlib>
+#include <functional>
+#include <list>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if __cplusplus >= 201103L
+#include <unordered_map>
+#include <unordered_set>
+#endif
+
+namespace DiffTest {
+
+  using namespace cpunit;
+  using namespace cpunit::impl;
+
+  typedef std::vector<int>::const_iterator Iterator;
+
+  bool contains(const std::string &s, const std::string &part) {
+    return s.find(part) != std::string::npos;
+  }
+
+  template<class T>
+  std::string failure_of(const T &e, const T &a) {
+    try {
+      assert_equals("Container", e, a);
+    } catch (AssertionException &ex) {
+      return ex.get_message();
+    }
+    return "";
+  }
+
+  std::vector<Iterator> iterators(const std::vector<int> &v) {
+    std::vector<Iterator> result;
+    for (Iterator it = v.begin(); it != v.end(); ++it) {
+      result.push_back(it);
+    }
+    return result;
+  }
+
+  std::vector<int> random_vector(const std::size_t n) {
+    std::vector<int> v(n);
+    for (std::size_t i=0; i<n; ++i) {
+      v[i] = std::rand() % 4;
+    }
+    return v;
+  }
+
+  std::size_t lcs_length(const std::vector<int> &a, const std::vector<int> &b) {
+    std::vector<std::vector<std::size_t> > lcs(a.size() + 1, std::vector<std::size_t>(b.size() + 1, 0));
+    for (std::size_t i=1; i<=a.size(); ++i) {
+      for (std::size_t j=1; j<=b.size(); ++j) {
+	lcs[i][j] = a[i-1] == b[j-1] ? lcs[i-1][j-1] + 1 : std::max(lcs[i-1][j], lcs[i][j-1]);
+      }
+    }
+    return lcs[a.size()][b.size()];
+  }
+
+  // The edits must turn the expected into the actual sequence, with as few changes as possible.
+  CPUNIT_TEST(DiffTest, test_edits_are_shortest) {
+    std::srand(5);
+    for (int round=0; round<300; ++round) {
+      const std::vector<int> e = random_vector(std::rand() % 30);
+      const std::vector<int> a = random_vector(std::rand() % 30);
+      const std::vector<Iterator> ei = iterators(e);
+      const std::vector<Iterator> ai = iterators(a);
+      SequenceDiff<Iterator> diff(ei, ai, 1000);
+      diff.compute();
+      assert_true("complete", diff.is_complete());
+      assert_true("aligned", diff.is_aligned());
+
+      std::vector<int> rebuilt;
+      std::size_t i = 0;
+      std::size_t j = 0;
+      std::size_t changes = 0;
+      const std::vector<Diff::Edit> &edits = diff.get_edits();
+      for (std::size_t k=0; k<edits.size(); ++k) {
+	const Diff::Edit &edit = edits[k];
+	assert_equals(i, edit.a);
+	assert_equals(j, edit.b);
+	switch (edit.kind) {
+	case Diff::KEEP:
+	  for (std::size_t l=0; l<edit.length; ++l) {
+	    assert_equals(e[i + l], a[j + l]);
+	    rebuilt.push_back(e[i + l]);
+	  }
+	  i += edit.length;
+	  j += edit.length;
+	  break;
+	case Diff::REMOVE:
+	  i += edit.length;
+	  changes += edit.length;
+	  break;
+	case Diff::ADD:
+	  rebuilt.insert(rebuilt.end(), a.begin() + j, a.begin() + j + edit.length);
+	  j += edit.length;
+	  changes += edit.length;
+	  break;
+	}
+      }
+      assert_equals(e.size(), i);
+      assert_equals(a, rebuilt);
+      assert_equals(e.size() + a.size() - 2 * lcs_length(e, a), changes);
+    }
+  }
+
+  CPUNIT_TEST(DiffTest, test_insertion_is_aligned) {
+    std::vector<int> e;
+    for (int i=0; i<100; ++i) {
+      e.push_back(i);
+    }
+    std::vector<int> a = e;
+    a.insert(a.begin() + 50, 1000);
+
+    const std::string msg = failure_of(e, a);
+    assert_true(msg, contains(msg, "First difference at index 50, expected (-) and actual (+):"));
+    assert_true(msg, contains(msg, "  @@ -48,4 +48,5 @@\n   48\n   49\n  +1000\n   50\n   51"));
+    // The elements after the insertion are not reported as changed.
+    assert_false(msg, contains(msg, "-50"));
+  }
+
+  CPUNIT_TEST(DiffTest, test_separate_changes_get_separate_hunks) {
+    std::vector<int> e;
+    for (int i=0; i<100; ++i) {
+      e.push_back(i);
+    }
+    std::vector<int> a = e;
+    a[10] = -1;
+    a.erase(a.begin() + 80);
+
+    const std::string msg = failure_of(e, a);
+    assert_true(msg, contains(msg, "  @@ -8,5 +8,5 @@\n   8\n   9\n  -10\n  +-1\n   11\n   12\n  @@ -78,5 +78,4 @@\n   78\n   79\n  -80\n   81\n   82"));
+    assert_false(msg, contains(msg, "\n  ..."));
+  }
+
+  CPUNIT_TEST(DiffTest, test_large_vector_shows_first_index) {
+    std::vector<int> e(2000000);
+    for (std::size_t i=0; i<e.size(); ++i) {
+      e[i] = static_cast<int>(i);
+    }
+    std::vector<int> a = e;
+    a[1234567] = -1;
+
+    const std::string msg = failure_of(e, a);
+    assert_true(msg, contains(msg, "First difference at index 1234567"));
+    assert_true(msg, contains(msg, "  -1234567\n  +-1\n"));
+  }
+
+  CPUNIT_TEST(DiffTest, test_output_is_bounded) {
+    std::vector<int> e(1000, 0);
+    std::vector<int> a(1000, 1);
+
+    std::ostringstream oss;
+    write_sequence_diff(oss, e.begin(), e.end(), a.begin(), a.end(), 6);
+    const std::string msg = oss.str();
+    assert_true(msg, contains(msg, "  -0\n  -0\n  -0\n  -0\n  -0\n  -0\n  ..."));
+    assert_false(msg, contains(msg, "+1"));
+
+    const std::vector<Iterator> ei = iterators(e);
+    const std::vector<Iterator> ai = iterators(a);
+    SequenceDiff<Iterator> diff(ei, ai, 10);
+    diff.compute();
+    assert_true(diff.is_complete());
+    assert_equals(std::size_t(2), diff.get_edits().size());
+  }
+
+  CPUNIT_TEST(DiffTest, test_search_stops_early) {
+    std::vector<int> e(1000);
+    std::vector<int> a(1000);
+    for (std::size_t i=0; i<e.size(); ++i) {
+      e[i] = static_cast<int>(i % 3);
+      a[i] = static_cast<int>(i % 5);
+    }
+    const std::vector<Iterator> ei = iterators(e);
+    const std::vector<Iterator> ai = iterators(a);
+    SequenceDiff<Iterator> diff(ei, ai, 10);
+    diff.compute();
+    assert_false(diff.is_complete());
+  }
+
+  CPUNIT_TEST(DiffTest, test_costly_alignment_is_given_up) {
+    std::srand(11);
+    std::vector<int> e(20000);
+    std::vector<int> a(20000);
+    for (std::size_t i=0; i<e.size(); ++i) {
+      e[i] = std::rand();
+      a[i] = std::rand();
+    }
+    a[0] = e[0];
+
+    const std::vector<Iterator> ei = iterators(e);
+    const std::vector<Iterator> ai = iterators(a);
+    SequenceDiff<Iterator> diff(ei, ai, 100000);
+    diff.compute();
+    assert_false(diff.is_aligned());
+    assert_true(diff.is_complete());
+
+    const std::string msg = failure_of(e, a);
+    assert_true(msg, contains(msg, "First difference at index 1"));
+    assert_true(msg, contains(msg, "shown as removed and added"));
+  }
+
+  CPUNIT_TEST(DiffTest, test_list) {
+    std::list<std::string> e;
+    e.push_back("a");
+    e.push_back("b");
+    e.push_back("c");
+    std::list<std::string> a = e;
+    a.pop_front();
+
+    const std::string msg = failure_of(e, a);
+    assert_true(msg, contains(msg, "First difference at index 0"));
+    assert_true(msg, contains(msg, "  @@ -0,3 +0,2 @@\n  -a\n   b\n   c"));
+  }
+
+  CPUNIT_TEST(DiffTest, test_set) {
+    std::set<int> e;
+    std::set<int> a;
+    for (int i=0; i<100; ++i) {
+      e.insert(i);
+      a.insert(i + 2);
+    }
+    const std::string msg = failure_of(e, a);
+    assert_true(msg, contains(msg, "2 missing (-) and 2 unexpected (+) elements:\n  -0\n  -1\n  +100\n  +101"));
+  }
+
+  CPUNIT_TEST(DiffTest, test_map) {
+    std::map<std::string, int> e;
+    e["one"] = 1;
+    e["two"] = 2;
+    e["three"] = 3;
+    std::map<std::string, int> a = e;
+    a.erase("one");
+    a["two"] = 22;
+    a["four"] = 4;
+
+    const std::string msg = failure_of(e, a);
+    assert_true(msg, contains(msg, "1 missing (-), 1 unexpected (+) and 1 changed keys:\n  +(four - 4)\n  -(one - 1)\n  -(two - 2)\n  +(two - 22)"));
+  }
+
+#if __cplusplus >= 201103L
+  CPUNIT_TEST(DiffTest, test_unordered_map) {
+    std::unordered_map<std::string, int> e;
+    for (int i=0; i<1000; ++i) {
+      e[std::to_string(i)] = i;
+    }
+    std::unordered_map<std::string, int> a = e;
+    a.erase("17");
+    a["500"] = -500;
+    a["x"] = 0;
+
+    const std::string msg = failure_of(e, a);
+    assert_true(msg, contains(msg, "1 missing (-), 1 unexpected (+) and 1 changed keys:"));
+    assert_true(msg, contains(msg, "\n  -(17 - 17)"));
+    assert_true(msg, contains(msg, "\n  -(500 - 500)\n  +(500 - -500)"));
+    assert_true(msg, contains(msg, "\n  +(x - 0)"));
+  }
+
+  CPUNIT_TEST(DiffTest, test_unordered_multimap) {
+    std::unordered_multimap<int, int> e;
+    e.insert(std::make_pair(1, 10));
+    e.insert(std::make_pair(1, 11));
+    e.insert(std::make_pair(2, 20));
+    std::unordered_multimap<int, int> a;
+    a.insert(std::make_pair(1, 11));
+    a.insert(std::make_pair(1, 12));
+    a.insert(std::make_pair(2, 20));
+    a.insert(std::make_pair(2, 20));
+
+    const std::string msg = failure_of(e, a);
+    assert_true(msg, contains(msg, "0 missing (-), 1 unexpected (+) and 1 changed keys:"));
+    assert_true(msg, contains(msg, "\n  -(1 - 10)\n  +(1 - 12)"));
+    assert_true(msg, contains(msg, "\n  +(2 - 20)"));
+  }
+
+  CPUNIT_TEST(DiffTest, test_unordered_set) {
+    std::unordered_multiset<int> e;
+    std::unordered_multiset<int> a;
+    for (int i=0; i<100; ++i) {
+      e.insert(i);
+      a.insert(i + 50);
+    }
+    a.insert(60);
+
+    std::ostringstream oss;
+    write_unordered_diff(oss, e, a, ElementKey(), false, 3);
+    const std::string msg = oss.str();
+    assert_true(msg, contains(msg, "50 missing (-) and 51 unexpected (+) elements:"));
+    assert_true(msg, contains(msg, "\n  ..."));
+  }
+#endif
+
+  CPUNIT_TEST(DiffTest, test_diff_can_be_turned_off) {
+    const std::vector<int> e(3, 1);
+    const std::vector<int> a(3, 2);
+    std::ostringstream oss;
+    write_sequence_diff(oss, e.begin(), e.end(), a.begin(), a.end(), 0);
+    write_set_diff(oss, e.begin(), e.end(), a.begin(), a.end(), std::less<int>(), 0);
+    assert_equals(std::string(), oss.str());
+  }
+}
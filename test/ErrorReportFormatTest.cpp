@@ -97,4 +97,29 @@ namespace ErrorReportFormatTest {
     assert_equals("Should be the error message.", expected.str(), f.format(report));
   }
 
+  CPUNIT_TEST(ErrorReportFormatTest, test_resource_usage_formatting) {
+    ExecutionReport r(report);
+    r.set_resource_usage(ResourceUsage(1.5, 2, 3, 4, 5));
+    const ErrorReportFormat f("%c %w %W %r %R");
+    assert_equals("Should be the resource usage.", std::string("1.500 2 3 4 5"), f.format(r));
+  }
+
+  CPUNIT_TEST(ErrorReportFormatTest, test_perf_counters_formatting) {
+    ExecutionReport r(report);
+    PerfCounters c;
+    c.set(PerfCounters::CYCLES, 1000);
+    c.set(PerfCounters::INSTRUCTIONS, 2000);
+    c.set(PerfCounters::BRANCH_MISSES, 3);
+    r.set_perf_counters(c);
+    const ErrorReportFormat f("%y %i %x %b");
+    assert_equals("Should be the counters, and '-' if not counted.", std::string("1000 2000 - 3"), f.format(r));
+  }
+
+  CPUNIT_TEST(ErrorReportFormatTest, test_allocations_formatting) {
+    ExecutionReport r(report);
+    r.set_allocation_stats(AllocationStats(12, 10, 4096, 1024));
+    const ErrorReportFormat f("%a %B %P");
+    assert_equals(std::string("12 4096 1024"), f.format(r));
+  }
+
 }
@@ -0,0 +1,147 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#include <cpunit>
+#include <cpunit_AssertionException.hpp>
+#include <cpunit_BasicTestRunner.hpp>
+#include <cpunit_Callable.hpp>
+
+#include <string>
+
+namespace ExpectTest {
+
+  using namespace cpunit;
+
+  bool contains(const std::string &s, const std::string &part) {
+    return s.find(part) != std::string::npos;
+  }
+
+  // Fails n expectations, then possibly an assert.
+  class Validation : public Callable {
+    const int n;
+    const bool fatal;
+  public:
+    int checked;
+
+    Validation(const int n_, const bool fatal_) :
+      Callable(RegInfo("ExpectTest", "validation", "ExpectTest.cpp", "42")),
+      n(n_),
+      fatal(fatal_),
+      checked(0)
+    {}
+
+    void run() {
+      for (int i=0; i<n; ++i) {
+	CPUNIT_EXPECT(i == -1);
+	++checked;
+      }
+      expect_equals(1, 1);
+      assert_false("Fatal", fatal);
+    }
+  };
+
+  std::string failure_of(Validation &v) {
+    try {
+      BasicTestRunner().run(v);
+    } catch (AssertionException &e) {
+      assert_not_null(e.get_test());
+      return e.get_message();
+    }
+    return "";
+  }
+
+  CPUNIT_TEST(ExpectTest, test_expectations_are_collected) {
+    ExpectationScope scope(10);
+    expect_true(true);
+    expect_equals(std::string("a"), std::string("a"));
+    assert_false(scope.has_failures());
+
+    expect_true("first", false);
+    expect_equals("second", 1, 2);
+    expect_equals(1.0, 1.5, 0.1);
+    expect_null(&scope);
+    int x = 2;
+    CPUNIT_EXPECT(x * 2 == 5);
+    assert_equals(std::size_t(5), scope.get_failures());
+
+    const std::string msg = scope.to_string();
+    assert_true(msg, contains(msg, "EXPECTATIONS FAILED - 5 expectations failed:"));
+    assert_true(msg, contains(msg, "\n  EXPECT TRUE FAILED - first"));
+    assert_true(msg, contains(msg, "\n  EXPECT EQUALS FAILED - second Expected <1>, was <2>."));
+    assert_true(msg, contains(msg, "\n  EXPECT NULL FAILED - "));
+    assert_true(msg, contains(msg, "Stmt: 'x * 2 == 5' With: <4> == <5>"));
+    assert_true(msg, msg.find("first") < msg.find("second"));
+  }
+
+  CPUNIT_TEST(ExpectTest, test_messages_are_capped) {
+    ExpectationScope scope(2);
+    for (int i=0; i<5; ++i) {
+      expect_equals(0, i + 1);
+    }
+
+    const std::string msg = scope.to_string();
+    assert_equals(std::size_t(5), scope.get_failures());
+    assert_true(msg, contains(msg, "Expected <0>, was <2>."));
+    assert_false(msg, contains(msg, "Expected <0>, was <3>."));
+    assert_true(msg, contains(msg, "\n  (3 more)"));
+  }
+
+  CPUNIT_TEST(ExpectTest, test_runner_reports_all_failures) {
+    Validation v(3, false);
+    const std::string msg = failure_of(v);
+    assert_equals(3, v.checked);
+    assert_true(msg, contains(msg, "3 expectations failed"));
+    assert_false(msg, contains(msg, "Fatal"));
+
+    Validation passing(0, false);
+    assert_equals(std::string(""), failure_of(passing));
+  }
+
+  CPUNIT_TEST(ExpectTest, test_runner_appends_failed_assert) {
+    Validation v(1, true);
+    const std::string msg = failure_of(v);
+    assert_true(msg, contains(msg, "1 expectation failed:"));
+    assert_true(msg, contains(msg, "\n  ASSERT FALSE FAILED - Fatal"));
+
+    Validation fatal_only(0, true);
+    assert_equals(std::string("ASSERT FALSE FAILED - Fatal"), failure_of(fatal_only));
+  }
+
+  CPUNIT_TEST(ExpectTest, test_scopes_nest) {
+    ExpectationScope outer;
+    {
+      ExpectationScope inner;
+      expect_false(true);
+      assert_equals(std::size_t(1), inner.get_failures());
+    }
+    assert_false(outer.has_failures());
+  }
+}
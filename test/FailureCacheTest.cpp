@@ -0,0 +1,128 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <cpunit>
+#include <cpunit_FailureCache.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace FailureCacheTest {
+
+  using namespace cpunit;
+
+  struct TempFile {
+    std::string path;
+    TempFile(const std::string &name) :
+      path()
+    {
+      std::ostringstream oss;
+      oss<<"/tmp/cpunit_FailureCacheTest_"<<name<<'_'<<getpid();
+      path = oss.str();
+      std::remove(path.c_str());
+    }
+    ~TempFile() {
+      std::remove(path.c_str());
+    }
+  };
+
+  const RegInfo a("FailureCacheTest::Suite", "test_a", "a.cpp", "10");
+  const RegInfo b("FailureCacheTest::Suite", "test_b", "b.cpp", "20");
+  const RegInfo c("FailureCacheTest::Other", "test_a", "c.cpp", "30");
+
+  ExecutionReport report(const RegInfo &ri, const ExecutionReport::ExecutionResult r) {
+    return ExecutionReport(r, "", ri, .0);
+  }
+
+  CPUNIT_TEST(FailureCacheTest, test_missing_file_is_empty) {
+    TempFile tmp("missing");
+    FailureCache cache(tmp.path);
+    assert_equals(0, static_cast<int>(cache.size()));
+    assert_false("Found test in empty cache.", cache.contains(a));
+  }
+
+  CPUNIT_TEST(FailureCacheTest, test_round_trip) {
+    TempFile tmp("round_trip");
+    {
+      FailureCache cache(tmp.path);
+      std::vector<ExecutionReport> reports;
+      reports.push_back(report(a, ExecutionReport::FAILURE));
+      reports.push_back(report(b, ExecutionReport::OK));
+      reports.push_back(report(c, ExecutionReport::ERROR));
+      cache.update(reports);
+      cache.save();
+    }
+    FailureCache cache(tmp.path);
+    assert_equals(2, static_cast<int>(cache.size()));
+    assert_true("test_a not found.", cache.contains(a));
+    assert_false("test_b found.", cache.contains(b));
+    assert_true("Other::test_a not found.", cache.contains(c));
+  }
+
+  CPUNIT_TEST(FailureCacheTest, test_update_keeps_tests_not_run) {
+    TempFile tmp("merge");
+    FailureCache cache(tmp.path);
+    cache.add(a);
+    cache.add(b);
+    std::vector<ExecutionReport> reports;
+    reports.push_back(report(a, ExecutionReport::OK));
+    reports.push_back(report(c, ExecutionReport::FAILURE));
+    cache.update(reports);
+    assert_false("Passed test kept.", cache.contains(a));
+    assert_true("Test not run removed.", cache.contains(b));
+    assert_true("Failed test not added.", cache.contains(c));
+    assert_equals(2, static_cast<int>(cache.size()));
+  }
+
+  CPUNIT_TEST(FailureCacheTest, test_add_is_idempotent) {
+    TempFile tmp("idempotent");
+    FailureCache cache(tmp.path);
+    cache.add(a);
+    cache.add(a);
+    assert_equals(1, static_cast<int>(cache.size()));
+  }
+
+  CPUNIT_TEST(FailureCacheTest, test_malformed_lines_are_skipped) {
+    TempFile tmp("malformed");
+    {
+      std::ofstream out(tmp.path.c_str());
+      out<<"# comment"<<std::endl;
+      out<<"no tabs here"<<std::endl;
+      out<<a.get_path()<<'\t'<<a.get_name()<<'\t'<<a.get_file()<<'\t'<<a.get_line()<<std::endl;
+    }
+    FailureCache cache(tmp.path);
+    assert_equals(1, static_cast<int>(cache.size()));
+    assert_true("test_a not found.", cache.contains(a));
+  }
+}
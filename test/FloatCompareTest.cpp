@@ -0,0 +1,227 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#include <cpunit>
+#include <cpunit_AssertionException.hpp>
+#include <cpunit_impl_ArrayCompare.hpp>
+#include <cpunit_impl_FloatCompare.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <math.h>
+#include <string>
+#include <vector>
+
+namespace FloatCompareTest {
+
+  using namespace cpunit;
+  using namespace cpunit::impl;
+
+  const std::size_t BENCH_SIZE = 1 << 20;
+
+  bool contains(const std::string &s, const std::string &part) {
+    return s.find(part) != std::string::npos;
+  }
+
+  template<class T>
+  T from_bits(const typename FloatBits<T>::UInt bits) {
+    T t;
+    std::memcpy(&t, &bits, sizeof(t));
+    return t;
+  }
+
+  // Values near an interesting one, with random bits, or special.
+  template<class T>
+  T random_value(const T near) {
+    typedef typename FloatBits<T>::UInt UInt;
+    switch (std::rand() % 8) {
+    case 0: return std::numeric_limits<T>::quiet_NaN();
+    case 1: return std::numeric_limits<T>::infinity();
+    case 2: return -std::numeric_limits<T>::infinity();
+    case 3: return -near;
+    case 4: return std::numeric_limits<T>::max();
+    case 5: {
+      UInt bits = 0;
+      for (std::size_t i=0; i<sizeof(bits); ++i) {
+	bits = (bits << 8) | static_cast<UInt>(std::rand() & 0xFF);
+      }
+      return from_bits<T>(bits);
+    }
+    default: {
+      const UInt ulps = static_cast<UInt>(std::rand() % 6);
+      UInt bits;
+      std::memcpy(&bits, &near, sizeof(bits));
+      return from_bits<T>(bits + ulps);
+    }
+    }
+  }
+
+  template<class T>
+  void check_ulp_kernels_agree() {
+    const uint64_t max_ulps[] = {0, 1, 4, 0x80000005u, 0xFFFFFFFFu};
+    std::srand(23);
+    for (std::size_t n=0; n<41; ++n) {
+      std::vector<T> e(n);
+      std::vector<T> a(n);
+      for (std::size_t i=0; i<n; ++i) {
+	e[i] = std::rand() % 4 == 0 ? random_value<T>(T(1.5)) : T(0.0);
+	a[i] = std::rand() % 4 == 0 ? random_value<T>(e[i]) : e[i];
+      }
+      for (int u=0; u<5; ++u) {
+	const ArrayMismatches scalar = find_ulp_mismatches(priv::data_of(e), priv::data_of(a), n, max_ulps[u], SCALAR);
+	const SimdLevel levels[] = {SSE2, AVX2};
+	for (int l=0; l<2; ++l) {
+	  if (is_supported(levels[l])) {
+	    const ArrayMismatches v = find_ulp_mismatches(priv::data_of(e), priv::data_of(a), n, max_ulps[u], levels[l]);
+	    assert_equals("Count", scalar.count, v.count);
+	    assert_equals("First", scalar.first, v.first);
+	  }
+	}
+      }
+    }
+  }
+
+  template<class T>
+  std::string failure_of_ulps(const T expected, const T actual, const unsigned int max_ulps) {
+    try {
+      assert_equals_ulps("Ulps", expected, actual, max_ulps);
+    } catch (AssertionException &e) {
+      return e.get_message();
+    }
+    return "";
+  }
+
+  CPUNIT_TEST(FloatCompareTest, test_ulp_distance) {
+    const float denorm = std::numeric_limits<float>::denorm_min();
+    assert_equals(uint64_t(0), ulp_distance(0.0f, -0.0f));
+    assert_equals(uint64_t(1), ulp_distance(1.0f, nextafterf(1.0f, 2.0f)));
+    assert_equals(uint64_t(2), ulp_distance(-denorm, denorm));
+    assert_equals(uint64_t(1), ulp_distance(std::numeric_limits<double>::max(), std::numeric_limits<double>::infinity()));
+    assert_equals(uint64_t(3), ulp_distance(-1.0, nextafter(nextafter(nextafter(-1.0, 0.0), 0.0), 0.0)));
+  }
+
+  CPUNIT_TEST(FloatCompareTest, test_within_ulps) {
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    assert_true(within_ulps(1e-12, nextafter(1e-12, 1.0), 1));
+    assert_true(within_ulps(1e12, nextafter(1e12, 0.0), 1));
+    assert_false(within_ulps(1e12, nextafter(nextafter(1e12, 0.0), 0.0), 1));
+    assert_true(within_ulps(0.0, -0.0, 0));
+    assert_true(within_ulps(inf, inf, 0));
+    assert_false(within_ulps(inf, -inf, 0xFFFFFFFFu));
+    assert_false(within_ulps(std::numeric_limits<double>::max(), inf, 0xFFFFFFFFu));
+    assert_false(within_ulps(nan, nan, 0xFFFFFFFFu));
+    assert_false(within_ulps(1.0f, std::numeric_limits<float>::quiet_NaN(), 0xFFFFFFFFu));
+  }
+
+  CPUNIT_TEST(FloatCompareTest, test_assert_equals_ulps) {
+    assert_equals_ulps(0.1 + 0.2, 0.3, 1);
+    assert_equals_ulps(1e-30f, nextafterf(1e-30f, 0.0f), 1);
+    assert_equals(std::string(""), failure_of_ulps(-0.0, 0.0, 0));
+
+    std::string msg = failure_of_ulps(1.0f, nextafterf(nextafterf(1.0f, 2.0f), 2.0f), 1);
+    assert_true(msg, contains(msg, "ASSERT EQUALS ULPS FAILED - Ulps Expected <1>, was <1.00000024>, 2 ulps apart, with at most 1 allowed."));
+    msg = failure_of_ulps(1.0, std::numeric_limits<double>::quiet_NaN(), 10);
+    assert_true(msg, contains(msg, "NaN is not equal to anything."));
+    msg = failure_of_ulps(std::numeric_limits<double>::max(), std::numeric_limits<double>::infinity(), 10);
+    assert_true(msg, contains(msg, "infinity is only equal to itself."));
+  }
+
+  CPUNIT_TEST(FloatCompareTest, test_assert_close) {
+    assert_close(1e-12, 1.5e-12, 1e-12, 0.0);
+    assert_close(1e12, 1e12 + 1e3, 0.0, 1e-6);
+    assert_close(1.0f, 1.001f, 0.0f, 0.01f);
+    assert_close(std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), 0.0, 0.0);
+    try {
+      assert_close("Big", 1e12, 1e12 + 1e7, 1.0, 1e-6);
+    } catch (AssertionException &e) {
+      const std::string msg = e.get_message();
+      assert_true(msg, contains(msg, "ASSERT CLOSE FAILED - Big With abs tolerance 1 and rel tolerance 1e-06, abs error 1e+07, rel error 1e-05."));
+      assert_true(msg, contains(msg, "Expected <1000000000000>, was <1000010000000>."));
+      return;
+    }
+    fail("The values are not close.");
+  }
+
+  CPUNIT_TEST(FloatCompareTest, test_ulp_kernels_agree) {
+    check_ulp_kernels_agree<float>();
+    check_ulp_kernels_agree<double>();
+  }
+
+  CPUNIT_TEST(FloatCompareTest, test_vectors) {
+    std::vector<float> e(19, 1.0f);
+    std::vector<float> a(e);
+    a[3] = nextafterf(1.0f, 2.0f);
+    assert_all_within_ulps(e, a, 1);
+    assert_all_close(e, a, 0.0f, 1e-6f);
+    assert_array_equals(std::vector<int>(), std::vector<int>());
+    try {
+      assert_all_within_ulps("Exact", e, a, 0);
+    } catch (AssertionException &ex) {
+      const std::string msg = ex.get_message();
+      assert_true(msg, contains(msg, "ASSERT ALL WITHIN ULPS FAILED - Exact With at most 0 ulps allowed, 1 of 19 elements differ"));
+      assert_true(msg, contains(msg, "\n  [3] expected <1>, was <1.00000012>"));
+      a.pop_back();
+      try {
+	assert_all_close("Sizes", e, a, 0.0f, 0.0f);
+      } catch (AssertionException &ex) {
+	assert_equals(std::string("ASSERT ALL CLOSE FAILED - Sizes Expected 19 elements, was 18."), std::string(ex.get_message()));
+	return;
+      }
+    }
+    fail("The vectors differ.");
+  }
+
+  CPUNIT_BENCH(FloatCompareTest, bench_assert_all_within_ulps) {
+    const std::vector<double> e(BENCH_SIZE, 1.0);
+    const std::vector<double> a(e);
+    while (state.keep_running()) {
+      assert_all_within_ulps(e, a, 4);
+    }
+  }
+
+  CPUNIT_BENCH(FloatCompareTest, bench_assert_all_within_ulps_scalar) {
+    const std::vector<double> e(BENCH_SIZE, 1.0);
+    const std::vector<double> a(e);
+    while (state.keep_running()) {
+      do_not_optimize(find_ulp_mismatches(&e[0], &a[0], BENCH_SIZE, 4, SCALAR));
+    }
+  }
+
+  CPUNIT_BENCH(FloatCompareTest, bench_assert_equals_ulps) {
+    double d = 1.0;
+    while (state.keep_running()) {
+      do_not_optimize(d);
+      assert_equals_ulps(d, 1.0, 4);
+    }
+  }
+}
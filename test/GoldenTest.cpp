@@ -0,0 +1,226 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+
+#include <cpunit>
+#include <cpunit_AssertionException.hpp>
+#include <cpunit_impl_AtomicFile.hpp>
+
+#include <cstdio>
+#include <dirent.h>
+#include <fstream>
+#include <pthread.h>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace GoldenTest {
+
+  using namespace cpunit;
+
+  /**
+     A golden file name unique to the test and process, removed again at the end of the test.
+   */
+  struct TempFile {
+    std::string path;
+    TempFile(const std::string &name) :
+      path()
+    {
+      std::ostringstream oss;
+      oss<<"/tmp/cpunit_GoldenTest_"<<name<<'_'<<getpid()<<".txt";
+      path = oss.str();
+      std::remove(path.c_str());
+    }
+    ~TempFile() {
+      std::remove(path.c_str());
+    }
+  };
+
+  // The default of --max-diff-lines.
+  const std::size_t MAX_LINES = 40;
+
+  // Replaces the golden file with the data if they differ, as with --update-golden.
+  void update(const std::string &path, const std::string &data) {
+    priv::assert_matches_golden("", path, data.data(), data.length(), true, MAX_LINES);
+  }
+
+  std::string read(const std::string &path) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    std::ostringstream oss;
+    oss<<in.rdbuf();
+    return oss.str();
+  }
+
+  std::string failure_of(const std::string &path, const std::string &data, const std::size_t max_lines = MAX_LINES) {
+    try {
+      priv::assert_matches_golden("Report", path, data.data(), data.length(), false, max_lines);
+    } catch (AssertionException &ex) {
+      return ex.get_message();
+    }
+    return "";
+  }
+
+  std::string numbered_lines(const int n) {
+    std::ostringstream oss;
+    for (int i=1; i<=n; ++i) {
+      oss<<"line "<<i<<'\n';
+    }
+    return oss.str();
+  }
+
+  // The files in /tmp left by write_file_atomically for a path.
+  int temporary_files(const std::string &path) {
+    const std::string prefix = path.substr(5) + ".tmp.";
+    int count = 0;
+    DIR *dir = opendir("/tmp");
+    for (struct dirent *e = readdir(dir); e != NULL; e = readdir(dir)) {
+      if (std::string(e->d_name).compare(0, prefix.length(), prefix) == 0) {
+	++count;
+      }
+    }
+    closedir(dir);
+    return count;
+  }
+
+  CPUNIT_TEST(GoldenTest, test_missing_file) {
+    TempFile tmp("missing");
+    assert_equals("ASSERT MATCHES GOLDEN FAILED - Report The golden file '" + tmp.path + "' does not exist. Run with --update-golden to create it.",
+		  failure_of(tmp.path, "output"));
+  }
+
+  CPUNIT_TEST(GoldenTest, test_update_creates_and_replaces) {
+    TempFile tmp("update");
+    update(tmp.path, "first\n");
+    assert_equals(std::string("first\n"), read(tmp.path));
+    update(tmp.path, std::string("second\0", 7));
+    assert_equals(std::string("second\0", 7), read(tmp.path));
+    assert_matches_golden(tmp.path, std::string("second\0", 7));
+    assert_matches_golden(tmp.path, "second", 7);
+    assert_equals(0, temporary_files(tmp.path));
+  }
+
+  CPUNIT_TEST(GoldenTest, test_same_file_is_not_rewritten) {
+    TempFile tmp("same");
+    impl::write_file_atomically(tmp.path, "unchanged");
+    struct stat before;
+    assert_equals(0, stat(tmp.path.c_str(), &before));
+    update(tmp.path, "unchanged");
+    struct stat after;
+    assert_equals(0, stat(tmp.path.c_str(), &after));
+    assert_equals(before.st_ino, after.st_ino);
+  }
+
+  CPUNIT_TEST(GoldenTest, test_empty_file) {
+    TempFile tmp("empty");
+    impl::write_file_atomically(tmp.path, "");
+    assert_matches_golden(tmp.path, "");
+    const std::string msg = failure_of(tmp.path, "x");
+    assert_true(msg, msg.find("at byte 0 (the file has 0 bytes, the output 1).") != std::string::npos);
+    assert_true(msg, msg.find("  @@ -1,0 +1,1 @@\n  +x") != std::string::npos);
+  }
+
+  CPUNIT_TEST(GoldenTest, test_line_diff) {
+    TempFile tmp("diff");
+    const std::string golden = numbered_lines(100);
+    impl::write_file_atomically(tmp.path, golden);
+    std::string output = golden;
+    output.replace(output.find("line 50\n"), 8, "line fifty\nextra\n");
+
+    const std::string msg = failure_of(tmp.path, output);
+    assert_equals("ASSERT MATCHES GOLDEN FAILED - Report The output differs from '" + tmp.path + "' at byte 388 (the file has 792 bytes, the output 801).\n"
+		  "First difference at line 50, expected (-) and actual (+):\n"
+		  "  @@ -48,5 +48,6 @@\n"
+		  "   line 48\n"
+		  "   line 49\n"
+		  "  -line 50\n"
+		  "  +line fifty\n"
+		  "  +extra\n"
+		  "   line 51\n"
+		  "   line 52", msg);
+
+    assert_equals("ASSERT MATCHES GOLDEN FAILED - Report The output differs from '" + tmp.path + "' at byte 388 (the file has 792 bytes, the output 801).",
+		  failure_of(tmp.path, output, 0));
+  }
+
+  CPUNIT_TEST(GoldenTest, test_missing_newline_at_end) {
+    TempFile tmp("newline");
+    impl::write_file_atomically(tmp.path, "a\nb\n");
+    const std::string msg = failure_of(tmp.path, "a\nb");
+    assert_true(msg, msg.find("The lines are the same, but one ends with a newline.") != std::string::npos);
+  }
+
+  CPUNIT_TEST(GoldenTest, test_large_file) {
+    TempFile tmp("large");
+    const std::string golden = numbered_lines(300000);
+    impl::write_file_atomically(tmp.path, golden);
+    assert_matches_golden(tmp.path, golden);
+
+    std::string output = golden;
+    output[output.find("line 299999\n") + 5] = 'X';
+    const std::string msg = failure_of(tmp.path, output);
+    assert_true(msg, msg.find("First difference at line 299999,") != std::string::npos);
+    assert_true(msg, msg.find("  -line 299999\n  +line X99999\n   line 300000") != std::string::npos);
+  }
+
+  struct Writer {
+    std::string path;
+    std::string data;
+  };
+
+  void* update_repeatedly(void *arg) {
+    const Writer *w = static_cast<const Writer*>(arg);
+    for (int i=0; i<50; ++i) {
+      update(w->path, w->data);
+    }
+    return NULL;
+  }
+
+  // Concurrent updates of one file leave it with one of the outputs in full.
+  CPUNIT_TEST(GoldenTest, test_concurrent_updates) {
+    TempFile tmp("concurrent");
+    const int THREADS = 4;
+    Writer writers[THREADS];
+    pthread_t threads[THREADS];
+    for (int t=0; t<THREADS; ++t) {
+      writers[t].path = tmp.path;
+      writers[t].data = std::string(10000 + t, static_cast<char>('a' + t));
+      pthread_create(&threads[t], NULL, update_repeatedly, &writers[t]);
+    }
+    for (int t=0; t<THREADS; ++t) {
+      pthread_join(threads[t], NULL);
+    }
+    const std::string result = read(tmp.path);
+    assert_true(result.size() >= 10000 && result.size() < 10000 + THREADS);
+    assert_equals(std::string(result.size(), static_cast<char>('a' + result.size() - 10000)), result);
+    assert_equals(0, temporary_files(tmp.path));
+  }
+}
@@ -0,0 +1,106 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <cpunit>
+#include <cpunit_CPUnitException.hpp>
+#include <cpunit_ExecutionReport.hpp>
+#include <cpunit_InstructionBaseline.hpp>
+
+#include <cstdio>
+#include <string>
+
+namespace InstructionBaselineTest {
+
+  using namespace cpunit;
+
+  const std::string FILE_NAME("InstructionBaselineTest.tmp");
+  const RegInfo test_info("A::B", "test_x", "f.cpp", "1");
+
+  ExecutionReport make_report(const ExecutionReport::ExecutionResult r, const uint64_t instructions) {
+    ExecutionReport result(r, "", test_info, 0.5);
+    PerfCounters c;
+    c.set(PerfCounters::INSTRUCTIONS, instructions);
+    result.set_perf_counters(c);
+    return result;
+  }
+
+  CPUNIT_TEAR_DOWN(InstructionBaselineTest) {
+    std::remove(FILE_NAME.c_str());
+  }
+
+  CPUNIT_TEST(InstructionBaselineTest, test_save_and_load) {
+    InstructionBaseline out(FILE_NAME);
+    out.record(test_info, static_cast<uint64_t>(123456789) * 1000);
+    out.record(RegInfo("", "test_global", "f.cpp", "2"), 42);
+    out.save();
+
+    InstructionBaseline in(FILE_NAME);
+    in.load();
+    assert_equals(2, static_cast<int>(in.size()));
+    uint64_t n = 0;
+    assert_true("Missing test_x.", in.lookup(RegInfo("A::B", "test_x", "", ""), n));
+    assert_true("Wrong count for test_x.", n == static_cast<uint64_t>(123456789) * 1000);
+    assert_true("Missing test_global.", in.lookup(RegInfo("", "test_global", "", ""), n));
+    assert_equals(42, static_cast<int>(n));
+    assert_false("Found unknown.", in.lookup(RegInfo("A", "test_x", "", ""), n));
+  }
+
+  CPUNIT_TEST_EX(InstructionBaselineTest, test_load_missing_file, CPUnitException) {
+    InstructionBaseline("/nonexisting/baseline").load();
+  }
+
+  CPUNIT_TEST(InstructionBaselineTest, test_growth_fails) {
+    InstructionBaseline baseline(FILE_NAME);
+    baseline.record(test_info, 1000);
+
+    const ExecutionReport within = baseline.check(make_report(ExecutionReport::OK, 1010), 0.01);
+    assert_equals(ExecutionReport::OK, within.get_execution_result());
+
+    const ExecutionReport beyond = baseline.check(make_report(ExecutionReport::OK, 1011), 0.01);
+    assert_equals(ExecutionReport::FAILURE, beyond.get_execution_result());
+    assert_true(beyond.get_message(), beyond.get_message().find("INSTRUCTION COUNT REGRESSION") != std::string::npos);
+    assert_equals(0.5, beyond.get_time_spent(), 1e-12);
+    assert_equals(1011, static_cast<int>(beyond.get_perf_counters().get(PerfCounters::INSTRUCTIONS)));
+  }
+
+  CPUNIT_TEST(InstructionBaselineTest, test_unchecked_reports) {
+    InstructionBaseline baseline(FILE_NAME);
+    baseline.record(test_info, 1000);
+
+    const ExecutionReport error = baseline.check(make_report(ExecutionReport::ERROR, 5000), 0.01);
+    assert_equals(ExecutionReport::ERROR, error.get_execution_result());
+
+    ExecutionReport uncounted(ExecutionReport::OK, "", test_info, 0.5);
+    assert_equals(ExecutionReport::OK, baseline.check(uncounted, 0.01).get_execution_result());
+
+    const ExecutionReport unknown(ExecutionReport::OK, "", RegInfo("A::B", "test_y", "", ""), 0.5);
+    assert_equals(ExecutionReport::OK, baseline.check(unknown, 0.01).get_execution_result());
+  }
+}
@@ -37,6 +37,22 @@
 #include <map>
 #include <set>
 #include <list>
+#include <utility>
+
+#if __cplusplus >= 201103L
+#include <array>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#endif
+
+#if __cplusplus >= 201703L
+#include <optional>
+#endif
+
+#if __cplusplus >= 202002L
+#include <span>
+#endif
 
 namespace OstreamTest {
 
@@ -169,4 +185,65 @@ namespace OstreamTest {
     oss<<data;
     assert_equals("Multimap ostream failed.", expected, oss.str());
   }
+
+  CPUNIT_TEST(OstreamTest, test_pair_ostream) {
+    std::ostringstream oss;
+    oss<<std::make_pair(std::string("x"), 2.5);
+    assert_equals("Pair ostream failed.", std::string("(x, 2.5)"), oss.str());
+  }
+
+#if __cplusplus >= 201103L
+  CPUNIT_TEST(OstreamTest, test_array_ostream) {
+    const std::array<int, 3> a = {{7, 8, 9}};
+    std::ostringstream oss;
+    oss<<a;
+    assert_equals("Array ostream failed.", std::string("[7,8,9]"), oss.str());
+  }
+
+  CPUNIT_TEST(OstreamTest, test_tuple_ostream) {
+    std::ostringstream oss;
+    oss<<std::make_tuple(1, std::string("two"), std::vector<int>(2, 3))<<std::tuple<>()<<std::make_tuple('c');
+    assert_equals("Tuple ostream failed.", std::string("(1, two, [3,3])()(c)"), oss.str());
+  }
+
+  CPUNIT_TEST(OstreamTest, test_unordered_set_ostream) {
+    std::unordered_set<int> s;
+    s.insert(5);
+    std::unordered_multiset<int> ms;
+    ms.insert(4);
+    ms.insert(4);
+    std::ostringstream oss;
+    oss<<s<<ms;
+    assert_equals("Unordered set ostream failed.", std::string("{5}{4,4}"), oss.str());
+  }
+
+  CPUNIT_TEST(OstreamTest, test_unordered_map_ostream) {
+    std::unordered_map<std::string, int> m;
+    m["alpha"] = 4;
+    std::unordered_multimap<int, int> mm;
+    for (int i=0; i<max_list_display+1; i++) {
+      mm.insert(std::make_pair(1, 1));
+    }
+    std::ostringstream oss;
+    oss<<m<<mm;
+    assert_equals("Unordered map ostream failed.", std::string("{(alpha - 4)}{(1 - 1),(1 - 1),(1 - 1),(1 - 1),(1 - 1),...} (and 16 more)"), oss.str());
+  }
+#endif
+
+#if __cplusplus >= 201703L
+  CPUNIT_TEST(OstreamTest, test_optional_ostream) {
+    std::ostringstream oss;
+    oss<<std::optional<int>(3)<<' '<<std::optional<int>();
+    assert_equals("Optional ostream failed.", std::string("3 nullopt"), oss.str());
+  }
+#endif
+
+#if __cplusplus >= 202002L
+  CPUNIT_TEST(OstreamTest, test_span_ostream) {
+    const int data[4] = {1, 2, 3, 4};
+    std::ostringstream oss;
+    oss<<std::span<const int>(data + 1, 2);
+    assert_equals("Span ostream failed.", std::string("[2,3]"), oss.str());
+  }
+#endif
 }
@@ -0,0 +1,95 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <cpunit>
+#include <cpunit_PerfCounters.hpp>
+#include <cpunit_impl_PerfEventGroup.hpp>
+
+#include <string>
+
+namespace PerfCountersTest {
+
+  using namespace cpunit;
+
+  CPUNIT_TEST(PerfCountersTest, test_names) {
+    for (int i=0; i<PerfCounters::NUM_EVENTS; ++i) {
+      const PerfCounters::Event e = static_cast<PerfCounters::Event>(i);
+      PerfCounters::Event parsed = PerfCounters::NUM_EVENTS;
+      assert_true(PerfCounters::name_of(e), PerfCounters::parse(PerfCounters::name_of(e), parsed));
+      assert_equals(static_cast<int>(e), static_cast<int>(parsed));
+    }
+    PerfCounters::Event e;
+    assert_false("Parsed unknown event.", PerfCounters::parse("cache-hits", e));
+  }
+
+  CPUNIT_TEST(PerfCountersTest, test_difference_and_sum) {
+    PerfCounters before, after;
+    before.set(PerfCounters::CYCLES, 100);
+    before.set(PerfCounters::INSTRUCTIONS, 50);
+    after.set(PerfCounters::CYCLES, 350);
+    after.set(PerfCounters::CACHE_MISSES, 7);
+
+    const PerfCounters d = after - before;
+    assert_true("Cycles not measured.", d.has(PerfCounters::CYCLES));
+    assert_equals(250, static_cast<int>(d.get(PerfCounters::CYCLES)));
+    assert_false("Instructions only measured before.", d.has(PerfCounters::INSTRUCTIONS));
+    assert_false("Cache misses only measured after.", d.has(PerfCounters::CACHE_MISSES));
+
+    PerfCounters sum;
+    assert_true("Default not empty.", sum.is_empty());
+    sum += d;
+    sum += before;
+    assert_equals(350, static_cast<int>(sum.get(PerfCounters::CYCLES)));
+    assert_true("Instructions lost in sum.", sum.has(PerfCounters::INSTRUCTIONS));
+    assert_false("Branch misses appeared in sum.", sum.has(PerfCounters::BRANCH_MISSES));
+  }
+
+  CPUNIT_TEST(PerfCountersTest, test_group_counts_supported_events) {
+    const unsigned all = PerfCounters::mask_of(PerfCounters::NUM_EVENTS) - 1;
+    std::string problem;
+    const unsigned supported = impl::PerfEventGroup::probe(all, problem);
+    assert_true(problem, supported == all || !problem.empty());
+
+    const PerfCounters before = impl::PerfEventGroup::of_this_thread(supported);
+    volatile int x = 0;
+    for (int i=0; i<100000; ++i) {
+      x = x + i;
+    }
+    const PerfCounters used = impl::PerfEventGroup::of_this_thread(supported) - before;
+    if (supported == 0 || before.is_empty()) {
+      // No counters on this machine, or the group was never scheduled.
+      assert_true("Counted without counters.", used.is_empty());
+      return;
+    }
+    if (used.has(PerfCounters::INSTRUCTIONS)) {
+      assert_true("Too few instructions.", used.get(PerfCounters::INSTRUCTIONS) >= 100000);
+    }
+  }
+}
@@ -0,0 +1,126 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cpunit>
+#include <cpunit_ExecutionReport.hpp>
+#include <cpunit_RegInfo.hpp>
+#include <cpunit_impl_ProcessPool.hpp>
+#include <cpunit_impl_SharedReportTable.hpp>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace ProcessPoolTest {
+
+  using namespace cpunit;
+  using namespace cpunit::impl;
+
+  RegInfo ri("ProcessPoolTest", "job", "ProcessPoolTest.cpp", "42");
+
+  class TableJob : public ProcessPool::Job {
+    SharedReportTable &table;
+    const std::size_t crash_item;
+  public:
+    std::vector<int> done_count;
+    std::vector<std::string> crash_reasons;
+
+    TableJob(SharedReportTable &t, const std::size_t n, const std::size_t crash) :
+      table(t),
+      crash_item(crash),
+      done_count(n, 0),
+      crash_reasons(n)
+    {}
+
+    void run(const std::size_t item) {
+      if (item == crash_item) {
+	std::abort();
+      }
+      table.store(item, ExecutionReport(ExecutionReport::FAILURE, CPUNIT_STR("item "<<item), ri, item), true);
+    }
+
+    void done(const std::size_t item) {
+      ++done_count[item];
+    }
+
+    void crashed(const std::size_t item, const std::string &reason) {
+      crash_reasons[item] = reason;
+    }
+  };
+
+  std::vector<std::size_t> items(const std::size_t n) {
+    std::vector<std::size_t> result(n);
+    for (std::size_t i=0; i<n; ++i) {
+      result[i] = i;
+    }
+    return result;
+  }
+
+  CPUNIT_TEST(ProcessPoolTest, test_results_through_shared_table) {
+    const std::size_t n = 20;
+    SharedReportTable table(n);
+    TableJob job(table, n, n);
+    ProcessPool pool(3, 4, 0);
+    pool.run(items(n), job);
+    for (std::size_t i=0; i<n; ++i) {
+      assert_equals(CPUNIT_STR("done count for #"<<i), 1, job.done_count[i]);
+      assert_true(CPUNIT_STR("#"<<i<<" not done"), table.is_done(i));
+      const ExecutionReport r = table.load(i, ri);
+      assert_equals(CPUNIT_STR("message of #"<<i), CPUNIT_STR("item "<<i), r.get_message());
+      assert_equals(CPUNIT_STR("time of #"<<i), static_cast<double>(i), r.get_time_spent(), 0.0);
+      assert_true(CPUNIT_STR("result of #"<<i), r.get_execution_result() == ExecutionReport::FAILURE);
+    }
+  }
+
+  CPUNIT_TEST(ProcessPoolTest, test_crashed_worker_is_replaced) {
+    const std::size_t n = 10;
+    SharedReportTable table(n);
+    TableJob job(table, n, 3);
+    ProcessPool pool(2, 0, 0);
+    pool.run(items(n), job);
+    assert_equals("crashed item reported done", 0, job.done_count[3]);
+    assert_true(CPUNIT_STR("Unexpected crash reason: "<<job.crash_reasons[3]), 
+		job.crash_reasons[3].find("signal") != std::string::npos);
+    for (std::size_t i=0; i<n; ++i) {
+      if (i != 3) {
+	assert_equals(CPUNIT_STR("done count for #"<<i), 1, job.done_count[i]);
+      }
+    }
+  }
+
+  CPUNIT_TEST(ProcessPoolTest, test_long_message_is_truncated) {
+    SharedReportTable table(1);
+    const std::string msg(3 * SharedReportTable::MESSAGE_CAPACITY, 'x');
+    table.store(0, ExecutionReport(ExecutionReport::ERROR, msg, ri, .0), false);
+    const ExecutionReport r = table.load(0, ri);
+    assert_true("message not truncated", r.get_message().length() < SharedReportTable::MESSAGE_CAPACITY);
+    assert_equals("truncation marker", std::string(" [...]"), r.get_message().substr(r.get_message().length() - 6));
+    assert_false("executed", table.is_executed(0));
+  }
+}
@@ -0,0 +1,67 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <cpunit>
+#include <cpunit_ResourceUsage.hpp>
+
+namespace ResourceUsageTest {
+
+  using namespace cpunit;
+
+  CPUNIT_TEST(ResourceUsageTest, test_difference_and_sum) {
+    const ResourceUsage a(2.5, 10, 20, 30, 40);
+    const ResourceUsage b(1.0, 1, 2, 3, 4);
+    const ResourceUsage d = a - b;
+    assert_equals(1.5, d.get_cpu_time(), 1e-12);
+    assert_equals(9L, d.get_voluntary_switches());
+    assert_equals(18L, d.get_involuntary_switches());
+    assert_equals(27L, d.get_minor_faults());
+    assert_equals(36L, d.get_major_faults());
+
+    ResourceUsage sum(b);
+    sum += d;
+    assert_equals(a.get_cpu_time(), sum.get_cpu_time(), 1e-12);
+    assert_equals(a.get_major_faults(), sum.get_major_faults());
+  }
+
+  CPUNIT_TEST(ResourceUsageTest, test_busy_thread_uses_cpu) {
+    const ResourceUsage before = ResourceUsage::of_this_thread();
+    volatile double x = 0;
+    ResourceUsage used;
+    while (used.get_cpu_time() < 0.01) {
+      for (int i=0; i<100000; ++i) {
+	x = x + i;
+      }
+      used = ResourceUsage::of_this_thread() - before;
+    }
+    assert_true("Negative context switches.", used.get_voluntary_switches() >= 0 && used.get_involuntary_switches() >= 0);
+    assert_true("Negative page faults.", used.get_minor_faults() >= 0 && used.get_major_faults() >= 0);
+  }
+}
@@ -0,0 +1,113 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <cpunit>
+#include <cpunit_TimingDatabase.hpp>
+#include <cpunit_impl_Schedule.hpp>
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace ScheduleTest {
+
+  using namespace cpunit;
+  using namespace cpunit::impl;
+
+  // The database only lives in memory, since it is never saved.
+  std::string unsaved_path() {
+    std::ostringstream oss;
+    oss<<"/tmp/cpunit_ScheduleTest_"<<getpid()<<".db";
+    return oss.str();
+  }
+
+  const RegInfo slow("ScheduleTest::A", "test_slow", __FILE__, "1");
+  const RegInfo fast("ScheduleTest::A", "test_fast", __FILE__, "2");
+  const RegInfo new_in_a("ScheduleTest::A", "test_new", __FILE__, "3");
+  const RegInfo new_in_b("ScheduleTest::B", "test_new", __FILE__, "4");
+  const RegInfo medium("ScheduleTest::C", "test_medium", __FILE__, "5");
+
+  std::vector<const RegInfo*> all_tests() {
+    std::vector<const RegInfo*> tests;
+    tests.push_back(&fast);
+    tests.push_back(&new_in_a);
+    tests.push_back(&slow);
+    tests.push_back(&new_in_b);
+    tests.push_back(&medium);
+    return tests;
+  }
+
+  void fill(TimingDatabase &db) {
+    db.record(ExecutionReport(ExecutionReport::OK, "", slow, 10.0));
+    db.record(ExecutionReport(ExecutionReport::OK, "", fast, 2.0));
+    db.record(ExecutionReport(ExecutionReport::OK, "", medium, 3.0));
+  }
+
+  CPUNIT_TEST(ScheduleTest, test_estimates) {
+    TimingDatabase db(unsaved_path());
+    fill(db);
+    const std::vector<double> e = estimate_durations(all_tests(), db);
+    assert_equals(2.0, e[0], 1e-12);
+    assert_equals("Suite mean expected.", 6.0, e[1], 1e-12);
+    assert_equals(10.0, e[2], 1e-12);
+    assert_equals("Global mean expected.", 5.0, e[3], 1e-12);
+    assert_equals(3.0, e[4], 1e-12);
+  }
+
+  CPUNIT_TEST(ScheduleTest, test_longest_first) {
+    TimingDatabase db(unsaved_path());
+    fill(db);
+    const std::vector<std::size_t> order = order_by_duration(estimate_durations(all_tests(), db), true);
+    const std::size_t expected[] = { 2, 1, 3, 4, 0 };
+    for (std::size_t i=0; i<order.size(); ++i) {
+      assert_equals(CPUNIT_STR("Position #"<<i), expected[i], order[i]);
+    }
+  }
+
+  CPUNIT_TEST(ScheduleTest, test_shortest_first) {
+    TimingDatabase db(unsaved_path());
+    fill(db);
+    const std::vector<std::size_t> order = order_by_duration(estimate_durations(all_tests(), db), false);
+    const std::size_t expected[] = { 0, 4, 3, 1, 2 };
+    for (std::size_t i=0; i<order.size(); ++i) {
+      assert_equals(CPUNIT_STR("Position #"<<i), expected[i], order[i]);
+    }
+  }
+
+  CPUNIT_TEST(ScheduleTest, test_no_history_keeps_order) {
+    TimingDatabase db(unsaved_path());
+    const std::vector<std::size_t> order = order_by_duration(estimate_durations(all_tests(), db), true);
+    for (std::size_t i=0; i<order.size(); ++i) {
+      assert_equals(i, order[i]);
+    }
+  }
+}
@@ -0,0 +1,99 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <cpunit>
+#include <cpunit_ShardFilter.hpp>
+#include <cpunit_WrongSetupException.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ShardFilterTest {
+
+  using namespace cpunit;
+
+  std::vector<RegInfo> make_tests(const int suites, const int per_suite) {
+    std::vector<RegInfo> result;
+    for (int s=0; s<suites; ++s) {
+      std::ostringstream path;
+      path<<"Suite"<<s;
+      for (int t=0; t<per_suite; ++t) {
+	std::ostringstream name;
+	name<<"test_"<<t;
+	result.push_back(RegInfo(path.str(), name.str(), __FILE__, "1"));
+      }
+    }
+    return result;
+  }
+
+  CPUNIT_TEST(ShardFilterTest, test_shards_are_disjoint_and_complete) {
+    const std::vector<RegInfo> tests = make_tests(10, 10);
+    const std::size_t count = 4;
+    std::vector<int> owners(tests.size(), 0);
+    for (std::size_t s=0; s<count; ++s) {
+      ShardFilter shard(s, count, false);
+      for (std::size_t i=0; i<tests.size(); ++i) {
+	if (shard.accepts(tests[i])) {
+	  ++owners[i];
+	}
+      }
+    }
+    for (std::size_t i=0; i<tests.size(); ++i) {
+      assert_equals(CPUNIT_STR("Owners of "<<tests[i].get_path()<<"::"<<tests[i].get_name()), 1, owners[i]);
+    }
+  }
+
+  CPUNIT_TEST(ShardFilterTest, test_shard_is_stable) {
+    const RegInfo ri("Some::Suite", "test_something", __FILE__, "1");
+    const RegInfo same("Some::Suite", "test_something", "other_file.cpp", "42");
+    ShardFilter shard(0, 7, false);
+    assert_equals(shard.shard_of(ri), shard.shard_of(same));
+    assert_equals(shard.shard_of(ri), ShardFilter(3, 7, false).shard_of(ri));
+  }
+
+  CPUNIT_TEST(ShardFilterTest, test_by_suite_keeps_suites_together) {
+    const std::vector<RegInfo> tests = make_tests(10, 10);
+    ShardFilter shard(0, 3, true);
+    for (std::size_t i=0; i<tests.size(); i+=10) {
+      for (std::size_t j=1; j<10; ++j) {
+	assert_equals(CPUNIT_STR("Suite of test #"<<i+j), shard.shard_of(tests[i]), shard.shard_of(tests[i + j]));
+      }
+    }
+  }
+
+  CPUNIT_TEST_EX(ShardFilterTest, test_index_out_of_range, WrongSetupException) {
+    ShardFilter shard(2, 2, false);
+  }
+
+  CPUNIT_TEST_EX(ShardFilterTest, test_zero_shards, WrongSetupException) {
+    ShardFilter shard(0, 0, false);
+  }
+}
@@ -55,4 +55,20 @@ namespace TimeFormatTest {
 		    expected[i], static_cast<const std::string&>(tf.get_formatted_time()));
     }
   }
+
+  CPUNIT_TEST(TimeFormatTest, test_resolutions) {
+    assert_equals(std::string("1.123"), TimeFormat(1.1234567891, TimeFormat::MILLISECONDS).get_formatted_time());
+    assert_equals(std::string("1.123457"), TimeFormat(1.1234567891, TimeFormat::MICROSECONDS).get_formatted_time());
+    assert_equals(std::string("0.000000123"), TimeFormat(123e-9, TimeFormat::NANOSECONDS).get_formatted_time());
+  }
+
+  CPUNIT_TEST(TimeFormatTest, test_parse_resolution) {
+    TimeFormat::Resolution r = TimeFormat::MILLISECONDS;
+    assert_true(TimeFormat::parse_resolution("ns", r));
+    assert_true(r == TimeFormat::NANOSECONDS);
+    assert_true(TimeFormat::parse_resolution("us", r));
+    assert_true(r == TimeFormat::MICROSECONDS);
+    assert_false(TimeFormat::parse_resolution("s", r));
+    assert_true(r == TimeFormat::MICROSECONDS);
+  }
 }
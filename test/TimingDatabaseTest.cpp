@@ -0,0 +1,182 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <cpunit>
+#include <cpunit_CPUnitException.hpp>
+#include <cpunit_TimingDatabase.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace TimingDatabaseTest {
+
+  using namespace cpunit;
+
+  /**
+     A database file name unique to the test and process, removed again at the end of the test.
+   */
+  struct TempFile {
+    std::string path;
+    TempFile(const std::string &name) :
+      path()
+    {
+      std::ostringstream oss;
+      oss<<"/tmp/cpunit_TimingDatabaseTest_"<<name<<'_'<<getpid()<<".db";
+      path = oss.str();
+      std::remove(path.c_str());
+    }
+    ~TempFile() {
+      std::remove(path.c_str());
+    }
+  };
+
+  long file_size(const std::string &path) {
+    std::ifstream in(path.c_str(), std::ios::binary | std::ios::ate);
+    return static_cast<long>(in.tellg());
+  }
+
+  const RegInfo a("TimingDatabaseTest::Suite", "test_a", __FILE__, "1");
+  const RegInfo b("TimingDatabaseTest::Suite", "test_b", __FILE__, "2");
+
+  ExecutionReport report(const RegInfo &ri, const double time, const double set_up) {
+    ExecutionReport r(ExecutionReport::OK, "", ri, time);
+    r.set_set_up_time(set_up);
+    return r;
+  }
+
+  CPUNIT_TEST(TimingDatabaseTest, test_missing_file_is_empty) {
+    TempFile tmp("missing");
+    TimingDatabase db(tmp.path);
+    TimingDatabase::Entry e;
+    assert_equals(0, static_cast<int>(db.size()));
+    assert_false("Found entry in empty database.", db.lookup(a, e));
+  }
+
+  CPUNIT_TEST(TimingDatabaseTest, test_round_trip) {
+    TempFile tmp("round_trip");
+    {
+      TimingDatabase db(tmp.path);
+      db.record(report(a, 1.0, 0.25));
+      db.record(report(b, 2.0, 0.0));
+      db.save();
+    }
+    TimingDatabase db(tmp.path);
+    assert_equals(2, static_cast<int>(db.size()));
+    TimingDatabase::Entry e;
+    assert_true("test_a not found.", db.lookup(a, e));
+    assert_equals(1, static_cast<int>(e.count));
+    assert_equals(1.0, e.last_time, 1e-12);
+    assert_equals(0.25, e.last_set_up_time, 1e-12);
+    assert_equals(1.0, e.mean, 1e-12);
+    assert_equals(0.0, e.variance, 1e-12);
+    assert_true("test_b not found.", db.lookup(b, e));
+    assert_equals(2.0, e.last_time, 1e-12);
+  }
+
+  CPUNIT_TEST(TimingDatabaseTest, test_mean_and_variance) {
+    TempFile tmp("statistics");
+    const double times[] = { 2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0 };
+    for (std::size_t i=0; i<sizeof(times)/sizeof(times[0]); ++i) {
+      TimingDatabase db(tmp.path);
+      db.record(report(a, times[i], 0.0));
+      db.save();
+    }
+    TimingDatabase db(tmp.path);
+    TimingDatabase::Entry e;
+    assert_true("test_a not found.", db.lookup(a, e));
+    assert_equals(8, static_cast<int>(e.count));
+    assert_equals(5.0, e.mean, 1e-12);
+    assert_equals(4.0, e.variance, 1e-12);
+  }
+
+  CPUNIT_TEST(TimingDatabaseTest, test_rolling_window) {
+    TimingDatabase::Entry e;
+    for (std::size_t i=0; i<10 * TimingDatabase::WINDOW; ++i) {
+      e.add(1.0, 0.0);
+    }
+    for (std::size_t i=0; i<10 * TimingDatabase::WINDOW; ++i) {
+      e.add(3.0, 0.0);
+    }
+    assert_equals(3.0, e.mean, 1e-3);
+  }
+
+  CPUNIT_TEST(TimingDatabaseTest, test_updates_in_place) {
+    TempFile tmp("in_place");
+    {
+      TimingDatabase db(tmp.path);
+      db.record(report(a, 1.0, 0.0));
+      db.save();
+    }
+    const long size = file_size(tmp.path);
+    {
+      TimingDatabase db(tmp.path);
+      db.record(report(a, 3.0, 0.0));
+      db.save();
+    }
+    assert_equals("File grew on update.", size, file_size(tmp.path));
+    TimingDatabase db(tmp.path);
+    TimingDatabase::Entry e;
+    assert_true("test_a not found.", db.lookup(a, e));
+    assert_equals(2, static_cast<int>(e.count));
+    assert_equals(2.0, e.mean, 1e-12);
+  }
+
+  CPUNIT_TEST(TimingDatabaseTest, test_torn_record_is_ignored) {
+    TempFile tmp("torn");
+    {
+      TimingDatabase db(tmp.path);
+      db.record(report(a, 1.0, 0.0));
+      db.save();
+    }
+    const long size = file_size(tmp.path);
+    {
+      std::ofstream out(tmp.path.c_str(), std::ios::binary | std::ios::app);
+      out<<"garbage";
+    }
+    TimingDatabase db(tmp.path);
+    assert_equals(1, static_cast<int>(db.size()));
+    db.record(report(a, 1.0, 0.0));
+    db.save();
+    assert_equals("Torn record not cut off.", size, file_size(tmp.path));
+  }
+
+  CPUNIT_TEST_EX(TimingDatabaseTest, test_foreign_file, CPUnitException) {
+    TempFile tmp("foreign");
+    {
+      std::ofstream out(tmp.path.c_str());
+      out<<"This is not a timing database."<<std::endl;
+    }
+    TimingDatabase db(tmp.path);
+  }
+}
@@ -0,0 +1,88 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <cpunit>
+#include <cpunit_impl_Watchdog.hpp>
+
+#include <string>
+#include <unistd.h>
+
+namespace WatchdogTest {
+
+  using namespace cpunit;
+  using namespace cpunit::impl;
+
+  /**
+     Records the timeout instead of ending the process.
+   */
+  struct RecordingHandler : public Watchdog::Handler {
+    volatile bool fired;
+    std::string message;
+    const RegInfo *test;
+
+    RecordingHandler() :
+      fired(false),
+      message(),
+      test(NULL)
+    {}
+
+    void timed_out(const RegInfo &t, const std::string &m) {
+      test = &t;
+      message = m;
+      fired = true;
+    }
+  };
+
+  const RegInfo stuck("WatchdogTest", "stuck", __FILE__, "1");
+
+  CPUNIT_TEST(WatchdogTest, test_fires_with_stack) {
+    RecordingHandler handler;
+    Watchdog watchdog(0.05, handler);
+    watchdog.arm(stuck);
+    for (int i=0; i<500 && !handler.fired; ++i) {
+      usleep(10000);
+    }
+    watchdog.disarm();
+    assert_true("Watchdog did not fire.", handler.fired);
+    assert_equals(&stuck, handler.test);
+    assert_true(CPUNIT_STR("Unexpected message: "<<handler.message), handler.message.find("TIME GUARD ERROR") == 0);
+    assert_true(CPUNIT_STR("No stack in message: "<<handler.message), handler.message.find("#0 ") != std::string::npos);
+  }
+
+  CPUNIT_TEST(WatchdogTest, test_disarmed_does_not_fire) {
+    RecordingHandler handler;
+    Watchdog watchdog(0.05, handler);
+    {
+      WatchdogGuard guard(&watchdog, stuck);
+    }
+    usleep(100000);
+    assert_false("Watchdog fired after disarm.", handler.fired);
+  }
+}
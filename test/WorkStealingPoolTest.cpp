@@ -0,0 +1,112 @@
+/*
+   Copyright (c) 2011 Daniel Bakkelund.
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the names of its
+       contributors may be used to endorse or promote products derived from
+       this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+   LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+   CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+   SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+   INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+   CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+   THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cpunit>
+#include <cpunit_impl_Mutex.hpp>
+#include <cpunit_impl_WorkStealingPool.hpp>
+#include <cpunit_WrongSetupException.hpp>
+
+#include <vector>
+
+namespace WorkStealingPoolTest {
+
+  using namespace cpunit;
+  using namespace cpunit::impl;
+
+  class CountingJob : public WorkStealingPool::Job {
+    Mutex lock;
+  public:
+    std::vector<int> runs;
+    std::vector<std::size_t> workers;
+    WorkStealingPool *cancel_in;
+    std::size_t cancel_at;
+    std::size_t started;
+
+    CountingJob(const std::size_t items) :
+      lock(),
+      runs(items, 0),
+      workers(),
+      cancel_in(NULL),
+      cancel_at(0),
+      started(0)
+    {}
+
+    void run(const std::size_t item, const std::size_t worker) {
+      MutexLock l(lock);
+      ++runs[item];
+      workers.push_back(worker);
+      if (cancel_in != NULL && ++started == cancel_at) {
+	cancel_in->cancel();
+      }
+    }
+  };
+
+  std::vector<std::size_t> items(const std::size_t n) {
+    std::vector<std::size_t> result(n);
+    for (std::size_t i=0; i<n; ++i) {
+      result[i] = i;
+    }
+    return result;
+  }
+
+  CPUNIT_TEST(WorkStealingPoolTest, test_all_items_run_once) {
+    const std::size_t n = 1000;
+    WorkStealingPool pool(4);
+    CountingJob job(n);
+    pool.run(items(n), job);
+    for (std::size_t i=0; i<n; ++i) {
+      assert_equals(CPUNIT_STR("Item #"<<i), 1, job.runs[i]);
+    }
+    for (std::size_t i=0; i<job.workers.size(); ++i) {
+      assert_true(CPUNIT_STR("Worker #"<<job.workers[i]<<" out of range"), job.workers[i] < 4);
+    }
+  }
+
+  CPUNIT_TEST(WorkStealingPoolTest, test_more_workers_than_items) {
+    WorkStealingPool pool(8);
+    CountingJob job(3);
+    pool.run(items(3), job);
+    assert_equals(3, static_cast<int>(job.workers.size()));
+  }
+
+  CPUNIT_TEST(WorkStealingPoolTest, test_cancel_stops_pending_items) {
+    const std::size_t n = 1000;
+    WorkStealingPool pool(1);
+    CountingJob job(n);
+    job.cancel_in = &pool;
+    job.cancel_at = 10;
+    pool.run(items(n), job);
+    assert_equals(10, static_cast<int>(job.workers.size()));
+    assert_true("Pool not cancelled.", pool.is_cancelled());
+  }
+
+  CPUNIT_TEST_EX(WorkStealingPoolTest, test_zero_workers, WrongSetupException) {
+    WorkStealingPool pool(0);
+  }
+}